@@ -0,0 +1,198 @@
+// Shared plumbing for the benchmark suites: a scratch database per run,
+// timing with per-operation latency samples, and a seeded PRNG so every run
+// issues the same key sequence.
+import { WiredTigerConnection } from '../src/connection'
+import { WiredTigerSession } from '../src/session'
+import * as fs from 'fs'
+import * as os from 'os'
+import * as path from 'path'
+
+export interface BenchConfig {
+  // Records loaded per table and operations per measurement
+  records: number
+  ops: number
+  valueSizes: number[]
+  // Caps records x value size per measurement, so 1MB values stay feasible
+  maxBytes: number
+  seed: number
+  // Substring a benchmark's name must contain to run
+  filter?: string
+}
+
+export interface LatencyStats {
+  // Microseconds
+  mean: number
+  p50: number
+  p95: number
+  p99: number
+  max: number
+}
+
+export interface BenchResult {
+  suite: string
+  name: string
+  // 'sync', 'batched', 'async', ...
+  variant: string
+  valueSize: number
+  ops: number
+  durationMs: number
+  opsPerSec: number
+  // MiB/s of keys and values moved
+  throughputMiBs: number
+  // Per-operation latencies; absent for batched variants, where one timed
+  // call covers many operations
+  latencyUs?: LatencyStats
+}
+
+export interface Timing {
+  start: bigint
+  end: bigint
+  latencies?: Float64Array
+}
+
+export interface BenchCase {
+  suite: string
+  name: string
+  variant: string
+  valueSize: number
+}
+
+export class Recorder {
+  readonly results: BenchResult[] = []
+
+  constructor(private readonly config: BenchConfig) {}
+
+  enabled(name: string): boolean {
+    return !this.config.filter || name.includes(this.config.filter)
+  }
+
+  // Whether any of `name`'s variants would run, to skip loading its data
+  any(name: string, variants: string[]): boolean {
+    return variants.some(variant => this.enabled(`${name}/${variant}`))
+  }
+
+  // `ops` operations moving `bytes` of keys and values took `timing`
+  add(entry: BenchCase, timing: Timing, ops: number, bytes: number): void {
+    const durationMs = Number(timing.end - timing.start) / 1e6
+    const result: BenchResult = {
+      ...entry,
+      ops,
+      durationMs: round(durationMs),
+      opsPerSec: round(ops / (durationMs / 1000)),
+      throughputMiBs: round(bytes / (1024 * 1024) / (durationMs / 1000))
+    }
+    if (timing.latencies && timing.latencies.length > 0) {
+      result.latencyUs = summarize(timing.latencies)
+    }
+    this.results.push(result)
+
+    const size = entry.valueSize ? `, ${formatSize(entry.valueSize)}` : ''
+    const latency = result.latencyUs ? `  p50 ${result.latencyUs.p50}us  p99 ${result.latencyUs.p99}us` : ''
+    console.error(
+      `${entry.suite}/${entry.name} [${entry.variant}${size}]: ${result.opsPerSec.toLocaleString()} ops/s${latency}`
+    )
+  }
+}
+
+function round(value: number): number {
+  return Math.round(value * 100) / 100
+}
+
+export function summarize(latencies: Float64Array): LatencyStats {
+  const sorted = Float64Array.from(latencies).sort()
+  const at = (q: number) => round(sorted[Math.min(sorted.length - 1, Math.floor(q * sorted.length))])
+  let sum = 0
+  for (const value of sorted) sum += value
+  return {
+    mean: round(sum / sorted.length),
+    p50: at(0.5),
+    p95: at(0.95),
+    p99: at(0.99),
+    max: round(sorted[sorted.length - 1])
+  }
+}
+
+export function formatSize(bytes: number): string {
+  if (bytes >= 1024 * 1024) return `${bytes / (1024 * 1024)}MB`
+  if (bytes >= 1024) return `${bytes / 1024}KB`
+  return `${bytes}B`
+}
+
+export const now = () => process.hrtime.bigint()
+
+// Times `ops` calls of `op`, sampling each one's latency
+export function timeEach(ops: number, op: (i: number) => void): Timing {
+  const latencies = new Float64Array(ops)
+  const start = now()
+  for (let i = 0; i < ops; i++) {
+    const t = now()
+    op(i)
+    latencies[i] = Number(now() - t) / 1e3
+  }
+  return { start, end: now(), latencies }
+}
+
+export async function timeEachAsync(ops: number, op: (i: number) => Promise<unknown>): Promise<Timing> {
+  const latencies = new Float64Array(ops)
+  const start = now()
+  for (let i = 0; i < ops; i++) {
+    const t = now()
+    await op(i)
+    latencies[i] = Number(now() - t) / 1e3
+  }
+  return { start, end: now(), latencies }
+}
+
+// mulberry32
+export class Random {
+  private state: number
+
+  constructor(seed: number) {
+    this.state = seed >>> 0
+  }
+
+  next(): number {
+    let t = (this.state = (this.state + 0x6d2b79f5) >>> 0)
+    t = Math.imul(t ^ (t >>> 15), t | 1)
+    t ^= t + Math.imul(t ^ (t >>> 7), t | 61)
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296
+  }
+
+  int(bound: number): number {
+    return Math.floor(this.next() * bound)
+  }
+}
+
+// Operations for one measurement at `valueSize`, within config.maxBytes
+export function opsFor(config: BenchConfig, valueSize: number, ops = config.ops): number {
+  return Math.max(10, Math.min(ops, Math.floor(config.maxBytes / Math.max(1, valueSize))))
+}
+
+export function keyOf(i: number): string {
+  return `key${String(i).padStart(10, '0')}`
+}
+
+export function valueOf(size: number, i: number): string {
+  const stamp = String(i)
+  return stamp + 'x'.repeat(Math.max(0, size - stamp.length))
+}
+
+// A fresh database in the system temp directory, removed on close()
+export class ScratchDb {
+  readonly dir: string
+  readonly conn: WiredTigerConnection
+  readonly session: WiredTigerSession
+
+  constructor(name: string, cacheSize = '1G') {
+    this.dir = fs.mkdtempSync(path.join(os.tmpdir(), `wt-bench-${name}-`))
+    this.conn = new WiredTigerConnection()
+    this.conn.open(this.dir, `create,cache_size=${cacheSize}`)
+    this.session = this.conn.openSession()
+  }
+
+  close(): void {
+    this.session.close()
+    this.conn.close()
+    fs.rmSync(this.dir, { recursive: true, force: true })
+  }
+}
@@ -0,0 +1,233 @@
+// Point reads and writes, range scans and transactions across value sizes,
+// each through the sync, batched and async variants of the API
+import { WiredTigerCursor } from '../src/cursor'
+import { packEntries } from '../src/packed'
+import {
+  BenchConfig,
+  Recorder,
+  Random,
+  ScratchDb,
+  Timing,
+  keyOf,
+  now,
+  opsFor,
+  timeEach,
+  timeEachAsync,
+  valueOf
+} from './harness'
+
+const SUITE = 'micro'
+const BATCH = 1000
+
+function entries(from: number, to: number, size: number): [string, string][] {
+  const batch: [string, string][] = []
+  for (let i = from; i < to; i++) batch.push([keyOf(i), valueOf(size, i)])
+  return batch
+}
+
+function load(cursor: WiredTigerCursor, count: number, size: number): void {
+  for (let i = 0; i < count; i += BATCH) {
+    cursor.putMany(packEntries(entries(i, Math.min(count, i + BATCH), size)))
+  }
+}
+
+export async function runMicro(config: BenchConfig, recorder: Recorder): Promise<void> {
+  const db = new ScratchDb(SUITE)
+  try {
+    for (const size of config.valueSizes) {
+      await runPuts(db, config, recorder, size)
+      await runGets(db, config, recorder, size)
+      await runScans(db, config, recorder, size)
+    }
+    await runTransactions(db, config, recorder)
+  } finally {
+    db.close()
+  }
+}
+
+// Each variant writes to a fresh table
+async function runPuts(db: ScratchDb, config: BenchConfig, recorder: Recorder, size: number): Promise<void> {
+  const ops = opsFor(config, size)
+  const bytes = ops * (keyOf(0).length + size)
+  const values = Array.from({ length: Math.min(ops, 64) }, (_, i) => valueOf(size, i))
+  const value = (i: number) => values[i % values.length]
+
+  const variants: [string, (cursor: WiredTigerCursor) => Promise<Timing>][] = [
+    [
+      'sync',
+      async cursor =>
+        timeEach(ops, i => {
+          cursor.set(keyOf(i), value(i))
+          cursor.insert()
+        })
+    ],
+    [
+      'transaction',
+      async cursor =>
+        timeEach(ops, i => {
+          if (i % BATCH === 0) db.session.beginTransaction()
+          cursor.set(keyOf(i), value(i))
+          cursor.insert()
+          if (i % BATCH === BATCH - 1 || i === ops - 1) db.session.commitTransaction()
+        })
+    ],
+    [
+      'batched',
+      async cursor => {
+        const start = now()
+        for (let i = 0; i < ops; i += BATCH) {
+          cursor.putMany(packEntries(entries(i, Math.min(ops, i + BATCH), size)))
+        }
+        return { start, end: now() }
+      }
+    ],
+    ['async', cursor => timeEachAsync(ops, i => cursor.insertAsync(keyOf(i), value(i)))],
+    [
+      'batched-async',
+      async cursor => {
+        const start = now()
+        for (let i = 0; i < ops; i += BATCH) {
+          await cursor.putManyAsync(packEntries(entries(i, Math.min(ops, i + BATCH), size)))
+        }
+        return { start, end: now() }
+      }
+    ]
+  ]
+
+  for (const [variant, run] of variants) {
+    if (!recorder.enabled(`put/${variant}`)) continue
+    const table = `put_${variant.replace('-', '_')}_${size}`
+    db.session.createTable(table, 'key_format=u,value_format=u')
+    const cursor = db.session.openCursor(table)
+    const timing = await run(cursor)
+    cursor.close()
+    recorder.add({ suite: SUITE, name: 'put', variant, valueSize: size }, timing, ops, bytes)
+    db.session.drop(`table:${table}`)
+  }
+}
+
+async function runGets(db: ScratchDb, config: BenchConfig, recorder: Recorder, size: number): Promise<void> {
+  if (!recorder.any('get', ['sync', 'view', 'batched', 'async', 'batched-async'])) return
+  const records = opsFor(config, size, config.records)
+  const ops = opsFor(config, size)
+  const table = `get_${size}`
+  db.session.createTable(table, 'key_format=u,value_format=u')
+  const cursor = db.session.openCursor(table)
+  load(cursor, records, size)
+
+  const random = new Random(config.seed)
+  const keys = Array.from({ length: ops }, () => keyOf(random.int(records)))
+  const bytes = ops * (keyOf(0).length + size)
+  const entry = (variant: string) => ({ suite: SUITE, name: 'get', variant, valueSize: size })
+
+  if (recorder.enabled('get/sync')) {
+    recorder.add(entry('sync'), timeEach(ops, i => cursor.search(keys[i])), ops, bytes)
+  }
+  if (recorder.enabled('get/view')) {
+    recorder.add(entry('view'), timeEach(ops, i => cursor.searchView(keys[i])), ops, bytes)
+  }
+  if (recorder.enabled('get/batched')) {
+    const start = now()
+    for (let i = 0; i < ops; i += BATCH) cursor.getMany(keys.slice(i, i + BATCH))
+    recorder.add(entry('batched'), { start, end: now() }, ops, bytes)
+  }
+  if (recorder.enabled('get/async')) {
+    recorder.add(entry('async'), await timeEachAsync(ops, i => cursor.searchAsync(keys[i])), ops, bytes)
+  }
+  if (recorder.enabled('get/batched-async')) {
+    const start = now()
+    for (let i = 0; i < ops; i += BATCH) await cursor.getManyAsync(keys.slice(i, i + BATCH))
+    recorder.add(entry('batched-async'), { start, end: now() }, ops, bytes)
+  }
+
+  cursor.close()
+  db.session.drop(`table:${table}`)
+}
+
+// Full-table scans; ops is the number of records visited
+async function runScans(db: ScratchDb, config: BenchConfig, recorder: Recorder, size: number): Promise<void> {
+  if (!recorder.any('scan', ['sync', 'chunked', 'async'])) return
+  const records = opsFor(config, size, config.records)
+  const table = `scan_${size}`
+  db.session.createTable(table, 'key_format=u,value_format=u')
+  const cursor = db.session.openCursor(table)
+  load(cursor, records, size)
+  const bytes = records * (keyOf(0).length + size)
+  const entry = (variant: string) => ({ suite: SUITE, name: 'scan', variant, valueSize: size })
+
+  if (recorder.enabled('scan/sync')) {
+    cursor.reset()
+    const start = now()
+    while (cursor.next()) {
+      // visit
+    }
+    recorder.add(entry('sync'), { start, end: now() }, records, bytes)
+  }
+  if (recorder.enabled('scan/chunked')) {
+    let chunk = Buffer.allocUnsafe(1024 * 1024)
+    const start = now()
+    cursor.scanStart({})
+    for (;;) {
+      const result = cursor.scanFill(chunk)
+      if (result.needed > 0) {
+        chunk = Buffer.allocUnsafe(result.needed)
+        continue
+      }
+      if (result.done) break
+    }
+    recorder.add(entry('chunked'), { start, end: now() }, records, bytes)
+  }
+  if (recorder.enabled('scan/async')) {
+    const start = now()
+    for await (const record of cursor.scan({})) {
+      void record
+    }
+    recorder.add(entry('async'), { start, end: now() }, records, bytes)
+  }
+
+  cursor.close()
+  db.session.drop(`table:${table}`)
+}
+
+// Short read-modify-write transactions, committed sync and async
+async function runTransactions(db: ScratchDb, config: BenchConfig, recorder: Recorder): Promise<void> {
+  if (!recorder.any('transaction', ['sync', 'async'])) return
+  const size = 100
+  const records = Math.min(config.records, 10000)
+  const table = 'transactions'
+  db.session.createTable(table, 'key_format=u,value_format=u')
+  const cursor = db.session.openCursor(table)
+  load(cursor, records, size)
+
+  const ops = Math.max(10, Math.floor(config.ops / 10))
+  const random = new Random(config.seed)
+  const keys = Array.from({ length: ops * 10 }, () => keyOf(random.int(records)))
+  const bytes = ops * 10 * (keyOf(0).length + size)
+  const update = (i: number) => {
+    db.session.beginTransaction()
+    for (let k = i * 10; k < i * 10 + 10; k++) {
+      cursor.search(keys[k])
+      cursor.set(keys[k], valueOf(size, k))
+      cursor.update()
+    }
+  }
+  const entry = (variant: string) => ({ suite: SUITE, name: 'transaction', variant, valueSize: size })
+
+  if (recorder.enabled('transaction/sync')) {
+    const timing = timeEach(ops, i => {
+      update(i)
+      db.session.commitTransaction()
+    })
+    recorder.add(entry('sync'), timing, ops, bytes)
+  }
+  if (recorder.enabled('transaction/async')) {
+    const timing = await timeEachAsync(ops, i => {
+      update(i)
+      return db.session.commitTransactionAsync()
+    })
+    recorder.add(entry('async'), timing, ops, bytes)
+  }
+
+  cursor.close()
+  db.session.drop(`table:${table}`)
+}
@@ -0,0 +1,92 @@
+// Benchmark runner: npm run bench -- [--suite micro|ycsb|all] [--quick]
+//   [--records N] [--ops N] [--sizes 100,1024,...] [--filter get/sync]
+//   [--seed N] [--out results.json]
+//
+// Prints a line per measurement to stderr and writes every result, with the
+// environment it ran in, as JSON to --out (default bench/results/latest.json)
+// so runs can be compared across releases.
+import { execSync } from 'child_process'
+import * as fs from 'fs'
+import * as os from 'os'
+import * as path from 'path'
+import { BenchConfig, Recorder } from './harness'
+import { runMicro } from './micro'
+import { runYcsb } from './ycsb'
+
+const FULL: BenchConfig = {
+  records: 100000,
+  ops: 100000,
+  valueSizes: [100, 1024, 10 * 1024, 100 * 1024, 1024 * 1024],
+  maxBytes: 256 * 1024 * 1024,
+  seed: 42
+}
+
+const QUICK: BenchConfig = { ...FULL, records: 10000, ops: 10000, maxBytes: 32 * 1024 * 1024 }
+
+function parseArgs(argv: string[]): { config: BenchConfig; suite: string; out: string } {
+  const options: Record<string, string> = {}
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i]
+    if (!arg.startsWith('--')) throw new Error(`Unexpected argument: ${arg}`)
+    const name = arg.slice(2)
+    if (name === 'quick') {
+      options.quick = 'true'
+    } else {
+      if (i + 1 >= argv.length) throw new Error(`Missing value for ${arg}`)
+      options[name] = argv[++i]
+    }
+  }
+
+  const config = { ...(options.quick ? QUICK : FULL) }
+  if (options.records) config.records = Number(options.records)
+  if (options.ops) config.ops = Number(options.ops)
+  if (options.sizes) config.valueSizes = options.sizes.split(',').map(Number)
+  if (options.seed) config.seed = Number(options.seed)
+  if (options.filter) config.filter = options.filter
+  return {
+    config,
+    suite: options.suite ?? 'all',
+    out: options.out ?? path.join(__dirname, 'results', 'latest.json')
+  }
+}
+
+function gitRevision(): string | undefined {
+  try {
+    return execSync('git rev-parse --short HEAD', { cwd: __dirname, stdio: ['ignore', 'pipe', 'ignore'] })
+      .toString()
+      .trim()
+  } catch {
+    return undefined
+  }
+}
+
+async function main(): Promise<void> {
+  const { config, suite, out } = parseArgs(process.argv.slice(2))
+  const recorder = new Recorder(config)
+  const startedAt = new Date().toISOString()
+
+  if (suite === 'all' || suite === 'micro') await runMicro(config, recorder)
+  if (suite === 'all' || suite === 'ycsb') await runYcsb(config, recorder)
+
+  const report = {
+    startedAt,
+    revision: gitRevision(),
+    environment: {
+      node: process.version,
+      platform: `${process.platform}-${process.arch}`,
+      cpu: os.cpus()[0]?.model,
+      cpus: os.cpus().length,
+      memoryGiB: Math.round(os.totalmem() / 1024 ** 3)
+    },
+    config,
+    results: recorder.results
+  }
+  fs.mkdirSync(path.dirname(out), { recursive: true })
+  fs.writeFileSync(out, JSON.stringify(report, null, 2) + '\n')
+  console.error(`\n${recorder.results.length} results written to ${out}`)
+}
+
+main().catch(err => {
+  console.error(err)
+  process.exit(1)
+})
@@ -0,0 +1,158 @@
+// YCSB core workloads A-F against one table of 1KB records, loaded once and
+// run in order (D and E insert new records, as in YCSB)
+import { ScanFillResult, WiredTigerCursor } from '../src/cursor'
+import { packEntries } from '../src/packed'
+import { BenchConfig, Recorder, Random, ScratchDb, keyOf, timeEach, valueOf } from './harness'
+
+const SUITE = 'ycsb'
+const RECORD_SIZE = 1000
+const MAX_SCAN = 100
+
+type Operation = 'read' | 'update' | 'insert' | 'scan' | 'rmw'
+
+interface Workload {
+  name: string
+  mix: [Operation, number][]
+  distribution: 'zipfian' | 'latest'
+}
+
+const WORKLOADS: Workload[] = [
+  { name: 'A', mix: [['read', 0.5], ['update', 0.5]], distribution: 'zipfian' },
+  { name: 'B', mix: [['read', 0.95], ['update', 0.05]], distribution: 'zipfian' },
+  { name: 'C', mix: [['read', 1]], distribution: 'zipfian' },
+  { name: 'D', mix: [['read', 0.95], ['insert', 0.05]], distribution: 'latest' },
+  { name: 'E', mix: [['scan', 0.95], ['insert', 0.05]], distribution: 'zipfian' },
+  { name: 'F', mix: [['read', 0.5], ['rmw', 0.5]], distribution: 'zipfian' }
+]
+
+// YCSB's ZipfianGenerator (Gray et al.), theta 0.99
+class Zipfian {
+  private readonly zetan: number
+  private readonly alpha: number
+  private readonly eta: number
+  private readonly theta = 0.99
+
+  constructor(
+    private readonly items: number,
+    private readonly random: Random
+  ) {
+    this.zetan = Zipfian.zeta(items, this.theta)
+    this.alpha = 1 / (1 - this.theta)
+    this.eta = (1 - Math.pow(2 / items, 1 - this.theta)) / (1 - Zipfian.zeta(2, this.theta) / this.zetan)
+  }
+
+  private static zeta(n: number, theta: number): number {
+    let sum = 0
+    for (let i = 1; i <= n; i++) sum += 1 / Math.pow(i, theta)
+    return sum
+  }
+
+  // 0 is the most popular item
+  next(): number {
+    const u = this.random.next()
+    const uz = u * this.zetan
+    if (uz < 1) return 0
+    if (uz < 1 + Math.pow(0.5, this.theta)) return 1
+    return Math.min(this.items - 1, Math.floor(this.items * Math.pow(this.eta * u - this.eta + 1, this.alpha)))
+  }
+}
+
+// FNV-1a, so popular items are spread over the key space
+function scramble(item: number, items: number): number {
+  let hash = 0x811c9dc5
+  for (let shift = 0; shift < 32; shift += 8) {
+    hash ^= (item >>> shift) & 0xff
+    hash = Math.imul(hash, 0x01000193)
+  }
+  return (hash >>> 0) % items
+}
+
+export async function runYcsb(config: BenchConfig, recorder: Recorder): Promise<void> {
+  if (!WORKLOADS.some(workload => recorder.enabled(`workload-${workload.name}`))) return
+
+  const db = new ScratchDb(SUITE)
+  try {
+    db.session.createTable('usertable', 'key_format=u,value_format=u')
+    const cursor = db.session.openCursor('usertable')
+    const records = config.records
+    for (let i = 0; i < records; i += 1000) {
+      const batch: [string, string][] = []
+      for (let k = i; k < Math.min(records, i + 1000); k++) batch.push([keyOf(k), valueOf(RECORD_SIZE, k)])
+      cursor.putMany(packEntries(batch))
+    }
+
+    const random = new Random(config.seed)
+    const zipfian = new Zipfian(records, random)
+    let inserted = records
+    for (const workload of WORKLOADS) {
+      if (!recorder.enabled(`workload-${workload.name}`)) continue
+      inserted = run(workload, cursor, config, recorder, random, zipfian, inserted)
+    }
+    cursor.close()
+  } finally {
+    db.close()
+  }
+}
+
+function run(
+  workload: Workload,
+  cursor: WiredTigerCursor,
+  config: BenchConfig,
+  recorder: Recorder,
+  random: Random,
+  zipfian: Zipfian,
+  inserted: number
+): number {
+  const records = config.records
+  const chunk = Buffer.allocUnsafe((MAX_SCAN + 1) * (RECORD_SIZE + 64))
+  const choose = () =>
+    workload.distribution === 'latest'
+      ? Math.max(0, inserted - 1 - zipfian.next())
+      : scramble(zipfian.next(), records)
+  let bytes = 0
+
+  const operations: Record<Operation, () => void> = {
+    read: () => {
+      const value = cursor.search(keyOf(choose()))
+      bytes += value ? value.length : 0
+    },
+    update: () => {
+      cursor.set(keyOf(choose()), valueOf(RECORD_SIZE, inserted))
+      cursor.update()
+      bytes += RECORD_SIZE
+    },
+    insert: () => {
+      cursor.set(keyOf(inserted), valueOf(RECORD_SIZE, inserted))
+      cursor.insert()
+      inserted++
+      bytes += RECORD_SIZE
+    },
+    scan: () => {
+      cursor.scanStart({ gte: keyOf(choose()), limit: 1 + random.int(MAX_SCAN) })
+      let result: ScanFillResult
+      do {
+        result = cursor.scanFill(chunk)
+        bytes += result.bytes
+      } while (!result.done && result.count > 0)
+    },
+    rmw: () => {
+      const key = keyOf(choose())
+      const value = cursor.search(key)
+      cursor.set(key, value ? value.slice(0, -1) + 'y' : valueOf(RECORD_SIZE, 0))
+      cursor.update()
+      bytes += 2 * RECORD_SIZE
+    }
+  }
+
+  const plan = Array.from({ length: config.ops }, () => {
+    let roll = random.next()
+    for (const [operation, share] of workload.mix) {
+      if ((roll -= share) < 0) return operations[operation]
+    }
+    return operations[workload.mix[workload.mix.length - 1][0]]
+  })
+  const timing = timeEach(config.ops, i => plan[i]())
+  const entry = { suite: SUITE, name: `workload-${workload.name}`, variant: 'sync', valueSize: RECORD_SIZE }
+  recorder.add(entry, timing, config.ops, bytes)
+  return inserted
+}
@@ -0,0 +1,321 @@
+#pragma once
+
+#include <wiredtiger.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "doc_filter.h"
+#include "field_index.h"
+#include "session_pool.h"
+
+// Count, sum, min and max over the JSON documents in a key range of a
+// value_format=u table, optionally grouped by a field. The range is split at
+// sampled keys and each part is scanned on its own thread with a pooled
+// session; the partial results are merged at the end, so only the totals
+// cross into JS. Parts read independently rather than as one snapshot.
+// Cursors are raw, so on typed key formats the bounds must already be packed.
+
+namespace aggregate
+{
+  struct Totals
+  {
+    uint64_t count = 0;
+    // Documents whose aggregated field is a number
+    uint64_t numeric = 0;
+    double sum = 0;
+    double min = 0;
+    double max = 0;
+
+    void Add(double value)
+    {
+      min = numeric == 0 ? value : std::min(min, value);
+      max = numeric == 0 ? value : std::max(max, value);
+      sum += value;
+      numeric++;
+    }
+
+    void Merge(const Totals &other)
+    {
+      count += other.count;
+      if (other.numeric == 0)
+      {
+        return;
+      }
+      min = numeric == 0 ? other.min : std::min(min, other.min);
+      max = numeric == 0 ? other.max : std::max(max, other.max);
+      sum += other.sum;
+      numeric += other.numeric;
+    }
+  };
+
+  struct Group
+  {
+    // JSON text of the group's value; "null" for documents without the field
+    std::string token;
+    Totals totals;
+  };
+
+  struct Result
+  {
+    Totals totals;
+    // Keyed by the encoded group value, so groups come out in index order
+    std::map<std::string, Group> groups;
+
+    void Merge(const Result &other)
+    {
+      totals.Merge(other.totals);
+      for (const auto &entry : other.groups)
+      {
+        auto it = groups.find(entry.first);
+        if (it == groups.end())
+        {
+          groups.insert(entry);
+        }
+        else
+        {
+          it->second.totals.Merge(entry.second.totals);
+        }
+      }
+    }
+  };
+
+  struct Spec
+  {
+    std::string uri; // "table:users"
+    std::string lower, upper;
+    bool hasLower = false, hasUpper = false;
+    bool lowerInclusive = true, upperInclusive = true;
+    std::shared_ptr<const doc_filter::Node> filter;
+    // Field summed and ranged over; empty to only count
+    std::vector<std::string> field;
+    // Field grouped by; empty for a single total
+    std::vector<std::string> groupBy;
+  };
+
+  // Reads the field at `path` if it is a JSON number
+  inline bool ReadNumber(const char *doc, size_t size, const std::vector<std::string> &path, double &out)
+  {
+    size_t start, end;
+    if (!field_index::FindField(doc, size, path, start, end))
+    {
+      return false;
+    }
+    char c = doc[start];
+    if (c != '-' && (c < '0' || c > '9'))
+    {
+      return false;
+    }
+    // The value isn't NUL-terminated; numbers are short enough to copy
+    char number[64];
+    size_t length = end - start;
+    if (length >= sizeof(number))
+    {
+      return false;
+    }
+    std::memcpy(number, doc + start, length);
+    number[length] = '\0';
+    char *last;
+    out = std::strtod(number, &last);
+    return *last == '\0';
+  }
+
+  class Aggregator
+  {
+  public:
+    Aggregator(SessionPool &pool, Spec spec, unsigned threads)
+        : pool_(pool), spec_(std::move(spec)), threads_(std::max(1u, std::min<unsigned>(threads, (unsigned)pool.Max())))
+    {
+    }
+
+    int Run()
+    {
+      WT_SESSION *session;
+      int ret = pool_.Acquire(&session, true);
+      if (ret != 0)
+      {
+        return Fail(ret, "no session available");
+      }
+      std::vector<std::string> bounds;
+      ret = field_index::SampleSplitKeys(session, spec_.uri, threads_, spec_.hasLower ? &spec_.lower : nullptr,
+                                         spec_.hasUpper ? &spec_.upper : nullptr, bounds);
+      pool_.Release(session);
+      if (ret != 0)
+      {
+        return Fail(ret, "failed to split the range");
+      }
+
+      // Part k covers [bounds[k - 1], bounds[k]); the outer ends are the
+      // requested range's
+      size_t parts = bounds.size() + 1;
+      std::vector<std::thread> workers;
+      std::vector<Result> partials(parts);
+      std::vector<int> results(parts, 0);
+      for (size_t k = 0; k < parts; k++)
+      {
+        Bound lower{k > 0 ? &bounds[k - 1] : spec_.hasLower ? &spec_.lower : nullptr,
+                    k > 0 || spec_.lowerInclusive};
+        Bound upper{k < bounds.size() ? &bounds[k] : spec_.hasUpper ? &spec_.upper : nullptr,
+                    k == bounds.size() && spec_.upperInclusive};
+        workers.emplace_back([this, lower, upper, &partials, &results, k]
+                             { results[k] = ScanPart(lower, upper, partials[k]); });
+      }
+      for (std::thread &worker : workers)
+      {
+        worker.join();
+      }
+      for (size_t k = 0; k < parts; k++)
+      {
+        if (results[k] != 0)
+        {
+          return results[k];
+        }
+        result_.Merge(partials[k]);
+      }
+      return 0;
+    }
+
+    const Result &Get() const
+    {
+      return result_;
+    }
+
+    const std::string &Error() const
+    {
+      return error_;
+    }
+
+  private:
+    struct Bound
+    {
+      const std::string *key;
+      bool inclusive;
+    };
+
+    SessionPool &pool_;
+    Spec spec_;
+    unsigned threads_;
+    Result result_;
+    std::atomic<bool> failed_{false};
+    std::mutex errorMutex_;
+    std::string error_;
+
+    int Fail(int ret, const std::string &message)
+    {
+      std::lock_guard<std::mutex> lock(errorMutex_);
+      if (error_.empty())
+      {
+        error_ = message + ": " + wiredtiger_strerror(ret);
+      }
+      failed_ = true;
+      return ret;
+    }
+
+    void Accumulate(const char *doc, size_t size, Result &out, std::string &scratch)
+    {
+      double number = 0;
+      bool numeric = !spec_.field.empty() && ReadNumber(doc, size, spec_.field, number);
+
+      Totals *totals = &out.totals;
+      if (!spec_.groupBy.empty())
+      {
+        scratch.clear();
+        size_t start = 0, end = 0;
+        bool found = field_index::FindField(doc, size, spec_.groupBy, start, end) &&
+                     field_index::EncodeToken(doc, start, end, scratch);
+        if (!found)
+        {
+          scratch.clear();
+          field_index::EncodeNull(scratch);
+        }
+        auto it = out.groups.find(scratch);
+        if (it == out.groups.end())
+        {
+          Group group;
+          group.token = found ? std::string(doc + start, end - start) : "null";
+          it = out.groups.emplace(scratch, std::move(group)).first;
+        }
+        totals = &it->second.totals;
+        out.totals.count++;
+        if (numeric)
+        {
+          out.totals.Add(number);
+        }
+      }
+
+      totals->count++;
+      if (numeric)
+      {
+        totals->Add(number);
+      }
+    }
+
+    int ScanPart(Bound lower, Bound upper, Result &out)
+    {
+      WT_SESSION *session;
+      int ret = pool_.Acquire(&session, true);
+      if (ret != 0)
+      {
+        return Fail(ret, "no session available");
+      }
+
+      WT_CURSOR *cursor;
+      ret = session->open_cursor(session, spec_.uri.c_str(), nullptr, "raw", &cursor);
+      if (ret == 0)
+      {
+        std::string scratch;
+        uint64_t seen = 0;
+        // Bounded cursors stop at the part's end by themselves
+        bool bounded = (lower.key || upper.key) && field_index::SetBounds(cursor, lower.key, lower.inclusive, upper.key,
+                                                                          upper.inclusive) == 0;
+        for (ret = bounded ? cursor->next(cursor) : field_index::SeekLower(cursor, lower.key, lower.inclusive);
+             ret == 0; ret = cursor->next(cursor))
+        {
+          // Check on another part's failure now and then rather than per row
+          if ((++seen & 0x3FF) == 0 && failed_)
+          {
+            break;
+          }
+          WT_ITEM key, value;
+          if ((ret = cursor->get_key(cursor, &key)) != 0)
+          {
+            break;
+          }
+          if (upper.key && !bounded)
+          {
+            int cmp = field_index::CompareKey(key, *upper.key);
+            if (cmp > 0 || (cmp == 0 && !upper.inclusive))
+            {
+              break;
+            }
+          }
+          if ((ret = cursor->get_value(cursor, &value)) != 0)
+          {
+            break;
+          }
+          const char *doc = (const char *)value.data;
+          if (spec_.filter && !spec_.filter->Matches(doc, value.size, scratch))
+          {
+            continue;
+          }
+          Accumulate(doc, value.size, out, scratch);
+        }
+        if (ret == WT_NOTFOUND)
+        {
+          ret = 0;
+        }
+        cursor->close(cursor);
+      }
+      pool_.Release(session);
+      return ret != 0 ? Fail(ret, "aggregation failed") : 0;
+    }
+  };
+} // namespace aggregate
@@ -0,0 +1,371 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Opt-in timing of the binding's hot paths. Each instrumented call records
+// its total latency and the part spent inside WiredTiger, so the remainder
+// is marshalling between JS and native values, plus the bytes it moved in
+// each direction.
+//
+// Counters are per thread: the owning thread is the only writer, so
+// recording is a handful of uncontended relaxed stores, and readers sum
+// every thread's counters. When disabled a call costs one relaxed load.
+//
+// Latencies go into log-linear histograms with four buckets per power of
+// two of nanoseconds (values are within 25% of their bucket's upper bound,
+// which is what percentiles report).
+
+namespace binding_metrics
+{
+  enum Op
+  {
+    SET,
+    SEARCH,
+    NEXT,
+    PREV,
+    INSERT,
+    UPDATE,
+    REMOVE,
+    COMMIT,
+    SCAN_FILL,
+    OP_COUNT
+  };
+
+  inline const char *OpName(int op)
+  {
+    static const char *names[OP_COUNT] = {"set",    "search", "next",   "prev",    "insert",
+                                          "update", "remove", "commit", "scanFill"};
+    return names[op];
+  }
+
+  const int SUB_BITS = 2;
+  // Up to 2^40 ns (about 18 minutes); slower calls land in the last bucket
+  const int BUCKETS = 41 << SUB_BITS;
+
+  inline int BucketOf(uint64_t ns)
+  {
+    if (ns < (1u << SUB_BITS))
+    {
+      return (int)ns;
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    int msb = 63 - __builtin_clzll(ns);
+#else
+    int msb = 0;
+    for (uint64_t v = ns; v >>= 1;)
+    {
+      msb++;
+    }
+#endif
+    int sub = (int)((ns >> (msb - SUB_BITS)) & ((1u << SUB_BITS) - 1));
+    int bucket = ((msb - SUB_BITS + 1) << SUB_BITS) + sub;
+    return bucket < BUCKETS ? bucket : BUCKETS - 1;
+  }
+
+  // Largest value that falls into `bucket`
+  inline uint64_t BucketLimit(int bucket)
+  {
+    if (bucket < (1 << SUB_BITS))
+    {
+      return (uint64_t)bucket;
+    }
+    int exponent = bucket >> SUB_BITS;
+    uint64_t sub = (uint64_t)(bucket & ((1 << SUB_BITS) - 1));
+    uint64_t lower = ((1ULL << SUB_BITS) + sub) << (exponent - 1);
+    return lower + (1ULL << (exponent - 1)) - 1;
+  }
+
+  struct OpCounters
+  {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> totalNs{0};
+    std::atomic<uint64_t> engineNs{0};
+    std::atomic<uint64_t> maxNs{0};
+    std::atomic<uint64_t> bytesIn{0};
+    std::atomic<uint64_t> bytesOut{0};
+    std::atomic<uint64_t> total[BUCKETS] = {};
+    std::atomic<uint64_t> engine[BUCKETS] = {};
+  };
+
+  struct ThreadCounters
+  {
+    OpCounters ops[OP_COUNT];
+  };
+
+  // Single-writer increment: no lock prefix needed
+  inline void Bump(std::atomic<uint64_t> &counter, uint64_t amount)
+  {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+  }
+
+  struct OpSnapshot
+  {
+    uint64_t calls = 0;
+    uint64_t totalNs = 0;
+    uint64_t engineNs = 0;
+    uint64_t maxNs = 0;
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+    std::vector<uint64_t> total = std::vector<uint64_t>(BUCKETS);
+    std::vector<uint64_t> engine = std::vector<uint64_t>(BUCKETS);
+
+    void Add(const OpCounters &counters)
+    {
+      calls += counters.calls.load(std::memory_order_relaxed);
+      totalNs += counters.totalNs.load(std::memory_order_relaxed);
+      engineNs += counters.engineNs.load(std::memory_order_relaxed);
+      uint64_t max = counters.maxNs.load(std::memory_order_relaxed);
+      maxNs = max > maxNs ? max : maxNs;
+      bytesIn += counters.bytesIn.load(std::memory_order_relaxed);
+      bytesOut += counters.bytesOut.load(std::memory_order_relaxed);
+      for (int b = 0; b < BUCKETS; b++)
+      {
+        total[b] += counters.total[b].load(std::memory_order_relaxed);
+        engine[b] += counters.engine[b].load(std::memory_order_relaxed);
+      }
+    }
+
+    // Upper bound of the bucket holding the q-th quantile, in nanoseconds
+    static uint64_t Percentile(const std::vector<uint64_t> &histogram, double q)
+    {
+      uint64_t count = 0;
+      for (uint64_t n : histogram)
+      {
+        count += n;
+      }
+      if (count == 0)
+      {
+        return 0;
+      }
+      uint64_t rank = (uint64_t)(q * (double)(count - 1)) + 1;
+      uint64_t seen = 0;
+      for (int b = 0; b < BUCKETS; b++)
+      {
+        seen += histogram[b];
+        if (seen >= rank)
+        {
+          return BucketLimit(b);
+        }
+      }
+      return BucketLimit(BUCKETS - 1);
+    }
+  };
+
+  class Registry
+  {
+  public:
+    static Registry &Get()
+    {
+      // Never destroyed: threads may retire after static destructors run
+      static Registry *registry = new Registry();
+      return *registry;
+    }
+
+    std::atomic<bool> enabled{false};
+
+    void Attach(ThreadCounters *counters)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      live_.push_back(counters);
+    }
+
+    // Folds an exiting thread's counters into the retired totals
+    void Detach(ThreadCounters *counters)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (size_t i = 0; i < live_.size(); i++)
+      {
+        if (live_[i] == counters)
+        {
+          live_.erase(live_.begin() + (long)i);
+          break;
+        }
+      }
+      for (int op = 0; op < OP_COUNT; op++)
+      {
+        retired_[op].Add(counters->ops[op]);
+      }
+    }
+
+    void Snapshot(std::vector<OpSnapshot> &out)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      out = retired_;
+      for (ThreadCounters *counters : live_)
+      {
+        for (int op = 0; op < OP_COUNT; op++)
+        {
+          out[op].Add(counters->ops[op]);
+        }
+      }
+    }
+
+    // Zeroes every counter. Calls racing with the reset may be half counted.
+    void Reset()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      retired_.assign(OP_COUNT, OpSnapshot());
+      for (ThreadCounters *counters : live_)
+      {
+        for (OpCounters &op : counters->ops)
+        {
+          op.calls = 0;
+          op.totalNs = 0;
+          op.engineNs = 0;
+          op.maxNs = 0;
+          op.bytesIn = 0;
+          op.bytesOut = 0;
+          for (int b = 0; b < BUCKETS; b++)
+          {
+            op.total[b] = 0;
+            op.engine[b] = 0;
+          }
+        }
+      }
+    }
+
+  private:
+    std::mutex mutex_;
+    std::vector<ThreadCounters *> live_;
+    std::vector<OpSnapshot> retired_ = std::vector<OpSnapshot>(OP_COUNT);
+  };
+
+  inline bool Enabled()
+  {
+    return Registry::Get().enabled.load(std::memory_order_relaxed);
+  }
+
+  inline void SetEnabled(bool enabled)
+  {
+    Registry::Get().enabled.store(enabled, std::memory_order_relaxed);
+  }
+
+  // The calling thread's counters, registered on first use
+  inline ThreadCounters &Local()
+  {
+    struct Holder
+    {
+      ThreadCounters counters;
+      Holder()
+      {
+        Registry::Get().Attach(&counters);
+      }
+      ~Holder()
+      {
+        Registry::Get().Detach(&counters);
+      }
+    };
+    thread_local Holder holder;
+    return holder.counters;
+  }
+
+  inline uint64_t Now()
+  {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  // Times one binding call from construction to destruction. Bytes() and
+  // Engine attribute to the innermost Call on the thread.
+  class Call
+  {
+  public:
+    explicit Call(Op op) : op_(op), active_(Enabled())
+    {
+      if (active_)
+      {
+        previous_ = Current();
+        Current() = this;
+        start_ = Now();
+      }
+    }
+
+    ~Call()
+    {
+      if (!active_)
+      {
+        return;
+      }
+      uint64_t elapsed = Now() - start_;
+      OpCounters &counters = Local().ops[op_];
+      Bump(counters.calls, 1);
+      Bump(counters.totalNs, elapsed);
+      Bump(counters.engineNs, engineNs_);
+      Bump(counters.bytesIn, bytesIn_);
+      Bump(counters.bytesOut, bytesOut_);
+      Bump(counters.total[BucketOf(elapsed)], 1);
+      Bump(counters.engine[BucketOf(engineNs_)], 1);
+      if (elapsed > counters.maxNs.load(std::memory_order_relaxed))
+      {
+        counters.maxNs.store(elapsed, std::memory_order_relaxed);
+      }
+      Current() = previous_;
+    }
+
+    Call(const Call &) = delete;
+    Call &operator=(const Call &) = delete;
+
+    static void BytesIn(size_t bytes)
+    {
+      if (Call *call = Current())
+      {
+        call->bytesIn_ += bytes;
+      }
+    }
+
+    static void BytesOut(size_t bytes)
+    {
+      if (Call *call = Current())
+      {
+        call->bytesOut_ += bytes;
+      }
+    }
+
+  private:
+    friend class Engine;
+
+    Op op_;
+    bool active_;
+    Call *previous_ = nullptr;
+    uint64_t start_ = 0;
+    uint64_t engineNs_ = 0;
+    uint64_t bytesIn_ = 0;
+    uint64_t bytesOut_ = 0;
+
+    static Call *&Current()
+    {
+      thread_local Call *current = nullptr;
+      return current;
+    }
+  };
+
+  // Marks a scope spent inside WiredTiger
+  class Engine
+  {
+  public:
+    Engine() : call_(Call::Current()), start_(call_ ? Now() : 0)
+    {
+    }
+
+    ~Engine()
+    {
+      if (call_)
+      {
+        call_->engineNs_ += Now() - start_;
+      }
+    }
+
+    Engine(const Engine &) = delete;
+    Engine &operator=(const Engine &) = delete;
+
+  private:
+    Call *call_;
+    uint64_t start_;
+  };
+} // namespace binding_metrics
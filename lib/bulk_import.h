@@ -0,0 +1,1138 @@
+#pragma once
+
+#include <wiredtiger.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "field_index.h"
+#include "key_codec.h"
+#include "read_cache.h"
+#include "session_pool.h"
+
+// Loads a file of records into a table. The calling thread reads the file
+// in large sequential blocks cut at record boundaries, and parser threads
+// turn the blocks into key/value records. Each parser collects its records
+// in a run that is sorted (unless it already is) and spilled to a temporary
+// file once it fills its share of the memory budget. A k-way merge of the
+// runs then yields every record in key order, the last occurrence of a
+// duplicated key winning.
+//
+// Merged records go into the table through a bulk cursor when the table is
+// empty and nothing else has it open, or else in batched transactions on
+// several pooled sessions (the only way for tables with field indexes).
+//
+// Input is NDJSON, one document per line keyed by one of its fields, or the
+// packed [uint32 LE length][key][uint32 LE length][value] records taken by
+// putMany().
+
+namespace bulk_import
+{
+  enum Format
+  {
+    NDJSON,
+    PACKED
+  };
+
+  // How NDJSON keys are made from the key field: STRING takes a string's
+  // text ({ "$oid": hex } its hex, other values their JSON text); COMPOUND
+  // encodes the value as a one-element key_codec key
+  enum KeyEncoding
+  {
+    KEY_STRING,
+    KEY_COMPOUND
+  };
+
+  enum Phase
+  {
+    READ,
+    MERGE,
+    LOAD,
+    DONE
+  };
+
+  inline const char *PhaseName(Phase phase)
+  {
+    static const char *names[] = {"read", "merge", "load", "done"};
+    return names[phase];
+  }
+
+  struct Spec
+  {
+    std::string uri; // "table:users"
+    std::string path;
+    Format format = NDJSON;
+    std::vector<std::string> keyPath{"_id"};
+    KeyEncoding keyEncoding = KEY_STRING;
+    unsigned threads = 4;
+    size_t blockBytes = 4 << 20;
+    // Records held in memory by all parsers together before runs spill
+    size_t memoryBytes = 256 << 20;
+    // Where runs spill; the system's temporary directory if empty
+    std::string tempDir;
+    // Try a bulk cursor first
+    bool bulk = true;
+    size_t batchRecords = 1000;
+  };
+
+  struct Progress
+  {
+    Phase phase = READ;
+    uint64_t bytesRead = 0;
+    uint64_t totalBytes = 0;
+    // Records parsed, and lines skipped for lack of a usable key
+    uint64_t records = 0;
+    uint64_t skipped = 0;
+    uint64_t duplicates = 0;
+    uint64_t loaded = 0;
+    // Runs spilled to disk
+    uint64_t runs = 0;
+    bool bulk = false;
+  };
+
+  inline uint32_t ReadU32(const unsigned char *p)
+  {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+  }
+
+  inline void AppendU32(std::string &out, uint32_t v)
+  {
+    for (int i = 0; i < 4; i++)
+    {
+      out.push_back((char)(v >> (8 * i)));
+    }
+  }
+
+  // Key order, then input order
+  inline bool Less(const char *a, size_t aSize, uint64_t aSeq, const char *b, size_t bSize, uint64_t bSeq)
+  {
+    int cmp = std::memcmp(a, b, std::min(aSize, bSize));
+    if (cmp != 0)
+    {
+      return cmp < 0;
+    }
+    return aSize != bSize ? aSize < bSize : aSeq < bSeq;
+  }
+
+  // Records in one buffer, sorted through their references
+  struct Records
+  {
+    struct Ref
+    {
+      size_t offset;
+      uint32_t keySize;
+      uint32_t valueSize;
+      uint64_t seq;
+    };
+
+    std::string arena;
+    std::vector<Ref> refs;
+
+    size_t Bytes() const
+    {
+      return arena.size() + refs.size() * sizeof(Ref);
+    }
+
+    void Add(const char *key, size_t keySize, const char *value, size_t valueSize, uint64_t seq)
+    {
+      refs.push_back({arena.size(), (uint32_t)keySize, (uint32_t)valueSize, seq});
+      arena.append(key, keySize);
+      arena.append(value, valueSize);
+    }
+
+    const char *Key(const Ref &ref) const
+    {
+      return arena.data() + ref.offset;
+    }
+
+    const char *Value(const Ref &ref) const
+    {
+      return arena.data() + ref.offset + ref.keySize;
+    }
+
+    void Sort()
+    {
+      auto less = [this](const Ref &a, const Ref &b)
+      { return Less(Key(a), a.keySize, a.seq, Key(b), b.keySize, b.seq); };
+      if (!std::is_sorted(refs.begin(), refs.end(), less))
+      {
+        std::sort(refs.begin(), refs.end(), less);
+      }
+    }
+
+    void Clear()
+    {
+      arena.clear();
+      refs.clear();
+    }
+  };
+
+  // A sorted run being merged
+  class Source
+  {
+  public:
+    virtual ~Source() = default;
+    // 0, WT_NOTFOUND at the end, or an error
+    virtual int Next() = 0;
+
+    const char *key = nullptr;
+    size_t keySize = 0;
+    const char *value = nullptr;
+    size_t valueSize = 0;
+    uint64_t seq = 0;
+  };
+
+  class MemorySource : public Source
+  {
+  public:
+    explicit MemorySource(const Records &run) : run_(run)
+    {
+    }
+
+    int Next() override
+    {
+      if (next_ == run_.refs.size())
+      {
+        return WT_NOTFOUND;
+      }
+      const Records::Ref &ref = run_.refs[next_++];
+      key = run_.Key(ref);
+      keySize = ref.keySize;
+      value = run_.Value(ref);
+      valueSize = ref.valueSize;
+      seq = ref.seq;
+      return 0;
+    }
+
+  private:
+    const Records &run_;
+    size_t next_ = 0;
+  };
+
+  // Reads a spilled run: [uint32 key size][uint32 value size][uint64 seq]
+  // headers, little-endian, each followed by the key and value
+  class FileSource : public Source
+  {
+  public:
+    explicit FileSource(std::FILE *file) : file_(file)
+    {
+    }
+
+    ~FileSource() override
+    {
+      std::fclose(file_);
+    }
+
+    int Next() override
+    {
+      unsigned char header[16];
+      size_t got = std::fread(header, 1, sizeof(header), file_);
+      if (got == 0 && std::feof(file_))
+      {
+        return WT_NOTFOUND;
+      }
+      if (got != sizeof(header))
+      {
+        return EIO;
+      }
+      keyBuffer_.resize(ReadU32(header));
+      valueBuffer_.resize(ReadU32(header + 4));
+      seq = (uint64_t)ReadU32(header + 8) | (uint64_t)ReadU32(header + 12) << 32;
+      if (std::fread(&keyBuffer_[0], 1, keyBuffer_.size(), file_) != keyBuffer_.size() ||
+          std::fread(&valueBuffer_[0], 1, valueBuffer_.size(), file_) != valueBuffer_.size())
+      {
+        return EIO;
+      }
+      key = keyBuffer_.data();
+      keySize = keyBuffer_.size();
+      value = valueBuffer_.data();
+      valueSize = valueBuffer_.size();
+      return 0;
+    }
+
+  private:
+    std::FILE *file_;
+    std::string keyBuffer_;
+    std::string valueBuffer_;
+  };
+
+  class Importer
+  {
+  public:
+    // `indexes` are the table's field indexes (or null), `cache` the
+    // connection's read cache (or null), and `onProgress` is called from
+    // the import's threads every so often and once per phase
+    Importer(std::shared_ptr<SessionPool> pool, Spec spec, std::shared_ptr<const field_index::DefinitionList> indexes,
+             std::shared_ptr<ReadCache> cache, std::function<void(const Progress &)> onProgress)
+        : pool_(std::move(pool)), spec_(std::move(spec)), indexes_(std::move(indexes)), cache_(std::move(cache)),
+          onProgress_(std::move(onProgress)), threads_(std::max(1u, std::min<unsigned>(spec_.threads, (unsigned)pool_->Max())))
+    {
+      if (indexes_ && indexes_->empty())
+      {
+        indexes_.reset();
+      }
+      spec_.blockBytes = std::max<size_t>(spec_.blockBytes, 4096);
+      spec_.batchRecords = std::max<size_t>(spec_.batchRecords, 1);
+      runBytes_ = std::max<size_t>(spec_.memoryBytes / threads_, 4096);
+    }
+
+    ~Importer()
+    {
+      RemoveSpills();
+    }
+
+    Importer(const Importer &) = delete;
+    Importer &operator=(const Importer &) = delete;
+
+    // Runs the whole import on the calling thread and threads of its own
+    int Run()
+    {
+      int ret = CheckTable();
+      if (ret == 0)
+      {
+        ret = ReadAndParse();
+      }
+      if (ret == 0)
+      {
+        ret = MergeAndLoad();
+      }
+      RemoveSpills();
+      if (ret != 0)
+      {
+        return ret;
+      }
+      phase_ = DONE;
+      Report(true);
+      return 0;
+    }
+
+    Progress GetProgress() const
+    {
+      Progress progress;
+      progress.phase = phase_.load();
+      progress.bytesRead = bytesRead_.load();
+      progress.totalBytes = totalBytes_;
+      progress.records = records_.load();
+      progress.skipped = skipped_.load();
+      progress.duplicates = duplicates_.load();
+      progress.loaded = loaded_.load();
+      progress.runs = runs_.load();
+      progress.bulk = bulk_;
+      return progress;
+    }
+
+    const std::string &Error() const
+    {
+      return error_;
+    }
+
+  private:
+    static const int MAX_RETRIES = 10;
+    static const size_t WRITE_BUFFER = 1 << 20;
+
+    std::shared_ptr<SessionPool> pool_;
+    Spec spec_;
+    std::shared_ptr<const field_index::DefinitionList> indexes_;
+    std::shared_ptr<ReadCache> cache_;
+    std::function<void(const Progress &)> onProgress_;
+    unsigned threads_;
+    size_t runBytes_;
+
+    // S columns are packed with a terminating NUL
+    bool keyNul_ = false;
+    bool valueNul_ = false;
+    bool bulk_ = false;
+    uint64_t totalBytes_ = 0;
+    std::atomic<uint64_t> duplicates_{0};
+    std::atomic<Phase> phase_{READ};
+    std::atomic<uint64_t> bytesRead_{0};
+    std::atomic<uint64_t> records_{0};
+    std::atomic<uint64_t> skipped_{0};
+    std::atomic<uint64_t> loaded_{0};
+    std::atomic<uint64_t> runs_{0};
+
+    std::atomic<bool> failed_{false};
+    std::mutex errorMutex_;
+    std::string error_;
+
+    std::mutex reportMutex_;
+    std::chrono::steady_clock::time_point lastReport_;
+
+    // Blocks waiting for a parser, and batches waiting for a loader
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::condition_variable space_;
+    struct Block
+    {
+      uint64_t index;
+      std::string data;
+    };
+    std::deque<Block> blocks_;
+    std::deque<std::unique_ptr<Records>> batches_;
+    bool producerDone_ = false;
+
+    // Sorted runs, by the parsers
+    std::vector<Records> memoryRuns_;
+    std::vector<std::string> spills_;
+
+    // Pending record of the merge, held back until the next key differs
+    std::string pendingKey_;
+    std::string pendingValue_;
+    bool hasPending_ = false;
+
+    int Fail(int ret, const std::string &message)
+    {
+      std::lock_guard<std::mutex> lock(errorMutex_);
+      if (error_.empty())
+      {
+        error_ = message + ": " + wiredtiger_strerror(ret);
+      }
+      failed_ = true;
+      ready_.notify_all();
+      space_.notify_all();
+      return ret;
+    }
+
+    void RemoveSpills()
+    {
+      for (const std::string &path : spills_)
+      {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+      }
+      spills_.clear();
+    }
+
+    void Report(bool force)
+    {
+      if (!onProgress_)
+      {
+        return;
+      }
+      auto now = std::chrono::steady_clock::now();
+      std::lock_guard<std::mutex> lock(reportMutex_);
+      if (!force && now - lastReport_ < std::chrono::milliseconds(250))
+      {
+        return;
+      }
+      lastReport_ = now;
+      onProgress_(GetProgress());
+    }
+
+    // Reads the table's formats from the metadata, which unlike a cursor
+    // leaves no handle open that would keep a bulk cursor out
+    int CheckTable()
+    {
+      WT_SESSION *session;
+      int ret = pool_->Acquire(&session, true);
+      if (ret != 0)
+      {
+        return Fail(ret, "no session available");
+      }
+      WT_CURSOR *metadata;
+      std::string config;
+      ret = session->open_cursor(session, "metadata:", nullptr, nullptr, &metadata);
+      if (ret == 0)
+      {
+        metadata->set_key(metadata, spec_.uri.c_str());
+        ret = metadata->search(metadata);
+        const char *value;
+        if (ret == 0 && (ret = metadata->get_value(metadata, &value)) == 0)
+        {
+          config = value;
+        }
+        metadata->close(metadata);
+      }
+      pool_->Release(session);
+      if (ret != 0)
+      {
+        return Fail(ret, "cannot find " + spec_.uri);
+      }
+
+      std::string keyFormat = ConfigValue(config, "key_format");
+      std::string valueFormat = ConfigValue(config, "value_format");
+      if ((keyFormat != "u" && keyFormat != "S") || (valueFormat != "u" && valueFormat != "S"))
+      {
+        return Fail(EINVAL, "imports need a table with u or S keys and values");
+      }
+      keyNul_ = keyFormat == "S";
+      valueNul_ = valueFormat == "S";
+
+      std::error_code error;
+      totalBytes_ = std::filesystem::file_size(spec_.path, error);
+      if (error)
+      {
+        return Fail(error.value(), "cannot read " + spec_.path);
+      }
+      return 0;
+    }
+
+    // Top-level value of `name` in a metadata config, through WiredTiger's
+    // parser so nested values such as app_metadata can't be mistaken for it
+    static std::string ConfigValue(const std::string &config, const char *name)
+    {
+      WT_CONFIG_PARSER *parser;
+      if (config.empty() || wiredtiger_config_parser_open(nullptr, config.c_str(), config.size(), &parser) != 0)
+      {
+        return "";
+      }
+      WT_CONFIG_ITEM value;
+      std::string text;
+      if (parser->get(parser, name, &value) == 0)
+      {
+        text.assign(value.str, value.len);
+      }
+      parser->close(parser);
+      return text;
+    }
+
+    // ---- Reading and parsing ----
+
+    int ReadAndParse()
+    {
+      std::vector<std::thread> parsers;
+      for (unsigned i = 0; i < threads_; i++)
+      {
+        parsers.emplace_back([this]
+                             { ParseBlocks(); });
+      }
+      int ret = ReadBlocks();
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        producerDone_ = true;
+      }
+      ready_.notify_all();
+      for (std::thread &parser : parsers)
+      {
+        parser.join();
+      }
+      if (ret == 0 && failed_)
+      {
+        ret = EIO;
+      }
+      return ret;
+    }
+
+    int ReadBlocks()
+    {
+      std::FILE *file = std::fopen(spec_.path.c_str(), "rb");
+      if (!file)
+      {
+        return Fail(errno, "cannot open " + spec_.path);
+      }
+      // Records cut off at the end of a block start the next one
+      std::string carry;
+      uint64_t index = 0;
+      int ret = 0;
+      while (ret == 0 && !failed_)
+      {
+        std::string data = std::move(carry);
+        carry.clear();
+        size_t have = data.size();
+        data.resize(have + spec_.blockBytes);
+        size_t got = std::fread(&data[have], 1, spec_.blockBytes, file);
+        data.resize(have + got);
+        if (std::ferror(file))
+        {
+          ret = Fail(EIO, "cannot read " + spec_.path);
+          break;
+        }
+        bool eof = got < spec_.blockBytes;
+        bytesRead_ += got;
+
+        size_t cut = Boundary(data, eof);
+        if (cut == std::string::npos)
+        {
+          ret = Fail(EINVAL, spec_.path + " ends in a truncated record");
+          break;
+        }
+        carry.assign(data, cut, std::string::npos);
+        data.resize(cut);
+        if (!data.empty() && !Push({index++, std::move(data)}))
+        {
+          break;
+        }
+        Report(false);
+        if (eof)
+        {
+          break;
+        }
+      }
+      std::fclose(file);
+      return ret;
+    }
+
+    // End of the last whole record in `data` (0 if none, npos for a partial
+    // record at the end of the file)
+    size_t Boundary(const std::string &data, bool eof) const
+    {
+      if (spec_.format == NDJSON)
+      {
+        if (eof)
+        {
+          return data.size();
+        }
+        size_t newline = data.rfind('\n');
+        return newline == std::string::npos ? 0 : newline + 1;
+      }
+
+      const unsigned char *p = (const unsigned char *)data.data();
+      size_t n = data.size();
+      size_t pos = 0;
+      while (n - pos >= 4)
+      {
+        size_t keyEnd = pos + 4 + ReadU32(p + pos);
+        if (keyEnd > n || n - keyEnd < 4 || n - keyEnd - 4 < ReadU32(p + keyEnd))
+        {
+          break;
+        }
+        pos = keyEnd + 4 + ReadU32(p + keyEnd);
+      }
+      return eof && pos != n ? std::string::npos : pos;
+    }
+
+    bool Push(Block block)
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      space_.wait(lock, [this]
+                  { return failed_ || blocks_.size() < 2 * threads_; });
+      if (failed_)
+      {
+        return false;
+      }
+      blocks_.push_back(std::move(block));
+      ready_.notify_one();
+      return true;
+    }
+
+    void ParseBlocks()
+    {
+      Records run;
+      std::string key;
+      for (;;)
+      {
+        Block block;
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          ready_.wait(lock, [this]
+                      { return failed_ || producerDone_ || !blocks_.empty(); });
+          if (failed_)
+          {
+            return;
+          }
+          if (blocks_.empty())
+          {
+            break;
+          }
+          block = std::move(blocks_.front());
+          blocks_.pop_front();
+        }
+        space_.notify_one();
+
+        if (spec_.format == NDJSON)
+        {
+          ParseLines(block, run, key);
+        }
+        else
+        {
+          ParsePacked(block, run);
+        }
+        if (run.Bytes() >= runBytes_ && Spill(run) != 0)
+        {
+          return;
+        }
+      }
+
+      // What is left is merged from memory
+      run.Sort();
+      std::lock_guard<std::mutex> lock(mutex_);
+      memoryRuns_.push_back(std::move(run));
+    }
+
+    // Input order: the block, then the record within it
+    static uint64_t Seq(uint64_t block, uint64_t record)
+    {
+      return block << 32 | record;
+    }
+
+    void ParseLines(const Block &block, Records &run, std::string &key)
+    {
+      const char *p = block.data.data();
+      size_t n = block.data.size();
+      uint64_t record = 0, parsed = 0, skipped = 0;
+      size_t i = 0;
+      while (i < n)
+      {
+        const char *newline = (const char *)std::memchr(p + i, '\n', n - i);
+        size_t end = newline ? newline - p : n;
+        size_t lineEnd = end > i && p[end - 1] == '\r' ? end - 1 : end;
+        if (field_index::json::SkipSpace(p, i, lineEnd) < lineEnd)
+        {
+          if (ExtractKey(p + i, lineEnd - i, key))
+          {
+            run.Add(key.data(), key.size(), p + i, lineEnd - i, Seq(block.index, record++));
+            parsed++;
+          }
+          else
+          {
+            skipped++;
+          }
+        }
+        i = end + 1;
+      }
+      records_ += parsed;
+      skipped_ += skipped;
+    }
+
+    void ParsePacked(const Block &block, Records &run)
+    {
+      // Whole records only, see Boundary()
+      const unsigned char *p = (const unsigned char *)block.data.data();
+      size_t n = block.data.size();
+      uint64_t record = 0;
+      size_t pos = 0;
+      while (pos < n)
+      {
+        uint32_t keySize = ReadU32(p + pos);
+        const char *key = (const char *)p + pos + 4;
+        uint32_t valueSize = ReadU32(p + pos + 4 + keySize);
+        const char *value = key + keySize + 4;
+        run.Add(key, keySize, value, valueSize, Seq(block.index, record++));
+        pos += 8 + (size_t)keySize + valueSize;
+      }
+      records_ += record;
+    }
+
+    bool ExtractKey(const char *doc, size_t size, std::string &key) const
+    {
+      static const std::vector<std::string> oidPath{"$oid"};
+      size_t start, end;
+      if (!field_index::FindField(doc, size, spec_.keyPath, start, end))
+      {
+        return false;
+      }
+      key.clear();
+
+      std::string hex;
+      size_t oidStart, oidEnd;
+      bool objectId = doc[start] == '{' &&
+                      field_index::FindField(doc + start, end - start, oidPath, oidStart, oidEnd) &&
+                      doc[start + oidStart] == '"' &&
+                      field_index::json::Unescape(doc + start, oidStart, oidEnd, hex);
+      if (doc[start] == '{' || doc[start] == '[')
+      {
+        if (!objectId)
+        {
+          return false;
+        }
+        if (spec_.keyEncoding == KEY_STRING)
+        {
+          key = hex;
+          return true;
+        }
+        uint8_t id[key_codec::OBJECT_ID_SIZE];
+        if (!key_codec::ParseObjectId(hex, id))
+        {
+          return false;
+        }
+        key_codec::EncodeObjectId(key, id);
+        return true;
+      }
+
+      if (spec_.keyEncoding == KEY_COMPOUND)
+      {
+        // Scalars encode the same as field index keys
+        return field_index::EncodeToken(doc, start, end, key);
+      }
+      if (doc[start] == '"')
+      {
+        return field_index::json::Unescape(doc, start, end, key);
+      }
+      key.assign(doc + start, end - start);
+      return true;
+    }
+
+    int Spill(Records &run)
+    {
+      run.Sort();
+      std::filesystem::path dir = spec_.tempDir;
+      std::error_code error;
+      if (dir.empty())
+      {
+        dir = std::filesystem::temp_directory_path(error);
+        if (error)
+        {
+          return Fail(error.value(), "no temporary directory");
+        }
+      }
+      std::string path;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        path = (dir / ("wt-import-" + std::to_string((uintptr_t)this) + "-" + std::to_string(spills_.size()) + ".run")).string();
+        spills_.push_back(path);
+      }
+
+      std::FILE *file = std::fopen(path.c_str(), "wb");
+      if (!file)
+      {
+        return Fail(errno, "cannot create " + path);
+      }
+      std::setvbuf(file, nullptr, _IOFBF, WRITE_BUFFER);
+      std::string header;
+      bool ok = true;
+      for (const Records::Ref &ref : run.refs)
+      {
+        header.clear();
+        AppendU32(header, ref.keySize);
+        AppendU32(header, ref.valueSize);
+        AppendU32(header, (uint32_t)ref.seq);
+        AppendU32(header, (uint32_t)(ref.seq >> 32));
+        ok = std::fwrite(header.data(), 1, header.size(), file) == header.size() &&
+             std::fwrite(run.Key(ref), 1, (size_t)ref.keySize + ref.valueSize, file) == (size_t)ref.keySize + ref.valueSize;
+        if (!ok)
+        {
+          break;
+        }
+      }
+      if (std::fclose(file) != 0 || !ok)
+      {
+        return Fail(EIO, "cannot write " + path);
+      }
+      run.Clear();
+      runs_++;
+      Report(false);
+      return 0;
+    }
+
+    // ---- Merging and loading ----
+
+    struct Greater
+    {
+      bool operator()(const Source *a, const Source *b) const
+      {
+        return Less(b->key, b->keySize, b->seq, a->key, a->keySize, a->seq);
+      }
+    };
+
+    int MergeAndLoad()
+    {
+      phase_ = MERGE;
+      Report(true);
+
+      std::vector<std::unique_ptr<Source>> sources;
+      for (const std::string &path : spills_)
+      {
+        std::FILE *file = std::fopen(path.c_str(), "rb");
+        if (!file)
+        {
+          return Fail(errno, "cannot open " + path);
+        }
+        std::setvbuf(file, nullptr, _IOFBF, WRITE_BUFFER);
+        sources.push_back(std::make_unique<FileSource>(file));
+      }
+      for (const Records &run : memoryRuns_)
+      {
+        sources.push_back(std::make_unique<MemorySource>(run));
+      }
+      std::priority_queue<Source *, std::vector<Source *>, Greater> heap;
+      for (auto &source : sources)
+      {
+        int ret = source->Next();
+        if (ret == 0)
+        {
+          heap.push(source.get());
+        }
+        else if (ret != WT_NOTFOUND)
+        {
+          return Fail(ret, "cannot read a spilled run");
+        }
+      }
+
+      WT_SESSION *session;
+      int ret = pool_->Acquire(&session, true);
+      if (ret != 0)
+      {
+        return Fail(ret, "no session available");
+      }
+      WT_CURSOR *bulk = nullptr;
+      if (spec_.bulk && !indexes_)
+      {
+        // Refused for a table that isn't empty (EINVAL) or that is open
+        // elsewhere (EBUSY)
+        ret = session->open_cursor(session, spec_.uri.c_str(), nullptr, "bulk,raw", &bulk);
+        if (ret == EINVAL || ret == EBUSY)
+        {
+          bulk = nullptr;
+          ret = 0;
+        }
+        else if (ret != 0)
+        {
+          pool_->Release(session);
+          return Fail(ret, "cannot open a bulk cursor");
+        }
+      }
+      bulk_ = bulk != nullptr;
+      phase_ = LOAD;
+      Report(true);
+
+      if (bulk)
+      {
+        ret = Merge(heap, [this, bulk](const std::string &key, const std::string &value)
+                    { return Insert(bulk, bulk->insert, key, value); });
+        int closeRet = bulk->close(bulk);
+        pool_->Release(session);
+        if (ret == 0 && closeRet != 0)
+        {
+          ret = Fail(closeRet, "bulk load failed");
+        }
+        if (ret == 0 && cache_)
+        {
+          cache_->InvalidateTable(spec_.uri);
+        }
+        return ret;
+      }
+      pool_->Release(session);
+      return LoadParallel(heap);
+    }
+
+    // Feeds the merged records, duplicates resolved, to `sink`
+    template <typename Sink>
+    int Merge(std::priority_queue<Source *, std::vector<Source *>, Greater> &heap, Sink sink)
+    {
+      uint64_t merged = 0;
+      while (!heap.empty() && !failed_)
+      {
+        Source *source = heap.top();
+        heap.pop();
+        if (hasPending_ && pendingKey_.size() == source->keySize &&
+            std::memcmp(pendingKey_.data(), source->key, source->keySize) == 0)
+        {
+          // Later in the input, so it replaces the pending one
+          duplicates_++;
+        }
+        else
+        {
+          if (hasPending_)
+          {
+            int ret = sink(pendingKey_, pendingValue_);
+            if (ret != 0)
+            {
+              return ret;
+            }
+          }
+          pendingKey_.assign(source->key, source->keySize);
+          hasPending_ = true;
+        }
+        pendingValue_.assign(source->value, source->valueSize);
+
+        int ret = source->Next();
+        if (ret == 0)
+        {
+          heap.push(source);
+        }
+        else if (ret != WT_NOTFOUND)
+        {
+          return Fail(ret, "cannot read a spilled run");
+        }
+        if (++merged % 65536 == 0)
+        {
+          Report(false);
+        }
+      }
+      if (failed_)
+      {
+        return EIO;
+      }
+      return hasPending_ ? sink(pendingKey_, pendingValue_) : 0;
+    }
+
+    // Writes one record, packing S columns
+    int Insert(WT_CURSOR *cursor, int (*op)(WT_CURSOR *), const std::string &key, const std::string &value)
+    {
+      WT_ITEM keyItem, valueItem;
+      // The strings outlive the call, so they can take the terminating NUL
+      keyItem.data = key.c_str();
+      keyItem.size = key.size() + (keyNul_ ? 1 : 0);
+      valueItem.data = value.c_str();
+      valueItem.size = value.size() + (valueNul_ ? 1 : 0);
+      cursor->set_key(cursor, &keyItem);
+      cursor->set_value(cursor, &valueItem);
+      int ret = op(cursor);
+      if (ret != 0)
+      {
+        return Fail(ret, "bulk load failed");
+      }
+      loaded_++;
+      return 0;
+    }
+
+    int LoadParallel(std::priority_queue<Source *, std::vector<Source *>, Greater> &heap)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        producerDone_ = false;
+      }
+      std::vector<std::thread> loaders;
+      for (unsigned i = 0; i < threads_; i++)
+      {
+        loaders.emplace_back([this]
+                             { LoadBatches(); });
+      }
+
+      auto batch = std::make_unique<Records>();
+      int ret = Merge(heap, [this, &batch](const std::string &key, const std::string &value)
+                      {
+                        batch->Add(key.c_str(), key.size() + (keyNul_ ? 1 : 0), value.c_str(),
+                                   value.size() + (valueNul_ ? 1 : 0), 0);
+                        if (batch->refs.size() < spec_.batchRecords)
+                        {
+                          return 0;
+                        }
+                        return PushBatch(batch) ? 0 : EIO; });
+      if (ret == 0 && !batch->refs.empty())
+      {
+        PushBatch(batch);
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        producerDone_ = true;
+      }
+      ready_.notify_all();
+      for (std::thread &loader : loaders)
+      {
+        loader.join();
+      }
+      return failed_ ? (ret != 0 ? ret : EIO) : ret;
+    }
+
+    bool PushBatch(std::unique_ptr<Records> &batch)
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      space_.wait(lock, [this]
+                  { return failed_ || batches_.size() < 2 * threads_; });
+      if (failed_)
+      {
+        return false;
+      }
+      batches_.push_back(std::move(batch));
+      batch = std::make_unique<Records>();
+      ready_.notify_one();
+      return true;
+    }
+
+    void LoadBatches()
+    {
+      WT_SESSION *session;
+      int ret = pool_->Acquire(&session, true);
+      if (ret != 0)
+      {
+        Fail(ret, "no session available");
+        return;
+      }
+      WT_CURSOR *cursor;
+      ret = session->open_cursor(session, spec_.uri.c_str(), nullptr, "raw,overwrite=true", &cursor);
+      if (ret != 0)
+      {
+        pool_->Release(session);
+        Fail(ret, "cannot open " + spec_.uri);
+        return;
+      }
+
+      std::string cacheKey;
+      for (;;)
+      {
+        std::unique_ptr<Records> batch;
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          ready_.wait(lock, [this]
+                      { return failed_ || producerDone_ || !batches_.empty(); });
+          if (failed_ || batches_.empty())
+          {
+            break;
+          }
+          batch = std::move(batches_.front());
+          batches_.pop_front();
+        }
+        space_.notify_one();
+
+        ret = WriteBatch(session, cursor, *batch);
+        if (ret != 0)
+        {
+          Fail(ret, "load failed");
+          break;
+        }
+        if (cache_)
+        {
+          for (const Records::Ref &ref : batch->refs)
+          {
+            ReadCache::Key(spec_.uri.c_str(), batch->Key(ref), ref.keySize - (keyNul_ ? 1 : 0), cacheKey);
+            cache_->Invalidate(cacheKey);
+          }
+        }
+        loaded_ += batch->refs.size();
+        Report(false);
+      }
+      cursor->close(cursor);
+      pool_->Release(session);
+    }
+
+    // One transaction per batch, retried on write conflicts
+    int WriteBatch(WT_SESSION *session, WT_CURSOR *cursor, const Records &batch)
+    {
+      for (int retries = 0;; retries++)
+      {
+        int ret = session->begin_transaction(session, nullptr);
+        if (ret != 0)
+        {
+          return ret;
+        }
+        for (const Records::Ref &ref : batch.refs)
+        {
+          WT_ITEM key, value;
+          key.data = batch.Key(ref);
+          key.size = ref.keySize;
+          value.data = batch.Value(ref);
+          value.size = ref.valueSize;
+          if (indexes_)
+          {
+            ret = field_index::Write(session, cursor, *indexes_, false, cursor->insert, key, &value);
+          }
+          else
+          {
+            cursor->set_key(cursor, &key);
+            cursor->set_value(cursor, &value);
+            ret = cursor->insert(cursor);
+          }
+          if (ret != 0)
+          {
+            break;
+          }
+        }
+        cursor->reset(cursor);
+        if (ret == 0)
+        {
+          return session->commit_transaction(session, nullptr);
+        }
+        session->rollback_transaction(session, nullptr);
+        if (ret != WT_ROLLBACK || retries == MAX_RETRIES)
+        {
+          return ret;
+        }
+      }
+    }
+  };
+} // namespace bulk_import
@@ -0,0 +1,553 @@
+#pragma once
+
+#include <wiredtiger.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Suggests block compression and page layout for a table from its own data.
+// A sample of rows taken with a next_random cursor is bulk loaded into a
+// scratch table for every compressor and leaf page size tried, so the
+// numbers come from WiredTiger itself: on-disk size after a checkpoint,
+// load time (page building and compression) and the time to scan the
+// checkpoint back in (reads and decompression). Compressors WiredTiger
+// reports as unknown (their extension isn't loaded) are listed as
+// unavailable.
+//
+// Prefix compression is judged from the sample keys instead: it pays when
+// neighbouring keys share a good part of their bytes. memory_page_max isn't
+// measured; it is kept at WiredTiger's default unless that would hold fewer
+// than ten leaf pages.
+//
+// The recommended config can then be used to rebuild the table into a new
+// one: the copy reads the source in a single snapshot, so it stays readable
+// and writable throughout and the new table matches it as of the start. The
+// source's columns, collator and app_metadata carry over to it.
+
+namespace compression_advisor
+{
+  enum Goal
+  {
+    SIZE,
+    BALANCED,
+    SPEED
+  };
+
+  struct Spec
+  {
+    std::string uri; // "table:users"
+    size_t sampleRows = 10000;
+    std::vector<std::string> compressors{"none", "snappy", "lz4", "zstd", "zlib"};
+    std::vector<size_t> leafPageSizes{16 << 10, 32 << 10, 64 << 10, 128 << 10};
+    Goal goal = BALANCED;
+    // Name of a table to copy the source into with the recommended config;
+    // empty for none
+    std::string rebuildUri;
+  };
+
+  struct Candidate
+  {
+    std::string compressor;
+    size_t leafPageMax = 0;
+    uint64_t bytes = 0;
+    double ratio = 0;
+    double writeMBps = 0;
+    double readMBps = 0;
+    double score = 0;
+  };
+
+  struct Result
+  {
+    uint64_t sampledRows = 0;
+    uint64_t sampledBytes = 0;
+    // Share of key bytes repeated from the previous key, in sorted order
+    double keyPrefixRatio = 0;
+    std::vector<Candidate> candidates; // best first
+    std::vector<std::string> unavailable;
+    Candidate recommended;
+    size_t memoryPageMax = 0;
+    bool prefixCompression = false;
+    std::string config;
+    uint64_t rebuiltRows = 0;
+  };
+
+  // WiredTiger's default memory_page_max
+  const size_t DEFAULT_MEMORY_PAGE_MAX = 5 << 20;
+  // Average shared key prefix above which prefix compression is suggested
+  const double PREFIX_THRESHOLD = 0.2;
+  // leaf_page_max must be a multiple of the allocation size (4KB unless the
+  // table sets another) and at most 512MB
+  const size_t ALLOCATION_SIZE = 4 << 10;
+  const size_t MAX_PAGE_SIZE = 512 << 20;
+
+  inline bool ValidPageSize(size_t bytes)
+  {
+    return bytes >= ALLOCATION_SIZE && bytes <= MAX_PAGE_SIZE && bytes % ALLOCATION_SIZE == 0;
+  }
+
+  inline std::string SizeConfig(size_t bytes)
+  {
+    if (bytes % (1 << 20) == 0)
+    {
+      return std::to_string(bytes >> 20) + "MB";
+    }
+    if (bytes % (1 << 10) == 0)
+    {
+      return std::to_string(bytes >> 10) + "KB";
+    }
+    return std::to_string(bytes);
+  }
+
+  class Advisor
+  {
+  public:
+    // `home` is the connection's directory, where scratch tables' files are
+    // measured
+    Advisor(WT_CONNECTION *conn, std::string home, Spec spec)
+        : conn_(conn), home_(std::move(home)), spec_(std::move(spec))
+    {
+      spec_.sampleRows = std::max<size_t>(spec_.sampleRows, 1);
+    }
+
+    int Run()
+    {
+      // Cursors aren't cached, so scratch tables can be dropped right away
+      int ret = conn_->open_session(conn_, &errors_, "cache_cursors=false", &session_);
+      if (ret != 0)
+      {
+        return Fail(ret, "cannot open a session");
+      }
+      ret = ReadFormats();
+      if (ret == 0)
+      {
+        ret = Sample();
+      }
+      for (size_t i = 0; ret == 0 && i < spec_.compressors.size(); i++)
+      {
+        bool available = true;
+        for (size_t j = 0; ret == 0 && available && j < spec_.leafPageSizes.size(); j++)
+        {
+          ret = Measure(spec_.compressors[i], spec_.leafPageSizes[j], available);
+        }
+        if (!available)
+        {
+          result_.unavailable.push_back(spec_.compressors[i]);
+        }
+      }
+      if (ret == 0 && result_.candidates.empty())
+      {
+        ret = Fail(EINVAL, "no compressor could be tried");
+      }
+      if (ret == 0)
+      {
+        Recommend();
+        if (!spec_.rebuildUri.empty())
+        {
+          ret = Rebuild();
+        }
+      }
+      session_->close(session_, nullptr);
+      session_ = nullptr;
+      return ret;
+    }
+
+    const Result &GetResult() const
+    {
+      return result_;
+    }
+
+    const Spec &GetSpec() const
+    {
+      return spec_;
+    }
+
+    const std::string &Error() const
+    {
+      return error_;
+    }
+
+  private:
+    // Remembers the last error message reported on the advisor's session,
+    // then lets WiredTiger print it as usual
+    struct ErrorCapture : WT_EVENT_HANDLER
+    {
+      ErrorCapture() : WT_EVENT_HANDLER()
+      {
+        handle_error = Capture;
+      }
+
+      static int Capture(WT_EVENT_HANDLER *handler, WT_SESSION *, int, const char *message)
+      {
+        static_cast<ErrorCapture *>(handler)->message = message;
+        return 1;
+      }
+
+      std::string message;
+    };
+
+    WT_CONNECTION *conn_;
+    std::string home_;
+    Spec spec_;
+    ErrorCapture errors_;
+    WT_SESSION *session_ = nullptr;
+    std::string keyFormat_, valueFormat_;
+    // The source's columns, collator and app_metadata settings, appended to
+    // the recommended config
+    std::string sourceConfig_;
+    // Sorted sample
+    std::map<std::string, std::string> sample_;
+    Result result_;
+    std::string error_;
+
+    int Fail(int ret, const std::string &message)
+    {
+      if (error_.empty())
+      {
+        error_ = message + ": " + wiredtiger_strerror(ret);
+      }
+      return ret;
+    }
+
+    // A parsed config value written back out: strings are quoted again and
+    // structs keep their brackets
+    static std::string ConfigText(const WT_CONFIG_ITEM &item)
+    {
+      std::string text(item.str, item.len);
+      if (item.type == WT_CONFIG_ITEM::WT_CONFIG_ITEM_STRING)
+      {
+        return '"' + text + '"';
+      }
+      if (item.type == WT_CONFIG_ITEM::WT_CONFIG_ITEM_STRUCT && (text.empty() || text.front() != '('))
+      {
+        return '(' + text + ')';
+      }
+      return text;
+    }
+
+    int ParseMetadata(const char *config)
+    {
+      WT_CONFIG_PARSER *parser;
+      int ret = wiredtiger_config_parser_open(session_, config, std::strlen(config), &parser);
+      if (ret != 0)
+      {
+        return ret;
+      }
+      WT_CONFIG_ITEM key, value;
+      while ((ret = parser->next(parser, &key, &value)) == 0)
+      {
+        std::string name(key.str, key.len);
+        std::string text = ConfigText(value);
+        if (name == "key_format")
+        {
+          keyFormat_ = text;
+        }
+        else if (name == "value_format")
+        {
+          valueFormat_ = text;
+        }
+        else if ((name == "columns" || name == "collator" || name == "app_metadata") && value.len > 0 &&
+                 text != "()")
+        {
+          sourceConfig_ += "," + name + "=" + text;
+        }
+      }
+      parser->close(parser);
+      return ret == WT_NOTFOUND ? 0 : ret;
+    }
+
+    int ReadFormats()
+    {
+      WT_CURSOR *metadata;
+      int ret = session_->open_cursor(session_, "metadata:", nullptr, nullptr, &metadata);
+      if (ret != 0)
+      {
+        return Fail(ret, "cannot read the metadata");
+      }
+      metadata->set_key(metadata, spec_.uri.c_str());
+      const char *value;
+      if ((ret = metadata->search(metadata)) == 0 && (ret = metadata->get_value(metadata, &value)) == 0)
+      {
+        ret = ParseMetadata(value);
+      }
+      metadata->close(metadata);
+      return ret != 0 ? Fail(ret, "cannot find " + spec_.uri) : 0;
+    }
+
+    int Sample()
+    {
+      WT_CURSOR *random;
+      int ret = session_->open_cursor(session_, spec_.uri.c_str(), nullptr, "next_random=true,raw", &random);
+      if (ret != 0)
+      {
+        return Fail(ret, "cannot open " + spec_.uri);
+      }
+      for (size_t i = 0; i < spec_.sampleRows && ret == 0; i++)
+      {
+        WT_ITEM key, value;
+        if ((ret = random->next(random)) == 0 && (ret = random->get_key(random, &key)) == 0 &&
+            (ret = random->get_value(random, &value)) == 0)
+        {
+          sample_.emplace(std::string((const char *)key.data, key.size),
+                          std::string((const char *)value.data, value.size));
+        }
+      }
+      random->close(random);
+      if (ret != 0 && ret != WT_NOTFOUND)
+      {
+        return Fail(ret, "cannot sample " + spec_.uri);
+      }
+      if (sample_.empty())
+      {
+        return Fail(WT_NOTFOUND, spec_.uri + " is empty");
+      }
+
+      uint64_t keyBytes = 0, sharedBytes = 0;
+      const std::string *previous = nullptr;
+      for (const auto &entry : sample_)
+      {
+        result_.sampledBytes += entry.first.size() + entry.second.size();
+        keyBytes += entry.first.size();
+        if (previous)
+        {
+          size_t n = std::min(previous->size(), entry.first.size());
+          size_t shared = 0;
+          while (shared < n && (*previous)[shared] == entry.first[shared])
+          {
+            shared++;
+          }
+          sharedBytes += shared;
+        }
+        previous = &entry.first;
+      }
+      result_.sampledRows = sample_.size();
+      result_.keyPrefixRatio = keyBytes > 0 ? (double)sharedBytes / keyBytes : 0;
+      result_.prefixCompression = result_.keyPrefixRatio >= PREFIX_THRESHOLD;
+      return 0;
+    }
+
+    std::string TableConfig(const std::string &compressor, size_t leafPageMax, size_t memoryPageMax) const
+    {
+      std::string config = "key_format=" + keyFormat_ + ",value_format=" + valueFormat_ +
+                           ",block_compressor=" + (compressor == "none" ? "" : compressor) +
+                           ",leaf_page_max=" + SizeConfig(leafPageMax) +
+                           ",prefix_compression=" + (result_.prefixCompression ? "true" : "false");
+      if (memoryPageMax > 0)
+      {
+        config += ",memory_page_max=" + SizeConfig(memoryPageMax);
+      }
+      return config;
+    }
+
+    // Loads the sample into a scratch table and measures it. `available`
+    // turns false if the compressor isn't loaded. Scratch tables keep the
+    // default collation, as the sample is sorted bytewise for bulk loading.
+    int Measure(const std::string &compressor, size_t leafPageMax, bool &available)
+    {
+      static std::atomic<uint64_t> tables{0};
+      std::string name = "__compression_advisor_" + std::to_string((uintptr_t)this) + "_" + std::to_string(++tables);
+      std::string uri = "table:" + name;
+      std::string config = TableConfig(compressor, leafPageMax, 0) + ",log=(enabled=false)";
+      errors_.message.clear();
+      int ret = session_->create(session_, uri.c_str(), config.c_str());
+      // Any other invalid setting is an error, not a missing extension
+      if (ret == EINVAL && compressor != "none" && errors_.message.find("'" + compressor + "'") != std::string::npos)
+      {
+        available = false;
+        return 0;
+      }
+      if (ret != 0)
+      {
+        return Fail(ret, "cannot create a scratch table");
+      }
+
+      Candidate candidate;
+      candidate.compressor = compressor;
+      candidate.leafPageMax = leafPageMax;
+      auto start = std::chrono::steady_clock::now();
+      ret = Load(uri);
+      if (ret == 0)
+      {
+        std::string checkpoint = "target=(\"" + uri + "\")";
+        ret = session_->checkpoint(session_, checkpoint.c_str());
+      }
+      double writeSeconds = Seconds(start);
+      if (ret == 0)
+      {
+        std::error_code error;
+        candidate.bytes = std::filesystem::file_size(std::filesystem::path(home_) / (name + ".wt"), error);
+        ret = error ? error.value() : 0;
+      }
+      if (ret == 0)
+      {
+        // A checkpoint cursor has a tree of its own, read back from disk
+        start = std::chrono::steady_clock::now();
+        ret = Scan(uri, "checkpoint=WiredTigerCheckpoint,raw");
+      }
+      double readSeconds = Seconds(start);
+      int dropRet = Drop(uri);
+      if (ret == 0)
+      {
+        ret = dropRet;
+      }
+      if (ret != 0)
+      {
+        return Fail(ret, "cannot measure " + compressor + " with " + SizeConfig(leafPageMax) + " pages");
+      }
+
+      double megabytes = result_.sampledBytes / 1e6;
+      candidate.ratio = candidate.bytes > 0 ? (double)result_.sampledBytes / candidate.bytes : 0;
+      candidate.writeMBps = megabytes / std::max(writeSeconds, 1e-9);
+      candidate.readMBps = megabytes / std::max(readSeconds, 1e-9);
+      result_.candidates.push_back(candidate);
+      return 0;
+    }
+
+    static double Seconds(std::chrono::steady_clock::time_point start)
+    {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    int Load(const std::string &uri)
+    {
+      WT_CURSOR *bulk;
+      int ret = session_->open_cursor(session_, uri.c_str(), nullptr, "bulk,raw", &bulk);
+      if (ret != 0)
+      {
+        return ret;
+      }
+      for (auto it = sample_.begin(); it != sample_.end() && ret == 0; ++it)
+      {
+        WT_ITEM key, value;
+        key.data = it->first.data();
+        key.size = it->first.size();
+        value.data = it->second.data();
+        value.size = it->second.size();
+        bulk->set_key(bulk, &key);
+        bulk->set_value(bulk, &value);
+        ret = bulk->insert(bulk);
+      }
+      int closeRet = bulk->close(bulk);
+      return ret != 0 ? ret : closeRet;
+    }
+
+    int Scan(const std::string &uri, const char *config)
+    {
+      WT_CURSOR *cursor;
+      int ret = session_->open_cursor(session_, uri.c_str(), nullptr, config, &cursor);
+      if (ret != 0)
+      {
+        return ret;
+      }
+      WT_ITEM value;
+      while ((ret = cursor->next(cursor)) == 0 && (ret = cursor->get_value(cursor, &value)) == 0)
+      {
+      }
+      cursor->close(cursor);
+      return ret == WT_NOTFOUND ? 0 : ret;
+    }
+
+    // The checkpoint's handle may linger for a moment after its cursor closes
+    int Drop(const std::string &uri)
+    {
+      int ret;
+      for (int attempt = 0; (ret = session_->drop(session_, uri.c_str(), nullptr)) == EBUSY && attempt < 50; attempt++)
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      }
+      return ret;
+    }
+
+    // Weighted geometric mean of ratio and throughputs, so no single figure
+    // dominates by its scale
+    void Recommend()
+    {
+      double ratioWeight = 1, readWeight = 0.5, writeWeight = 0.25;
+      if (spec_.goal == SIZE)
+      {
+        readWeight = 0.1;
+        writeWeight = 0.05;
+      }
+      else if (spec_.goal == SPEED)
+      {
+        ratioWeight = 0.25;
+        readWeight = 1;
+        writeWeight = 0.5;
+      }
+      for (Candidate &candidate : result_.candidates)
+      {
+        candidate.score = std::pow(candidate.ratio, ratioWeight) * std::pow(candidate.readMBps, readWeight) *
+                          std::pow(candidate.writeMBps, writeWeight);
+      }
+      std::stable_sort(result_.candidates.begin(), result_.candidates.end(),
+                       [](const Candidate &a, const Candidate &b)
+                       { return a.score > b.score; });
+
+      result_.recommended = result_.candidates.front();
+      result_.memoryPageMax = std::max(DEFAULT_MEMORY_PAGE_MAX, 10 * result_.recommended.leafPageMax);
+      result_.config = TableConfig(result_.recommended.compressor, result_.recommended.leafPageMax, result_.memoryPageMax) +
+                       sourceConfig_;
+    }
+
+    // Copies the source into a new table with the recommended config
+    int Rebuild()
+    {
+      int ret = session_->create(session_, spec_.rebuildUri.c_str(), (result_.config + ",exclusive=true").c_str());
+      if (ret != 0)
+      {
+        return Fail(ret, "cannot create " + spec_.rebuildUri);
+      }
+
+      // One snapshot for the whole copy, on a session of its own so the bulk
+      // cursor's writes stay outside the transaction
+      WT_SESSION *reader;
+      ret = conn_->open_session(conn_, nullptr, "cache_cursors=false", &reader);
+      if (ret != 0)
+      {
+        return Fail(ret, "cannot open a session");
+      }
+      WT_CURSOR *source = nullptr, *target = nullptr;
+      ret = reader->begin_transaction(reader, "isolation=snapshot");
+      if (ret == 0)
+      {
+        ret = reader->open_cursor(reader, spec_.uri.c_str(), nullptr, "raw", &source);
+      }
+      if (ret == 0)
+      {
+        ret = session_->open_cursor(session_, spec_.rebuildUri.c_str(), nullptr, "bulk,raw", &target);
+      }
+      while (ret == 0 && (ret = source->next(source)) == 0)
+      {
+        WT_ITEM key, value;
+        if ((ret = source->get_key(source, &key)) != 0 || (ret = source->get_value(source, &value)) != 0)
+        {
+          break;
+        }
+        target->set_key(target, &key);
+        target->set_value(target, &value);
+        if ((ret = target->insert(target)) == 0)
+        {
+          result_.rebuiltRows++;
+        }
+      }
+      if (ret == WT_NOTFOUND)
+      {
+        ret = 0;
+      }
+      if (target)
+      {
+        int closeRet = target->close(target);
+        ret = ret != 0 ? ret : closeRet;
+      }
+      reader->close(reader, nullptr);
+      return ret != 0 ? Fail(ret, "cannot rebuild into " + spec_.rebuildUri) : 0;
+    }
+  };
+} // namespace compression_advisor
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <wiredtiger.h>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "field_index.h"
+#include "read_cache.h"
+
+// WiredTiger allows one WT_CONNECTION per home directory per process, while
+// every worker_thread loads the addon on its own. Opening goes through this
+// process-wide registry instead: the first open of a home calls
+// wiredtiger_open, later ones (from any thread) share that handle, and the
+// last one to let go closes it. A WT_CONNECTION is thread-safe; each opener
+// still uses sessions of its own.
+//
+// The first opener's config applies; later opens of the same home don't
+// reconfigure the connection. Field index definitions and the read cache
+// belong to the connection, so writes from every worker maintain them; the
+// definitions are loaded from their catalog table when it opens.
+
+class SharedConnection
+{
+public:
+  WT_CONNECTION *conn = nullptr;
+  std::string home;
+  std::string config;
+  std::shared_ptr<field_index::Registry> indexes = std::make_shared<field_index::Registry>();
+  // Null unless the first opener asked for one
+  std::shared_ptr<ReadCache> readCache;
+};
+
+class ConnectionRegistry
+{
+public:
+  struct Entry
+  {
+    std::string home;
+    long references;
+  };
+
+  static ConnectionRegistry &Get()
+  {
+    // Never destroyed: connections may be released after static destructors run
+    static ConnectionRegistry *registry = new ConnectionRegistry();
+    return *registry;
+  }
+
+  // Sets `shared` to the connection for `path`, opening it if no one else
+  // has. `opened` tells whether this call did; only then does
+  // `readCacheBytes` (0 for none) apply.
+  int Open(const std::string &path, const std::string &config, std::shared_ptr<SharedConnection> &shared, bool &opened,
+           size_t readCacheBytes = 0)
+  {
+    std::string home = Canonical(path);
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = connections_.find(home);
+    if (it != connections_.end())
+    {
+      shared = it->second.lock();
+      if (shared)
+      {
+        opened = false;
+        return 0;
+      }
+      // The last reference just went; reopen once the close is done
+      closed_.wait(lock, [this, &home]
+                   { return connections_.find(home) == connections_.end(); });
+    }
+
+    WT_CONNECTION *conn;
+    int ret = wiredtiger_open(path.c_str(), nullptr, config.c_str(), &conn);
+    if (ret != 0)
+    {
+      return ret;
+    }
+    auto *created = new SharedConnection();
+    ret = field_index::LoadDefinitions(conn, *created->indexes);
+    if (ret != 0)
+    {
+      delete created;
+      conn->close(conn, nullptr);
+      return ret;
+    }
+    created->conn = conn;
+    created->home = home;
+    created->config = config;
+    if (readCacheBytes > 0)
+    {
+      created->readCache = std::make_shared<ReadCache>(readCacheBytes);
+    }
+    shared = std::shared_ptr<SharedConnection>(created, [this](SharedConnection *connection)
+                                               { Close(connection); });
+    connections_[home] = shared;
+    opened = true;
+    return 0;
+  }
+
+  std::vector<Entry> List()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Entry> entries;
+    for (const auto &pair : connections_)
+    {
+      long references = pair.second.use_count();
+      if (references > 0)
+      {
+        entries.push_back({pair.first, references});
+      }
+    }
+    return entries;
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable closed_;
+  std::map<std::string, std::weak_ptr<SharedConnection>> connections_;
+
+  // Resolves symlinks and relative paths so every spelling of a home maps to
+  // one entry. Homes that don't exist yet fall back to the path as given,
+  // and wiredtiger_open reports the error.
+  static std::string Canonical(const std::string &path)
+  {
+    std::error_code error;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+    return error ? path : canonical.string();
+  }
+
+  // Runs when the last reference goes. The entry stays until the handle is
+  // closed, so a concurrent Open of the same home waits for it.
+  void Close(SharedConnection *connection)
+  {
+    connection->conn->close(connection->conn, nullptr);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      connections_.erase(connection->home);
+    }
+    closed_.notify_all();
+    delete connection;
+  }
+};
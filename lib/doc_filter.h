@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "field_index.h"
+
+// Predicates over the JSON documents of a key_format=u,value_format=u table,
+// evaluated against the raw value bytes so scans only hand matching records
+// to JS. The shape follows MongoDB's query operators:
+//
+//   { "age": { "$gte": 18 }, "status": { "$in": ["active", "trial"] },
+//     "$or": [{ "address.city": "Oslo" }, { "vip": true }] }
+//
+// Operands are held in field_index's encoding, so a comparison is a byte
+// compare of the encoded field against the encoded operand. Ordering
+// comparisons ($gt, $gte, $lt, $lte) only match fields of the operand's
+// type; arrays and objects are compared as a whole, by their JSON text.
+
+namespace doc_filter
+{
+  enum Op
+  {
+    AND,
+    OR,
+    NOR,
+    EQ,
+    NE,
+    GT,
+    GTE,
+    LT,
+    LTE,
+    IN,
+    NIN,
+    EXISTS
+  };
+
+  struct Node
+  {
+    Op op = AND;
+    // Field operators only
+    std::vector<std::string> path;
+    // Encoded operands: one for comparisons, any number for $in/$nin
+    std::vector<std::string> values;
+    bool exists = true;
+    // $and/$or/$nor only
+    std::vector<Node> children;
+
+    // `scratch` is reused between calls to hold the encoded field
+    bool Matches(const char *doc, size_t size, std::string &scratch) const
+    {
+      switch (op)
+      {
+      case AND:
+        for (const Node &child : children)
+        {
+          if (!child.Matches(doc, size, scratch))
+          {
+            return false;
+          }
+        }
+        return true;
+      case OR:
+        for (const Node &child : children)
+        {
+          if (child.Matches(doc, size, scratch))
+          {
+            return true;
+          }
+        }
+        return false;
+      case NOR:
+        for (const Node &child : children)
+        {
+          if (child.Matches(doc, size, scratch))
+          {
+            return false;
+          }
+        }
+        return true;
+      default:
+        break;
+      }
+
+      scratch.clear();
+      bool found = field_index::EncodeField(doc, size, path, scratch);
+      switch (op)
+      {
+      case EXISTS:
+        return found == exists;
+      case EQ:
+      case IN:
+        return AnyEqual(found, scratch);
+      case NE:
+      case NIN:
+        return !AnyEqual(found, scratch);
+      default:
+      {
+        const std::string &operand = values[0];
+        if (!found || scratch[0] != operand[0])
+        {
+          return false;
+        }
+        int cmp = scratch.compare(operand);
+        switch (op)
+        {
+        case GT:
+          return cmp > 0;
+        case GTE:
+          return cmp >= 0;
+        case LT:
+          return cmp < 0;
+        default:
+          return cmp <= 0;
+        }
+      }
+      }
+    }
+
+  private:
+    // A null operand also matches a missing field
+    bool AnyEqual(bool found, const std::string &field) const
+    {
+      for (const std::string &value : values)
+      {
+        if (found ? field == value : value[0] == (char)field_index::TAG_NULL)
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+  };
+} // namespace doc_filter
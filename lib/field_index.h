@@ -0,0 +1,1207 @@
+#pragma once
+
+#include <wiredtiger.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "session_pool.h"
+
+// Secondary indexes over a field of the JSON documents stored in a
+// key_format=u,value_format=u table. Each index lives in its own table:
+//
+//   unique:     [encoded field]              -> primary key
+//   non-unique: [encoded field][primary key] -> primary key
+//
+// Encoded fields sort by type (null < false < true < numbers < strings <
+// other JSON) and then by value, numerically for numbers, so equality and
+// range lookups are prefix scans. Documents without the field aren't indexed.
+
+namespace field_index
+{
+  enum Tag : uint8_t
+  {
+    TAG_NULL = 0x01,
+    TAG_FALSE = 0x02,
+    TAG_TRUE = 0x03,
+    TAG_NUMBER = 0x04,
+    TAG_STRING = 0x05,
+    TAG_JSON = 0x06
+  };
+
+  // Byte strings are terminated by 0x00 0x00 with embedded zeros escaped as
+  // 0x00 0xFF, so a shorter string sorts before any longer one it prefixes
+  inline void AppendTerminated(std::string &out, const char *data, size_t size)
+  {
+    for (size_t i = 0; i < size; i++)
+    {
+      out.push_back(data[i]);
+      if (data[i] == '\0')
+      {
+        out.push_back('\xFF');
+      }
+    }
+    out.push_back('\0');
+    out.push_back('\0');
+  }
+
+  inline void EncodeNull(std::string &out)
+  {
+    out.push_back((char)TAG_NULL);
+  }
+
+  inline void EncodeBool(std::string &out, bool value)
+  {
+    out.push_back((char)(value ? TAG_TRUE : TAG_FALSE));
+  }
+
+  // IEEE 754 bits, big-endian, with the sign flipped for positives and every
+  // bit flipped for negatives, so byte order matches numeric order
+  inline void EncodeNumber(std::string &out, double value)
+  {
+    if (value == 0)
+    {
+      value = 0; // -0 and 0 are the same key
+    }
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    bits = (bits & 0x8000000000000000ULL) ? ~bits : bits ^ 0x8000000000000000ULL;
+    out.push_back((char)TAG_NUMBER);
+    for (int shift = 56; shift >= 0; shift -= 8)
+    {
+      out.push_back((char)(uint8_t)(bits >> shift));
+    }
+  }
+
+  inline void EncodeString(std::string &out, const std::string &value)
+  {
+    out.push_back((char)TAG_STRING);
+    AppendTerminated(out, value.data(), value.size());
+  }
+
+  // Minimal JSON scanning: enough to walk to a field without building a DOM
+  namespace json
+  {
+    inline size_t SkipSpace(const char *p, size_t i, size_t n)
+    {
+      while (i < n && (p[i] == ' ' || p[i] == '\t' || p[i] == '\n' || p[i] == '\r'))
+      {
+        i++;
+      }
+      return i;
+    }
+
+    // `i` is on the opening quote; leaves it past the closing one. Jumps
+    // between quotes with memchr, which the C library vectorizes, and treats
+    // a quote as closing when it follows an even run of backslashes.
+    inline bool SkipString(const char *p, size_t &i, size_t n)
+    {
+      size_t begin = ++i;
+      while (i < n)
+      {
+        const char *quote = (const char *)std::memchr(p + i, '"', n - i);
+        if (!quote)
+        {
+          break;
+        }
+        size_t q = (size_t)(quote - p);
+        size_t k = q;
+        while (k > begin && p[k - 1] == '\\')
+        {
+          k--;
+        }
+        i = q + 1;
+        if ((q - k) % 2 == 0)
+        {
+          return true;
+        }
+      }
+      i = n;
+      return false;
+    }
+
+    inline bool SkipValue(const char *p, size_t &i, size_t n)
+    {
+      if (i >= n)
+      {
+        return false;
+      }
+      if (p[i] == '"')
+      {
+        return SkipString(p, i, n);
+      }
+      if (p[i] == '{' || p[i] == '[')
+      {
+        int depth = 0;
+        while (i < n)
+        {
+          char c = p[i];
+          if (c == '"')
+          {
+            if (!SkipString(p, i, n))
+            {
+              return false;
+            }
+            continue;
+          }
+          if (c == '{' || c == '[')
+          {
+            depth++;
+          }
+          else if ((c == '}' || c == ']') && --depth == 0)
+          {
+            i++;
+            return true;
+          }
+          i++;
+        }
+        return false;
+      }
+      size_t start = i;
+      while (i < n && p[i] != ',' && p[i] != '}' && p[i] != ']' && p[i] != ' ' && p[i] != '\t' && p[i] != '\n' &&
+             p[i] != '\r')
+      {
+        i++;
+      }
+      return i > start;
+    }
+
+    inline void AppendUtf8(std::string &out, uint32_t cp)
+    {
+      if (cp < 0x80)
+      {
+        out.push_back((char)cp);
+      }
+      else if (cp < 0x800)
+      {
+        out.push_back((char)(0xC0 | (cp >> 6)));
+        out.push_back((char)(0x80 | (cp & 0x3F)));
+      }
+      else if (cp < 0x10000)
+      {
+        out.push_back((char)(0xE0 | (cp >> 12)));
+        out.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back((char)(0x80 | (cp & 0x3F)));
+      }
+      else
+      {
+        out.push_back((char)(0xF0 | (cp >> 18)));
+        out.push_back((char)(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back((char)(0x80 | (cp & 0x3F)));
+      }
+    }
+
+    inline bool ReadHex4(const char *p, size_t i, size_t n, uint32_t &out)
+    {
+      if (i + 4 > n)
+      {
+        return false;
+      }
+      out = 0;
+      for (size_t k = i; k < i + 4; k++)
+      {
+        char c = p[k];
+        uint32_t digit;
+        if (c >= '0' && c <= '9')
+        {
+          digit = (uint32_t)(c - '0');
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+          digit = (uint32_t)(c - 'a' + 10);
+        }
+        else if (c >= 'A' && c <= 'F')
+        {
+          digit = (uint32_t)(c - 'A' + 10);
+        }
+        else
+        {
+          return false;
+        }
+        out = (out << 4) | digit;
+      }
+      return true;
+    }
+
+    // Decodes the string token [start, end) (quotes included)
+    inline bool Unescape(const char *p, size_t start, size_t end, std::string &out)
+    {
+      out.clear();
+      for (size_t i = start + 1; i + 1 < end; i++)
+      {
+        if (p[i] != '\\')
+        {
+          out.push_back(p[i]);
+          continue;
+        }
+        if (++i + 1 >= end)
+        {
+          return false;
+        }
+        switch (p[i])
+        {
+        case 'b':
+          out.push_back('\b');
+          break;
+        case 'f':
+          out.push_back('\f');
+          break;
+        case 'n':
+          out.push_back('\n');
+          break;
+        case 'r':
+          out.push_back('\r');
+          break;
+        case 't':
+          out.push_back('\t');
+          break;
+        case 'u':
+        {
+          uint32_t cp;
+          if (!ReadHex4(p, i + 1, end, cp))
+          {
+            return false;
+          }
+          i += 4;
+          uint32_t low;
+          if (cp >= 0xD800 && cp < 0xDC00 && i + 6 < end && p[i + 1] == '\\' && p[i + 2] == 'u' &&
+              ReadHex4(p, i + 3, end, low) && low >= 0xDC00 && low < 0xE000)
+          {
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+            i += 6;
+          }
+          AppendUtf8(out, cp);
+          break;
+        }
+        default:
+          out.push_back(p[i]);
+        }
+      }
+      return true;
+    }
+  } // namespace json
+
+  // Splits a dotted field path ("address.city", "tags.0"); empty segments
+  // are rejected
+  inline bool ParsePath(const std::string &field, std::vector<std::string> &path)
+  {
+    path.clear();
+    size_t start = 0;
+    while (true)
+    {
+      size_t dot = field.find('.', start);
+      std::string segment = field.substr(start, dot == std::string::npos ? std::string::npos : dot - start);
+      if (segment.empty())
+      {
+        return false;
+      }
+      path.push_back(segment);
+      if (dot == std::string::npos)
+      {
+        return true;
+      }
+      start = dot + 1;
+    }
+  }
+
+  // Finds the value at `path` (object keys, or decimal indexes into arrays)
+  // in a JSON document. [start, end) is the value's token.
+  inline bool FindField(const char *p, size_t n, const std::vector<std::string> &path, size_t &start, size_t &end)
+  {
+    size_t i = json::SkipSpace(p, 0, n);
+    std::string name;
+    for (const std::string &segment : path)
+    {
+      if (i >= n)
+      {
+        return false;
+      }
+      bool found = false;
+      if (p[i] == '{')
+      {
+        i = json::SkipSpace(p, i + 1, n);
+        while (i < n && p[i] == '"')
+        {
+          size_t keyStart = i;
+          if (!json::SkipString(p, i, n))
+          {
+            return false;
+          }
+          size_t keyEnd = i;
+          i = json::SkipSpace(p, i, n);
+          if (i >= n || p[i] != ':')
+          {
+            return false;
+          }
+          i = json::SkipSpace(p, i + 1, n);
+
+          // Keys rarely need unescaping; compare in place when they don't
+          bool match;
+          if (std::memchr(p + keyStart, '\\', keyEnd - keyStart))
+          {
+            match = json::Unescape(p, keyStart, keyEnd, name) && name == segment;
+          }
+          else
+          {
+            match = keyEnd - keyStart - 2 == segment.size() &&
+                    std::memcmp(p + keyStart + 1, segment.data(), segment.size()) == 0;
+          }
+          if (match)
+          {
+            found = true;
+            break;
+          }
+
+          if (!json::SkipValue(p, i, n))
+          {
+            return false;
+          }
+          i = json::SkipSpace(p, i, n);
+          if (i < n && p[i] == ',')
+          {
+            i = json::SkipSpace(p, i + 1, n);
+          }
+        }
+      }
+      else if (p[i] == '[')
+      {
+        char *last;
+        unsigned long index = std::strtoul(segment.c_str(), &last, 10);
+        if (segment.empty() || *last != '\0')
+        {
+          return false;
+        }
+        i = json::SkipSpace(p, i + 1, n);
+        for (unsigned long k = 0; i < n && p[i] != ']'; k++)
+        {
+          if (k == index)
+          {
+            found = true;
+            break;
+          }
+          if (!json::SkipValue(p, i, n))
+          {
+            return false;
+          }
+          i = json::SkipSpace(p, i, n);
+          if (i < n && p[i] == ',')
+          {
+            i = json::SkipSpace(p, i + 1, n);
+          }
+        }
+      }
+      if (!found)
+      {
+        return false;
+      }
+    }
+
+    start = i;
+    if (!json::SkipValue(p, i, n))
+    {
+      return false;
+    }
+    end = i;
+    return true;
+  }
+
+  // Encodes the JSON value at [start, end) of `doc`, as found by FindField()
+  inline bool EncodeToken(const char *doc, size_t start, size_t end, std::string &out)
+  {
+    const char *token = doc + start;
+    size_t length = end - start;
+    switch (token[0])
+    {
+    case '"':
+    {
+      std::string value;
+      if (!json::Unescape(doc, start, end, value))
+      {
+        return false;
+      }
+      EncodeString(out, value);
+      return true;
+    }
+    case 't':
+      EncodeBool(out, true);
+      return true;
+    case 'f':
+      EncodeBool(out, false);
+      return true;
+    case 'n':
+      EncodeNull(out);
+      return true;
+    case '{':
+    case '[':
+      out.push_back((char)TAG_JSON);
+      AppendTerminated(out, token, length);
+      return true;
+    default:
+    {
+      std::string number(token, length);
+      char *last;
+      double value = std::strtod(number.c_str(), &last);
+      if (*last != '\0')
+      {
+        return false;
+      }
+      EncodeNumber(out, value);
+      return true;
+    }
+    }
+  }
+
+  // Encodes the field at `path` of a JSON document. Returns false when the
+  // document doesn't have it (or isn't JSON), in which case it isn't indexed.
+  inline bool EncodeField(const char *doc, size_t size, const std::vector<std::string> &path, std::string &out)
+  {
+    size_t start, end;
+    return FindField(doc, size, path, start, end) && EncodeToken(doc, start, end, out);
+  }
+
+  struct Definition
+  {
+    std::string table; // "table:users"
+    std::string name;
+    std::string field; // dotted path, e.g. "address.city"
+    std::vector<std::string> path;
+    bool unique = false;
+    std::string uri; // "table:users_idx_<name>"
+
+    // Index key for a document, or false if it has no such field
+    bool Key(const char *doc, size_t size, const char *pk, size_t pkSize, std::string &out) const
+    {
+      out.clear();
+      if (!EncodeField(doc, size, path, out))
+      {
+        return false;
+      }
+      if (!unique)
+      {
+        out.append(pk, pkSize);
+      }
+      return true;
+    }
+  };
+
+  typedef std::vector<Definition> DefinitionList;
+
+  // Indexes registered on a connection, by base table. Lists are immutable
+  // once published, so writers on any thread can hold on to one lock-free.
+  class Registry
+  {
+  public:
+    void Add(Definition definition)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto &current = tables_[definition.table];
+      auto next = std::make_shared<DefinitionList>(current ? *current : DefinitionList());
+      size_t before = next->size();
+      next->erase(std::remove_if(next->begin(), next->end(), [&](const Definition &d)
+                                 { return d.name == definition.name; }),
+                  next->end());
+      bool replaced = next->size() != before;
+      next->push_back(std::move(definition));
+      current = next;
+      if (!replaced)
+      {
+        count_++;
+      }
+    }
+
+    bool Remove(const std::string &table, const std::string &name)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = tables_.find(table);
+      if (it == tables_.end())
+      {
+        return false;
+      }
+      auto next = std::make_shared<DefinitionList>(*it->second);
+      size_t before = next->size();
+      next->erase(std::remove_if(next->begin(), next->end(), [&](const Definition &d)
+                                 { return d.name == name; }),
+                  next->end());
+      if (next->size() == before)
+      {
+        return false;
+      }
+      if (next->empty())
+      {
+        tables_.erase(it);
+      }
+      else
+      {
+        it->second = next;
+      }
+      count_--;
+      return true;
+    }
+
+    // Null when the table has no indexes, the common case
+    std::shared_ptr<const DefinitionList> For(const char *table)
+    {
+      if (count_.load(std::memory_order_relaxed) == 0 || !table)
+      {
+        return nullptr;
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = tables_.find(table);
+      return it == tables_.end() ? nullptr : it->second;
+    }
+
+    bool Find(const std::string &table, const std::string &name, Definition &out)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = tables_.find(table);
+      if (it == tables_.end())
+      {
+        return false;
+      }
+      for (const Definition &d : *it->second)
+      {
+        if (d.name == name)
+        {
+          out = d;
+          return true;
+        }
+      }
+      return false;
+    }
+
+  private:
+    std::mutex mutex_;
+    std::map<std::string, std::shared_ptr<const DefinitionList>> tables_;
+    std::atomic<size_t> count_{0};
+  };
+
+  // Definitions are also kept in a catalog table, keyed by index URI, so a
+  // reopened connection maintains its indexes before anyone registers them
+  // again
+  const char *const CATALOG_URI = "table:__field_indexes";
+
+  inline int OpenCatalog(WT_SESSION *session, WT_CURSOR **cursor)
+  {
+    // value: base table, index name, field path, unique
+    int ret = session->create(session, CATALOG_URI, "key_format=S,value_format=SSSB");
+    return ret != 0 ? ret : session->open_cursor(session, CATALOG_URI, nullptr, nullptr, cursor);
+  }
+
+  inline int SaveDefinition(WT_SESSION *session, const Definition &index)
+  {
+    WT_CURSOR *catalog;
+    int ret = OpenCatalog(session, &catalog);
+    if (ret != 0)
+    {
+      return ret;
+    }
+    catalog->set_key(catalog, index.uri.c_str());
+    catalog->set_value(catalog, index.table.c_str(), index.name.c_str(), index.field.c_str(), (int)index.unique);
+    ret = catalog->insert(catalog);
+    catalog->close(catalog);
+    return ret;
+  }
+
+  inline int RemoveDefinition(WT_SESSION *session, const std::string &uri)
+  {
+    WT_CURSOR *catalog;
+    int ret = OpenCatalog(session, &catalog);
+    if (ret != 0)
+    {
+      return ret;
+    }
+    catalog->set_key(catalog, uri.c_str());
+    ret = catalog->remove(catalog);
+    catalog->close(catalog);
+    return ret == WT_NOTFOUND ? 0 : ret;
+  }
+
+  // Registers every definition in the catalog; a connection without one
+  // has none
+  inline int LoadDefinitions(WT_CONNECTION *conn, Registry &registry)
+  {
+    WT_SESSION *session;
+    int ret = conn->open_session(conn, nullptr, nullptr, &session);
+    if (ret != 0)
+    {
+      return ret;
+    }
+    WT_CURSOR *catalog;
+    ret = session->open_cursor(session, CATALOG_URI, nullptr, nullptr, &catalog);
+    if (ret == ENOENT || ret == WT_NOTFOUND)
+    {
+      session->close(session, nullptr);
+      return 0;
+    }
+    while (ret == 0 && (ret = catalog->next(catalog)) == 0)
+    {
+      const char *uri, *table, *name, *field;
+      int8_t unique;
+      if ((ret = catalog->get_key(catalog, &uri)) != 0 ||
+          (ret = catalog->get_value(catalog, &table, &name, &field, &unique)) != 0)
+      {
+        break;
+      }
+      Definition index;
+      index.uri = uri;
+      index.table = table;
+      index.name = name;
+      index.field = field;
+      index.unique = unique != 0;
+      if (ParsePath(index.field, index.path))
+      {
+        registry.Add(std::move(index));
+      }
+    }
+    session->close(session, nullptr);
+    return ret == WT_NOTFOUND ? 0 : ret;
+  }
+
+  inline int OpenIndexCursor(WT_SESSION *session, const Definition &index, WT_CURSOR **cursor)
+  {
+    return session->open_cursor(session, index.uri.c_str(), nullptr, nullptr, cursor);
+  }
+
+  // Writes one document through `base` and brings every index up to date.
+  // Must run inside a transaction so the document and its index entries
+  // commit together. Unique constraints are checked before anything is
+  // written, so a violation (WT_DUPLICATE_KEY) leaves the transaction
+  // usable; any other failure may leave a partial write behind.
+  inline int Write(WT_SESSION *session, WT_CURSOR *base, const DefinitionList &indexes, bool remove, int (*op)(WT_CURSOR *),
+                   const WT_ITEM &key, const WT_ITEM *value)
+  {
+    // The previous version of the document, to find its old index entries
+    base->set_key(base, &key);
+    int ret = base->search(base);
+    bool hadOld = ret == 0;
+    std::string old;
+    if (hadOld)
+    {
+      WT_ITEM item;
+      ret = base->get_value(base, &item);
+      if (ret != 0)
+      {
+        return ret;
+      }
+      old.assign((const char *)item.data, item.size);
+    }
+    else if (ret != WT_NOTFOUND)
+    {
+      return ret;
+    }
+    if (remove && !hadOld)
+    {
+      // Nothing indexed; the cursor's overwrite setting decides the result
+      base->set_key(base, &key);
+      return op(base);
+    }
+
+    const char *pk = (const char *)key.data;
+    size_t n = indexes.size();
+    std::vector<std::string> oldKeys(n), newKeys(n);
+    std::vector<char> hasOld(n, 0), hasNew(n, 0);
+    for (size_t i = 0; i < n; i++)
+    {
+      hasOld[i] = hadOld && indexes[i].Key(old.data(), old.size(), pk, key.size, oldKeys[i]);
+      hasNew[i] = !remove && indexes[i].Key((const char *)value->data, value->size, pk, key.size, newKeys[i]);
+    }
+
+    for (size_t i = 0; i < n; i++)
+    {
+      if (!indexes[i].unique || !hasNew[i] || (hasOld[i] && oldKeys[i] == newKeys[i]))
+      {
+        continue;
+      }
+      WT_CURSOR *cursor;
+      if ((ret = OpenIndexCursor(session, indexes[i], &cursor)) != 0)
+      {
+        return ret;
+      }
+      WT_ITEM indexKey;
+      indexKey.data = newKeys[i].data();
+      indexKey.size = newKeys[i].size();
+      cursor->set_key(cursor, &indexKey);
+      ret = cursor->search(cursor);
+      if (ret == 0)
+      {
+        WT_ITEM owner;
+        ret = cursor->get_value(cursor, &owner);
+        if (ret == 0 && (owner.size != key.size || std::memcmp(owner.data, key.data, key.size) != 0))
+        {
+          ret = WT_DUPLICATE_KEY;
+        }
+      }
+      else if (ret == WT_NOTFOUND)
+      {
+        ret = 0;
+      }
+      cursor->close(cursor);
+      if (ret != 0)
+      {
+        return ret;
+      }
+    }
+
+    base->set_key(base, &key);
+    if (value)
+    {
+      base->set_value(base, value);
+    }
+    if ((ret = op(base)) != 0)
+    {
+      return ret;
+    }
+
+    for (size_t i = 0; i < n && ret == 0; i++)
+    {
+      if (hasOld[i] == hasNew[i] && (!hasOld[i] || oldKeys[i] == newKeys[i]))
+      {
+        continue;
+      }
+      WT_CURSOR *cursor;
+      if ((ret = OpenIndexCursor(session, indexes[i], &cursor)) != 0)
+      {
+        break;
+      }
+      WT_ITEM indexKey;
+      if (hasOld[i])
+      {
+        indexKey.data = oldKeys[i].data();
+        indexKey.size = oldKeys[i].size();
+        cursor->set_key(cursor, &indexKey);
+        ret = cursor->remove(cursor);
+        if (ret == WT_NOTFOUND)
+        {
+          ret = 0;
+        }
+      }
+      if (ret == 0 && hasNew[i])
+      {
+        indexKey.data = newKeys[i].data();
+        indexKey.size = newKeys[i].size();
+        cursor->set_key(cursor, &indexKey);
+        cursor->set_value(cursor, &key);
+        ret = cursor->insert(cursor);
+      }
+      cursor->close(cursor);
+    }
+    return ret;
+  }
+
+  // Picks up to `parts - 1` increasing keys that split `uri` (or the part of
+  // it strictly between `lower` and `upper`) into roughly even ranges, by
+  // sampling with a raw next_random cursor, so the keys come back packed and
+  // in the table's own byte order whatever its key_format. Small or narrow
+  // ranges may get fewer.
+  inline int SampleSplitKeys(WT_SESSION *session, const std::string &uri, unsigned parts, const std::string *lower,
+                             const std::string *upper, std::vector<std::string> &bounds)
+  {
+    if (parts < 2)
+    {
+      return 0;
+    }
+    WT_CURSOR *random;
+    int ret = session->open_cursor(session, uri.c_str(), nullptr, "next_random=true,raw", &random);
+    if (ret != 0)
+    {
+      return ret;
+    }
+    std::vector<std::string> samples;
+    for (unsigned i = 0; i < parts * 16 && ret == 0; i++)
+    {
+      WT_ITEM key;
+      if ((ret = random->next(random)) == 0 && (ret = random->get_key(random, &key)) == 0)
+      {
+        std::string sample((const char *)key.data, key.size);
+        if ((!lower || *lower < sample) && (!upper || sample < *upper))
+        {
+          samples.push_back(std::move(sample));
+        }
+      }
+    }
+    random->close(random);
+    if (ret != 0 && ret != WT_NOTFOUND)
+    {
+      return ret;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    samples.erase(std::unique(samples.begin(), samples.end()), samples.end());
+    for (unsigned k = 1; k < parts && !samples.empty(); k++)
+    {
+      const std::string &bound = samples[k * samples.size() / parts];
+      if (bounds.empty() || bounds.back() < bound)
+      {
+        bounds.push_back(bound);
+      }
+    }
+    return 0;
+  }
+
+  // memcmp order of a raw key against a bound, as WiredTiger sorts 'u' keys
+  inline int CompareKey(const WT_ITEM &key, const std::string &bound)
+  {
+    size_t common = std::min(key.size, bound.size());
+    int cmp = common > 0 ? std::memcmp(key.data, bound.data(), common) : 0;
+    if (cmp != 0)
+    {
+      return cmp;
+    }
+    return key.size < bound.size() ? -1 : key.size > bound.size() ? 1 : 0;
+  }
+
+  // Bounds an unpositioned cursor with WT_CURSOR::bound, so next()/prev()
+  // start at the bound and return WT_NOTFOUND past the other end without
+  // walking further. Clears the bounds again on failure; cursor types that
+  // can't be bounded return an error and callers fall back to comparing
+  // keys themselves. reset() drops the bounds.
+  inline int SetBounds(WT_CURSOR *cursor, const std::string *lower, bool lowerInclusive, const std::string *upper,
+                       bool upperInclusive)
+  {
+    int ret = 0;
+    WT_ITEM key;
+    if (lower)
+    {
+      key.data = lower->data();
+      key.size = lower->size();
+      cursor->set_key(cursor, &key);
+      ret = cursor->bound(cursor, lowerInclusive ? "action=set,bound=lower,inclusive=true"
+                                                 : "action=set,bound=lower,inclusive=false");
+    }
+    if (ret == 0 && upper)
+    {
+      key.data = upper->data();
+      key.size = upper->size();
+      cursor->set_key(cursor, &key);
+      ret = cursor->bound(cursor, upperInclusive ? "action=set,bound=upper,inclusive=true"
+                                                 : "action=set,bound=upper,inclusive=false");
+    }
+    if (ret != 0)
+    {
+      cursor->bound(cursor, "action=clear");
+    }
+    return ret;
+  }
+
+  // Positions `cursor` on the first key at or after (`inclusive`) or past
+  // `lower`, or on the first key if there's no lower bound
+  inline int SeekLower(WT_CURSOR *cursor, const std::string *lower, bool inclusive)
+  {
+    if (!lower)
+    {
+      return cursor->next(cursor);
+    }
+    WT_ITEM key;
+    key.data = lower->data();
+    key.size = lower->size();
+    cursor->set_key(cursor, &key);
+    int exact;
+    int ret = cursor->search_near(cursor, &exact);
+    if (ret == 0 && (exact < 0 || (exact == 0 && !inclusive)))
+    {
+      ret = cursor->next(cursor);
+    }
+    return ret;
+  }
+
+  // Rebuilds an index from its base table. The table's key range is split at
+  // randomly sampled keys and each part is scanned by its own thread with
+  // its own pooled session, committing every `batch` entries. Writes to the
+  // base table while the build runs are indexed by Write() as usual.
+  //
+  // Every document the build indexes is also touched (its first byte
+  // rewritten in place) in the batch's transaction. A Write() of the same
+  // document that the batch's snapshot doesn't see therefore conflicts with
+  // it: either the batch replays and indexes the new version, or the writer
+  // gets WT_ROLLBACK. Without that, an entry for a version a concurrent
+  // Write() replaced could commit after the Write() removed the entries it
+  // could see, and stay behind.
+  class Builder
+  {
+  public:
+    Builder(SessionPool &pool, Definition index, unsigned threads)
+        : pool_(pool), index_(std::move(index)), threads_(std::max(1u, std::min<unsigned>(threads, (unsigned)pool.Max())))
+    {
+    }
+
+    int Run()
+    {
+      WT_SESSION *session;
+      int ret = pool_.Acquire(&session, true);
+      if (ret != 0)
+      {
+        return Fail(ret, "no session available");
+      }
+      ret = Clear(session);
+      std::vector<std::string> bounds;
+      if (ret == 0)
+      {
+        ret = SampleSplitKeys(session, index_.table, threads_, nullptr, nullptr, bounds);
+      }
+      pool_.Release(session);
+      if (ret != 0)
+      {
+        return Fail(ret, "failed to prepare the build");
+      }
+
+      // Part k covers [bounds[k - 1], bounds[k]); the outer ends are open
+      size_t parts = bounds.size() + 1;
+      std::vector<std::thread> workers;
+      std::vector<int> results(parts, 0);
+      for (size_t k = 0; k < parts; k++)
+      {
+        const std::string *lower = k > 0 ? &bounds[k - 1] : nullptr;
+        const std::string *upper = k < bounds.size() ? &bounds[k] : nullptr;
+        workers.emplace_back([this, lower, upper, &results, k]
+                             { results[k] = ScanPart(lower, upper); });
+      }
+      for (std::thread &worker : workers)
+      {
+        worker.join();
+      }
+      for (int result : results)
+      {
+        if (result != 0)
+        {
+          return result;
+        }
+      }
+      return 0;
+    }
+
+    uint64_t Count() const
+    {
+      return count_.load();
+    }
+
+    const std::string &Error() const
+    {
+      return error_;
+    }
+
+  private:
+    static const size_t BATCH = 1000;
+    static const int MAX_RETRIES = 10;
+
+    SessionPool &pool_;
+    Definition index_;
+    unsigned threads_;
+    std::atomic<uint64_t> count_{0};
+    std::atomic<bool> failed_{false};
+    std::mutex errorMutex_;
+    std::string error_;
+
+    int Fail(int ret, const std::string &message)
+    {
+      std::lock_guard<std::mutex> lock(errorMutex_);
+      if (error_.empty())
+      {
+        error_ = message + ": " + wiredtiger_strerror(ret);
+      }
+      failed_ = true;
+      return ret;
+    }
+
+    // Empties the index table. A range truncate from the first entry doesn't
+    // need exclusive access to the table, unlike truncating it by URI.
+    int Clear(WT_SESSION *session)
+    {
+      WT_CURSOR *start;
+      int ret = session->open_cursor(session, index_.uri.c_str(), nullptr, nullptr, &start);
+      if (ret != 0)
+      {
+        return ret;
+      }
+      ret = start->next(start);
+      if (ret == 0)
+      {
+        ret = session->truncate(session, nullptr, start, nullptr, nullptr);
+      }
+      start->close(start);
+      return ret == WT_NOTFOUND ? 0 : ret;
+    }
+
+    // Positions `base` on the first key >= `lower` (or the first key)
+    static int Seek(WT_CURSOR *base, const std::string *lower)
+    {
+      if (!lower)
+      {
+        base->reset(base);
+        return base->next(base);
+      }
+      WT_ITEM key;
+      key.data = lower->data();
+      key.size = lower->size();
+      base->set_key(base, &key);
+      int exact;
+      int ret = base->search_near(base, &exact);
+      if (ret == 0 && exact < 0)
+      {
+        ret = base->next(base);
+      }
+      return ret;
+    }
+
+    int ScanPart(const std::string *lower, const std::string *upper)
+    {
+      WT_SESSION *session;
+      int ret = pool_.Acquire(&session, true);
+      if (ret != 0)
+      {
+        return Fail(ret, "no session available");
+      }
+
+      WT_CURSOR *base = nullptr, *index = nullptr;
+      ret = session->open_cursor(session, index_.table.c_str(), nullptr, nullptr, &base);
+      if (ret == 0)
+      {
+        // Duplicates in a unique index surface as WT_DUPLICATE_KEY
+        ret = session->open_cursor(session, index_.uri.c_str(), nullptr, index_.unique ? "overwrite=false" : nullptr, &index);
+      }
+
+      std::string resume = lower ? *lower : std::string();
+      bool hasResume = lower != nullptr;
+      int retries = 0;
+      while (ret == 0 && !failed_)
+      {
+        // One transaction per batch; a write conflict with a concurrent
+        // writer replays the batch
+        ret = session->begin_transaction(session, "isolation=snapshot");
+        if (ret != 0)
+        {
+          break;
+        }
+        size_t inBatch = 0;
+        bool done = false;
+        ret = Seek(base, hasResume ? &resume : nullptr);
+        std::string indexKey, next;
+        while (ret == 0 && inBatch < BATCH)
+        {
+          WT_ITEM key, value;
+          if ((ret = base->get_key(base, &key)) != 0 || (ret = base->get_value(base, &value)) != 0)
+          {
+            break;
+          }
+          if (upper && std::string((const char *)key.data, key.size) >= *upper)
+          {
+            ret = WT_NOTFOUND;
+            break;
+          }
+          if (index_.Key((const char *)value.data, value.size, (const char *)key.data, key.size, indexKey))
+          {
+            if ((ret = Touch(base, value)) != 0)
+            {
+              break;
+            }
+            ret = Insert(index, indexKey, key);
+            if (ret != 0)
+            {
+              break;
+            }
+            inBatch++;
+          }
+          ret = base->next(base);
+          if (ret == 0 && inBatch == BATCH)
+          {
+            WT_ITEM nextKey;
+            base->get_key(base, &nextKey);
+            next.assign((const char *)nextKey.data, nextKey.size);
+          }
+        }
+        if (ret == WT_NOTFOUND)
+        {
+          done = true;
+          ret = 0;
+        }
+        base->reset(base);
+        index->reset(index);
+
+        if (ret == WT_ROLLBACK && retries++ < MAX_RETRIES)
+        {
+          session->rollback_transaction(session, nullptr);
+          ret = 0;
+          continue;
+        }
+        if (ret != 0)
+        {
+          session->rollback_transaction(session, nullptr);
+          break;
+        }
+        if ((ret = session->commit_transaction(session, nullptr)) != 0)
+        {
+          break;
+        }
+        count_ += inBatch;
+        retries = 0;
+        if (done)
+        {
+          break;
+        }
+        resume = next;
+        hasResume = true;
+      }
+
+      if (index)
+      {
+        index->close(index);
+      }
+      if (base)
+      {
+        base->close(base);
+      }
+      pool_.Release(session);
+
+      if (ret == WT_DUPLICATE_KEY)
+      {
+        return Fail(ret, "unique index '" + index_.name + "' has duplicate values");
+      }
+      return ret != 0 ? Fail(ret, "index build failed") : 0;
+    }
+
+    // Rewrites the document's first byte with itself; see the class comment
+    static int Touch(WT_CURSOR *base, const WT_ITEM &value)
+    {
+      char first = *(const char *)value.data;
+      WT_MODIFY modify;
+      modify.data.data = &first;
+      modify.data.size = 1;
+      modify.offset = 0;
+      modify.size = 1;
+      return base->modify(base, &modify, 1);
+    }
+
+    int Insert(WT_CURSOR *index, const std::string &indexKey, const WT_ITEM &pk)
+    {
+      WT_ITEM key;
+      key.data = indexKey.data();
+      key.size = indexKey.size();
+      index->set_key(index, &key);
+      index->set_value(index, &pk);
+      int ret = index->insert(index);
+      if (ret != WT_DUPLICATE_KEY)
+      {
+        return ret;
+      }
+
+      // Already indexed by a concurrent Write() for the same document?
+      WT_ITEM owner;
+      index->set_key(index, &key);
+      if (index->search(index) == 0 && index->get_value(index, &owner) == 0 && owner.size == pk.size &&
+          std::memcmp(owner.data, pk.data, pk.size) == 0)
+      {
+        return 0;
+      }
+      return WT_DUPLICATE_KEY;
+    }
+  };
+} // namespace field_index
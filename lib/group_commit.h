@@ -0,0 +1,174 @@
+#pragma once
+
+#include <wiredtiger.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Coalesces durable commits across sessions. Transactions commit with
+// sync=off, which writes their log records without waiting for them to reach
+// disk, and take a ticket; a dedicated thread then flushes the log once for
+// every ticket handed out since its last flush. A flush starts when
+// `maxBatch` commits are waiting or `maxDelay` after the oldest of them
+// arrived, whichever comes first.
+//
+// log_flush syncs everything written to the log so far, so a flush started
+// after a ticket was taken covers that ticket's commit. A failed flush is
+// sticky: once the log can't be synced nothing later is reported durable.
+class GroupCommit
+{
+public:
+  struct Options
+  {
+    std::chrono::microseconds maxDelay{1000};
+    size_t maxBatch = 128;
+  };
+
+  struct Stats
+  {
+    uint64_t commits = 0;
+    uint64_t flushes = 0;
+    uint64_t largestBatch = 0;
+    uint64_t flushNanos = 0;
+    uint64_t pending = 0;
+  };
+
+  // Called on the flush thread after each flush with the last ticket it
+  // covers and the flush's result
+  using Flushed = std::function<void(uint64_t upTo, int ret)>;
+
+  GroupCommit(WT_CONNECTION *conn, Options options, Flushed flushed)
+      : conn_(conn), options_(options), flushed_(std::move(flushed))
+  {
+    options_.maxBatch = std::max<size_t>(options_.maxBatch, 1);
+  }
+
+  ~GroupCommit()
+  {
+    Stop();
+  }
+
+  GroupCommit(const GroupCommit &) = delete;
+  GroupCommit &operator=(const GroupCommit &) = delete;
+
+  // Opens the flush session and starts the thread. The first flush is done
+  // here so a connection without a usable log fails up front.
+  int Start()
+  {
+    int ret = conn_->open_session(conn_, nullptr, nullptr, &session_);
+    if (ret != 0)
+    {
+      return ret;
+    }
+    ret = session_->log_flush(session_, "sync=on");
+    if (ret != 0)
+    {
+      session_->close(session_, nullptr);
+      session_ = nullptr;
+      return ret;
+    }
+    thread_ = std::thread([this]
+                          { Run(); });
+    return 0;
+  }
+
+  // Registers a transaction just committed with sync=off. Returns its ticket.
+  uint64_t Enqueue()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (issued_ == taken_)
+    {
+      oldest_ = std::chrono::steady_clock::now();
+      wake_.notify_one();
+    }
+    uint64_t ticket = ++issued_;
+    stats_.commits++;
+    if (issued_ - taken_ == options_.maxBatch)
+    {
+      wake_.notify_one();
+    }
+    return ticket;
+  }
+
+  // Flushes whatever is still waiting, then stops the thread and closes its
+  // session. Must run before the connection closes.
+  void Stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    wake_.notify_one();
+    if (thread_.joinable())
+    {
+      thread_.join();
+    }
+    if (session_)
+    {
+      session_->close(session_, nullptr);
+      session_ = nullptr;
+    }
+  }
+
+  Stats GetStats()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.pending = issued_ - taken_;
+    return stats;
+  }
+
+private:
+  WT_CONNECTION *conn_;
+  Options options_;
+  Flushed flushed_;
+  WT_SESSION *session_ = nullptr;
+  std::thread thread_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  // Tickets are numbered from 1; `taken_` is the last one a flush covers or
+  // is covering
+  uint64_t issued_ = 0;
+  uint64_t taken_ = 0;
+  std::chrono::steady_clock::time_point oldest_;
+  bool stopping_ = false;
+  int failed_ = 0;
+  Stats stats_;
+
+  void Run()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;)
+    {
+      wake_.wait(lock, [this]
+                 { return issued_ > taken_ || stopping_; });
+      if (issued_ == taken_)
+      {
+        return;
+      }
+      wake_.wait_until(lock, oldest_ + options_.maxDelay, [this]
+                       { return issued_ - taken_ >= options_.maxBatch || stopping_; });
+
+      uint64_t upTo = issued_;
+      uint64_t batch = upTo - taken_;
+      taken_ = upTo;
+      lock.unlock();
+
+      auto start = std::chrono::steady_clock::now();
+      int ret = failed_ != 0 ? failed_ : session_->log_flush(session_, "sync=on");
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      flushed_(upTo, ret);
+
+      lock.lock();
+      failed_ = ret;
+      stats_.flushes++;
+      stats_.largestBatch = std::max(stats_.largestBatch, batch);
+      stats_.flushNanos += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    }
+  }
+};
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "field_index.h"
+
+// Compound keys for key_format=u tables, encoded so that memcmp order is the
+// order of the tuples: element by element, then shorter before longer. Each
+// element is a type tag followed by a self-delimiting body, built from the
+// same encodings as field index keys:
+//
+//   null, false, true  tag only
+//   number             tag + 8 order-preserving bytes of the double
+//   string, binary     tag + bytes terminated by 0x00 0x00 (0x00 escaped)
+//   date               tag + the number encoding of its epoch milliseconds
+//   ObjectId           tag + its 12 bytes
+//
+// Types sort null < false < true < numbers < strings < dates < ObjectIds <
+// binary. No element starts with 0xFF, so appending 0xFF to an encoded
+// prefix gives an upper bound for every key extending it.
+
+namespace key_codec
+{
+  enum Tag : uint8_t
+  {
+    TAG_NULL = field_index::TAG_NULL,
+    TAG_FALSE = field_index::TAG_FALSE,
+    TAG_TRUE = field_index::TAG_TRUE,
+    TAG_NUMBER = field_index::TAG_NUMBER,
+    TAG_STRING = field_index::TAG_STRING,
+    TAG_DATE = 0x07,
+    TAG_OBJECT_ID = 0x08,
+    TAG_BINARY = 0x09
+  };
+
+  const size_t OBJECT_ID_SIZE = 12;
+
+  struct Part
+  {
+    Tag tag = TAG_NULL;
+    // Numbers and dates
+    double number = 0;
+    // Strings, binary and ObjectIds
+    std::string bytes;
+  };
+
+  inline void EncodeDate(std::string &out, double millis)
+  {
+    size_t start = out.size();
+    field_index::EncodeNumber(out, millis);
+    out[start] = (char)TAG_DATE;
+  }
+
+  inline void EncodeBinary(std::string &out, const char *data, size_t size)
+  {
+    out.push_back((char)TAG_BINARY);
+    field_index::AppendTerminated(out, data, size);
+  }
+
+  inline void EncodeObjectId(std::string &out, const uint8_t *id)
+  {
+    out.push_back((char)TAG_OBJECT_ID);
+    out.append((const char *)id, OBJECT_ID_SIZE);
+  }
+
+  // Parses 24 hex digits into the 12 bytes of an ObjectId
+  inline bool ParseObjectId(const std::string &hex, uint8_t *id)
+  {
+    if (hex.size() != OBJECT_ID_SIZE * 2)
+    {
+      return false;
+    }
+    for (size_t i = 0; i < hex.size(); i++)
+    {
+      char c = hex[i];
+      int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+      if (digit < 0)
+      {
+        return false;
+      }
+      id[i / 2] = (uint8_t)(i % 2 == 0 ? digit << 4 : id[i / 2] | digit);
+    }
+    return true;
+  }
+
+  inline std::string ObjectIdHex(const std::string &id)
+  {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    for (unsigned char c : id)
+    {
+      hex.push_back(digits[c >> 4]);
+      hex.push_back(digits[c & 0xF]);
+    }
+    return hex;
+  }
+
+  inline bool DecodeNumber(const uint8_t *p, size_t n, size_t &i, double &out)
+  {
+    if (n - i < 8)
+    {
+      return false;
+    }
+    uint64_t bits = 0;
+    for (int k = 0; k < 8; k++)
+    {
+      bits = (bits << 8) | p[i++];
+    }
+    bits = (bits & 0x8000000000000000ULL) ? bits ^ 0x8000000000000000ULL : ~bits;
+    std::memcpy(&out, &bits, sizeof(out));
+    return true;
+  }
+
+  // Reverses field_index::AppendTerminated
+  inline bool DecodeTerminated(const uint8_t *p, size_t n, size_t &i, std::string &out)
+  {
+    while (i < n)
+    {
+      uint8_t c = p[i++];
+      if (c != 0)
+      {
+        out.push_back((char)c);
+        continue;
+      }
+      if (i == n)
+      {
+        return false;
+      }
+      uint8_t next = p[i++];
+      if (next == 0)
+      {
+        return true;
+      }
+      if (next != 0xFF)
+      {
+        return false;
+      }
+      out.push_back('\0');
+    }
+    return false;
+  }
+
+  // Splits an encoded key back into its elements. Returns false for bytes
+  // that aren't a key built by this codec.
+  inline bool Decode(const uint8_t *p, size_t n, std::vector<Part> &parts)
+  {
+    size_t i = 0;
+    while (i < n)
+    {
+      Part part;
+      part.tag = (Tag)p[i++];
+      switch (part.tag)
+      {
+      case TAG_NULL:
+      case TAG_FALSE:
+      case TAG_TRUE:
+        break;
+      case TAG_NUMBER:
+      case TAG_DATE:
+        if (!DecodeNumber(p, n, i, part.number))
+        {
+          return false;
+        }
+        break;
+      case TAG_STRING:
+      case TAG_BINARY:
+        if (!DecodeTerminated(p, n, i, part.bytes))
+        {
+          return false;
+        }
+        break;
+      case TAG_OBJECT_ID:
+        if (n - i < OBJECT_ID_SIZE)
+        {
+          return false;
+        }
+        part.bytes.assign((const char *)p + i, OBJECT_ID_SIZE);
+        i += OBJECT_ID_SIZE;
+        break;
+      default:
+        return false;
+      }
+      parts.push_back(std::move(part));
+    }
+    return true;
+  }
+} // namespace key_codec
@@ -0,0 +1,440 @@
+#pragma once
+
+#include <wiredtiger.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "session_pool.h"
+
+// Checkpoints and compaction run by a thread of the connection's own instead
+// of on the JS thread or the libuv threadpool. Checkpoints start on a timer,
+// after a given amount of log has been written since the last one, or on
+// request; each listed table is compacted once the share of its file that
+// is free space passes a threshold. Tasks run one at a time on a pooled
+// session.
+//
+// While paused (say, during peak traffic) nothing new starts: due tasks wait
+// until it resumes, and a compaction pass stops between tables. A checkpoint
+// or compaction already inside WiredTiger runs to completion; compactTimeout
+// bounds the latter.
+
+namespace maintenance
+{
+  enum Task
+  {
+    CHECKPOINT,
+    COMPACT
+  };
+
+  enum Reason
+  {
+    INTERVAL,
+    LOG_SIZE,
+    FREE_SPACE,
+    MANUAL
+  };
+
+  inline const char *TaskName(Task task)
+  {
+    return task == CHECKPOINT ? "checkpoint" : "compact";
+  }
+
+  inline const char *ReasonName(Reason reason)
+  {
+    static const char *names[] = {"interval", "logSize", "freeSpace", "manual"};
+    return names[reason];
+  }
+
+  struct Policy
+  {
+    // Zero disables the corresponding trigger
+    std::chrono::milliseconds checkpointInterval{0};
+    uint64_t checkpointLogBytes = 0;
+    // Tables ("table:users") checked for compaction
+    std::vector<std::string> compactTables;
+    double compactFreeRatio = 0.2;
+    std::chrono::milliseconds compactCheckInterval{60000};
+    // Seconds a single compact call may take; zero for WiredTiger's default
+    unsigned compactTimeout = 0;
+    // How often the policy is evaluated
+    std::chrono::milliseconds tick{1000};
+  };
+
+  struct Event
+  {
+    enum Type
+    {
+      START,
+      PROGRESS,
+      COMPLETE,
+      ERROR
+    };
+
+    Type type = START;
+    Task task = CHECKPOINT;
+    Reason reason = MANUAL;
+    // Compaction progress: the table about to be compacted, its position in
+    // the pass and its free space ratio (-1 if unknown)
+    std::string uri;
+    size_t index = 0;
+    size_t total = 0;
+    double freeRatio = -1;
+    // Complete: tables compacted in the pass
+    size_t compacted = 0;
+    uint64_t durationNanos = 0;
+    std::string error;
+  };
+
+  struct Stats
+  {
+    uint64_t checkpoints = 0;
+    uint64_t compactions = 0;
+    uint64_t errors = 0;
+    uint64_t checkpointNanos = 0;
+    uint64_t compactNanos = 0;
+    bool paused = false;
+    bool running = false;
+  };
+
+  class Scheduler
+  {
+  public:
+    // Called on the scheduler thread
+    using Listener = std::function<void(const Event &)>;
+
+    Scheduler(std::shared_ptr<SessionPool> pool, Policy policy, Listener listener)
+        : pool_(std::move(pool)), policy_(std::move(policy)), listener_(std::move(listener))
+    {
+    }
+
+    ~Scheduler()
+    {
+      Stop();
+    }
+
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+
+    void Start()
+    {
+      lastCheckpoint_ = lastCompactCheck_ = std::chrono::steady_clock::now();
+      thread_ = std::thread([this]
+                            { Run(); });
+    }
+
+    // Tells the thread to stop without waiting for it. Returns true if it is
+    // inside a checkpoint or compaction, which it finishes first; otherwise
+    // it exits without starting another and Stop() returns promptly.
+    bool RequestStop()
+    {
+      bool running;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        running = stats_.running;
+      }
+      wake_.notify_one();
+      return running;
+    }
+
+    // Waits for a running task to finish
+    void Stop()
+    {
+      RequestStop();
+      if (thread_.joinable())
+      {
+        thread_.join();
+      }
+    }
+
+    void Pause(bool paused)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.paused = paused;
+      }
+      wake_.notify_one();
+    }
+
+    // Runs the task at the next opportunity, whatever the policy says. A
+    // manual compaction pass compacts every listed table.
+    void Trigger(Task task)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        (task == CHECKPOINT ? checkpointRequested_ : compactRequested_) = true;
+      }
+      wake_.notify_one();
+    }
+
+    Stats GetStats()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return stats_;
+    }
+
+  private:
+    std::shared_ptr<SessionPool> pool_;
+    Policy policy_;
+    Listener listener_;
+    std::thread thread_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    bool checkpointRequested_ = false;
+    bool compactRequested_ = false;
+    Stats stats_;
+
+    // Scheduler thread only
+    std::chrono::steady_clock::time_point lastCheckpoint_;
+    std::chrono::steady_clock::time_point lastCompactCheck_;
+    uint64_t logBytesAtCheckpoint_ = 0;
+
+    static uint64_t Elapsed(std::chrono::steady_clock::time_point start)
+    {
+      return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+          .count();
+    }
+
+    void Run()
+    {
+      ReadLogBytes(logBytesAtCheckpoint_);
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (!stopping_)
+      {
+        wake_.wait_for(lock, policy_.tick, [this]
+                       { return stopping_ || (!stats_.paused && (checkpointRequested_ || compactRequested_)); });
+        if (stopping_)
+        {
+          break;
+        }
+        if (stats_.paused)
+        {
+          continue;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        bool checkpoint = checkpointRequested_;
+        bool compact = compactRequested_;
+        checkpointRequested_ = compactRequested_ = false;
+        Reason checkpointReason = MANUAL, compactReason = MANUAL;
+        if (!checkpoint && policy_.checkpointInterval.count() > 0 &&
+            now - lastCheckpoint_ >= policy_.checkpointInterval)
+        {
+          checkpoint = true;
+          checkpointReason = INTERVAL;
+        }
+        if (!compact && !policy_.compactTables.empty() && now - lastCompactCheck_ >= policy_.compactCheckInterval)
+        {
+          compact = true;
+          compactReason = FREE_SPACE;
+        }
+        stats_.running = true;
+        lock.unlock();
+
+        uint64_t logBytes;
+        if (!checkpoint && policy_.checkpointLogBytes > 0 && ReadLogBytes(logBytes) == 0 &&
+            logBytes - logBytesAtCheckpoint_ >= policy_.checkpointLogBytes)
+        {
+          checkpoint = true;
+          checkpointReason = LOG_SIZE;
+        }
+        if (checkpoint)
+        {
+          RunCheckpoint(checkpointReason);
+        }
+        if (compact)
+        {
+          RunCompaction(compactReason);
+        }
+
+        lock.lock();
+        stats_.running = false;
+      }
+    }
+
+    void Emit(Event &event)
+    {
+      if (event.type == Event::ERROR)
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.errors++;
+      }
+      listener_(event);
+    }
+
+    void Fail(Event &event, const std::string &message, int ret)
+    {
+      event.type = Event::ERROR;
+      event.error = message + ": " + wiredtiger_strerror(ret);
+      Emit(event);
+    }
+
+    bool Interrupted()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return stopping_ || stats_.paused;
+    }
+
+    // Reads one statistic from a statistics cursor on `uri`
+    int ReadStat(const char *uri, int key, int64_t &out)
+    {
+      WT_SESSION *session;
+      int ret = pool_->Acquire(&session, true);
+      if (ret != 0)
+      {
+        return ret;
+      }
+      WT_CURSOR *cursor;
+      ret = session->open_cursor(session, uri, nullptr, "statistics=(fast)", &cursor);
+      if (ret == 0)
+      {
+        cursor->set_key(cursor, key);
+        const char *desc, *printable;
+        if ((ret = cursor->search(cursor)) == 0)
+        {
+          ret = cursor->get_value(cursor, &desc, &printable, &out);
+        }
+        cursor->close(cursor);
+      }
+      pool_->Release(session);
+      return ret;
+    }
+
+    // Needs connection statistics; without them the log-size trigger never fires
+    int ReadLogBytes(uint64_t &out)
+    {
+      int64_t value = 0;
+      int ret = ReadStat("statistics:", WT_STAT_CONN_LOG_BYTES_WRITTEN, value);
+      out = (uint64_t)value;
+      return ret;
+    }
+
+    // Share of the table's file that is free blocks awaiting reuse
+    int ReadFreeRatio(const std::string &uri, double &out)
+    {
+      int64_t reusable = 0, size = 0;
+      std::string statsUri = "statistics:" + uri;
+      int ret = ReadStat(statsUri.c_str(), WT_STAT_DSRC_BLOCK_REUSE_BYTES, reusable);
+      if (ret == 0)
+      {
+        ret = ReadStat(statsUri.c_str(), WT_STAT_DSRC_BLOCK_SIZE, size);
+      }
+      out = size > 0 ? (double)reusable / (double)size : 0;
+      return ret;
+    }
+
+    void RunCheckpoint(Reason reason)
+    {
+      Event event;
+      event.task = CHECKPOINT;
+      event.reason = reason;
+      Emit(event);
+
+      auto start = std::chrono::steady_clock::now();
+      uint64_t logBytes = 0;
+      bool haveLogBytes = ReadLogBytes(logBytes) == 0;
+      WT_SESSION *session;
+      int ret = pool_->Acquire(&session, true);
+      if (ret == 0)
+      {
+        ret = session->checkpoint(session, nullptr);
+        pool_->Release(session);
+      }
+      lastCheckpoint_ = std::chrono::steady_clock::now();
+      event.durationNanos = Elapsed(start);
+      if (ret != 0)
+      {
+        Fail(event, "Checkpoint failed", ret);
+        return;
+      }
+      if (haveLogBytes)
+      {
+        logBytesAtCheckpoint_ = logBytes;
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.checkpoints++;
+        stats_.checkpointNanos += event.durationNanos;
+      }
+      event.type = Event::COMPLETE;
+      Emit(event);
+    }
+
+    void RunCompaction(Reason reason)
+    {
+      Event event;
+      event.task = COMPACT;
+      event.reason = reason;
+      event.total = policy_.compactTables.size();
+      Emit(event);
+
+      auto start = std::chrono::steady_clock::now();
+      std::string config;
+      if (policy_.compactTimeout > 0)
+      {
+        config = "timeout=" + std::to_string(policy_.compactTimeout);
+      }
+      for (size_t i = 0; i < policy_.compactTables.size(); i++)
+      {
+        if (Interrupted())
+        {
+          break;
+        }
+        const std::string &uri = policy_.compactTables[i];
+        event.uri = uri;
+        event.index = i;
+        event.freeRatio = -1;
+        double ratio;
+        int ret = ReadFreeRatio(uri, ratio);
+        if (ret != 0)
+        {
+          Fail(event, "Failed to read free space of " + uri, ret);
+          continue;
+        }
+        event.freeRatio = ratio;
+        if (reason != MANUAL && ratio < policy_.compactFreeRatio)
+        {
+          continue;
+        }
+        event.type = Event::PROGRESS;
+        Emit(event);
+
+        WT_SESSION *session;
+        ret = pool_->Acquire(&session, true);
+        if (ret == 0)
+        {
+          ret = session->compact(session, uri.c_str(), config.empty() ? nullptr : config.c_str());
+          pool_->Release(session);
+        }
+        if (ret != 0)
+        {
+          Fail(event, "Failed to compact " + uri, ret);
+          continue;
+        }
+        event.compacted++;
+      }
+      lastCompactCheck_ = std::chrono::steady_clock::now();
+
+      event.type = Event::COMPLETE;
+      event.uri.clear();
+      event.error.clear();
+      event.freeRatio = -1;
+      event.durationNanos = Elapsed(start);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.compactions += event.compacted;
+        stats_.compactNanos += event.durationNanos;
+      }
+      Emit(event);
+    }
+  };
+} // namespace maintenance
@@ -0,0 +1,449 @@
+#pragma once
+
+#include <wiredtiger.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "doc_filter.h"
+#include "field_index.h"
+#include "session_pool.h"
+
+// Scans a key range of a table on several threads. The range is split at
+// keys sampled with a next_random cursor, each part is read by its own
+// thread on a pooled session, and rows come back in batches of packed
+// [uint32 LE length][key][uint32 LE length][value] records.
+//
+// All parts read the same data: either a named checkpoint taken of the
+// table when the scan starts (dropped when it ends), or transactions at one
+// read timestamp. Without either each part reads a snapshot of its own.
+//
+// Batches are handed out in key order, part after part, or in whatever order
+// they are filled. Each part queues at most `queueDepth` batches, so a slow
+// consumer holds the threads back rather than buffering the table.
+//
+// The threads are detached and hold the scanner (and whatever it was told
+// to keep alive, such as the connection) until they exit, so cancelling
+// never waits: the threads stop at their next batch or filter check, and
+// the last one drops the checkpoint.
+
+namespace parallel_scan
+{
+  enum Snapshot
+  {
+    NONE,
+    CHECKPOINT,
+    TIMESTAMP
+  };
+
+  struct Spec
+  {
+    std::string uri; // "table:users"
+    std::string lower, upper;
+    bool hasLower = false, hasUpper = false;
+    bool lowerInclusive = true, upperInclusive = true;
+    std::shared_ptr<const doc_filter::Node> filter;
+    Snapshot snapshot = CHECKPOINT;
+    // Hex timestamp for TIMESTAMP
+    std::string readTimestamp;
+    bool ordered = true;
+    size_t batchBytes = 256 * 1024;
+    size_t queueDepth = 4;
+  };
+
+  struct Batch
+  {
+    size_t part = 0;
+    size_t rows = 0;
+    std::string data;
+  };
+
+  class Scanner : public std::enable_shared_from_this<Scanner>
+  {
+  public:
+    // `keepAlive` is released once the last thread has exited
+    Scanner(std::shared_ptr<SessionPool> pool, Spec spec, unsigned threads, std::shared_ptr<void> keepAlive = nullptr)
+        : pool_(std::move(pool)), keepAlive_(std::move(keepAlive)), spec_(std::move(spec)),
+          threads_(std::max(1u, std::min<unsigned>(threads, (unsigned)pool_->Max())))
+    {
+      spec_.queueDepth = std::max<size_t>(spec_.queueDepth, 1);
+    }
+
+    Scanner(const Scanner &) = delete;
+    Scanner &operator=(const Scanner &) = delete;
+
+    // Splits the range, takes the snapshot and starts the threads. Blocks
+    // for the checkpoint, so call it off the JS thread, on a scanner owned
+    // by a shared_ptr.
+    int Start()
+    {
+      WT_SESSION *session;
+      int ret = pool_->Acquire(&session, true);
+      if (ret != 0)
+      {
+        return Fail(ret, "no session available");
+      }
+      conn_ = session->connection;
+      ret = field_index::SampleSplitKeys(session, spec_.uri, threads_, spec_.hasLower ? &spec_.lower : nullptr,
+                                         spec_.hasUpper ? &spec_.upper : nullptr, bounds_);
+      if (ret == 0 && spec_.snapshot == CHECKPOINT)
+      {
+        static std::atomic<uint64_t> scans{0};
+        checkpoint_ = "parallel_scan_" + std::to_string((uintptr_t)this) + "_" + std::to_string(++scans);
+        std::string config = "name=" + checkpoint_ + ",target=(\"" + spec_.uri + "\")";
+        ret = session->checkpoint(session, config.c_str());
+        if (ret != 0)
+        {
+          checkpoint_.clear();
+        }
+      }
+      pool_->Release(session);
+      if (ret != 0)
+      {
+        return Fail(ret, "failed to prepare the scan");
+      }
+
+      // Part k covers [bounds[k - 1], bounds[k]); the outer ends are the
+      // requested range's
+      size_t parts = bounds_.size() + 1;
+      std::unique_lock<std::mutex> lock(mutex_);
+      // Checked under the lock, so a cancelled scan starts no thread
+      if (cancelled_)
+      {
+        lock.unlock();
+        DropCheckpoint();
+        return 0;
+      }
+      queues_.resize(parts);
+      remaining_ = parts;
+      std::shared_ptr<Scanner> self = shared_from_this();
+      for (size_t k = 0; k < parts; k++)
+      {
+        std::thread([self, k]
+                    { self->ScanPart(k); })
+            .detach();
+      }
+      return 0;
+    }
+
+    // Waits for the next batch. Returns false once every part is done, the
+    // scan failed or it was cancelled (see Cancelled()).
+    bool Next(Batch &out)
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      for (;;)
+      {
+        if (cancelled_ || failed_)
+        {
+          return false;
+        }
+        if (spec_.ordered)
+        {
+          while (current_ < queues_.size() && queues_[current_].done && queues_[current_].batches.empty())
+          {
+            current_++;
+          }
+          if (current_ == queues_.size())
+          {
+            return false;
+          }
+          if (Take(current_, out))
+          {
+            return true;
+          }
+        }
+        else
+        {
+          for (size_t i = 0; i < queues_.size(); i++)
+          {
+            size_t k = (current_ + i) % queues_.size();
+            if (Take(k, out))
+            {
+              current_ = k + 1;
+              return true;
+            }
+          }
+          if (remaining_ == 0)
+          {
+            return false;
+          }
+        }
+        filled_.wait(lock);
+      }
+    }
+
+    // Tells the threads to stop without waiting for them. Next() returns
+    // false from then on.
+    void Cancel()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+      }
+      stopped_ = true;
+      drained_.notify_all();
+      filled_.notify_all();
+    }
+
+    bool Cancelled()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return cancelled_;
+    }
+
+    size_t Parts()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return queues_.size();
+    }
+
+    std::string Error()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return error_;
+    }
+
+  private:
+    struct Queue
+    {
+      std::deque<Batch> batches;
+      bool done = false;
+    };
+
+    std::shared_ptr<SessionPool> pool_;
+    std::shared_ptr<void> keepAlive_;
+    // For dropping the checkpoint once the pool may be closed
+    WT_CONNECTION *conn_ = nullptr;
+    Spec spec_;
+    unsigned threads_;
+    std::vector<std::string> bounds_;
+    std::string checkpoint_;
+
+    std::mutex mutex_;
+    std::condition_variable filled_;
+    std::condition_variable drained_;
+    std::vector<Queue> queues_;
+    size_t remaining_ = 0;
+    size_t current_ = 0;
+    bool cancelled_ = false;
+    bool failed_ = false;
+    std::string error_;
+    // Either of the above, read by the threads without the lock
+    std::atomic<bool> stopped_{false};
+
+    int Fail(int ret, const std::string &message)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error_.empty())
+        {
+          error_ = message + ": " + wiredtiger_strerror(ret);
+        }
+        failed_ = true;
+      }
+      stopped_ = true;
+      filled_.notify_all();
+      drained_.notify_all();
+      return ret;
+    }
+
+    // Caller holds mutex_
+    bool Take(size_t part, Batch &out)
+    {
+      Queue &queue = queues_[part];
+      if (queue.batches.empty())
+      {
+        return false;
+      }
+      out = std::move(queue.batches.front());
+      queue.batches.pop_front();
+      drained_.notify_all();
+      return true;
+    }
+
+    // Returns false if the scan stopped meanwhile
+    bool Push(size_t part, Batch &batch)
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      drained_.wait(lock, [this, part]
+                    { return cancelled_ || failed_ || queues_[part].batches.size() < spec_.queueDepth; });
+      if (cancelled_ || failed_)
+      {
+        return false;
+      }
+      queues_[part].batches.push_back(std::move(batch));
+      filled_.notify_all();
+      return true;
+    }
+
+    // The last part to finish drops the checkpoint, whether the scan
+    // completed, failed or was cancelled
+    void Finish(size_t part)
+    {
+      bool last;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queues_[part].done = true;
+        last = --remaining_ == 0;
+      }
+      if (last)
+      {
+        DropCheckpoint();
+      }
+      filled_.notify_all();
+    }
+
+    static void Append(std::string &out, const void *data, size_t size)
+    {
+      uint8_t length[4] = {(uint8_t)size, (uint8_t)(size >> 8), (uint8_t)(size >> 16), (uint8_t)(size >> 24)};
+      out.append((const char *)length, 4);
+      out.append((const char *)data, size);
+    }
+
+    int OpenPart(WT_SESSION *session, WT_CURSOR **cursor)
+    {
+      std::string config = "raw";
+      if (spec_.snapshot == CHECKPOINT)
+      {
+        config += ",checkpoint=" + checkpoint_;
+      }
+      else
+      {
+        std::string txn = "isolation=snapshot";
+        if (spec_.snapshot == TIMESTAMP)
+        {
+          txn += ",read_timestamp=" + spec_.readTimestamp;
+        }
+        int ret = session->begin_transaction(session, txn.c_str());
+        if (ret != 0)
+        {
+          return ret;
+        }
+      }
+      int ret = session->open_cursor(session, spec_.uri.c_str(), nullptr, config.c_str(), cursor);
+      if (ret != 0 && spec_.snapshot != CHECKPOINT)
+      {
+        session->rollback_transaction(session, nullptr);
+      }
+      return ret;
+    }
+
+    void ScanPart(size_t k)
+    {
+      const std::string *lower = k > 0 ? &bounds_[k - 1] : spec_.hasLower ? &spec_.lower : nullptr;
+      bool lowerInclusive = k > 0 || spec_.lowerInclusive;
+      const std::string *upper = k < bounds_.size() ? &bounds_[k] : spec_.hasUpper ? &spec_.upper : nullptr;
+      bool upperInclusive = k == bounds_.size() && spec_.upperInclusive;
+
+      WT_SESSION *session;
+      int ret = pool_->Acquire(&session, true);
+      if (ret != 0)
+      {
+        Fail(ret, "no session available");
+        Finish(k);
+        return;
+      }
+
+      WT_CURSOR *cursor;
+      ret = OpenPart(session, &cursor);
+      if (ret == 0)
+      {
+        Batch batch;
+        batch.part = k;
+        std::string scratch;
+        uint64_t seen = 0;
+        // Bounded cursors stop at the part's end by themselves
+        bool bounded = (lower || upper) &&
+                       field_index::SetBounds(cursor, lower, lowerInclusive, upper, upperInclusive) == 0;
+        for (ret = bounded ? cursor->next(cursor) : field_index::SeekLower(cursor, lower, lowerInclusive); ret == 0;
+             ret = cursor->next(cursor))
+        {
+          // Filters may skip a long way between batches
+          if ((++seen & 0x3FF) == 0 && stopped_)
+          {
+            break;
+          }
+          WT_ITEM key, value;
+          if ((ret = cursor->get_key(cursor, &key)) != 0)
+          {
+            break;
+          }
+          if (upper && !bounded)
+          {
+            int cmp = field_index::CompareKey(key, *upper);
+            if (cmp > 0 || (cmp == 0 && !upperInclusive))
+            {
+              break;
+            }
+          }
+          if ((ret = cursor->get_value(cursor, &value)) != 0)
+          {
+            break;
+          }
+          if (spec_.filter && !spec_.filter->Matches((const char *)value.data, value.size, scratch))
+          {
+            continue;
+          }
+          Append(batch.data, key.data, key.size);
+          Append(batch.data, value.data, value.size);
+          batch.rows++;
+          if (batch.data.size() >= spec_.batchBytes)
+          {
+            if (!Push(k, batch))
+            {
+              break;
+            }
+            batch = Batch();
+            batch.part = k;
+          }
+        }
+        if (ret == WT_NOTFOUND)
+        {
+          ret = 0;
+        }
+        if (ret == 0 && batch.rows > 0)
+        {
+          Push(k, batch);
+        }
+        cursor->close(cursor);
+        if (spec_.snapshot != CHECKPOINT)
+        {
+          session->rollback_transaction(session, nullptr);
+        }
+      }
+      pool_->Release(session);
+      if (ret != 0)
+      {
+        Fail(ret, "scan failed");
+      }
+      Finish(k);
+    }
+
+    // On a session of its own: the scan may outlive its pool, but not the
+    // connection (see keepAlive)
+    void DropCheckpoint()
+    {
+      if (checkpoint_.empty())
+      {
+        return;
+      }
+      WT_SESSION *session;
+      if (conn_->open_session(conn_, nullptr, nullptr, &session) == 0)
+      {
+        // Dropping a named checkpoint takes a new one of the table
+        std::string config = "drop=(" + checkpoint_ + "),target=(\"" + spec_.uri + "\")";
+        session->checkpoint(session, config.c_str());
+        session->close(session, nullptr);
+      }
+      checkpoint_.clear();
+    }
+  };
+} // namespace parallel_scan
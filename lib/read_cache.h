@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A read cache for hot keys, shared by every session (and worker_thread) on
+// a connection. Entries map a table URI and raw key to the raw value bytes
+// and are kept in per-shard LRU lists, bounded in bytes overall.
+//
+// The cache only ever holds committed data: it is filled by reads outside
+// transactions and cleared of a key once a write to it commits. A fill
+// carries the shard's epoch from before its read, and is dropped if any
+// invalidation hit the shard in between, so a read that raced a commit
+// can't put the old value back.
+
+class ReadCache
+{
+public:
+  struct Stats
+  {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t fills = 0;
+    uint64_t invalidations = 0;
+    uint64_t evictions = 0;
+    uint64_t entries = 0;
+    uint64_t bytes = 0;
+    uint64_t maxBytes = 0;
+  };
+
+  ReadCache(size_t maxBytes, size_t shards = 16)
+      : shards_(std::max<size_t>(shards, 1)), shardBytes_(std::max<size_t>(maxBytes / shards_.size(), 1))
+  {
+  }
+
+  ReadCache(const ReadCache &) = delete;
+  ReadCache &operator=(const ReadCache &) = delete;
+
+  // Builds the entry key for a table and raw key into `out`, reusing its
+  // buffer
+  static void Key(const char *uri, const void *key, size_t size, std::string &out)
+  {
+    out.assign(uri);
+    out.push_back('\0');
+    out.append((const char *)key, size);
+  }
+
+  // Read before looking the key up in WiredTiger, and handed to Put()
+  uint64_t Epoch(const std::string &key)
+  {
+    Shard &shard = For(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.epoch;
+  }
+
+  // Copies the cached value into `value`
+  bool Get(const std::string &key, std::string &value)
+  {
+    Shard &shard = For(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it == shard.index.end())
+    {
+      shard.misses++;
+      return false;
+    }
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    value.assign(it->second->value);
+    shard.hits++;
+    return true;
+  }
+
+  void Put(const std::string &key, const char *data, size_t size, uint64_t epoch)
+  {
+    size_t cost = Cost(key.size(), size);
+    Shard &shard = For(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.epoch != epoch || cost > shardBytes_)
+    {
+      return;
+    }
+    auto it = shard.index.find(key);
+    if (it != shard.index.end())
+    {
+      Erase(shard, it);
+    }
+    shard.lru.push_front({key, std::string(data, size)});
+    shard.index.emplace(key, shard.lru.begin());
+    shard.bytes += cost;
+    shard.fills++;
+    while (shard.bytes > shardBytes_)
+    {
+      Erase(shard, shard.index.find(shard.lru.back().key));
+      shard.evictions++;
+    }
+  }
+
+  void Invalidate(const std::string &key)
+  {
+    Shard &shard = For(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.epoch++;
+    auto it = shard.index.find(key);
+    if (it != shard.index.end())
+    {
+      Erase(shard, it);
+      shard.invalidations++;
+    }
+  }
+
+  // Drops every entry of a table (or all of them for an empty URI), e.g.
+  // when it is dropped, truncated or reloaded
+  void InvalidateTable(const std::string &uri)
+  {
+    std::string prefix = uri.empty() ? std::string() : uri + '\0';
+    for (Shard &shard : shards_)
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.epoch++;
+      for (auto it = shard.index.begin(); it != shard.index.end();)
+      {
+        auto next = std::next(it);
+        if (it->first.compare(0, prefix.size(), prefix) == 0)
+        {
+          Erase(shard, it);
+          shard.invalidations++;
+        }
+        it = next;
+      }
+    }
+  }
+
+  Stats GetStats()
+  {
+    Stats stats;
+    for (Shard &shard : shards_)
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      stats.hits += shard.hits;
+      stats.misses += shard.misses;
+      stats.fills += shard.fills;
+      stats.invalidations += shard.invalidations;
+      stats.evictions += shard.evictions;
+      stats.entries += shard.index.size();
+      stats.bytes += shard.bytes;
+    }
+    stats.maxBytes = shardBytes_ * shards_.size();
+    return stats;
+  }
+
+private:
+  struct Entry
+  {
+    std::string key;
+    std::string value;
+  };
+
+  struct Shard
+  {
+    std::mutex mutex;
+    std::list<Entry> lru;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    size_t bytes = 0;
+    uint64_t epoch = 0;
+    uint64_t hits = 0, misses = 0, fills = 0, invalidations = 0, evictions = 0;
+  };
+
+  std::vector<Shard> shards_;
+  size_t shardBytes_;
+
+  // Bytes charged for an entry: the key is held twice, plus bookkeeping
+  static size_t Cost(size_t keySize, size_t valueSize)
+  {
+    return 2 * keySize + valueSize + 96;
+  }
+
+  Shard &For(const std::string &key)
+  {
+    return shards_[std::hash<std::string>()(key) % shards_.size()];
+  }
+
+  static void Erase(Shard &shard, std::unordered_map<std::string, std::list<Entry>::iterator>::iterator it)
+  {
+    shard.bytes -= Cost(it->first.size(), it->second->value.size());
+    shard.lru.erase(it->second);
+    shard.index.erase(it);
+  }
+};
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <wiredtiger.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// A table's key_format or value_format, parsed once and shared by every
+// cursor on it. Fields are packed and unpacked through WiredTiger's pack
+// streams, so the bytes are exactly what a non-raw cursor would produce and
+// integer keys sort numerically.
+//
+// Get() returns null for "u" (and formats this binding can't pack, such as
+// ones with pad bytes): those columns are bound as raw bytes.
+class RecordFormat
+{
+public:
+  enum Kind
+  {
+    SIGNED,
+    UNSIGNED,
+    STRING,
+    FIXED_STRING,
+    BYTES
+  };
+
+  struct Field
+  {
+    Kind kind;
+    char type;
+    // Width of 's' and sized 'u' fields, 0 otherwise
+    size_t size;
+  };
+
+  struct Value
+  {
+    int64_t i = 0;
+    uint64_t u = 0;
+    std::string bytes;
+  };
+
+  static std::shared_ptr<const RecordFormat> Get(const char *format)
+  {
+    if (!format || std::strcmp(format, "u") == 0)
+    {
+      return nullptr;
+    }
+
+    static std::mutex mutex;
+    static std::map<std::string, std::shared_ptr<const RecordFormat>> formats;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = formats.find(format);
+    if (it != formats.end())
+    {
+      return it->second;
+    }
+    auto parsed = std::make_shared<RecordFormat>(format);
+    if (!parsed->valid_)
+    {
+      parsed.reset();
+    }
+    formats.emplace(format, parsed);
+    return parsed;
+  }
+
+  explicit RecordFormat(const std::string &format) : format_(format)
+  {
+    valid_ = Parse();
+  }
+
+  const std::string &Format() const
+  {
+    return format_;
+  }
+
+  const std::vector<Field> &Fields() const
+  {
+    return fields_;
+  }
+
+  int Pack(WT_SESSION *session, const std::vector<Value> &values, std::string &out) const
+  {
+    if (values.size() != fields_.size())
+    {
+      return EINVAL;
+    }
+
+    // Packed integers take at most 9 bytes, as does a 'u' length prefix
+    size_t bound = 0;
+    for (size_t i = 0; i < fields_.size(); i++)
+    {
+      bound += fields_[i].kind == SIGNED || fields_[i].kind == UNSIGNED ? 9 : values[i].bytes.size() + 9;
+      if (fields_[i].kind == FIXED_STRING)
+      {
+        bound += fields_[i].size;
+      }
+    }
+    out.resize(bound);
+
+    WT_PACK_STREAM *stream;
+    int ret = wiredtiger_pack_start(session, format_.c_str(), &out[0], out.size(), &stream);
+    if (ret != 0)
+    {
+      return ret;
+    }
+    for (size_t i = 0; i < fields_.size() && ret == 0; i++)
+    {
+      const Value &value = values[i];
+      switch (fields_[i].kind)
+      {
+      case SIGNED:
+        ret = wiredtiger_pack_int(stream, value.i);
+        break;
+      case UNSIGNED:
+        ret = wiredtiger_pack_uint(stream, value.u);
+        break;
+      case STRING:
+      case FIXED_STRING:
+        ret = wiredtiger_pack_str(stream, value.bytes.c_str());
+        break;
+      case BYTES:
+      {
+        WT_ITEM item;
+        item.data = value.bytes.data();
+        item.size = value.bytes.size();
+        ret = wiredtiger_pack_item(stream, &item);
+        break;
+      }
+      }
+    }
+    size_t used = 0;
+    int closeRet = wiredtiger_pack_close(stream, &used);
+    if (ret == 0)
+    {
+      ret = closeRet;
+    }
+    out.resize(ret == 0 ? used : 0);
+    return ret;
+  }
+
+  int Unpack(WT_SESSION *session, const WT_ITEM &item, std::vector<Value> &values) const
+  {
+    values.assign(fields_.size(), Value());
+
+    WT_PACK_STREAM *stream;
+    int ret = wiredtiger_unpack_start(session, format_.c_str(), item.data, item.size, &stream);
+    if (ret != 0)
+    {
+      return ret;
+    }
+    for (size_t i = 0; i < fields_.size() && ret == 0; i++)
+    {
+      Value &value = values[i];
+      switch (fields_[i].kind)
+      {
+      case SIGNED:
+        ret = wiredtiger_unpack_int(stream, &value.i);
+        break;
+      case UNSIGNED:
+        ret = wiredtiger_unpack_uint(stream, &value.u);
+        break;
+      case STRING:
+      case FIXED_STRING:
+      {
+        const char *str;
+        ret = wiredtiger_unpack_str(stream, &str);
+        if (ret == 0)
+        {
+          // Fixed-width strings are only NUL-terminated when shorter
+          size_t length = fields_[i].kind == FIXED_STRING ? strnlen(str, fields_[i].size) : std::strlen(str);
+          value.bytes.assign(str, length);
+        }
+        break;
+      }
+      case BYTES:
+      {
+        WT_ITEM field;
+        ret = wiredtiger_unpack_item(stream, &field);
+        if (ret == 0)
+        {
+          value.bytes.assign((const char *)field.data, field.size);
+        }
+        break;
+      }
+      }
+    }
+    int closeRet = wiredtiger_pack_close(stream, nullptr);
+    return ret != 0 ? ret : closeRet;
+  }
+
+private:
+  std::string format_;
+  std::vector<Field> fields_;
+  bool valid_ = false;
+
+  bool Parse()
+  {
+    size_t pos = 0;
+    // Byte-order prefixes; WiredTiger's encoding doesn't depend on them
+    while (pos < format_.size() && std::strchr(".@<>!", format_[pos]))
+    {
+      pos++;
+    }
+
+    while (pos < format_.size())
+    {
+      size_t count = 0;
+      bool hasCount = false;
+      while (pos < format_.size() && format_[pos] >= '0' && format_[pos] <= '9')
+      {
+        count = count * 10 + (size_t)(format_[pos++] - '0');
+        hasCount = true;
+      }
+      if (pos == format_.size())
+      {
+        return false;
+      }
+
+      char type = format_[pos++];
+      switch (type)
+      {
+      case 'b':
+      case 'h':
+      case 'i':
+      case 'l':
+      case 'q':
+        fields_.insert(fields_.end(), hasCount ? count : 1, Field{SIGNED, type, 0});
+        break;
+      case 'B':
+      case 'H':
+      case 'I':
+      case 'L':
+      case 'Q':
+      case 'r':
+        fields_.insert(fields_.end(), hasCount ? count : 1, Field{UNSIGNED, type, 0});
+        break;
+      case 't':
+        // The count is the bit width of a single field
+        fields_.push_back(Field{UNSIGNED, type, 0});
+        break;
+      case 'S':
+        fields_.push_back(Field{STRING, type, 0});
+        break;
+      case 's':
+        fields_.push_back(Field{FIXED_STRING, type, hasCount ? count : 1});
+        break;
+      case 'u':
+        fields_.push_back(Field{BYTES, type, hasCount ? count : 0});
+        break;
+      default:
+        // Pad bytes ('x') and anything unknown
+        return false;
+      }
+    }
+    return !fields_.empty();
+  }
+};
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <wiredtiger.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Reusable WT_SESSION handles owned by a connection. Closing a session from
+// JS hands it back here instead of to WiredTiger, so opening a session (and,
+// with cache_cursors, reopening its cursors) stays off the request path.
+//
+// Each session is used by one owner at a time. Up to `max` sessions are kept;
+// Acquire() from a worker thread waits for one to come back when all are in
+// use, while the JS thread, which must never block, opens an overflow session
+// that is closed again on release. The JS thread may itself be holding every
+// pooled session, so a worker only waits up to `maxWait` before taking an
+// overflow session too. A thread preferentially gets back the session it
+// released last, keeping its cached cursors and pages warm.
+class SessionPool
+{
+public:
+  struct Stats
+  {
+    uint64_t hits = 0;
+    uint64_t affinityHits = 0;
+    uint64_t misses = 0;
+    uint64_t overflows = 0;
+    uint64_t waits = 0;
+    uint64_t waitNanos = 0;
+  };
+
+  SessionPool(WT_CONNECTION *conn, size_t max, std::string config,
+              std::chrono::milliseconds maxWait = std::chrono::milliseconds(100))
+      : conn_(conn), max_(std::max<size_t>(max, 1)), config_(std::move(config)), maxWait_(maxWait)
+  {
+  }
+
+  int Acquire(WT_SESSION **out, bool wait)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (idle_.empty() && open_ >= max_ && wait && !closed_)
+    {
+      stats_.waits++;
+      auto start = std::chrono::steady_clock::now();
+      available_.wait_for(lock, maxWait_, [this]
+                          { return !idle_.empty() || open_ < max_ || closed_; });
+      stats_.waitNanos += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+    }
+    if (closed_)
+    {
+      return EINVAL;
+    }
+
+    if (!idle_.empty())
+    {
+      *out = TakeIdle();
+      stats_.hits++;
+      return 0;
+    }
+
+    if (open_ >= max_)
+    {
+      stats_.overflows++;
+    }
+    else
+    {
+      stats_.misses++;
+    }
+    open_++;
+    lock.unlock();
+
+    int ret = conn_->open_session(conn_, nullptr, config_.empty() ? nullptr : config_.c_str(), out);
+    if (ret != 0)
+    {
+      lock.lock();
+      open_--;
+      available_.notify_one();
+    }
+    return ret;
+  }
+
+  // The session must have no transaction running and no open cursors
+  void Release(WT_SESSION *session)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (closed_ || open_ > max_)
+    {
+      open_--;
+      lock.unlock();
+      session->close(session, nullptr);
+      return;
+    }
+
+    idle_.push_back(session);
+    affinity_[std::this_thread::get_id()] = session;
+    available_.notify_one();
+  }
+
+  // Closes the idle sessions; the ones in use are closed as they come back.
+  // The connection may stay open for other users, so nothing is left to
+  // WT_CONNECTION::close.
+  void Close()
+  {
+    std::vector<WT_SESSION *> idle;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+      idle.swap(idle_);
+      open_ -= idle.size();
+      affinity_.clear();
+      available_.notify_all();
+    }
+    for (WT_SESSION *session : idle)
+    {
+      session->close(session, nullptr);
+    }
+  }
+
+  size_t Max() const
+  {
+    return max_;
+  }
+
+  void Snapshot(Stats &stats, size_t &open, size_t &idle)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats = stats_;
+    open = open_;
+    idle = idle_.size();
+  }
+
+private:
+  WT_CONNECTION *conn_;
+  size_t max_;
+  std::string config_;
+  std::chrono::milliseconds maxWait_;
+
+  std::mutex mutex_;
+  std::condition_variable available_;
+  std::vector<WT_SESSION *> idle_;
+  std::map<std::thread::id, WT_SESSION *> affinity_;
+  size_t open_ = 0;
+  bool closed_ = false;
+  Stats stats_;
+
+  WT_SESSION *TakeIdle()
+  {
+    auto preferred = affinity_.find(std::this_thread::get_id());
+    if (preferred != affinity_.end())
+    {
+      auto it = std::find(idle_.begin(), idle_.end(), preferred->second);
+      if (it != idle_.end())
+      {
+        WT_SESSION *session = *it;
+        idle_.erase(it);
+        stats_.affinityHits++;
+        return session;
+      }
+    }
+
+    // Most recently released first; its cache footprint is the warmest
+    WT_SESSION *session = idle_.back();
+    idle_.pop_back();
+    return session;
+  }
+};
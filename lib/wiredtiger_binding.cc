@@ -5,488 +5,5723 @@
 #include <map>
 #include <sstream>
 #include <cstdint>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "aggregate.h"
+#include "binding_metrics.h"
+#include "bulk_import.h"
+#include "compression_advisor.h"
+#include "connection_registry.h"
+#include "doc_filter.h"
+#include "field_index.h"
+#include "group_commit.h"
+#include "key_codec.h"
+#include "maintenance.h"
+#include "parallel_scan.h"
+#include "read_cache.h"
+#include "record_format.h"
+#include "session_pool.h"
+
+// Constructors of each class. The main thread and every worker_thread load
+// the addon into an environment of their own, and JS values from one can't be
+// used in another, so these are per-environment instance data.
+struct AddonData
+{
+  Napi::FunctionReference cursorConstructor;
+  Napi::FunctionReference sessionConstructor;
+  Napi::FunctionReference connectionConstructor;
+  Napi::FunctionReference parallelScanConstructor;
+};
 
-// Static function references for each class
-static Napi::FunctionReference *cursorConstructor = nullptr;
-static Napi::FunctionReference *sessionConstructor = nullptr;
-static Napi::FunctionReference *connectionConstructor = nullptr;
+class SessionWorker;
+struct GroupCommitQueue;
 
-// WiredTigerCursor class (defined first since it's used by WiredTigerSession)
-class WiredTigerCursor : public Napi::ObjectWrap<WiredTigerCursor>
+// Shared between a session wrapper, its cursors and any async work queued on
+// them. WiredTiger sessions (and their cursors) must only be used by one
+// thread at a time, so while `busy` is set the session belongs to a worker on
+// the libuv threadpool and the JS thread is locked out. Only touched on the
+// JS thread.
+struct SessionState
+{
+  WT_SESSION *session = nullptr;
+  bool busy = false;
+  // Set between begin_transaction and commit/rollback; batch writes only
+  // open their own transaction when the caller hasn't
+  bool inTransaction = false;
+  std::deque<SessionWorker *> pending;
+  // Zero-copy views (getValueView & co) handed out by this session's cursors
+  std::vector<std::pair<WT_CURSOR *, Napi::Reference<Napi::ArrayBuffer>>> views;
+  // Slots of the cursor wrappers opened on this session, so they can be
+  // closed (and see themselves closed) when the session goes back to the pool
+  std::vector<WT_CURSOR **> cursors;
+  // Pool the session came from; null for sessions closed outright
+  std::shared_ptr<SessionPool> pool;
+
+  // Cursors closed from JS but kept open (reset) for the next openCursor()
+  // of the same URI and config, most recently closed first. The wrapper
+  // object is reused as well.
+  struct CachedCursor
+  {
+    std::string key;
+    Napi::ObjectReference wrapper;
+  };
+  std::list<CachedCursor> cursorCache;
+  size_t cursorCacheMax = 32;
+  uint64_t cursorCacheHits = 0;
+  uint64_t cursorCacheMisses = 0;
+  uint64_t cursorCacheEvictions = 0;
+  // Field indexes registered on the connection
+  std::shared_ptr<field_index::Registry> indexes;
+  // Set when the connection was opened with groupCommit
+  std::shared_ptr<GroupCommitQueue> groupCommit;
+  // Parallel scans started from this session; they end with it. Their
+  // next()/close() calls in flight count as pending work on close.
+  std::vector<std::weak_ptr<parallel_scan::Scanner>> scans;
+  int scanCalls = 0;
+  // On the connection's admin state: importFile() and adviseCompression()
+  // calls still running, which also hold off close
+  int jobs = 0;
+  // Held by work that may outlive the session, such as a cancelled scan's
+  // threads, so WiredTiger stays open until it is done
+  std::shared_ptr<SharedConnection> connection;
+  // The connection's read cache, if it has one, and the entry keys written
+  // by the open transaction, invalidated once it commits
+  std::shared_ptr<ReadCache> readCache;
+  std::vector<std::string> cacheWrites;
+  // Whether reads may be served from the cache: only sessions reading at
+  // snapshot isolation see what it holds. Writes invalidate it regardless.
+  bool readsFromCache = false;
+  // Set when the connection wrapper was collected while async work ran on
+  // the session; the last worker returns the session once it is done
+  bool orphaned = false;
+};
+
+// Records a write to a cached table's key: invalidated now outside a
+// transaction, at commit inside one
+static void NoteCacheWrite(SessionState &state, const std::string &key)
+{
+  if (state.inTransaction)
+  {
+    state.cacheWrites.push_back(key);
+  }
+  else
+  {
+    state.readCache->Invalidate(key);
+  }
+}
+
+// Called once the transaction has ended; a rollback passes committed=false
+static void FinishCacheWrites(SessionState &state, bool committed)
+{
+  if (committed && state.readCache)
+  {
+    for (const std::string &key : state.cacheWrites)
+    {
+      state.readCache->Invalidate(key);
+    }
+  }
+  state.cacheWrites.clear();
+}
+
+// Looks up a key in a configuration string with WiredTiger's own parser, so
+// "sync" inside another key's value doesn't count. False if it's absent or
+// the string doesn't parse.
+static bool GetConfigItem(const std::string &config, const char *key, WT_CONFIG_ITEM &value)
+{
+  WT_CONFIG_PARSER *parser;
+  if (config.empty() || wiredtiger_config_parser_open(nullptr, config.data(), config.size(), &parser) != 0)
+  {
+    return false;
+  }
+  int ret = parser->get(parser, key, &value);
+  parser->close(parser);
+  return ret == 0;
+}
+
+static bool HasConfigKey(const std::string &config, const char *key)
+{
+  WT_CONFIG_ITEM value;
+  return GetConfigItem(config, key, value);
+}
+
+// Statistics cursors snapshot at open and bulk cursors can't be reset, so
+// neither is worth keeping. Returns the cache key, or "" if not cacheable.
+static std::string CursorCacheKey(const std::string &uri, const std::string &config)
+{
+  if (uri.compare(0, 11, "statistics:") == 0 || uri.compare(0, 7, "backup:") == 0 ||
+      HasConfigKey(config, "bulk"))
+  {
+    return "";
+  }
+  return uri + '\0' + config;
+}
+
+// Views point into memory WiredTiger only guarantees while the cursor stays
+// where it is. They are detached (reads then see an empty buffer) as soon as
+// the cursor moves, its transaction ends or the session closes. Pass a null
+// cursor to release every view on the session.
+static void ReleaseViews(SessionState &state, WT_CURSOR *cursor)
+{
+  auto &views = state.views;
+  for (auto it = views.begin(); it != views.end();)
+  {
+    if (cursor && it->first != cursor)
+    {
+      ++it;
+      continue;
+    }
+    Napi::ArrayBuffer buffer = it->second.Value();
+    if (!buffer.IsEmpty() && !buffer.IsDetached())
+    {
+      buffer.Detach();
+    }
+    it = views.erase(it);
+  }
+}
+
+static void UntrackCursor(SessionState &state, WT_CURSOR **slot)
+{
+  auto it = std::find(state.cursors.begin(), state.cursors.end(), slot);
+  if (it != state.cursors.end())
+  {
+    state.cursors.erase(it);
+  }
+}
+
+// Stops the session's parallel scans without waiting for their threads;
+// next() calls then reject as cancelled
+static void CancelScans(SessionState &state)
+{
+  for (auto &weak : state.scans)
+  {
+    if (auto scanner = weak.lock())
+    {
+      scanner->Cancel();
+    }
+  }
+  state.scans.clear();
+}
+
+// Ends a session from the JS side: closes its cursors, rolls back any open
+// transaction and returns the handle to the pool (or closes it if unpooled).
+static int ReturnSession(SessionState &state)
+{
+  WT_SESSION *session = state.session;
+  ReleaseViews(state, nullptr);
+  CancelScans(state);
+
+  if (!state.pool)
+  {
+    state.session = nullptr;
+    state.cursors.clear();
+    state.cursorCache.clear();
+    return session->close(session, nullptr);
+  }
+
+  int ret = 0;
+  for (WT_CURSOR **slot : state.cursors)
+  {
+    // With cache_cursors these go to the session's cursor cache
+    int closeRet = (*slot)->close(*slot);
+    if (ret == 0)
+    {
+      ret = closeRet;
+    }
+    *slot = nullptr;
+  }
+  state.cursors.clear();
+  // Those included the cached cursors
+  state.cursorCache.clear();
+
+  if (state.inTransaction)
+  {
+    session->rollback_transaction(session, nullptr);
+    state.inTransaction = false;
+  }
+  FinishCacheWrites(state, false);
+
+  state.session = nullptr;
+  if (ret != 0)
+  {
+    // Don't hand a session in an unknown state to someone else
+    session->close(session, nullptr);
+    return ret;
+  }
+  state.pool->Release(session);
+  return 0;
+}
+
+// Wraps WiredTiger-owned memory in an external ArrayBuffer registered for
+// invalidation. Runtimes that forbid external buffers (V8 sandbox) get a copy.
+static Napi::Value MakeView(Napi::Env env, SessionState &state, WT_CURSOR *cursor, const WT_ITEM &item)
+{
+  napi_value result;
+  if (item.size > 0 &&
+      napi_create_external_arraybuffer(env, const_cast<void *>(item.data), item.size, nullptr, nullptr, &result) == napi_ok)
+  {
+    Napi::ArrayBuffer view(env, result);
+    state.views.emplace_back(cursor, Napi::Weak(view));
+    return view;
+  }
+
+  napi_value ignored;
+  napi_get_and_clear_last_exception(env, &ignored);
+  Napi::ArrayBuffer copy = Napi::ArrayBuffer::New(env, item.size);
+  if (item.size > 0)
+  {
+    std::memcpy(copy.Data(), item.data, item.size);
+  }
+  return copy;
+}
+
+// Base class for the Promise-returning operations. Workers scheduled on the
+// same SessionState run one after another; the next one is queued from the
+// JS thread when the previous one settles.
+class SessionWorker : public Napi::AsyncWorker
 {
 public:
-  static Napi::Object Init(Napi::Env env, Napi::Object exports)
+  Napi::Promise Schedule()
   {
-    Napi::Function func = DefineClass(env, "WiredTigerCursor", {
-                                                                   InstanceMethod("set", &WiredTigerCursor::Set),
-                                                                   InstanceMethod("get", &WiredTigerCursor::Get),
-                                                                   InstanceMethod("search", &WiredTigerCursor::Search),
-                                                                   InstanceMethod("searchNear", &WiredTigerCursor::SearchNear),
-                                                                   InstanceMethod("next", &WiredTigerCursor::Next),
-                                                                   InstanceMethod("prev", &WiredTigerCursor::Prev),
-                                                                   InstanceMethod("reset", &WiredTigerCursor::Reset),
-                                                                   InstanceMethod("insert", &WiredTigerCursor::Insert),
-                                                                   InstanceMethod("update", &WiredTigerCursor::Update),
-                                                                   InstanceMethod("remove", &WiredTigerCursor::Remove),
-                                                                   InstanceMethod("close", &WiredTigerCursor::Close),
-                                                                   InstanceMethod("getKey", &WiredTigerCursor::GetRawKey),
-                                                                   InstanceMethod("getValue", &WiredTigerCursor::GetRawValue),
-                                                                   InstanceMethod("setRawKey", &WiredTigerCursor::SetRawKey),
-                                                                   InstanceMethod("setRawValue", &WiredTigerCursor::SetRawValue),
-                                                               });
+    Napi::Promise promise = deferred_.Promise();
+    if (state_->busy)
+    {
+      state_->pending.push_back(this);
+    }
+    else
+    {
+      state_->busy = true;
+      Queue();
+    }
+    return promise;
+  }
 
-    cursorConstructor = new Napi::FunctionReference();
-    *cursorConstructor = Napi::Persistent(func);
-    exports.Set("WiredTigerCursor", func);
-    return exports;
+protected:
+  SessionWorker(Napi::Env env, const char *name, std::shared_ptr<SessionState> state, Napi::Object owner)
+      : Napi::AsyncWorker(env, name), state_(std::move(state)), deferred_(Napi::Promise::Deferred::New(env))
+  {
+    // Keep the wrapper (and the WT handle it owns) alive until we settle
+    owner_ = Napi::Persistent(owner);
   }
 
-  static Napi::Object NewInstance(Napi::Env env, WT_CURSOR *cursor, WT_SESSION *session)
+  virtual Napi::Value Result(Napi::Env env)
   {
-    Napi::EscapableHandleScope scope(env);
-    Napi::Object obj = cursorConstructor->New({});
-    WiredTigerCursor *wrapper = Napi::ObjectWrap<WiredTigerCursor>::Unwrap(obj);
-    wrapper->cursor_ = cursor;
-    wrapper->session_ = session;
-    return scope.Escape(napi_value(obj)).ToObject();
+    return env.Undefined();
   }
 
-  WiredTigerCursor(const Napi::CallbackInfo &info)
-      : Napi::ObjectWrap<WiredTigerCursor>(info), cursor_(nullptr), session_(nullptr)
+  // Settles the promise once Execute() succeeded; workers whose result
+  // isn't final yet can hold on to the deferred instead
+  virtual void Resolve(Napi::Promise::Deferred &deferred)
   {
+    deferred.Resolve(Result(Env()));
   }
 
-  ~WiredTigerCursor()
+  void OnOK() override
+  {
+    Resolve(deferred_);
+    ReleaseSession();
+  }
+
+  void OnError(const Napi::Error &error) override
+  {
+    deferred_.Reject(error.Value());
+    ReleaseSession();
+  }
+
+  std::shared_ptr<SessionState> state_;
+
+private:
+  Napi::Promise::Deferred deferred_;
+  Napi::ObjectReference owner_;
+
+  void ReleaseSession()
   {
-    if (cursor_)
+    if (state_->pending.empty())
     {
-      cursor_->close(cursor_);
+      state_->busy = false;
+      if (state_->orphaned && state_->session)
+      {
+        ReturnSession(*state_);
+        state_->connection.reset();
+      }
+      return;
+    }
+    SessionWorker *next = state_->pending.front();
+    state_->pending.pop_front();
+    next->Queue();
+  }
+};
+
+// Throws and returns false if the session can't be used from the JS thread
+static bool EnsureSessionUsable(Napi::Env env, const std::shared_ptr<SessionState> &state)
+{
+  if (!state || !state->session)
+  {
+    Napi::Error::New(env, "Session is closed").ThrowAsJavaScriptException();
+    return false;
+  }
+  if (state->busy)
+  {
+    Napi::Error::New(env, "Session is busy with an async operation").ThrowAsJavaScriptException();
+    return false;
+  }
+  return true;
+}
+
+// Appends the UTF-8 bytes of a JS string to `out` without going through an
+// intermediate std::string. Returns the number of bytes appended.
+static size_t AppendUtf8(napi_env env, napi_value value, std::string &out)
+{
+  size_t length = 0;
+  napi_get_value_string_utf8(env, value, nullptr, 0, &length);
+  size_t offset = out.size();
+  out.resize(offset + length + 1);
+  napi_get_value_string_utf8(env, value, &out[offset], length + 1, &length);
+  out.resize(offset + length);
+  return length;
+}
+
+// Replaces `out` with the UTF-8 bytes of a JS string, reusing its capacity.
+// A string that fits is written with a single N-API call and no allocation;
+// only longer ones need the length query and a resize. V8 stops short of a
+// character that doesn't fit, so the first write is only known to be
+// complete if it left room for the longest (4-byte) one.
+static void AssignUtf8(napi_env env, napi_value value, std::string &out)
+{
+  size_t length = 0;
+  if (out.capacity() >= 16)
+  {
+    out.resize(out.capacity());
+    napi_get_value_string_utf8(env, value, &out[0], out.size(), &length);
+    if (out.size() - 1 - length >= 4)
+    {
+      out.resize(length);
+      return;
+    }
+  }
+  out.clear();
+  AppendUtf8(env, value, out);
+}
+
+// Packed batches are sequences of [uint32 LE length][bytes] records
+static inline uint32_t ReadU32LE(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void WriteU32LE(uint8_t *p, uint32_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+// Length prefix used for a missing value in a packed result
+static const uint32_t PACKED_MISSING = 0xFFFFFFFFu;
+
+// Resolves an ArrayBuffer, Buffer or other TypedArray to its bytes
+static bool GetBytes(Napi::Value value, const uint8_t *&data, size_t &length)
+{
+  if (value.IsArrayBuffer())
+  {
+    Napi::ArrayBuffer buffer = value.As<Napi::ArrayBuffer>();
+    data = static_cast<const uint8_t *>(buffer.Data());
+    length = buffer.ByteLength();
+    return true;
+  }
+  if (value.IsTypedArray())
+  {
+    Napi::TypedArray array = value.As<Napi::TypedArray>();
+    data = static_cast<const uint8_t *>(array.ArrayBuffer().Data()) + array.ByteOffset();
+    length = array.ByteLength();
+    return true;
+  }
+  return false;
+}
+
+// Appends the key_codec encoding of an array of key elements: null or
+// undefined, booleans, numbers, strings, Dates, byte arrays, and ObjectIds
+// (anything with a toHexString() returning 24 hex digits). Throws and
+// returns false on anything else.
+static bool EncodeKeyParts(Napi::Env env, Napi::Array parts, std::string &out)
+{
+  for (uint32_t i = 0; i < parts.Length(); i++)
+  {
+    Napi::Value part = parts.Get(i);
+    const uint8_t *data;
+    size_t length;
+    if (part.IsNull() || part.IsUndefined())
+    {
+      field_index::EncodeNull(out);
+    }
+    else if (part.IsBoolean())
+    {
+      field_index::EncodeBool(out, part.As<Napi::Boolean>().Value());
+    }
+    else if (part.IsNumber())
+    {
+      double number = part.As<Napi::Number>().DoubleValue();
+      if (std::isnan(number))
+      {
+        Napi::TypeError::New(env, "NaN can't be part of a key").ThrowAsJavaScriptException();
+        return false;
+      }
+      field_index::EncodeNumber(out, number);
+    }
+    else if (part.IsString())
+    {
+      field_index::EncodeString(out, part.As<Napi::String>().Utf8Value());
+    }
+    else if (part.IsDate())
+    {
+      double time = part.As<Napi::Date>().ValueOf();
+      if (std::isnan(time))
+      {
+        Napi::TypeError::New(env, "An invalid Date can't be part of a key").ThrowAsJavaScriptException();
+        return false;
+      }
+      key_codec::EncodeDate(out, time);
+    }
+    else if (GetBytes(part, data, length))
+    {
+      key_codec::EncodeBinary(out, (const char *)data, length);
+    }
+    else
+    {
+      uint8_t id[key_codec::OBJECT_ID_SIZE];
+      Napi::Value toHex = part.IsObject() ? part.As<Napi::Object>().Get("toHexString") : env.Undefined();
+      if (!toHex.IsFunction())
+      {
+        Napi::TypeError::New(env, "Unsupported key element at index " + std::to_string(i))
+            .ThrowAsJavaScriptException();
+        return false;
+      }
+      Napi::Value hex = toHex.As<Napi::Function>().Call(part, {});
+      if (env.IsExceptionPending())
+      {
+        return false;
+      }
+      if (!hex.IsString() || !key_codec::ParseObjectId(hex.As<Napi::String>().Utf8Value(), id))
+      {
+        Napi::TypeError::New(env, "Invalid ObjectId at index " + std::to_string(i)).ThrowAsJavaScriptException();
+        return false;
+      }
+      key_codec::EncodeObjectId(out, id);
+    }
+  }
+  return true;
+}
+
+// Resolves a raw key argument: bytes as they are, or an array of key
+// elements encoded into `scratch`
+static bool GetKeyBytes(Napi::Env env, Napi::Value value, std::string &scratch, const uint8_t *&data, size_t &length)
+{
+  if (value.IsArray())
+  {
+    scratch.clear();
+    if (!EncodeKeyParts(env, value.As<Napi::Array>(), scratch))
+    {
+      return false;
+    }
+    data = (const uint8_t *)scratch.data();
+    length = scratch.size();
+    return true;
+  }
+  if (!GetBytes(value, data, length))
+  {
+    Napi::TypeError::New(env, "ArrayBuffer, Uint8Array or array of key elements expected")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+  return true;
+}
+
+// Largest integer a JS number holds exactly; 64-bit fields beyond it come
+// back as BigInt
+static const int64_t MAX_SAFE_INTEGER = 9007199254740991LL;
+
+// A key or value crossing the binding. Raw 'u' columns carry the UTF-8 bytes
+// of a string; typed columns (see RecordFormat) carry the converted fields,
+// which are packed or unpacked on whichever thread owns the session.
+struct FieldBuffer
+{
+  std::shared_ptr<const RecordFormat> format;
+  std::vector<RecordFormat::Value> fields;
+  std::string bytes;
+
+  // A single field takes a scalar, compound formats an array with one
+  // element per field. Throws and returns false on mismatch.
+  bool Read(Napi::Env env, Napi::Value input, const char *what)
+  {
+    if (!format)
+    {
+      if (!input.IsString())
+      {
+        Napi::TypeError::New(env, std::string(what) + " string expected").ThrowAsJavaScriptException();
+        return false;
+      }
+      bytes.clear();
+      AppendUtf8(env, input, bytes);
+      return true;
+    }
+
+    const std::vector<RecordFormat::Field> &specs = format->Fields();
+    fields.assign(specs.size(), RecordFormat::Value());
+    bool ok;
+    if (specs.size() == 1)
+    {
+      ok = ReadField(env, specs[0], input, fields[0]);
+    }
+    else
+    {
+      ok = input.IsArray() && input.As<Napi::Array>().Length() == specs.size();
+      for (uint32_t i = 0; ok && i < specs.size(); i++)
+      {
+        ok = ReadField(env, specs[i], input.As<Napi::Array>().Get(i), fields[i]);
+      }
+    }
+    if (!ok)
+    {
+      Napi::TypeError::New(env, std::string(what) + " does not match format '" + format->Format() + "'")
+          .ThrowAsJavaScriptException();
+    }
+    return ok;
+  }
+
+  int Pack(WT_SESSION *session)
+  {
+    return format ? format->Pack(session, fields, bytes) : 0;
+  }
+
+  int Unpack(WT_SESSION *session, const WT_ITEM &item)
+  {
+    if (!format)
+    {
+      bytes.assign((const char *)item.data, item.size);
+      return 0;
+    }
+    return format->Unpack(session, item, fields);
+  }
+
+  WT_ITEM Item() const
+  {
+    WT_ITEM item;
+    item.data = bytes.data();
+    item.size = bytes.size();
+    return item;
+  }
+
+  Napi::Value ToJs(Napi::Env env) const
+  {
+    if (!format)
+    {
+      return Napi::String::New(env, bytes);
+    }
+    const std::vector<RecordFormat::Field> &specs = format->Fields();
+    if (specs.size() == 1)
+    {
+      return FieldToJs(env, specs[0], fields[0]);
+    }
+    Napi::Array array = Napi::Array::New(env, specs.size());
+    for (uint32_t i = 0; i < specs.size(); i++)
+    {
+      array.Set(i, FieldToJs(env, specs[i], fields[i]));
+    }
+    return array;
+  }
+
+private:
+  static bool ReadField(Napi::Env env, const RecordFormat::Field &spec, Napi::Value input, RecordFormat::Value &out)
+  {
+    switch (spec.kind)
+    {
+    case RecordFormat::SIGNED:
+    case RecordFormat::UNSIGNED:
+    {
+      bool isSigned = spec.kind == RecordFormat::SIGNED;
+      if (input.IsNumber())
+      {
+        double number = input.As<Napi::Number>().DoubleValue();
+        if (std::trunc(number) != number || std::fabs(number) > 9.2e18 || (!isSigned && number < 0))
+        {
+          return false;
+        }
+        out.i = (int64_t)number;
+        out.u = (uint64_t)out.i;
+        return true;
+      }
+      if (input.IsBigInt())
+      {
+        bool lossless;
+        napi_status status = isSigned ? napi_get_value_bigint_int64(env, input, &out.i, &lossless)
+                                      : napi_get_value_bigint_uint64(env, input, &out.u, &lossless);
+        return status == napi_ok && lossless;
+      }
+      return false;
+    }
+    case RecordFormat::STRING:
+    case RecordFormat::FIXED_STRING:
+      if (!input.IsString())
+      {
+        return false;
+      }
+      AppendUtf8(env, input, out.bytes);
+      return true;
+    case RecordFormat::BYTES:
+    {
+      const uint8_t *data;
+      size_t length;
+      if (GetBytes(input, data, length))
+      {
+        out.bytes.assign((const char *)data, length);
+        return true;
+      }
+      if (input.IsString())
+      {
+        AppendUtf8(env, input, out.bytes);
+        return true;
+      }
+      return false;
+    }
+    }
+    return false;
+  }
+
+  static Napi::Value FieldToJs(Napi::Env env, const RecordFormat::Field &spec, const RecordFormat::Value &value)
+  {
+    napi_value result = nullptr;
+    switch (spec.kind)
+    {
+    case RecordFormat::SIGNED:
+      if (value.i >= -MAX_SAFE_INTEGER && value.i <= MAX_SAFE_INTEGER)
+      {
+        return Napi::Number::New(env, (double)value.i);
+      }
+      napi_create_bigint_int64(env, value.i, &result);
+      return Napi::Value(env, result);
+    case RecordFormat::UNSIGNED:
+      if (value.u <= (uint64_t)MAX_SAFE_INTEGER)
+      {
+        return Napi::Number::New(env, (double)value.u);
+      }
+      napi_create_bigint_uint64(env, value.u, &result);
+      return Napi::Value(env, result);
+    case RecordFormat::STRING:
+    case RecordFormat::FIXED_STRING:
+      return Napi::String::New(env, value.bytes);
+    case RecordFormat::BYTES:
+    {
+      Napi::Buffer<uint8_t> buffer = Napi::Buffer<uint8_t>::New(env, value.bytes.size());
+      if (!value.bytes.empty())
+      {
+        std::memcpy(buffer.Data(), value.bytes.data(), value.bytes.size());
+      }
+      return buffer;
+    }
+    }
+    return env.Undefined();
+  }
+};
+
+// Packed batch buffers (packKeys/packEntries) carry keys and values as plain
+// bytes. Typed columns take them when they are a single string or byte
+// field, packed as that field; other formats need JS values per record.
+static bool BytesFormat(const std::shared_ptr<const RecordFormat> &format)
+{
+  return !format || (format->Fields().size() == 1 && format->Fields()[0].kind != RecordFormat::SIGNED &&
+                     format->Fields()[0].kind != RecordFormat::UNSIGNED);
+}
+
+// Packs bytes as the single field of a BytesFormat() format (or copies them
+// for raw columns). Strings can't hold a NUL.
+static int PackBytes(WT_SESSION *session, const std::shared_ptr<const RecordFormat> &format, const char *data, size_t size,
+                     std::string &out)
+{
+  if (!format)
+  {
+    out.assign(data, size);
+    return 0;
+  }
+  if (format->Fields()[0].kind != RecordFormat::BYTES && std::memchr(data, 0, size))
+  {
+    return EINVAL;
+  }
+  std::vector<RecordFormat::Value> fields(1);
+  fields[0].bytes.assign(data, size);
+  return format->Pack(session, fields, out);
+}
+
+// Point lookups for getMany(). Keys and found values are stored back to back
+// in two arenas so a batch costs a handful of allocations, and the searches
+// run in key order so consecutive lookups land on the same leaf pages.
+struct MultiGetBatch
+{
+  std::string keys;
+  std::vector<size_t> keyOffsets{0}; // key i is [keyOffsets[i], keyOffsets[i + 1])
+  std::string values;
+  std::vector<size_t> valueOffsets;
+  std::vector<size_t> valueLengths;
+  std::vector<bool> found;
+  bool packed = false;
+  // Typed formats of the table, null for raw columns; set before Parse().
+  // Typed keys are packed by Run(), on the thread that owns the session.
+  std::shared_ptr<const RecordFormat> keyFormat, valueFormat;
+  std::vector<std::vector<RecordFormat::Value>> keyFields;
+  bool keysPacked = false;
+  // Values found on a typed table, for an array result
+  std::vector<std::vector<RecordFormat::Value>> valueFields;
+
+  size_t Count() const
+  {
+    return keyOffsets.size() - 1;
+  }
+
+  // Parses either an array of strings or a packed buffer of keys. Throws and
+  // returns false on malformed input.
+  bool Parse(Napi::Env env, Napi::Value input)
+  {
+    if (input.IsArray())
+    {
+      Napi::Array array = input.As<Napi::Array>();
+      uint32_t length = array.Length();
+      keyOffsets.reserve(length + 1);
+      for (uint32_t i = 0; i < length; i++)
+      {
+        Napi::Value key = array.Get(i);
+        if (keyFormat)
+        {
+          FieldBuffer buffer;
+          buffer.format = keyFormat;
+          if (!buffer.Read(env, key, "Key"))
+          {
+            return false;
+          }
+          keyFields.push_back(std::move(buffer.fields));
+          continue;
+        }
+        if (!key.IsString())
+        {
+          Napi::TypeError::New(env, "Key strings expected").ThrowAsJavaScriptException();
+          return false;
+        }
+        AppendUtf8(env, key, keys);
+        keyOffsets.push_back(keys.size());
+      }
+      return true;
+    }
+
+    const uint8_t *data;
+    size_t length;
+    if (!GetBytes(input, data, length))
+    {
+      Napi::TypeError::New(env, "Array of keys or packed key buffer expected").ThrowAsJavaScriptException();
+      return false;
+    }
+    if (!BytesFormat(keyFormat) || !BytesFormat(valueFormat))
+    {
+      Napi::TypeError::New(env, "Packed key buffers need string or byte keys and values; pass an array of keys")
+          .ThrowAsJavaScriptException();
+      return false;
+    }
+
+    packed = true;
+    keys.reserve(length);
+    size_t pos = 0;
+    while (pos < length)
+    {
+      if (length - pos < 4 || length - pos - 4 < ReadU32LE(data + pos))
+      {
+        Napi::RangeError::New(env, "Malformed packed key buffer").ThrowAsJavaScriptException();
+        return false;
+      }
+      uint32_t size = ReadU32LE(data + pos);
+      keys.append(reinterpret_cast<const char *>(data + pos + 4), size);
+      keyOffsets.push_back(keys.size());
+      pos += 4 + size;
+    }
+    return true;
+  }
+
+  int Run(WT_CURSOR *cursor)
+  {
+    int ret = PackKeys(cursor->session);
+    if (ret != 0)
+    {
+      return ret;
+    }
+
+    size_t count = Count();
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; i++)
+    {
+      order[i] = i;
+    }
+
+    const char *base = keys.data();
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+              {
+                size_t lenA = keyOffsets[a + 1] - keyOffsets[a];
+                size_t lenB = keyOffsets[b + 1] - keyOffsets[b];
+                int cmp = std::memcmp(base + keyOffsets[a], base + keyOffsets[b], std::min(lenA, lenB));
+                return cmp != 0 ? cmp < 0 : lenA < lenB; });
+
+    found.assign(count, false);
+    valueOffsets.assign(count, 0);
+    valueLengths.assign(count, 0);
+    if (valueFormat && !packed)
+    {
+      valueFields.assign(count, std::vector<RecordFormat::Value>());
+    }
+
+    for (size_t i : order)
+    {
+      WT_ITEM key_item;
+      key_item.data = base + keyOffsets[i];
+      key_item.size = keyOffsets[i + 1] - keyOffsets[i];
+      cursor->set_key(cursor, &key_item);
+
+      ret = cursor->search(cursor);
+      if (ret == WT_NOTFOUND)
+      {
+        continue;
+      }
+
+      WT_ITEM value_item;
+      if (ret == 0)
+      {
+        ret = cursor->get_value(cursor, &value_item);
+      }
+      if (ret == 0 && valueFormat)
+      {
+        ret = UnpackValue(cursor->session, value_item, i);
+      }
+      if (ret != 0)
+      {
+        cursor->reset(cursor);
+        return ret;
+      }
+
+      if (!valueFormat)
+      {
+        valueOffsets[i] = values.size();
+        valueLengths[i] = value_item.size;
+        values.append((const char *)value_item.data, value_item.size);
+      }
+      found[i] = true;
+    }
+
+    // Don't keep the last leaf page pinned
+    return cursor->reset(cursor);
+  }
+
+  // An array with holes for missing keys, or a packed buffer (length
+  // PACKED_MISSING for missing keys) if the keys came in packed.
+  Napi::Value Result(Napi::Env env) const
+  {
+    size_t count = Count();
+    if (packed)
+    {
+      size_t total = count * 4 + values.size();
+      Napi::Buffer<uint8_t> buffer = Napi::Buffer<uint8_t>::New(env, total);
+      uint8_t *out = buffer.Data();
+      for (size_t i = 0; i < count; i++)
+      {
+        if (!found[i])
+        {
+          WriteU32LE(out, PACKED_MISSING);
+          out += 4;
+          continue;
+        }
+        WriteU32LE(out, (uint32_t)valueLengths[i]);
+        std::memcpy(out + 4, values.data() + valueOffsets[i], valueLengths[i]);
+        out += 4 + valueLengths[i];
+      }
+      return buffer;
+    }
+
+    Napi::Array result = Napi::Array::New(env, count);
+    for (size_t i = 0; i < count; i++)
+    {
+      if (!found[i])
+      {
+        continue;
+      }
+      if (valueFormat)
+      {
+        FieldBuffer buffer;
+        buffer.format = valueFormat;
+        buffer.fields = valueFields[i];
+        result.Set((uint32_t)i, buffer.ToJs(env));
+      }
+      else
+      {
+        result.Set((uint32_t)i, Napi::String::New(env, values.data() + valueOffsets[i], valueLengths[i]));
+      }
+    }
+    return result;
+  }
+
+private:
+  // Replaces typed keys (JS values, or a packed buffer's field bytes) with
+  // their packed form
+  int PackKeys(WT_SESSION *session)
+  {
+    if (!keyFormat || keysPacked)
+    {
+      return 0;
+    }
+    keysPacked = true;
+    std::string arena, field;
+    std::vector<size_t> offsets{0};
+    size_t count = packed ? Count() : keyFields.size();
+    for (size_t i = 0; i < count; i++)
+    {
+      int ret = packed ? PackBytes(session, keyFormat, keys.data() + keyOffsets[i], keyOffsets[i + 1] - keyOffsets[i], field)
+                       : keyFormat->Pack(session, keyFields[i], field);
+      if (ret != 0)
+      {
+        return ret;
+      }
+      arena.append(field);
+      offsets.push_back(arena.size());
+    }
+    keys.swap(arena);
+    keyOffsets.swap(offsets);
+    keyFields.clear();
+    return 0;
+  }
+
+  // Keeps a typed value: its field's bytes for a packed result, its fields
+  // for an array
+  int UnpackValue(WT_SESSION *session, const WT_ITEM &item, size_t i)
+  {
+    if (!packed)
+    {
+      return valueFormat->Unpack(session, item, valueFields[i]);
+    }
+    std::vector<RecordFormat::Value> fields;
+    int ret = valueFormat->Unpack(session, item, fields);
+    if (ret == 0)
+    {
+      valueOffsets[i] = values.size();
+      valueLengths[i] = fields[0].bytes.size();
+      values.append(fields[0].bytes);
+    }
+    return ret;
+  }
+};
+
+// cursor.getManyAsync(keys)
+class CursorMultiGetWorker : public SessionWorker
+{
+public:
+  CursorMultiGetWorker(Napi::Env env, std::shared_ptr<SessionState> state, Napi::Object owner, WT_CURSOR *cursor)
+      : SessionWorker(env, "WiredTigerCursor.getManyAsync", std::move(state), owner), cursor_(cursor)
+  {
+  }
+
+  MultiGetBatch batch;
+
+protected:
+  void Execute() override
+  {
+    int ret = batch.Run(cursor_);
+    if (ret != 0)
+    {
+      SetError("getMany failed: " + std::string(wiredtiger_strerror(ret)));
+    }
+  }
+
+  Napi::Value Result(Napi::Env env) override
+  {
+    return batch.Result(env);
+  }
+
+private:
+  WT_CURSOR *cursor_;
+};
+
+// Applies a cursor write and updates the table's field indexes in the same
+// transaction, opening one unless the caller already has
+static int WriteWithIndexes(WT_SESSION *session, WT_CURSOR *cursor, const field_index::DefinitionList &indexes, bool remove,
+                            int (*op)(WT_CURSOR *), const WT_ITEM &key, const WT_ITEM *value, bool inTransaction)
+{
+  if (inTransaction)
+  {
+    return field_index::Write(session, cursor, indexes, remove, op, key, value);
+  }
+
+  int ret = session->begin_transaction(session, nullptr);
+  if (ret != 0)
+  {
+    return ret;
+  }
+  ret = field_index::Write(session, cursor, indexes, remove, op, key, value);
+  if (ret != 0)
+  {
+    session->rollback_transaction(session, nullptr);
+    return ret;
+  }
+  return session->commit_transaction(session, nullptr);
+}
+
+// Writes for putMany()/removeMany(). Records are [uint32 LE length][bytes]
+// fields: key/value pairs for puts, bare keys for removes. Sync calls read
+// straight out of the caller's buffer; async calls copy it into `owned`.
+struct WriteBatch
+{
+  bool remove = false;
+  bool bulk = false;
+  bool usedBulk = false;
+  // Field indexes on the table; batches on indexed tables never go bulk
+  std::shared_ptr<const field_index::DefinitionList> indexes;
+  std::string owned;
+  const char *base = nullptr;
+  std::vector<size_t> keyOffsets, keyLengths, valueOffsets, valueLengths;
+  std::vector<int32_t> statuses;
+  // Typed formats of the table, null for raw columns; set before Parse().
+  // Typed records are packed by Run(), on the thread that owns the session.
+  std::shared_ptr<const RecordFormat> keyFormat, valueFormat;
+  std::vector<std::vector<RecordFormat::Value>> keyFields;
+  bool recordsPacked = false;
+
+  size_t Count() const
+  {
+    return keyOffsets.size();
+  }
+
+  // Invalidates the batch's keys in the read cache (at commit, inside a
+  // transaction). Called whether or not Run() succeeded, as a failure may
+  // leave earlier writes in the caller's transaction.
+  void NoteCacheWrites(SessionState &state, const char *uri) const
+  {
+    std::string cacheKey;
+    for (size_t i = 0; i < Count(); i++)
+    {
+      ReadCache::Key(uri, base + keyOffsets[i], keyLengths[i], cacheKey);
+      NoteCacheWrite(state, cacheKey);
+    }
+  }
+
+  // Parses a packed buffer (or, for removes, an array of key strings). Throws
+  // and returns false on malformed input.
+  bool Parse(Napi::Env env, Napi::Value input, bool copy)
+  {
+    if (remove && input.IsArray())
+    {
+      Napi::Array array = input.As<Napi::Array>();
+      uint32_t length = array.Length();
+      for (uint32_t i = 0; i < length; i++)
+      {
+        Napi::Value key = array.Get(i);
+        if (keyFormat)
+        {
+          FieldBuffer buffer;
+          buffer.format = keyFormat;
+          if (!buffer.Read(env, key, "Key"))
+          {
+            return false;
+          }
+          keyFields.push_back(std::move(buffer.fields));
+          continue;
+        }
+        if (!key.IsString())
+        {
+          Napi::TypeError::New(env, "Key strings expected").ThrowAsJavaScriptException();
+          return false;
+        }
+        keyOffsets.push_back(owned.size());
+        keyLengths.push_back(AppendUtf8(env, key, owned));
+      }
+      base = owned.data();
+      return true;
+    }
+
+    const uint8_t *data;
+    size_t length;
+    if (!GetBytes(input, data, length))
+    {
+      Napi::TypeError::New(env, remove ? "Array of keys or packed key buffer expected" : "Packed batch buffer expected")
+          .ThrowAsJavaScriptException();
+      return false;
+    }
+    if (!BytesFormat(keyFormat) || (!remove && !BytesFormat(valueFormat)))
+    {
+      Napi::TypeError::New(env, remove ? "Packed key buffers need string or byte keys; pass an array of keys"
+                                       : "Packed batches need string or byte keys and values")
+          .ThrowAsJavaScriptException();
+      return false;
+    }
+
+    if (copy)
+    {
+      owned.assign(reinterpret_cast<const char *>(data), length);
+      base = owned.data();
+    }
+    else
+    {
+      base = reinterpret_cast<const char *>(data);
+    }
+
+    size_t pos = 0;
+    while (pos < length)
+    {
+      for (int field = 0; field < (remove ? 1 : 2); field++)
+      {
+        if (length - pos < 4 || length - pos - 4 < ReadU32LE(data + pos))
+        {
+          Napi::RangeError::New(env, "Malformed packed batch buffer").ThrowAsJavaScriptException();
+          return false;
+        }
+        uint32_t size = ReadU32LE(data + pos);
+        (field == 0 ? keyOffsets : valueOffsets).push_back(pos + 4);
+        (field == 0 ? keyLengths : valueLengths).push_back(size);
+        pos += 4 + size;
+      }
+    }
+    return true;
+  }
+
+  // Applies the batch inside one transaction (the caller's, if one is
+  // running). Per-item WT_DUPLICATE_KEY/WT_NOTFOUND results are recorded in
+  // `statuses`; any other error rolls back our transaction and is returned.
+  int Run(WT_SESSION *session, WT_CURSOR *&cursor, const std::string &uri, const std::string &config, bool inTransaction)
+  {
+    int ret = PackRecords(session);
+    if (ret != 0)
+    {
+      return ret;
+    }
+    statuses.assign(Count(), 0);
+
+    if (bulk && !remove && !inTransaction && !indexes)
+    {
+      ret = TryBulk(session, cursor, uri, config);
+      if (ret != EBUSY)
+      {
+        return ret;
+      }
+    }
+
+    bool ownTransaction = !inTransaction;
+    if (ownTransaction)
+    {
+      ret = session->begin_transaction(session, nullptr);
+      if (ret != 0)
+      {
+        return ret;
+      }
+    }
+
+    for (size_t i = 0; i < Count(); i++)
+    {
+      WT_ITEM key_item;
+      key_item.data = base + keyOffsets[i];
+      key_item.size = keyLengths[i];
+      cursor->set_key(cursor, &key_item);
+
+      WT_ITEM value_item;
+      if (!remove)
+      {
+        value_item.data = base + valueOffsets[i];
+        value_item.size = valueLengths[i];
+      }
+      if (indexes)
+      {
+        ret = field_index::Write(session, cursor, *indexes, remove, remove ? cursor->remove : cursor->insert,
+                                 key_item, remove ? nullptr : &value_item);
+      }
+      else if (remove)
+      {
+        ret = cursor->remove(cursor);
+      }
+      else
+      {
+        cursor->set_value(cursor, &value_item);
+        ret = cursor->insert(cursor);
+      }
+
+      if (ret == WT_DUPLICATE_KEY || ret == WT_NOTFOUND)
+      {
+        statuses[i] = ret;
+      }
+      else if (ret != 0)
+      {
+        cursor->reset(cursor);
+        if (ownTransaction)
+        {
+          session->rollback_transaction(session, nullptr);
+        }
+        return ret;
+      }
+    }
+
+    cursor->reset(cursor);
+    return ownTransaction ? session->commit_transaction(session, nullptr) : 0;
+  }
+
+private:
+  // Replaces typed keys (JS values, or a packed buffer's field bytes) and
+  // values with their packed form
+  int PackRecords(WT_SESSION *session)
+  {
+    if ((!keyFormat && (remove || !valueFormat)) || recordsPacked)
+    {
+      return 0;
+    }
+    recordsPacked = true;
+    bool fromFields = remove && !keyFields.empty();
+    size_t count = fromFields ? keyFields.size() : Count();
+    std::string arena, field;
+    std::vector<size_t> offsets, lengths, packedValueOffsets, packedValueLengths;
+    for (size_t i = 0; i < count; i++)
+    {
+      int ret = fromFields ? keyFormat->Pack(session, keyFields[i], field)
+                           : PackBytes(session, keyFormat, base + keyOffsets[i], keyLengths[i], field);
+      if (ret != 0)
+      {
+        return ret;
+      }
+      offsets.push_back(arena.size());
+      lengths.push_back(field.size());
+      arena.append(field);
+      if (!remove)
+      {
+        if ((ret = PackBytes(session, valueFormat, base + valueOffsets[i], valueLengths[i], field)) != 0)
+        {
+          return ret;
+        }
+        packedValueOffsets.push_back(arena.size());
+        packedValueLengths.push_back(field.size());
+        arena.append(field);
+      }
+    }
+    owned.swap(arena);
+    base = owned.data();
+    keyOffsets.swap(offsets);
+    keyLengths.swap(lengths);
+    valueOffsets.swap(packedValueOffsets);
+    valueLengths.swap(packedValueLengths);
+    keyFields.clear();
+    return 0;
+  }
+
+  bool KeyLess(size_t a, size_t b) const
+  {
+    int cmp = std::memcmp(base + keyOffsets[a], base + keyOffsets[b], std::min(keyLengths[a], keyLengths[b]));
+    return cmp != 0 ? cmp < 0 : keyLengths[a] < keyLengths[b];
+  }
+
+  // Loads an empty table through a bulk cursor. Bulk cursors need exclusive
+  // access to the table, so the caller's cursor is closed for the duration
+  // and reopened with its original config afterwards. Returns EBUSY when a
+  // bulk load isn't possible (table not empty, or other handles open on it)
+  // so the caller falls back to a transaction. A bulk load is not atomic.
+  int TryBulk(WT_SESSION *session, WT_CURSOR *&cursor, const std::string &uri, const std::string &config)
+  {
+    cursor->reset(cursor);
+    int ret = cursor->next(cursor);
+    cursor->reset(cursor);
+    if (ret == 0)
+    {
+      return EBUSY;
+    }
+    if (ret != WT_NOTFOUND)
+    {
+      return ret;
+    }
+
+    // Bulk inserts must arrive in key order; for duplicate keys the last
+    // one in the batch wins, as it would with overwriting inserts
+    std::vector<size_t> order(Count());
+    for (size_t i = 0; i < order.size(); i++)
+    {
+      order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b)
+                     { return KeyLess(a, b); });
+
+    cursor->close(cursor);
+    cursor = nullptr;
+
+    WT_CURSOR *bulkCursor;
+    ret = session->open_cursor(session, uri.c_str(), nullptr, "bulk,raw", &bulkCursor);
+    if (ret == 0)
+    {
+      for (size_t n = 0; n < order.size() && ret == 0; n++)
+      {
+        size_t i = order[n];
+        if (n + 1 < order.size() && !KeyLess(i, order[n + 1]))
+        {
+          continue;
+        }
+
+        WT_ITEM key_item, value_item;
+        key_item.data = base + keyOffsets[i];
+        key_item.size = keyLengths[i];
+        value_item.data = base + valueOffsets[i];
+        value_item.size = valueLengths[i];
+        bulkCursor->set_key(bulkCursor, &key_item);
+        bulkCursor->set_value(bulkCursor, &value_item);
+        ret = bulkCursor->insert(bulkCursor);
+      }
+
+      int closeRet = bulkCursor->close(bulkCursor);
+      if (ret == 0)
+      {
+        ret = closeRet;
+      }
+      usedBulk = ret == 0;
+    }
+
+    int reopenRet = session->open_cursor(session, uri.c_str(), nullptr, config.empty() ? nullptr : config.c_str(), &cursor);
+    if (reopenRet != 0)
+    {
+      cursor = nullptr;
+      return ret != 0 && ret != EBUSY ? ret : reopenRet;
+    }
+    return ret;
+  }
+};
+
+static Napi::Value StatusArray(Napi::Env env, const std::vector<int32_t> &statuses)
+{
+  Napi::Int32Array result = Napi::Int32Array::New(env, statuses.size(), napi_int32_array);
+  if (!statuses.empty())
+  {
+    std::memcpy(result.Data(), statuses.data(), statuses.size() * sizeof(int32_t));
+  }
+  return result;
+}
+
+// cursor.putManyAsync(batch, options) / cursor.removeManyAsync(keys)
+class CursorWriteBatchWorker : public SessionWorker
+{
+public:
+  CursorWriteBatchWorker(Napi::Env env, std::shared_ptr<SessionState> state, Napi::Object owner, WT_CURSOR **cursor,
+                         std::string uri, std::string config)
+      : SessionWorker(env, "WiredTigerCursor.writeManyAsync", std::move(state), owner),
+        cursor_(cursor), uri_(std::move(uri)), config_(std::move(config))
+  {
+  }
+
+  WriteBatch batch;
+  bool readCacheable = false;
+
+protected:
+  void Execute() override
+  {
+    int ret = batch.Run(state_->session, *cursor_, uri_, config_, state_->inTransaction);
+    if (readCacheable)
+    {
+      batch.NoteCacheWrites(*state_, uri_.c_str());
+    }
+    if (ret != 0)
+    {
+      SetError(std::string(batch.remove ? "removeMany" : "putMany") + " failed: " + wiredtiger_strerror(ret));
+    }
+  }
+
+  Napi::Value Result(Napi::Env env) override
+  {
+    return StatusArray(env, batch.statuses);
+  }
+
+private:
+  // Points at the wrapper's cursor_, which a bulk load reopens
+  WT_CURSOR **cursor_;
+  std::string uri_;
+  std::string config_;
+};
+
+// Byte-wise key comparison, matching WiredTiger's default collation
+static inline int CompareKey(const WT_ITEM &key, const std::string &bound)
+{
+  int cmp = std::memcmp(key.data, bound.data(), std::min(key.size, bound.size()));
+  if (cmp != 0)
+  {
+    return cmp;
+  }
+  return key.size < bound.size() ? -1 : key.size > bound.size() ? 1 : 0;
+}
+
+// Reads an optional string/buffer key from an options object
+static bool ReadKeyOption(Napi::Env env, Napi::Object options, const char *name, std::string &out)
+{
+  if (!options.Has(name))
+  {
+    return false;
+  }
+  Napi::Value value = options.Get(name);
+  if (value.IsString())
+  {
+    out.clear();
+    AppendUtf8(env, value, out);
+    return true;
+  }
+  if (value.IsArray())
+  {
+    out.clear();
+    return EncodeKeyParts(env, value.As<Napi::Array>(), out);
+  }
+  const uint8_t *data;
+  size_t length;
+  if (GetBytes(value, data, length))
+  {
+    out.assign(reinterpret_cast<const char *>(data), length);
+    return true;
+  }
+  return false;
+}
+
+// Encodes a JS scalar the way field_index encodes the JSON field it would
+// be compared with
+static bool EncodeFieldValue(Napi::Value value, std::string &out)
+{
+  if (value.IsNull())
+  {
+    field_index::EncodeNull(out);
+  }
+  else if (value.IsBoolean())
+  {
+    field_index::EncodeBool(out, value.As<Napi::Boolean>().Value());
+  }
+  else if (value.IsNumber())
+  {
+    field_index::EncodeNumber(out, value.As<Napi::Number>().DoubleValue());
+  }
+  else if (value.IsString())
+  {
+    field_index::EncodeString(out, value.As<Napi::String>().Utf8Value());
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+}
+
+static bool CompileFilterOperand(Napi::Env env, const std::string &op, Napi::Value value, doc_filter::Node &node)
+{
+  node.values.emplace_back();
+  if (!EncodeFieldValue(value, node.values.back()))
+  {
+    Napi::TypeError::New(env, "String, number, boolean or null expected for " + op).ThrowAsJavaScriptException();
+    return false;
+  }
+  return true;
+}
+
+// One field's condition: a scalar (shorthand for $eq) or an object of
+// operators, each of which becomes a node of its own
+static bool CompileFieldFilter(Napi::Env env, const std::vector<std::string> &path, Napi::Value input,
+                               std::vector<doc_filter::Node> &out)
+{
+  if (!input.IsObject())
+  {
+    out.emplace_back();
+    out.back().op = doc_filter::EQ;
+    out.back().path = path;
+    return CompileFilterOperand(env, "$eq", input, out.back());
+  }
+  if (input.IsArray())
+  {
+    Napi::TypeError::New(env, "Use $in to match a field against several values").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  static const std::map<std::string, doc_filter::Op> operators = {
+      {"$eq", doc_filter::EQ}, {"$ne", doc_filter::NE}, {"$gt", doc_filter::GT}, {"$gte", doc_filter::GTE}, {"$lt", doc_filter::LT}, {"$lte", doc_filter::LTE}, {"$in", doc_filter::IN}, {"$nin", doc_filter::NIN}, {"$exists", doc_filter::EXISTS}};
+
+  Napi::Object conditions = input.As<Napi::Object>();
+  Napi::Array names = conditions.GetPropertyNames();
+  if (names.Length() == 0)
+  {
+    Napi::TypeError::New(env, "Empty filter condition").ThrowAsJavaScriptException();
+    return false;
+  }
+  for (uint32_t i = 0; i < names.Length(); i++)
+  {
+    std::string name = names.Get(i).As<Napi::String>().Utf8Value();
+    auto op = operators.find(name);
+    if (op == operators.end())
+    {
+      Napi::TypeError::New(env, "Unknown filter operator '" + name + "'").ThrowAsJavaScriptException();
+      return false;
+    }
+
+    Napi::Value operand = conditions.Get(name);
+    out.emplace_back();
+    doc_filter::Node &node = out.back();
+    node.op = op->second;
+    node.path = path;
+    if (node.op == doc_filter::EXISTS)
+    {
+      node.exists = operand.ToBoolean().Value();
+    }
+    else if (node.op == doc_filter::IN || node.op == doc_filter::NIN)
+    {
+      if (!operand.IsArray())
+      {
+        Napi::TypeError::New(env, "Array expected for " + name).ThrowAsJavaScriptException();
+        return false;
+      }
+      Napi::Array list = operand.As<Napi::Array>();
+      for (uint32_t j = 0; j < list.Length(); j++)
+      {
+        if (!CompileFilterOperand(env, name, list.Get(j), node))
+        {
+          return false;
+        }
+      }
+    }
+    else if (!CompileFilterOperand(env, name, operand, node))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Compiles a filter object into `node`, an AND of its entries. Throws and
+// returns false on bad input.
+static bool CompileFilter(Napi::Env env, Napi::Value input, doc_filter::Node &node)
+{
+  if (!input.IsObject() || input.IsArray())
+  {
+    Napi::TypeError::New(env, "Filter object expected").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  node.op = doc_filter::AND;
+  Napi::Object filter = input.As<Napi::Object>();
+  Napi::Array names = filter.GetPropertyNames();
+  for (uint32_t i = 0; i < names.Length(); i++)
+  {
+    std::string name = names.Get(i).As<Napi::String>().Utf8Value();
+    Napi::Value value = filter.Get(name);
+
+    if (name == "$and" || name == "$or" || name == "$nor")
+    {
+      if (!value.IsArray() || value.As<Napi::Array>().Length() == 0)
+      {
+        Napi::TypeError::New(env, "Non-empty array of filters expected for " + name).ThrowAsJavaScriptException();
+        return false;
+      }
+      Napi::Array list = value.As<Napi::Array>();
+      doc_filter::Node group;
+      group.op = name == "$and" ? doc_filter::AND : name == "$or" ? doc_filter::OR : doc_filter::NOR;
+      group.children.resize(list.Length());
+      for (uint32_t j = 0; j < list.Length(); j++)
+      {
+        if (!CompileFilter(env, list.Get(j), group.children[j]))
+        {
+          return false;
+        }
+      }
+      node.children.push_back(std::move(group));
+      continue;
+    }
+
+    std::vector<std::string> path;
+    if (name[0] == '$' || !field_index::ParsePath(name, path))
+    {
+      Napi::TypeError::New(env, "Invalid filter field '" + name + "'").ThrowAsJavaScriptException();
+      return false;
+    }
+    if (!CompileFieldFilter(env, path, value, node.children))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Chunked range scan (scanStart/scanFill). Each fill copies as many records
+// as fit into the caller's buffer as [uint32 LE key length][key][uint32 LE
+// value length][value], so a scan costs one native call per chunk instead
+// of a JS object and two strings per row.
+struct RangeScan
+{
+  std::string lower, upper;
+  bool hasLower = false, hasUpper = false;
+  bool lowerInclusive = true, upperInclusive = true;
+  bool reverse = false;
+  uint64_t remaining = UINT64_MAX;
+  bool positioned = false;
+  // The range is enforced by WT_CURSOR::bound rather than by comparing keys
+  bool bounded = false;
+  // The cursor sits on a record that didn't fit into the previous chunk
+  bool pending = false;
+  bool done = false;
+
+  // Only records whose (JSON) value matches are returned; see doc_filter.h
+  std::shared_ptr<const doc_filter::Node> filter;
+
+  // On typed tables, bounds given as JS values are packed through the key
+  // format by PackBounds(), on the thread that uses the cursor. Byte bounds
+  // are taken as packed keys.
+  std::shared_ptr<const RecordFormat> keyFormat;
+  std::vector<RecordFormat::Value> lowerFields, upperFields;
+  bool lowerTyped = false, upperTyped = false;
+
+  // Results of the last Fill()
+  uint32_t count = 0;
+  size_t used = 0;
+  size_t needed = 0;
+
+  // Parses { gt, gte, lt, lte, reverse, limit, filter }. Throws and returns
+  // false on bad input.
+  bool Parse(Napi::Env env, Napi::Value input, std::shared_ptr<const RecordFormat> format = nullptr)
+  {
+    *this = RangeScan();
+    keyFormat = std::move(format);
+    if (input.IsUndefined() || input.IsNull())
+    {
+      return true;
+    }
+    if (!input.IsObject())
+    {
+      Napi::TypeError::New(env, "Scan options object expected").ThrowAsJavaScriptException();
+      return false;
+    }
+
+    Napi::Object options = input.As<Napi::Object>();
+    if (ReadBound(env, options, "gte", lower, lowerFields, lowerTyped))
+    {
+      hasLower = true;
+    }
+    else if (ReadBound(env, options, "gt", lower, lowerFields, lowerTyped))
+    {
+      hasLower = true;
+      lowerInclusive = false;
+    }
+    if (ReadBound(env, options, "lte", upper, upperFields, upperTyped))
+    {
+      hasUpper = true;
+    }
+    else if (ReadBound(env, options, "lt", upper, upperFields, upperTyped))
+    {
+      hasUpper = true;
+      upperInclusive = false;
+    }
+
+    if (env.IsExceptionPending())
+    {
+      return false;
+    }
+
+    Napi::Value reverseOpt = options.Get("reverse");
+    reverse = reverseOpt.IsBoolean() && reverseOpt.As<Napi::Boolean>().Value();
+
+    Napi::Value limit = options.Get("limit");
+    if (limit.IsNumber() && limit.As<Napi::Number>().Int64Value() >= 0)
+    {
+      remaining = (uint64_t)limit.As<Napi::Number>().Int64Value();
+    }
+
+    Napi::Value filterOpt = options.Get("filter");
+    if (!filterOpt.IsUndefined() && !filterOpt.IsNull())
+    {
+      auto node = std::make_shared<doc_filter::Node>();
+      if (!CompileFilter(env, filterOpt, *node))
+      {
+        return false;
+      }
+      filter = node;
+    }
+    return true;
+  }
+
+  int PackBounds(WT_SESSION *session)
+  {
+    int ret = 0;
+    if (lowerTyped && (ret = keyFormat->Pack(session, lowerFields, lower)) == 0)
+    {
+      lowerTyped = false;
+    }
+    if (ret == 0 && upperTyped && (ret = keyFormat->Pack(session, upperFields, upper)) == 0)
+    {
+      upperTyped = false;
+    }
+    return ret;
+  }
+
+  int Fill(WT_CURSOR *cursor, uint8_t *out, size_t capacity)
+  {
+    count = 0;
+    used = 0;
+    needed = 0;
+    std::string scratch;
+
+    while (!done)
+    {
+      if (remaining == 0)
+      {
+        done = true;
+        break;
+      }
+
+      int ret;
+      if (!pending)
+      {
+        ret = positioned ? Step(cursor) : Position(cursor);
+        positioned = true;
+        if (ret == WT_NOTFOUND)
+        {
+          done = true;
+          break;
+        }
+        if (ret != 0)
+        {
+          return ret;
+        }
+        pending = true;
+      }
+
+      WT_ITEM key_item, value_item;
+      if ((ret = cursor->get_key(cursor, &key_item)) != 0 || (ret = cursor->get_value(cursor, &value_item)) != 0)
+      {
+        return ret;
+      }
+      if (PastEnd(key_item))
+      {
+        done = true;
+        break;
+      }
+      if (filter && !filter->Matches((const char *)value_item.data, value_item.size, scratch))
+      {
+        // Skipped records don't count towards the limit
+        pending = false;
+        continue;
+      }
+
+      size_t size = 8 + key_item.size + value_item.size;
+      if (capacity - used < size)
+      {
+        if (count == 0)
+        {
+          needed = size;
+        }
+        break;
+      }
+
+      uint8_t *p = out + used;
+      WriteU32LE(p, (uint32_t)key_item.size);
+      std::memcpy(p + 4, key_item.data, key_item.size);
+      p += 4 + key_item.size;
+      WriteU32LE(p, (uint32_t)value_item.size);
+      std::memcpy(p + 4, value_item.data, value_item.size);
+
+      used += size;
+      count++;
+      remaining--;
+      pending = false;
+    }
+
+    if (done)
+    {
+      // Don't keep the last page pinned once the scan is over; also drops
+      // the bounds
+      cursor->reset(cursor);
+    }
+    return 0;
+  }
+
+  // Counts the (matching) records of the range without copying them out
+  int Count(WT_CURSOR *cursor, uint64_t &out)
+  {
+    out = 0;
+    std::string scratch;
+    int ret;
+    for (ret = Position(cursor); ret == 0 && out < remaining; ret = Step(cursor))
+    {
+      WT_ITEM key_item;
+      if ((ret = cursor->get_key(cursor, &key_item)) != 0)
+      {
+        break;
+      }
+      if (PastEnd(key_item))
+      {
+        break;
+      }
+      if (filter)
+      {
+        WT_ITEM value_item;
+        if ((ret = cursor->get_value(cursor, &value_item)) != 0)
+        {
+          break;
+        }
+        if (!filter->Matches((const char *)value_item.data, value_item.size, scratch))
+        {
+          continue;
+        }
+      }
+      out++;
+    }
+    cursor->reset(cursor);
+    return ret == WT_NOTFOUND ? 0 : ret;
+  }
+
+private:
+  int Step(WT_CURSOR *cursor)
+  {
+    return reverse ? cursor->prev(cursor) : cursor->next(cursor);
+  }
+
+  bool ReadBound(Napi::Env env, Napi::Object options, const char *name, std::string &out,
+                 std::vector<RecordFormat::Value> &fields, bool &typed)
+  {
+    const uint8_t *data;
+    size_t length;
+    if (!keyFormat || !options.Has(name) || GetBytes(options.Get(name), data, length))
+    {
+      return ReadKeyOption(env, options, name, out);
+    }
+    FieldBuffer buffer;
+    buffer.format = keyFormat;
+    if (!buffer.Read(env, options.Get(name), "Bound"))
+    {
+      return false;
+    }
+    fields = std::move(buffer.fields);
+    typed = true;
+    return true;
+  }
+
+  // Moves onto the first record of the range. Bounding the cursor lets
+  // WiredTiger stop at the end of the range (and skip pages outside it);
+  // cursors that can't be bounded seek and compare keys instead.
+  int Position(WT_CURSOR *cursor)
+  {
+    int ret = PackBounds(cursor->session);
+    if (ret != 0)
+    {
+      return ret;
+    }
+    if ((hasLower || hasUpper) && cursor->reset(cursor) == 0 &&
+        field_index::SetBounds(cursor, hasLower ? &lower : nullptr, lowerInclusive, hasUpper ? &upper : nullptr,
+                               upperInclusive) == 0)
+    {
+      bounded = true;
+      return Step(cursor);
+    }
+
+    const std::string &bound = reverse ? upper : lower;
+    bool hasBound = reverse ? hasUpper : hasLower;
+    bool inclusive = reverse ? upperInclusive : lowerInclusive;
+    if (!hasBound)
+    {
+      return Step(cursor);
+    }
+
+    WT_ITEM key_item;
+    key_item.data = bound.data();
+    key_item.size = bound.size();
+    cursor->set_key(cursor, &key_item);
+
+    int exact;
+    ret = cursor->search_near(cursor, &exact);
+    if (ret != 0)
+    {
+      return ret;
+    }
+    // search_near may land on either side of the bound; step into the range
+    bool outside = reverse ? exact > 0 : exact < 0;
+    if (outside || (exact == 0 && !inclusive))
+    {
+      ret = Step(cursor);
+    }
+    return ret;
+  }
+
+  bool PastEnd(const WT_ITEM &key) const
+  {
+    if (bounded)
+    {
+      return false;
+    }
+    if (reverse)
+    {
+      if (!hasLower)
+      {
+        return false;
+      }
+      int cmp = CompareKey(key, lower);
+      return lowerInclusive ? cmp < 0 : cmp <= 0;
+    }
+    if (!hasUpper)
+    {
+      return false;
+    }
+    int cmp = CompareKey(key, upper);
+    return upperInclusive ? cmp > 0 : cmp >= 0;
+  }
+};
+
+static Napi::Value ScanFillResult(Napi::Env env, const RangeScan &scan)
+{
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("count", Napi::Number::New(env, scan.count));
+  result.Set("bytes", Napi::Number::New(env, (double)scan.used));
+  result.Set("done", Napi::Boolean::New(env, scan.done));
+  result.Set("needed", Napi::Number::New(env, (double)scan.needed));
+  return result;
+}
+
+// cursor.scanFillAsync(buffer)
+class CursorScanWorker : public SessionWorker
+{
+public:
+  CursorScanWorker(Napi::Env env, std::shared_ptr<SessionState> state, Napi::Object owner, WT_CURSOR *cursor,
+                   RangeScan *scan, Napi::Object buffer, uint8_t *data, size_t capacity)
+      : SessionWorker(env, "WiredTigerCursor.scanFillAsync", std::move(state), owner),
+        cursor_(cursor), scan_(scan), data_(data), capacity_(capacity)
+  {
+    buffer_ = Napi::Persistent(buffer);
+  }
+
+protected:
+  void Execute() override
+  {
+    int ret = scan_->Fill(cursor_, data_, capacity_);
+    if (ret != 0)
+    {
+      SetError("Scan failed: " + std::string(wiredtiger_strerror(ret)));
+    }
+  }
+
+  Napi::Value Result(Napi::Env env) override
+  {
+    return ScanFillResult(env, *scan_);
+  }
+
+private:
+  WT_CURSOR *cursor_;
+  RangeScan *scan_;
+  // Keeps the destination buffer alive while the worker writes into it
+  Napi::ObjectReference buffer_;
+  uint8_t *data_;
+  size_t capacity_;
+};
+
+// cursor.countAsync(range)
+class CursorCountWorker : public SessionWorker
+{
+public:
+  CursorCountWorker(Napi::Env env, std::shared_ptr<SessionState> state, Napi::Object owner, WT_CURSOR *cursor,
+                    RangeScan range)
+      : SessionWorker(env, "WiredTigerCursor.countAsync", std::move(state), owner), cursor_(cursor),
+        range_(std::move(range))
+  {
+  }
+
+protected:
+  void Execute() override
+  {
+    int ret = range_.Count(cursor_, count_);
+    if (ret != 0)
+    {
+      SetError("Count failed: " + std::string(wiredtiger_strerror(ret)));
+    }
+  }
+
+  Napi::Value Result(Napi::Env env) override
+  {
+    return Napi::Number::New(env, (double)count_);
+  }
+
+private:
+  WT_CURSOR *cursor_;
+  RangeScan range_;
+  uint64_t count_ = 0;
+};
+
+// cursor.searchAsync(key)
+class CursorSearchWorker : public SessionWorker
+{
+public:
+  CursorSearchWorker(Napi::Env env, std::shared_ptr<SessionState> state, Napi::Object owner, WT_CURSOR *cursor,
+                     FieldBuffer key, FieldBuffer value)
+      : SessionWorker(env, "WiredTigerCursor.searchAsync", std::move(state), owner), cursor_(cursor),
+        key_(std::move(key)), value_(std::move(value)), found_(false)
+  {
+  }
+
+protected:
+  void Execute() override
+  {
+    int ret = key_.Pack(cursor_->session);
+    if (ret == 0)
+    {
+      WT_ITEM key_item = key_.Item();
+      cursor_->set_key(cursor_, &key_item);
+      ret = cursor_->search(cursor_);
+    }
+    if (ret == 0)
+    {
+      WT_ITEM value_item;
+      cursor_->get_value(cursor_, &value_item);
+      ret = value_.Unpack(cursor_->session, value_item);
+      found_ = ret == 0;
+    }
+    if (ret != 0 && ret != WT_NOTFOUND)
+    {
+      SetError("Search failed: " + std::string(wiredtiger_strerror(ret)));
+    }
+  }
+
+  Napi::Value Result(Napi::Env env) override
+  {
+    if (!found_)
+    {
+      return env.Null();
+    }
+    return value_.ToJs(env);
+  }
+
+private:
+  WT_CURSOR *cursor_;
+  FieldBuffer key_;
+  FieldBuffer value_;
+  bool found_;
+};
+
+// cursor.nextAsync() / cursor.prevAsync()
+class CursorStepWorker : public SessionWorker
+{
+public:
+  CursorStepWorker(Napi::Env env, std::shared_ptr<SessionState> state, Napi::Object owner, WT_CURSOR *cursor, bool forward,
+                   FieldBuffer key, FieldBuffer value)
+      : SessionWorker(env, forward ? "WiredTigerCursor.nextAsync" : "WiredTigerCursor.prevAsync", std::move(state), owner),
+        cursor_(cursor), forward_(forward), key_(std::move(key)), value_(std::move(value)), found_(false)
+  {
+  }
+
+protected:
+  void Execute() override
+  {
+    int ret = forward_ ? cursor_->next(cursor_) : cursor_->prev(cursor_);
+    if (ret == 0)
+    {
+      WT_ITEM key_item, value_item;
+      cursor_->get_key(cursor_, &key_item);
+      cursor_->get_value(cursor_, &value_item);
+      ret = key_.Unpack(cursor_->session, key_item);
+      if (ret == 0)
+      {
+        ret = value_.Unpack(cursor_->session, value_item);
+      }
+      found_ = ret == 0;
+    }
+    if (ret != 0 && ret != WT_NOTFOUND)
+    {
+      SetError(std::string(forward_ ? "Next" : "Prev") + " failed: " + wiredtiger_strerror(ret));
+    }
+  }
+
+  Napi::Value Result(Napi::Env env) override
+  {
+    if (!found_)
+    {
+      return env.Null();
+    }
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("key", key_.ToJs(env));
+    result.Set("value", value_.ToJs(env));
+    return result;
+  }
+
+private:
+  WT_CURSOR *cursor_;
+  bool forward_;
+  FieldBuffer key_;
+  FieldBuffer value_;
+  bool found_;
+};
+
+// cursor.insertAsync(key, value) / updateAsync(key, value) / removeAsync(key)
+class CursorWriteWorker : public SessionWorker
+{
+public:
+  enum Op
+  {
+    INSERT,
+    UPDATE,
+    REMOVE
+  };
+
+  CursorWriteWorker(Napi::Env env, std::shared_ptr<SessionState> state, Napi::Object owner, WT_CURSOR *cursor,
+                    Op op, FieldBuffer key, FieldBuffer value, std::shared_ptr<const field_index::DefinitionList> indexes,
+                    bool readCacheable)
+      : SessionWorker(env, "WiredTigerCursor.writeAsync", std::move(state), owner),
+        cursor_(cursor), op_(op), key_(std::move(key)), value_(std::move(value)), indexes_(std::move(indexes)),
+        readCacheable_(readCacheable)
+  {
+  }
+
+protected:
+  void Execute() override
+  {
+    int ret = key_.Pack(cursor_->session);
+    if (ret == 0 && op_ != REMOVE)
+    {
+      ret = value_.Pack(cursor_->session);
+    }
+    if (ret == 0 && indexes_)
+    {
+      WT_ITEM key_item = key_.Item();
+      WT_ITEM value_item = value_.Item();
+      int (*op)(WT_CURSOR *) = op_ == INSERT ? cursor_->insert : op_ == UPDATE ? cursor_->update : cursor_->remove;
+      ret = WriteWithIndexes(cursor_->session, cursor_, *indexes_, op_ == REMOVE, op, key_item,
+                             op_ == REMOVE ? nullptr : &value_item, state_->inTransaction);
+      if (op_ == REMOVE && ret == WT_NOTFOUND)
+      {
+        ret = 0;
+      }
+    }
+    else if (ret == 0)
+    {
+      WT_ITEM key_item = key_.Item();
+      cursor_->set_key(cursor_, &key_item);
+      if (op_ == REMOVE)
+      {
+        ret = cursor_->remove(cursor_);
+        if (ret == WT_NOTFOUND)
+        {
+          ret = 0;
+        }
+      }
+      else
+      {
+        WT_ITEM value_item = value_.Item();
+        cursor_->set_value(cursor_, &value_item);
+        ret = op_ == INSERT ? cursor_->insert(cursor_) : cursor_->update(cursor_);
+      }
+    }
+
+    if (ret == 0 && readCacheable_)
+    {
+      WT_ITEM key_item = key_.Item();
+      std::string cacheKey;
+      ReadCache::Key(cursor_->uri, key_item.data, key_item.size, cacheKey);
+      NoteCacheWrite(*state_, cacheKey);
+    }
+
+    if (ret != 0)
+    {
+      const char *name = op_ == INSERT ? "Insert" : op_ == UPDATE ? "Update" : "Remove";
+      SetError(std::string(name) + " failed: " + wiredtiger_strerror(ret));
+    }
+  }
+
+  Napi::Value Result(Napi::Env env) override
+  {
+    return Napi::Boolean::New(env, true);
+  }
+
+private:
+  WT_CURSOR *cursor_;
+  Op op_;
+  FieldBuffer key_;
+  FieldBuffer value_;
+  std::shared_ptr<const field_index::DefinitionList> indexes_;
+  bool readCacheable_;
+};
+
+// WiredTigerCursor class (defined first since it's used by WiredTigerSession)
+class WiredTigerCursor : public Napi::ObjectWrap<WiredTigerCursor>
+{
+public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports)
+  {
+    Napi::Function func = DefineClass(env, "WiredTigerCursor", {
+                                                                   InstanceMethod("set", &WiredTigerCursor::Set),
+                                                                   InstanceMethod("get", &WiredTigerCursor::Get),
+                                                                   InstanceMethod("search", &WiredTigerCursor::Search),
+                                                                   InstanceMethod("searchNear", &WiredTigerCursor::SearchNear),
+                                                                   InstanceMethod("next", &WiredTigerCursor::Next),
+                                                                   InstanceMethod("prev", &WiredTigerCursor::Prev),
+                                                                   InstanceMethod("reset", &WiredTigerCursor::Reset),
+                                                                   InstanceMethod("insert", &WiredTigerCursor::Insert),
+                                                                   InstanceMethod("update", &WiredTigerCursor::Update),
+                                                                   InstanceMethod("remove", &WiredTigerCursor::Remove),
+                                                                   InstanceMethod("close", &WiredTigerCursor::Close),
+                                                                   InstanceMethod("getKey", &WiredTigerCursor::GetRawKey),
+                                                                   InstanceMethod("getValue", &WiredTigerCursor::GetRawValue),
+                                                                   InstanceMethod("setRawKey", &WiredTigerCursor::SetRawKey),
+                                                                   InstanceMethod("setRawValue", &WiredTigerCursor::SetRawValue),
+                                                                   InstanceMethod("searchAsync", &WiredTigerCursor::SearchAsync),
+                                                                   InstanceMethod("nextAsync", &WiredTigerCursor::NextAsync),
+                                                                   InstanceMethod("prevAsync", &WiredTigerCursor::PrevAsync),
+                                                                   InstanceMethod("insertAsync", &WiredTigerCursor::InsertAsync),
+                                                                   InstanceMethod("updateAsync", &WiredTigerCursor::UpdateAsync),
+                                                                   InstanceMethod("removeAsync", &WiredTigerCursor::RemoveAsync),
+                                                                   InstanceMethod("getMany", &WiredTigerCursor::GetMany),
+                                                                   InstanceMethod("getManyAsync", &WiredTigerCursor::GetManyAsync),
+                                                                   InstanceMethod("putMany", &WiredTigerCursor::PutMany),
+                                                                   InstanceMethod("removeMany", &WiredTigerCursor::RemoveMany),
+                                                                   InstanceMethod("putManyAsync", &WiredTigerCursor::PutManyAsync),
+                                                                   InstanceMethod("removeManyAsync", &WiredTigerCursor::RemoveManyAsync),
+                                                                   InstanceMethod("getKeyView", &WiredTigerCursor::GetKeyView),
+                                                                   InstanceMethod("getValueView", &WiredTigerCursor::GetValueView),
+                                                                   InstanceMethod("searchView", &WiredTigerCursor::SearchView),
+                                                                   InstanceMethod("scanStart", &WiredTigerCursor::ScanStart),
+                                                                   InstanceMethod("scanFill", &WiredTigerCursor::ScanFill),
+                                                                   InstanceMethod("scanFillAsync", &WiredTigerCursor::ScanFillAsync),
+                                                                   InstanceMethod("bound", &WiredTigerCursor::Bound),
+                                                                   InstanceMethod("count", &WiredTigerCursor::Count),
+                                                                   InstanceMethod("countAsync", &WiredTigerCursor::CountAsync),
+                                                               });
+
+    env.GetInstanceData<AddonData>()->cursorConstructor = Napi::Persistent(func);
+    exports.Set("WiredTigerCursor", func);
+    return exports;
+  }
+
+  static Napi::Object NewInstance(Napi::Env env, WT_CURSOR *cursor, std::shared_ptr<SessionState> state, const std::string &config,
+                                  const std::string &cacheKey = "")
+  {
+    Napi::EscapableHandleScope scope(env);
+    Napi::Object obj = env.GetInstanceData<AddonData>()->cursorConstructor.New({});
+    WiredTigerCursor *wrapper = Napi::ObjectWrap<WiredTigerCursor>::Unwrap(obj);
+    wrapper->cursor_ = cursor;
+    wrapper->state_ = std::move(state);
+    wrapper->config_ = config;
+    wrapper->cacheKey_ = cacheKey;
+    wrapper->keyFormat_ = RecordFormat::Get(cursor->key_format);
+    wrapper->valueFormat_ = RecordFormat::Get(cursor->value_format);
+    // The read cache holds raw key/value tables' records, as plain searches
+    // return them. Cursors reading a checkpoint or random records (and
+    // readonly ones) never read from it.
+    wrapper->readCacheable_ = wrapper->state_->readCache && !wrapper->keyFormat_ && !wrapper->valueFormat_ &&
+                              std::strncmp(cursor->uri, "table:", 6) == 0 && !HasConfigKey(config, "dump");
+    WT_CONFIG_ITEM readonly;
+    wrapper->readsFromCache_ = wrapper->readCacheable_ && wrapper->state_->readsFromCache &&
+                               !HasConfigKey(config, "checkpoint") && !HasConfigKey(config, "next_random") &&
+                               !(GetConfigItem(config, "readonly", readonly) && readonly.val != 0);
+    wrapper->state_->cursors.push_back(&wrapper->cursor_);
+    return scope.Escape(napi_value(obj)).ToObject();
+  }
+
+  // Hands back a cached wrapper for `key` (already reset), or an empty
+  // object on a miss
+  static Napi::Object TakeCached(Napi::Env env, SessionState &state, const std::string &key)
+  {
+    if (key.empty() || state.cursorCacheMax == 0)
+    {
+      return Napi::Object();
+    }
+    for (auto it = state.cursorCache.begin(); it != state.cursorCache.end(); ++it)
+    {
+      if (it->key != key)
+      {
+        continue;
+      }
+      Napi::Object obj = it->wrapper.Value();
+      state.cursorCache.erase(it);
+      Napi::ObjectWrap<WiredTigerCursor>::Unwrap(obj)->cached_ = false;
+      state.cursorCacheHits++;
+      return obj;
+    }
+    state.cursorCacheMisses++;
+    return Napi::Object();
+  }
+
+  // Closes every cached cursor, e.g. so drop() doesn't fail with EBUSY
+  static void FlushCache(SessionState &state)
+  {
+    while (!state.cursorCache.empty())
+    {
+      EvictOldest(state);
+    }
+  }
+
+  WiredTigerCursor(const Napi::CallbackInfo &info)
+      : Napi::ObjectWrap<WiredTigerCursor>(info), cursor_(nullptr)
+  {
+  }
+
+  ~WiredTigerCursor()
+  {
+    if (!state_)
+    {
+      return;
+    }
+    UntrackCursor(*state_, &cursor_);
+    // If the session is gone WiredTiger already closed the cursor with it
+    if (cursor_ && state_->session)
+    {
+      // Views can outlive the wrapper; they must not outlive the cursor
+      ReleaseViews(*state_, cursor_);
+      cursor_->close(cursor_);
+    }
+  }
+
+private:
+  WT_CURSOR *cursor_;
+  std::shared_ptr<SessionState> state_;
+  // Config the cursor was opened with, for reopening it
+  std::string config_;
+  // Key into the session's cursor cache; empty if the cursor isn't cached
+  std::string cacheKey_;
+  // Closed from JS and parked in the cursor cache
+  bool cached_ = false;
+  // Typed key/value formats; null for raw 'u' columns
+  std::shared_ptr<const RecordFormat> keyFormat_;
+  std::shared_ptr<const RecordFormat> valueFormat_;
+  RangeScan scan_;
+  // Keep strings alive until insert/update is called
+  std::string pending_key_;
+  std::string pending_value_;
+  // Searches and writes go through the connection's read cache
+  bool readCacheable_ = false;
+  bool readsFromCache_ = false;
+  // Set by bound(); a bounded search may miss keys the cache holds
+  bool bounded_ = false;
+  // The last search was answered from the read cache, leaving the cursor
+  // with its key set but unpositioned
+  bool readCacheHit_ = false;
+  // Reused for read cache lookups
+  std::string readCacheKey_;
+  std::string readCacheValue_;
+
+  // Throws and returns false if the cursor is closed or its session is busy.
+  // Calls that may move the cursor invalidate its zero-copy views.
+  bool EnsureUsable(Napi::Env env, bool moves = true)
+  {
+    if (!cursor_ || cached_)
+    {
+      Napi::Error::New(env, "Cursor is closed").ThrowAsJavaScriptException();
+      return false;
+    }
+    if (!EnsureSessionUsable(env, state_))
+    {
+      return false;
+    }
+    if (moves && !state_->views.empty())
+    {
+      ReleaseViews(*state_, cursor_);
+    }
+    Settle();
+    return true;
+  }
+
+  // Positions the cursor on the key a read cache hit left it on, for calls
+  // that depend on where the cursor is
+  void Settle()
+  {
+    if (readCacheHit_)
+    {
+      readCacheHit_ = false;
+      cursor_->search(cursor_);
+    }
+  }
+
+  // Async calls queue behind whatever is running on the session, so they
+  // only need the cursor to be open
+  bool EnsureOpen(Napi::Env env)
+  {
+    if (!cursor_ || cached_ || !state_->session)
+    {
+      Napi::Error::New(env, "Cursor is closed").ThrowAsJavaScriptException();
+      return false;
+    }
+    ReleaseViews(*state_, cursor_);
+    if (!state_->busy)
+    {
+      Settle();
+    }
+    return true;
+  }
+
+  FieldBuffer KeyBuffer() const
+  {
+    FieldBuffer buffer;
+    buffer.format = keyFormat_;
+    return buffer;
+  }
+
+  FieldBuffer ValueBuffer() const
+  {
+    FieldBuffer buffer;
+    buffer.format = valueFormat_;
+    return buffer;
+  }
+
+  // Converts and packs a JS key or value into `storage` and binds it to the
+  // cursor. WiredTiger keeps the pointer, so `storage` must outlive the call
+  // that consumes it. Throws and returns false on failure.
+  bool Bind(Napi::Env env, Napi::Value input, bool isKey, std::string &storage)
+  {
+    if (!(isKey ? keyFormat_ : valueFormat_))
+    {
+      // Raw columns: encode straight into the reused storage
+      if (!input.IsString())
+      {
+        Napi::TypeError::New(env, isKey ? "Key string expected" : "Value string expected")
+            .ThrowAsJavaScriptException();
+        return false;
+      }
+      AssignUtf8(env, input, storage);
+    }
+    else
+    {
+      FieldBuffer buffer = isKey ? KeyBuffer() : ValueBuffer();
+      if (!buffer.Read(env, input, isKey ? "Key" : "Value"))
+      {
+        return false;
+      }
+      int ret = buffer.Pack(cursor_->session);
+      if (ret != 0)
+      {
+        Napi::Error::New(env, std::string(isKey ? "Failed to pack key: " : "Failed to pack value: ") + wiredtiger_strerror(ret))
+            .ThrowAsJavaScriptException();
+        return false;
+      }
+      storage.swap(buffer.bytes);
+    }
+    binding_metrics::Call::BytesIn(storage.size());
+    WT_ITEM item;
+    item.data = storage.data();
+    item.size = storage.size();
+    if (isKey)
+    {
+      cursor_->set_key(cursor_, &item);
+    }
+    else
+    {
+      cursor_->set_value(cursor_, &item);
+    }
+    return true;
+  }
+
+  // Copies (and for typed formats unpacks) the key or value under the
+  // cursor. Returns an empty value, having thrown, if unpacking fails.
+  Napi::Value Current(Napi::Env env, bool isKey, const WT_ITEM &item)
+  {
+    binding_metrics::Call::BytesOut(item.size);
+    if (!(isKey ? keyFormat_ : valueFormat_))
+    {
+      // Raw columns: the string is built straight from WiredTiger's memory
+      return Napi::String::New(env, (const char *)item.data, item.size);
+    }
+    FieldBuffer buffer = isKey ? KeyBuffer() : ValueBuffer();
+    int ret = buffer.Unpack(cursor_->session, item);
+    if (ret != 0)
+    {
+      Napi::Error::New(env, std::string(isKey ? "Failed to unpack key: " : "Failed to unpack value: ") + wiredtiger_strerror(ret))
+          .ThrowAsJavaScriptException();
+      return Napi::Value();
+    }
+    return buffer.ToJs(env);
+  }
+
+  // { key, value } for the record under the cursor, or, given a `slots`
+  // array, the key and value stored into its first two elements and true
+  // returned, so iterating allocates no result objects
+  Napi::Value Record(Napi::Env env, Napi::Value slots = Napi::Value())
+  {
+    WT_ITEM key_item, value_item;
+    if (cursor_->get_key(cursor_, &key_item) != 0 || cursor_->get_value(cursor_, &value_item) != 0)
+    {
+      return NotFound(env, slots);
+    }
+
+    Napi::Value key = Current(env, true, key_item);
+    if (key.IsEmpty())
+    {
+      return env.Null();
+    }
+    Napi::Value value = Current(env, false, value_item);
+    if (value.IsEmpty())
+    {
+      return env.Null();
+    }
+
+    if (!slots.IsEmpty())
+    {
+      Napi::Array out = slots.As<Napi::Array>();
+      out.Set((uint32_t)0, key);
+      out.Set((uint32_t)1, value);
+      return Napi::Boolean::New(env, true);
+    }
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("key", key);
+    result.Set("value", value);
+    return result;
+  }
+
+  // Null, or false for callers that passed a slots array
+  static Napi::Value NotFound(Napi::Env env, Napi::Value slots)
+  {
+    return slots.IsEmpty() ? env.Null() : Napi::Boolean::New(env, false);
+  }
+
+  // The optional output array of get()/next()/prev()
+  static Napi::Value Slots(const Napi::CallbackInfo &info)
+  {
+    return info.Length() > 0 && info[0].IsArray() ? info[0] : Napi::Value();
+  }
+
+  std::shared_ptr<const field_index::DefinitionList> Indexes() const
+  {
+    return state_->indexes ? state_->indexes->For(cursor_->uri) : nullptr;
+  }
+
+  // insert()/update()/remove() of the key and value set on the cursor,
+  // keeping the table's field indexes and the read cache in step
+  int Write(int (*op)(WT_CURSOR *), bool remove)
+  {
+    WT_ITEM key_item;
+    if (!readCacheable_ || cursor_->get_key(cursor_, &key_item) != 0)
+    {
+      return WriteThrough(op, remove);
+    }
+    ReadCache::Key(cursor_->uri, key_item.data, key_item.size, readCacheKey_);
+    int ret = WriteThrough(op, remove);
+    if (ret != WT_NOTFOUND && ret != WT_DUPLICATE_KEY)
+    {
+      NoteCacheWrite(*state_, readCacheKey_);
+    }
+    return ret;
+  }
+
+  int WriteThrough(int (*op)(WT_CURSOR *), bool remove)
+  {
+    auto indexes = Indexes();
+    if (!indexes)
+    {
+      return op(cursor_);
+    }
+
+    // The key and value may point into the page under the cursor, which
+    // index maintenance moves away from
+    WT_ITEM key_item, value_item;
+    int ret = cursor_->get_key(cursor_, &key_item);
+    if (ret == 0 && !remove)
+    {
+      ret = cursor_->get_value(cursor_, &value_item);
+    }
+    if (ret != 0)
+    {
+      return ret;
+    }
+    std::string key((const char *)key_item.data, key_item.size);
+    std::string value = remove ? std::string() : std::string((const char *)value_item.data, value_item.size);
+    key_item.data = key.data();
+    value_item.data = value.data();
+    return WriteWithIndexes(state_->session, cursor_, *indexes, remove, op, key_item, remove ? nullptr : &value_item,
+                            state_->inTransaction);
+  }
+
+  Napi::Value Set(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+    binding_metrics::Call call(binding_metrics::SET);
+
+    // The new key replaces the one a cache hit left behind
+    readCacheHit_ = false;
+    if (!EnsureUsable(env))
+    {
+      return env.Null();
+    }
+
+    if (info.Length() < 2)
+    {
+      Napi::TypeError::New(env, "Key and value expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    // Store the bytes as member variables to keep them alive!
+    // This is crucial: WiredTiger stores pointers, not copies, so the bytes
+    // must remain valid until insert()/update() is called
+    if (!Bind(env, info[0], true, pending_key_) || !Bind(env, info[1], false, pending_value_))
+    {
+      return env.Null();
+    }
+
+    return Napi::Boolean::New(env, true);
+  }
+
+  Napi::Value Get(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureUsable(env, false))
+    {
+      return env.Null();
+    }
+
+    return Record(env, Slots(info));
+  }
+
+  Napi::Value Search(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+    binding_metrics::Call call(binding_metrics::SEARCH);
+
+    readCacheHit_ = false;
+    if (!EnsureUsable(env))
+    {
+      return env.Null();
+    }
+
+    if (info.Length() < 1)
+    {
+      Napi::TypeError::New(env, "Key expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    // Searching replaces any key set on the cursor, so its storage is reused
+    if (!Bind(env, info[0], true, pending_key_))
+    {
+      return env.Null();
+    }
+
+    // Outside transactions (whose snapshot may predate the cached value, or
+    // which may have written the key themselves) hot keys come from the
+    // read cache
+    ReadCache *cache = readsFromCache_ && !bounded_ && !state_->inTransaction ? state_->readCache.get() : nullptr;
+    uint64_t epoch = 0;
+    if (cache)
+    {
+      ReadCache::Key(cursor_->uri, pending_key_.data(), pending_key_.size(), readCacheKey_);
+      if (cache->Get(readCacheKey_, readCacheValue_))
+      {
+        readCacheHit_ = true;
+        WT_ITEM value_item;
+        value_item.data = readCacheValue_.data();
+        value_item.size = readCacheValue_.size();
+        Napi::Value value = Current(env, false, value_item);
+        return value.IsEmpty() ? env.Null() : value;
+      }
+      epoch = cache->Epoch(readCacheKey_);
+    }
+
+    int ret;
+    {
+      binding_metrics::Engine engine;
+      ret = cursor_->search(cursor_);
+    }
+
+    if (ret == 0)
+    {
+      WT_ITEM value_item;
+      cursor_->get_value(cursor_, &value_item);
+      if (cache)
+      {
+        cache->Put(readCacheKey_, (const char *)value_item.data, value_item.size, epoch);
+      }
+      // Copy the data immediately - the pointer is only valid until cursor moves!
+      Napi::Value value = Current(env, false, value_item);
+      return value.IsEmpty() ? env.Null() : value;
+    }
+    else if (ret == WT_NOTFOUND)
+    {
+      return env.Null();
+    }
+    else
+    {
+      Napi::Error::New(env, "Search failed: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+  }
+
+  // getMany(keys): one native call for a whole batch of point lookups.
+  // `keys` is an array of strings (result: array of strings with holes for
+  // missing keys) or a packed buffer of [uint32 LE length][bytes] records
+  // (result: packed buffer, length 0xFFFFFFFF marking missing keys).
+  Napi::Value GetMany(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureUsable(env))
+    {
+      return env.Null();
+    }
+
+    if (info.Length() < 1)
+    {
+      Napi::TypeError::New(env, "Array of keys or packed key buffer expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    MultiGetBatch batch;
+    batch.keyFormat = keyFormat_;
+    batch.valueFormat = valueFormat_;
+    if (!batch.Parse(env, info[0]))
+    {
+      return env.Null();
+    }
+
+    int ret = batch.Run(cursor_);
+    if (ret != 0)
+    {
+      Napi::Error::New(env, "getMany failed: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    return batch.Result(env);
+  }
+
+  // putMany(batch, { bulk }): applies a packed buffer of key/value records in
+  // one transaction and returns an Int32Array of per-item statuses (0, or
+  // WT_DUPLICATE_KEY when the cursor was opened with overwrite=false). With
+  // `bulk`, an empty table is loaded through a bulk cursor instead.
+  Napi::Value PutMany(const Napi::CallbackInfo &info)
+  {
+    return WriteMany(info, false);
+  }
+
+  // removeMany(keys): removes an array of key strings or a packed buffer of
+  // keys in one transaction; statuses as for putMany (WT_NOTFOUND for
+  // missing keys when the cursor was opened with overwrite=false).
+  Napi::Value RemoveMany(const Napi::CallbackInfo &info)
+  {
+    return WriteMany(info, true);
+  }
+
+  Napi::Value WriteMany(const Napi::CallbackInfo &info, bool remove)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureUsable(env))
+    {
+      return env.Null();
+    }
+
+    WriteBatch batch;
+    batch.remove = remove;
+    batch.bulk = !remove && BulkOption(info);
+    batch.indexes = Indexes();
+    batch.keyFormat = keyFormat_;
+    batch.valueFormat = valueFormat_;
+    if (!batch.Parse(env, info[0], false))
+    {
+      return env.Null();
+    }
+    if (batch.bulk)
+    {
+      // A bulk cursor needs exclusive access to the table
+      FlushCache(*state_);
+    }
+
+    std::string uri = cursor_->uri;
+    int ret = batch.Run(state_->session, cursor_, uri, config_, state_->inTransaction);
+    if (readCacheable_)
+    {
+      batch.NoteCacheWrites(*state_, uri.c_str());
+    }
+    if (ret != 0)
+    {
+      Napi::Error::New(env, std::string(remove ? "removeMany" : "putMany") + " failed: " + wiredtiger_strerror(ret))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    return StatusArray(env, batch.statuses);
+  }
+
+  static bool BulkOption(const Napi::CallbackInfo &info)
+  {
+    if (info.Length() < 2 || !info[1].IsObject())
+    {
+      return false;
+    }
+    Napi::Value bulk = info[1].As<Napi::Object>().Get("bulk");
+    return bulk.IsBoolean() && bulk.As<Napi::Boolean>().Value();
+  }
+
+  // scanStart({ gt, gte, lt, lte, reverse, limit, filter }): begins a chunked
+  // range scan on this cursor. Other positioning calls on the cursor
+  // interrupt it.
+  Napi::Value ScanStart(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureUsable(env))
+    {
+      return env.Null();
+    }
+
+    if (!scan_.Parse(env, info.Length() > 0 ? info[0] : env.Undefined(), keyFormat_))
+    {
+      return env.Null();
+    }
+
+    int ret = cursor_->reset(cursor_);
+    if (ret != 0)
+    {
+      Napi::Error::New(env, "Reset failed: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    return Napi::Boolean::New(env, true);
+  }
+
+  // bound({ gt, gte, lt, lte }): limits the cursor to a key range until
+  // bound(null) or reset(). next()/prev() start at the range's ends and
+  // return null past them; searches outside it find nothing.
+  Napi::Value Bound(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureUsable(env))
+    {
+      return env.Null();
+    }
+
+    RangeScan range;
+    if (!range.Parse(env, info.Length() > 0 ? info[0] : env.Undefined(), keyFormat_))
+    {
+      return env.Null();
+    }
+
+    // Bounds can only be changed on an unpositioned cursor
+    int ret = range.PackBounds(cursor_->session);
+    if (ret == 0)
+    {
+      ret = cursor_->reset(cursor_);
+    }
+    if (ret == 0)
+    {
+      ret = cursor_->bound(cursor_, "action=clear");
+    }
+    if (ret == 0 && (range.hasLower || range.hasUpper))
+    {
+      ret = field_index::SetBounds(cursor_, range.hasLower ? &range.lower : nullptr, range.lowerInclusive,
+                                   range.hasUpper ? &range.upper : nullptr, range.upperInclusive);
+    }
+    bounded_ = ret == 0 && (range.hasLower || range.hasUpper);
+    if (ret != 0)
+    {
+      Napi::Error::New(env, "Failed to set cursor bounds: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    return Napi::Boolean::New(env, true);
+  }
+
+  // count({ gt, gte, lt, lte, limit, filter }): number of records in the
+  // range (matching the filter), counted natively. Leaves the cursor reset.
+  Napi::Value Count(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureUsable(env))
+    {
+      return env.Null();
+    }
+
+    RangeScan range;
+    if (!range.Parse(env, info.Length() > 0 ? info[0] : env.Undefined(), keyFormat_))
+    {
+      return env.Null();
+    }
+    scan_ = RangeScan();
+
+    uint64_t count;
+    int ret = range.Count(cursor_, count);
+    if (ret != 0)
+    {
+      Napi::Error::New(env, "Count failed: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    return Napi::Number::New(env, (double)count);
+  }
+
+  Napi::Value CountAsync(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureOpen(env))
+    {
+      return env.Null();
+    }
+
+    RangeScan range;
+    if (!range.Parse(env, info.Length() > 0 ? info[0] : env.Undefined(), keyFormat_))
+    {
+      return env.Null();
+    }
+
+    auto *worker = new CursorCountWorker(env, state_, info.This().As<Napi::Object>(), cursor_, std::move(range));
+    return worker->Schedule();
+  }
+
+  // scanFill(buffer): copies the next records of the scan into `buffer` and
+  // returns { count, bytes, done, needed }. `needed` is set when the next
+  // record alone doesn't fit, so the caller can retry with a larger buffer.
+  Napi::Value ScanFill(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureUsable(env))
+    {
+      return env.Null();
+    }
+
+    const uint8_t *data;
+    size_t capacity;
+    if (info.Length() < 1 || !GetBytes(info[0], data, capacity))
+    {
+      Napi::TypeError::New(env, "ArrayBuffer or Buffer expected for scan chunk").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    binding_metrics::Call call(binding_metrics::SCAN_FILL);
+    int ret;
+    {
+      binding_metrics::Engine engine;
+      ret = scan_.Fill(cursor_, const_cast<uint8_t *>(data), capacity);
+    }
+    binding_metrics::Call::BytesOut(scan_.used);
+    if (ret != 0)
+    {
+      Napi::Error::New(env, "Scan failed: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    return ScanFillResult(env, scan_);
+  }
+
+  Napi::Value SearchNear(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureUsable(env))
+    {
+      return env.Null();
+    }
+
+    const uint8_t *data;
+    size_t length;
+    if (info.Length() < 1 || !GetKeyBytes(env, info[0], pending_key_, data, length))
+    {
+      if (!env.IsExceptionPending())
+      {
+        Napi::TypeError::New(env, "Key expected for searchNear").ThrowAsJavaScriptException();
+      }
+      return env.Null();
+    }
+
+    WT_ITEM key_item;
+    key_item.data = data;
+    key_item.size = length;
+    cursor_->set_key(cursor_, &key_item);
+
+    int exact;
+    int ret = cursor_->search_near(cursor_, &exact);
+
+    if (ret == 0)
+    {
+      Napi::Object result = Napi::Object::New(env);
+      result.Set("exact", Napi::Number::New(env, exact));
+      return result;
+    }
+    else if (ret == WT_NOTFOUND)
+    {
+      return env.Null();
+    }
+    else
+    {
+      Napi::Error::New(env, "search_near failed: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+  }
+
+  Napi::Value Next(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+    binding_metrics::Call call(binding_metrics::NEXT);
+
+    if (!EnsureUsable(env))
+    {
+      return env.Null();
+    }
+
+    int ret;
+    {
+      binding_metrics::Engine engine;
+      ret = cursor_->next(cursor_);
+    }
+
+    if (ret == 0)
+    {
+      // Copy data immediately - the pointers are only valid until cursor moves!
+      return Record(env, Slots(info));
+    }
+    else if (ret == WT_NOTFOUND)
+    {
+      return NotFound(env, Slots(info));
+    }
+    else
+    {
+      Napi::Error::New(env, "Next failed: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+  }
+
+  Napi::Value GetRawKey(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureUsable(env, false))
+    {
+      return env.Null();
+    }
+
+    WT_ITEM key_item;
+    int ret = cursor_->get_key(cursor_, &key_item);
+    if (ret != 0)
+    {
+      return env.Null();
+    }
+
+    Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(env, key_item.size);
+    std::memcpy(buffer.Data(), key_item.data, key_item.size);
+    return buffer;
+  }
+
+  Napi::Value GetRawValue(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureUsable(env, false))
+    {
+      return env.Null();
+    }
+
+    WT_ITEM value_item;
+    int ret = cursor_->get_value(cursor_, &value_item);
+    if (ret != 0)
+    {
+      return env.Null();
+    }
+
+    Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(env, value_item.size);
+    std::memcpy(buffer.Data(), value_item.data, value_item.size);
+    return buffer;
+  }
+
+  // getKeyView()/getValueView(): like getKey()/getValue() but without the
+  // copy - the ArrayBuffer points straight into WiredTiger's memory and is
+  // detached when the cursor moves, resets or closes, or the transaction ends
+  Napi::Value GetKeyView(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureUsable(env, false))
+    {
+      return env.Null();
+    }
+
+    WT_ITEM key_item;
+    if (cursor_->get_key(cursor_, &key_item) != 0)
+    {
+      return env.Null();
+    }
+    return MakeView(env, *state_, cursor_, key_item);
+  }
+
+  Napi::Value GetValueView(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureUsable(env, false))
+    {
+      return env.Null();
+    }
+
+    WT_ITEM value_item;
+    if (cursor_->get_value(cursor_, &value_item) != 0)
+    {
+      return env.Null();
+    }
+    return MakeView(env, *state_, cursor_, value_item);
+  }
+
+  // searchView(key): search() returning a value view instead of a string
+  Napi::Value SearchView(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureUsable(env))
+    {
+      return env.Null();
+    }
+
+    if (info.Length() < 1)
+    {
+      Napi::TypeError::New(env, "Key expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    // Raw keys may also be given as bytes; anything else binds like search()
+    WT_ITEM key_item;
+    const uint8_t *data;
+    if (!keyFormat_ && GetBytes(info[0], data, key_item.size))
+    {
+      key_item.data = data;
+      cursor_->set_key(cursor_, &key_item);
+    }
+    else if (!Bind(env, info[0], true, pending_key_))
+    {
+      return env.Null();
+    }
+
+    int ret = cursor_->search(cursor_);
+    if (ret == WT_NOTFOUND)
+    {
+      return env.Null();
+    }
+
+    WT_ITEM value_item;
+    if (ret == 0)
+    {
+      ret = cursor_->get_value(cursor_, &value_item);
+    }
+    if (ret != 0)
+    {
+      Napi::Error::New(env, "Search failed: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    return MakeView(env, *state_, cursor_, value_item);
+  }
+
+  Napi::Value SetRawKey(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureUsable(env))
+    {
+      return env.Null();
+    }
+
+    const uint8_t *data;
+    size_t length;
+    if (info.Length() < 1 || !GetKeyBytes(env, info[0], pending_key_, data, length))
+    {
+      if (!env.IsExceptionPending())
+      {
+        Napi::TypeError::New(env, "Key expected").ThrowAsJavaScriptException();
+      }
+      return env.Null();
+    }
+
+    WT_ITEM key_item;
+    key_item.data = data;
+    key_item.size = length;
+    cursor_->set_key(cursor_, &key_item);
+    return Napi::Boolean::New(env, true);
+  }
+
+  Napi::Value SetRawValue(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureUsable(env))
+    {
+      return env.Null();
+    }
+
+    if (info.Length() < 1 || !info[0].IsArrayBuffer())
+    {
+      Napi::TypeError::New(env, "ArrayBuffer expected for value").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    Napi::ArrayBuffer buffer = info[0].As<Napi::ArrayBuffer>();
+    WT_ITEM value_item;
+    value_item.data = buffer.Data();
+    value_item.size = buffer.ByteLength();
+    cursor_->set_value(cursor_, &value_item);
+    return Napi::Boolean::New(env, true);
+  }
+
+  Napi::Value Prev(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+    binding_metrics::Call call(binding_metrics::PREV);
+
+    if (!EnsureUsable(env))
+    {
+      return env.Null();
+    }
+
+    int ret;
+    {
+      binding_metrics::Engine engine;
+      ret = cursor_->prev(cursor_);
+    }
+
+    if (ret == 0)
+    {
+      return Record(env, Slots(info));
+    }
+    else if (ret == WT_NOTFOUND)
+    {
+      return NotFound(env, Slots(info));
+    }
+    else
+    {
+      Napi::Error::New(env, "Prev failed: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+  }
+
+  Napi::Value Reset(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    readCacheHit_ = false;
+    if (!EnsureUsable(env))
+    {
+      return env.Null();
+    }
+
+    // Resetting also clears the cursor's bounds
+    bounded_ = false;
+    int ret = cursor_->reset(cursor_);
+    if (ret != 0)
+    {
+      Napi::Error::New(env, "Reset failed: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    return Napi::Boolean::New(env, true);
+  }
+
+  Napi::Value Insert(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+    binding_metrics::Call call(binding_metrics::INSERT);
+
+    if (!EnsureUsable(env))
+    {
+      return env.Null();
+    }
+
+    int ret;
+    {
+      binding_metrics::Engine engine;
+      ret = Write(cursor_->insert, false);
+    }
+
+    if (ret != 0)
+    {
+      Napi::Error::New(env, "Insert failed: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    return Napi::Boolean::New(env, true);
+  }
+
+  Napi::Value Update(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+    binding_metrics::Call call(binding_metrics::UPDATE);
+
+    if (!EnsureUsable(env))
+    {
+      return env.Null();
+    }
+
+    int ret;
+    {
+      binding_metrics::Engine engine;
+      ret = Write(cursor_->update, false);
+    }
+
+    if (ret != 0)
+    {
+      Napi::Error::New(env, "Update failed: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    return Napi::Boolean::New(env, true);
+  }
+
+  Napi::Value Remove(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+    binding_metrics::Call call(binding_metrics::REMOVE);
+
+    if (!EnsureUsable(env))
+    {
+      return env.Null();
+    }
+
+    // Key must be set before calling remove
+    // The key should already be set by a previous search() or set() call
+    int ret;
+    {
+      binding_metrics::Engine engine;
+      ret = Write(cursor_->remove, true);
+    }
+
+    if (ret != 0 && ret != WT_NOTFOUND)
+    {
+      Napi::Error::New(env, "Remove failed: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    return Napi::Boolean::New(env, true);
+  }
+
+  Napi::Value Close(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (cursor_ && !cached_)
+    {
+      if (state_->busy)
+      {
+        Napi::Error::New(env, "Session is busy with an async operation").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      ReleaseViews(*state_, cursor_);
+      if (!Park())
+      {
+        Discard();
+      }
+    }
+
+    return Napi::Boolean::New(env, true);
+  }
+
+  // Resets the cursor and keeps it (and this wrapper) in the session's
+  // cursor cache instead of closing it. Returns false if it can't be cached.
+  bool Park()
+  {
+    if (cacheKey_.empty() || !state_->session || state_->cursorCacheMax == 0 ||
+        cursor_->reset(cursor_) != 0)
+    {
+      return false;
+    }
+    // reset() drops bounds, but a cursor handed out again must not inherit
+    // any from its previous user
+    cursor_->bound(cursor_, "action=clear");
+    scan_ = RangeScan();
+    bounded_ = false;
+    readCacheHit_ = false;
+    pending_key_.clear();
+    pending_value_.clear();
+    cached_ = true;
+    state_->cursorCache.push_front({cacheKey_, Napi::Persistent(Value())});
+    while (state_->cursorCache.size() > state_->cursorCacheMax)
+    {
+      EvictOldest(*state_);
+    }
+    return true;
+  }
+
+  void Discard()
+  {
+    UntrackCursor(*state_, &cursor_);
+    if (cursor_ && state_->session)
+    {
+      cursor_->close(cursor_);
+    }
+    cursor_ = nullptr;
+    cached_ = false;
+  }
+
+  static void EvictOldest(SessionState &state)
+  {
+    Napi::Object obj = state.cursorCache.back().wrapper.Value();
+    Napi::ObjectWrap<WiredTigerCursor>::Unwrap(obj)->Discard();
+    state.cursorCache.pop_back();
+    state.cursorCacheEvictions++;
+  }
+
+  // Async variants: same semantics as their sync counterparts, but the
+  // WiredTiger call runs on the libuv threadpool and a Promise is returned.
+  Napi::Value SearchAsync(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureOpen(env))
+    {
+      return env.Null();
+    }
+
+    // Packing waits for the worker, which owns the session
+    FieldBuffer key = KeyBuffer();
+    if (!key.Read(env, info[0], "Key"))
+    {
+      return env.Null();
+    }
+    auto *worker = new CursorSearchWorker(env, state_, info.This().As<Napi::Object>(), cursor_,
+                                          std::move(key), ValueBuffer());
+    return worker->Schedule();
+  }
+
+  Napi::Value GetManyAsync(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1)
+    {
+      Napi::TypeError::New(env, "Array of keys or packed key buffer expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    if (!EnsureOpen(env))
+    {
+      return env.Null();
+    }
+
+    auto *worker = new CursorMultiGetWorker(env, state_, info.This().As<Napi::Object>(), cursor_);
+    worker->batch.keyFormat = keyFormat_;
+    worker->batch.valueFormat = valueFormat_;
+    if (!worker->batch.Parse(env, info[0]))
+    {
+      delete worker;
+      return env.Null();
+    }
+    return worker->Schedule();
+  }
+
+  Napi::Value PutManyAsync(const Napi::CallbackInfo &info)
+  {
+    return WriteManyAsync(info, false);
+  }
+
+  Napi::Value RemoveManyAsync(const Napi::CallbackInfo &info)
+  {
+    return WriteManyAsync(info, true);
+  }
+
+  Napi::Value WriteManyAsync(const Napi::CallbackInfo &info, bool remove)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureOpen(env))
+    {
+      return env.Null();
+    }
+
+    auto *worker = new CursorWriteBatchWorker(env, state_, info.This().As<Napi::Object>(), &cursor_, cursor_->uri, config_);
+    worker->batch.remove = remove;
+    worker->batch.bulk = !remove && BulkOption(info);
+    worker->readCacheable = readCacheable_;
+    worker->batch.indexes = Indexes();
+    worker->batch.keyFormat = keyFormat_;
+    worker->batch.valueFormat = valueFormat_;
+    if (!worker->batch.Parse(env, info[0], true))
+    {
+      delete worker;
+      return env.Null();
+    }
+    if (worker->batch.bulk && !state_->busy)
+    {
+      FlushCache(*state_);
+    }
+    return worker->Schedule();
+  }
+
+  Napi::Value ScanFillAsync(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    const uint8_t *data;
+    size_t capacity;
+    if (info.Length() < 1 || !GetBytes(info[0], data, capacity))
+    {
+      Napi::TypeError::New(env, "ArrayBuffer or Buffer expected for scan chunk").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    if (!EnsureOpen(env))
+    {
+      return env.Null();
+    }
+
+    auto *worker = new CursorScanWorker(env, state_, info.This().As<Napi::Object>(), cursor_, &scan_,
+                                        info[0].As<Napi::Object>(), const_cast<uint8_t *>(data), capacity);
+    return worker->Schedule();
+  }
+
+  Napi::Value NextAsync(const Napi::CallbackInfo &info)
+  {
+    return StepAsync(info, true);
+  }
+
+  Napi::Value PrevAsync(const Napi::CallbackInfo &info)
+  {
+    return StepAsync(info, false);
+  }
+
+  Napi::Value StepAsync(const Napi::CallbackInfo &info, bool forward)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureOpen(env))
+    {
+      return env.Null();
+    }
+
+    auto *worker = new CursorStepWorker(env, state_, info.This().As<Napi::Object>(), cursor_, forward,
+                                        KeyBuffer(), ValueBuffer());
+    return worker->Schedule();
+  }
+
+  Napi::Value InsertAsync(const Napi::CallbackInfo &info)
+  {
+    return WriteAsync(info, CursorWriteWorker::INSERT);
+  }
+
+  Napi::Value UpdateAsync(const Napi::CallbackInfo &info)
+  {
+    return WriteAsync(info, CursorWriteWorker::UPDATE);
+  }
+
+  Napi::Value RemoveAsync(const Napi::CallbackInfo &info)
+  {
+    return WriteAsync(info, CursorWriteWorker::REMOVE);
+  }
+
+  Napi::Value WriteAsync(const Napi::CallbackInfo &info, CursorWriteWorker::Op op)
+  {
+    Napi::Env env = info.Env();
+
+    bool needsValue = op != CursorWriteWorker::REMOVE;
+    if (!EnsureOpen(env))
+    {
+      return env.Null();
+    }
+
+    FieldBuffer key = KeyBuffer();
+    FieldBuffer value = ValueBuffer();
+    if (!key.Read(env, info[0], "Key") || (needsValue && !value.Read(env, info[1], "Value")))
+    {
+      return env.Null();
+    }
+    auto *worker = new CursorWriteWorker(env, state_, info.This().As<Napi::Object>(), cursor_, op,
+                                         std::move(key), std::move(value), Indexes(), readCacheable_);
+    return worker->Schedule();
+  }
+};
+
+// session.commitTransactionAsync(config) / session.compactAsync(uri, config)
+class SessionCallWorker : public SessionWorker
+{
+public:
+  enum Op
+  {
+    COMMIT,
+    COMPACT
+  };
+
+  SessionCallWorker(Napi::Env env, const char *name, std::shared_ptr<SessionState> state, Napi::Object owner,
+                    Op op, std::string uri, std::string config)
+      : SessionWorker(env, name, std::move(state), owner), op_(op), uri_(std::move(uri)), config_(std::move(config))
+  {
+  }
+
+protected:
+  void Execute() override
+  {
+    WT_SESSION *session = state_->session;
+    const char *config = config_.empty() ? nullptr : config_.c_str();
+    if (op_ == COMMIT)
+    {
+      int ret = session->commit_transaction(session, config);
+      state_->inTransaction = false;
+      FinishCacheWrites(*state_, ret == 0);
+      if (ret != 0)
+      {
+        SetError("Failed to commit transaction: " + std::string(wiredtiger_strerror(ret)));
+      }
+    }
+    else
+    {
+      int ret = session->compact(session, uri_.c_str(), config);
+      if (ret != 0)
+      {
+        SetError("Failed to compact object: " + std::string(wiredtiger_strerror(ret)));
+      }
+    }
+  }
+
+  Napi::Value Result(Napi::Env env) override
+  {
+    return Napi::Boolean::New(env, true);
+  }
+
+private:
+  Op op_;
+  std::string uri_;
+  std::string config_;
+};
+
+// Group commits whose transaction has committed but whose log records may
+// not be on disk yet. The flush thread reports each flush through `flushed`;
+// the waiters are settled on the JS thread, which is the only one touching
+// this struct apart from `committer`.
+struct GroupCommitQueue
+{
+  std::unique_ptr<GroupCommit> committer;
+  Napi::ThreadSafeFunction flushed;
+  std::map<uint64_t, Napi::Promise::Deferred> waiters;
+  // Last ticket a successful flush covered, and the error of the first
+  // failed one. A flush can be reported before its commits register.
+  uint64_t durable = 0;
+  std::string error;
+
+  void Wait(uint64_t ticket, Napi::Promise::Deferred &deferred)
+  {
+    Napi::Env env = deferred.Env();
+    if (ticket <= durable)
+    {
+      deferred.Resolve(Napi::Boolean::New(env, true));
+    }
+    else if (!error.empty())
+    {
+      deferred.Reject(Napi::Error::New(env, error).Value());
+    }
+    else
+    {
+      if (waiters.empty())
+      {
+        // Pending commits keep the process alive until they are durable
+        flushed.Ref(env);
+      }
+      waiters.emplace(ticket, deferred);
+    }
+  }
+
+  void OnFlushed(Napi::Env env, uint64_t upTo, int ret)
+  {
+    if (ret == 0 && error.empty())
+    {
+      durable = upTo;
+    }
+    else if (error.empty())
+    {
+      error = "Transaction committed but the log flush failed: " + std::string(wiredtiger_strerror(ret));
+    }
+    for (auto it = waiters.begin(); it != waiters.end();)
+    {
+      if (it->first <= durable)
+      {
+        it->second.Resolve(Napi::Boolean::New(env, true));
+      }
+      else if (!error.empty())
+      {
+        it->second.Reject(Napi::Error::New(env, error).Value());
+      }
+      else
+      {
+        break;
+      }
+      it = waiters.erase(it);
+    }
+    if (waiters.empty())
+    {
+      flushed.Unref(env);
+    }
+  }
+};
+
+// session.commitTransactionAsync() on a connection opened with groupCommit:
+// commits without syncing the log, then resolves once the group flush that
+// covers the commit has finished
+class GroupCommitWorker : public SessionWorker
+{
+public:
+  GroupCommitWorker(Napi::Env env, std::shared_ptr<SessionState> state, Napi::Object owner, std::string config)
+      : SessionWorker(env, "WiredTigerSession.commitTransactionAsync", std::move(state), owner),
+        queue_(state_->groupCommit), config_(config.empty() ? "sync=off" : config + ",sync=off")
+  {
+  }
+
+protected:
+  void Execute() override
+  {
+    WT_SESSION *session = state_->session;
+    int ret = session->commit_transaction(session, config_.c_str());
+    state_->inTransaction = false;
+    FinishCacheWrites(*state_, ret == 0);
+    if (ret != 0)
+    {
+      SetError("Failed to commit transaction: " + std::string(wiredtiger_strerror(ret)));
+      return;
+    }
+    ticket_ = queue_->committer->Enqueue();
+  }
+
+  void Resolve(Napi::Promise::Deferred &deferred) override
+  {
+    queue_->Wait(ticket_, deferred);
+  }
+
+private:
+  std::shared_ptr<GroupCommitQueue> queue_;
+  std::string config_;
+  uint64_t ticket_ = 0;
+};
+
+// session.buildIndexAsync(table, name, options): rebuilds a field index on
+// pooled sessions of its own, see field_index::Builder
+class IndexBuildWorker : public SessionWorker
+{
+public:
+  IndexBuildWorker(Napi::Env env, std::shared_ptr<SessionState> state, Napi::Object owner, field_index::Definition index,
+                   unsigned threads)
+      : SessionWorker(env, "WiredTigerSession.buildIndexAsync", state, owner), pool_(state->pool),
+        index_(std::move(index)), threads_(threads), count_(0)
+  {
+  }
+
+protected:
+  void Execute() override
+  {
+    field_index::Builder builder(*pool_, index_, threads_);
+    if (builder.Run() != 0)
+    {
+      SetError("Failed to build index: " + builder.Error());
+      return;
+    }
+    count_ = builder.Count();
+  }
+
+  Napi::Value Result(Napi::Env env) override
+  {
+    return Napi::Number::New(env, (double)count_);
+  }
+
+private:
+  std::shared_ptr<SessionPool> pool_;
+  field_index::Definition index_;
+  unsigned threads_;
+  uint64_t count_;
+};
+
+// Group values are kept as the JSON text they had in the first matching
+// document, so they come back exactly as stored
+static Napi::Value ParseJson(Napi::Env env, const std::string &text)
+{
+  Napi::Object json = env.Global().Get("JSON").As<Napi::Object>();
+  return json.Get("parse").As<Napi::Function>().Call(json, {Napi::String::New(env, text)});
+}
+
+static Napi::Object AggregateTotals(Napi::Env env, const aggregate::Totals &totals)
+{
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("count", Napi::Number::New(env, (double)totals.count));
+  result.Set("sum", Napi::Number::New(env, totals.sum));
+  result.Set("min", totals.numeric > 0 ? Napi::Number::New(env, totals.min) : env.Null());
+  result.Set("max", totals.numeric > 0 ? Napi::Number::New(env, totals.max) : env.Null());
+  return result;
+}
+
+class AggregateWorker : public SessionWorker
+{
+public:
+  AggregateWorker(Napi::Env env, std::shared_ptr<SessionState> state, Napi::Object owner, aggregate::Spec spec,
+                  unsigned threads)
+      : SessionWorker(env, "WiredTigerSession.aggregateAsync", state, owner), pool_(state->pool),
+        aggregator_(*pool_, std::move(spec), threads), grouped_(false)
+  {
+  }
+
+  void SetGrouped(bool grouped)
+  {
+    grouped_ = grouped;
+  }
+
+protected:
+  void Execute() override
+  {
+    if (aggregator_.Run() != 0)
+    {
+      SetError("Aggregation failed: " + aggregator_.Error());
+    }
+  }
+
+  Napi::Value Result(Napi::Env env) override
+  {
+    const aggregate::Result &result = aggregator_.Get();
+    Napi::Object totals = AggregateTotals(env, result.totals);
+    if (grouped_)
+    {
+      Napi::Array groups = Napi::Array::New(env, result.groups.size());
+      uint32_t i = 0;
+      for (const auto &entry : result.groups)
+      {
+        Napi::Object group = AggregateTotals(env, entry.second.totals);
+        group.Set("key", ParseJson(env, entry.second.token));
+        groups.Set(i++, group);
+      }
+      totals.Set("groups", groups);
+    }
+    return totals;
+  }
+
+private:
+  std::shared_ptr<SessionPool> pool_;
+  aggregate::Aggregator aggregator_;
+  bool grouped_;
+};
+
+// Runs parallelScan's next() and close() off the JS thread: next() starts
+// the scan on first use, then waits for a batch; close() cancels it
+class ParallelScanWorker : public Napi::AsyncWorker
+{
+public:
+  enum Op
+  {
+    NEXT,
+    CLOSE
+  };
+
+  ParallelScanWorker(Napi::Env env, std::shared_ptr<parallel_scan::Scanner> scanner, Op op, bool start,
+                     bool *busy, Napi::Object owner, std::shared_ptr<SessionState> state)
+      : Napi::AsyncWorker(env, "WiredTigerParallelScan.next"), scanner_(std::move(scanner)), op_(op),
+        start_(start), busy_(busy), state_(std::move(state)), deferred_(Napi::Promise::Deferred::New(env))
+  {
+    owner_ = Napi::Persistent(owner);
+    state_->scanCalls++;
+  }
+
+  Napi::Promise Promise()
+  {
+    return deferred_.Promise();
+  }
+
+protected:
+  void Execute() override
+  {
+    if (op_ == CLOSE)
+    {
+      scanner_->Cancel();
+      return;
+    }
+    if (start_ && scanner_->Start() != 0)
+    {
+      SetError("Parallel scan failed: " + scanner_->Error());
+      return;
+    }
+    found_ = scanner_->Next(batch_);
+    std::string error = scanner_->Error();
+    if (!found_ && !error.empty())
+    {
+      SetError("Parallel scan failed: " + error);
+    }
+    else if (!found_ && scanner_->Cancelled())
+    {
+      // Only closing the session cancels a scan under a pending next()
+      SetError("Parallel scan cancelled: its session was closed");
+    }
+  }
+
+  void OnOK() override
+  {
+    Napi::Env env = Env();
+    *busy_ = false;
+    state_->scanCalls--;
+    if (!found_)
+    {
+      deferred_.Resolve(env.Null());
+      return;
+    }
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("chunk", Napi::Buffer<char>::Copy(env, batch_.data.data(), batch_.data.size()));
+    result.Set("count", Napi::Number::New(env, (double)batch_.rows));
+    result.Set("part", Napi::Number::New(env, (double)batch_.part));
+    deferred_.Resolve(result);
+  }
+
+  void OnError(const Napi::Error &error) override
+  {
+    *busy_ = false;
+    state_->scanCalls--;
+    deferred_.Reject(error.Value());
+  }
+
+private:
+  std::shared_ptr<parallel_scan::Scanner> scanner_;
+  Op op_;
+  bool start_;
+  // The wrapper's flag; `owner_` keeps the wrapper alive
+  bool *busy_;
+  // The session the scan was started from
+  std::shared_ptr<SessionState> state_;
+  Napi::Promise::Deferred deferred_;
+  Napi::ObjectReference owner_;
+  parallel_scan::Batch batch_;
+  bool found_ = false;
+};
+
+// Handle returned by session.parallelScan(). One next() or close() at a time.
+class WiredTigerParallelScan : public Napi::ObjectWrap<WiredTigerParallelScan>
+{
+public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports)
+  {
+    Napi::Function func = DefineClass(env, "WiredTigerParallelScan", {InstanceMethod("next", &WiredTigerParallelScan::Next), InstanceMethod("close", &WiredTigerParallelScan::Close)});
+
+    env.GetInstanceData<AddonData>()->parallelScanConstructor = Napi::Persistent(func);
+    exports.Set("WiredTigerParallelScan", func);
+    return exports;
+  }
+
+  static Napi::Object NewInstance(Napi::Env env, std::shared_ptr<parallel_scan::Scanner> scanner,
+                                  std::shared_ptr<SessionState> state)
+  {
+    Napi::EscapableHandleScope scope(env);
+    Napi::Object obj = env.GetInstanceData<AddonData>()->parallelScanConstructor.New({});
+    WiredTigerParallelScan *wrapper = Napi::ObjectWrap<WiredTigerParallelScan>::Unwrap(obj);
+    wrapper->scanner_ = std::move(scanner);
+    wrapper->state_ = std::move(state);
+    return scope.Escape(napi_value(obj)).ToObject();
+  }
+
+  WiredTigerParallelScan(const Napi::CallbackInfo &info) : Napi::ObjectWrap<WiredTigerParallelScan>(info)
+  {
+  }
+
+private:
+  std::shared_ptr<parallel_scan::Scanner> scanner_;
+  std::shared_ptr<SessionState> state_;
+  bool started_ = false;
+  bool busy_ = false;
+
+  Napi::Value Schedule(const Napi::CallbackInfo &info, ParallelScanWorker::Op op)
+  {
+    Napi::Env env = info.Env();
+    if (!scanner_)
+    {
+      Napi::Error::New(env, "Parallel scan is closed").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    if (busy_)
+    {
+      Napi::Error::New(env, "Parallel scan is busy with another call").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    busy_ = true;
+    auto *worker = new ParallelScanWorker(env, scanner_, op, op == ParallelScanWorker::NEXT && !started_, &busy_,
+                                          info.This().As<Napi::Object>(), state_);
+    started_ = true;
+    if (op == ParallelScanWorker::CLOSE)
+    {
+      scanner_.reset();
+    }
+    Napi::Promise promise = worker->Promise();
+    worker->Queue();
+    return promise;
+  }
+
+  Napi::Value Next(const Napi::CallbackInfo &info)
+  {
+    return Schedule(info, ParallelScanWorker::NEXT);
+  }
+
+  Napi::Value Close(const Napi::CallbackInfo &info)
+  {
+    return Schedule(info, ParallelScanWorker::CLOSE);
+  }
+};
+
+// Opens a cursor. Typed tables are reopened in raw mode so their keys and
+// values can be packed natively (see RecordFormat); `config` is updated to
+// the config actually used.
+static int OpenCursorHandle(WT_SESSION *session, const std::string &uri, std::string &config, WT_CURSOR **cursor)
+{
+  int ret = session->open_cursor(session, uri.c_str(), nullptr, config.empty() ? nullptr : config.c_str(), cursor);
+  if (ret != 0 || HasConfigKey(config, "raw") ||
+      (!RecordFormat::Get((*cursor)->key_format) && !RecordFormat::Get((*cursor)->value_format)))
+  {
+    return ret;
+  }
+
+  (*cursor)->close(*cursor);
+  config = config.empty() ? "raw" : config + ",raw";
+  return session->open_cursor(session, uri.c_str(), nullptr, config.c_str(), cursor);
+}
+
+// Parses a range over a table the caller holds no cursor on. The key format
+// is read, and typed bounds packed, on a pooled session, as the caller's own
+// may be busy. A table that can't be opened is left for the scan itself to
+// report. Throws and returns false on bad input.
+static bool ParseTableRange(Napi::Env env, SessionPool &pool, const std::string &uri, Napi::Value input, RangeScan &range)
+{
+  WT_SESSION *session;
+  if (pool.Acquire(&session, false) != 0)
+  {
+    return range.Parse(env, input);
+  }
+  WT_CURSOR *cursor;
+  if (session->open_cursor(session, uri.c_str(), nullptr, nullptr, &cursor) != 0)
+  {
+    pool.Release(session);
+    return range.Parse(env, input);
+  }
+  bool ok = range.Parse(env, input, RecordFormat::Get(cursor->key_format));
+  cursor->close(cursor);
+  int ret = ok ? range.PackBounds(session) : 0;
+  pool.Release(session);
+  if (ret != 0)
+  {
+    Napi::Error::New(env, "Failed to pack bounds: " + std::string(wiredtiger_strerror(ret))).ThrowAsJavaScriptException();
+    return false;
+  }
+  return ok;
+}
+
+// WiredTigerSession class (defined second since it's used by WiredTigerConnection)
+class WiredTigerSession : public Napi::ObjectWrap<WiredTigerSession>
+{
+public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports)
+  {
+    Napi::Function func = DefineClass(env, "WiredTigerSession", {InstanceMethod("createTable", &WiredTigerSession::CreateTable), InstanceMethod("openCursor", &WiredTigerSession::OpenCursor), InstanceMethod("close", &WiredTigerSession::Close), InstanceMethod("beginTransaction", &WiredTigerSession::BeginTransaction), InstanceMethod("commitTransaction", &WiredTigerSession::CommitTransaction), InstanceMethod("rollbackTransaction", &WiredTigerSession::RollbackTransaction), InstanceMethod("openCursorWithConfig", &WiredTigerSession::OpenCursorWithConfig), InstanceMethod("createIndex", &WiredTigerSession::CreateIndex), InstanceMethod("drop", &WiredTigerSession::Drop), InstanceMethod("compact", &WiredTigerSession::Compact), InstanceMethod("commitTransactionAsync", &WiredTigerSession::CommitTransactionAsync), InstanceMethod("compactAsync", &WiredTigerSession::CompactAsync), InstanceMethod("getCursorCacheStats", &WiredTigerSession::GetCursorCacheStats), InstanceMethod("registerIndex", &WiredTigerSession::RegisterIndex), InstanceMethod("dropIndex", &WiredTigerSession::DropIndex), InstanceMethod("buildIndexAsync", &WiredTigerSession::BuildIndexAsync), InstanceMethod("findByIndex", &WiredTigerSession::FindByIndex), InstanceMethod("countByIndex", &WiredTigerSession::CountByIndex), InstanceMethod("aggregateAsync", &WiredTigerSession::AggregateAsync), InstanceMethod("parallelScan", &WiredTigerSession::ParallelScan), InstanceMethod("timestampTransaction", &WiredTigerSession::TimestampTransaction), InstanceMethod("queryTimestamp", &WiredTigerSession::QueryTimestamp)});
+
+    env.GetInstanceData<AddonData>()->sessionConstructor = Napi::Persistent(func);
+    exports.Set("WiredTigerSession", func);
+    return exports;
+  }
+
+  static Napi::Object NewInstance(Napi::Env env, std::shared_ptr<SessionState> state)
+  {
+    Napi::EscapableHandleScope scope(env);
+    Napi::Object obj = env.GetInstanceData<AddonData>()->sessionConstructor.New({});
+    WiredTigerSession *wrapper = Napi::ObjectWrap<WiredTigerSession>::Unwrap(obj);
+    WT_SESSION *session = state->session;
+    wrapper->state_ = std::move(state);
+    if (session)
+    {
+      const char *idProperty = "__nativeSessionPtr";
+      uintptr_t rawPtr = reinterpret_cast<uintptr_t>(session);
+      obj.Set(idProperty, Napi::String::New(env, std::to_string(rawPtr)));
+    }
+    return scope.Escape(napi_value(obj)).ToObject();
+  }
+
+  WiredTigerSession(const Napi::CallbackInfo &info)
+      : Napi::ObjectWrap<WiredTigerSession>(info)
+  {
+  }
+
+  ~WiredTigerSession()
+  {
+    // Session is managed by connection, don't close here
+  }
+
+private:
+  std::shared_ptr<SessionState> state_;
+
+  Napi::Value CreateTable(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureSessionUsable(env, state_))
+    {
+      return env.Null();
+    }
+
+    if (info.Length() < 1 || !info[0].IsString())
+    {
+      Napi::TypeError::New(env, "String expected for table name").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    std::string tableName = info[0].As<Napi::String>().Utf8Value();
+    std::string config = info.Length() > 1 && info[1].IsString()
+                             ? info[1].As<Napi::String>().Utf8Value()
+                             : "key_format=S,value_format=S";
+    // Keys sharing a prefix (compound keys, index entries) are stored once
+    // per page; opt out with prefix_compression=false
+    if (!HasConfigKey(config, "prefix_compression"))
+    {
+      config += config.empty() ? "prefix_compression=true" : ",prefix_compression=true";
+    }
+
+    std::string uri = "table:" + tableName;
+    int ret = state_->session->create(state_->session, uri.c_str(), config.c_str());
+
+    if (ret != 0 && ret != EEXIST)
+    {
+      Napi::Error::New(env, "Failed to create table: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    return Napi::Boolean::New(env, true);
+  }
+
+  Napi::Value OpenCursor(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureSessionUsable(env, state_))
+    {
+      return env.Null();
+    }
+
+    if (info.Length() < 1 || !info[0].IsString())
+    {
+      Napi::TypeError::New(env, "String expected for table name").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    std::string tableName = info[0].As<Napi::String>().Utf8Value();
+    std::string uri = "table:" + tableName;
+
+    std::string cacheKey = CursorCacheKey(uri, "");
+    Napi::Object cached = WiredTigerCursor::TakeCached(env, *state_, cacheKey);
+    if (!cached.IsEmpty())
+    {
+      return cached;
+    }
+
+    WT_CURSOR *cursor;
+    std::string config;
+    int ret = OpenCursorHandle(state_->session, uri, config, &cursor);
+
+    if (ret != 0)
+    {
+      Napi::Error::New(env, "Failed to open cursor: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    Napi::Object cursorObj = WiredTigerCursor::NewInstance(env, cursor, state_, config, cacheKey);
+    return cursorObj;
+  }
+
+  Napi::Value OpenCursorWithConfig(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureSessionUsable(env, state_))
+    {
+      return env.Null();
+    }
+
+    if (info.Length() < 1 || !info[0].IsString())
+    {
+      Napi::TypeError::New(env, "URI string expected for cursor").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    std::string uri = info[0].As<Napi::String>().Utf8Value();
+    std::string config = info.Length() > 1 && info[1].IsString() ? info[1].As<Napi::String>().Utf8Value() : "";
+
+    std::string cacheKey = CursorCacheKey(uri, config);
+    Napi::Object cached = WiredTigerCursor::TakeCached(env, *state_, cacheKey);
+    if (!cached.IsEmpty())
+    {
+      return cached;
+    }
+
+    WT_CURSOR *cursor;
+    int ret = OpenCursorHandle(state_->session, uri, config, &cursor);
+
+    if (ret != 0)
+    {
+      Napi::Error::New(env, "Failed to open cursor: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    Napi::Object cursorObj = WiredTigerCursor::NewInstance(env, cursor, state_, config, cacheKey);
+    return cursorObj;
+  }
+
+  Napi::Value CreateIndex(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureSessionUsable(env, state_))
+    {
+      return env.Null();
+    }
+
+    if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString())
+    {
+      Napi::TypeError::New(env, "URI and config strings expected for createIndex").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    std::string uri = info[0].As<Napi::String>().Utf8Value();
+    std::string config = info[1].As<Napi::String>().Utf8Value();
+
+    int ret = state_->session->create(state_->session, uri.c_str(), config.c_str());
+
+    if (ret != 0 && ret != EEXIST)
+    {
+      Napi::Error::New(env, "Failed to create index: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    return Napi::Boolean::New(env, true);
+  }
+
+  Napi::Value Drop(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureSessionUsable(env, state_))
+    {
+      return env.Null();
+    }
+
+    if (info.Length() < 1 || !info[0].IsString())
+    {
+      Napi::TypeError::New(env, "URI string expected for drop").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    std::string uri = info[0].As<Napi::String>().Utf8Value();
+    std::string config = info.Length() > 1 && info[1].IsString() ? info[1].As<Napi::String>().Utf8Value() : "";
+
+    // Cached cursors keep their objects open
+    WiredTigerCursor::FlushCache(*state_);
+    int ret = state_->session->drop(state_->session, uri.c_str(), config.empty() ? nullptr : config.c_str());
+    if (ret == 0 && state_->readCache)
+    {
+      state_->readCache->InvalidateTable(uri);
+    }
+
+    if (ret != 0 && ret != WT_NOTFOUND)
+    {
+      Napi::Error::New(env, "Failed to drop object: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    return Napi::Boolean::New(env, true);
+  }
+
+  Napi::Value Compact(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureSessionUsable(env, state_))
+    {
+      return env.Null();
+    }
+
+    if (info.Length() < 1 || !info[0].IsString())
+    {
+      Napi::TypeError::New(env, "URI string expected for compact").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    std::string uri = info[0].As<Napi::String>().Utf8Value();
+    std::string config = info.Length() > 1 && info[1].IsString() ? info[1].As<Napi::String>().Utf8Value() : "";
+
+    int ret = state_->session->compact(state_->session, uri.c_str(), config.empty() ? nullptr : config.c_str());
+
+    if (ret != 0)
+    {
+      Napi::Error::New(env, "Failed to compact object: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    return Napi::Boolean::New(env, true);
+  }
+
+  // registerIndex(table, name, field, { unique }): maintains an index on a
+  // (dotted) field of the JSON documents in `table` from now on. Returns
+  // true if the index table was created, i.e. needs buildIndexAsync() if
+  // the table already holds documents.
+  Napi::Value RegisterIndex(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureSessionUsable(env, state_))
+    {
+      return env.Null();
+    }
+
+    if (info.Length() < 3 || !info[0].IsString() || !info[1].IsString() || !info[2].IsString())
+    {
+      Napi::TypeError::New(env, "Table, index name and field strings expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    field_index::Definition index;
+    index.table = "table:" + info[0].As<Napi::String>().Utf8Value();
+    index.name = info[1].As<Napi::String>().Utf8Value();
+    index.field = info[2].As<Napi::String>().Utf8Value();
+    index.uri = index.table + "_idx_" + index.name;
+    if (info.Length() > 3 && info[3].IsObject())
+    {
+      Napi::Value unique = info[3].As<Napi::Object>().Get("unique");
+      index.unique = unique.IsBoolean() && unique.As<Napi::Boolean>().Value();
+    }
+
+    if (index.name.empty() || !field_index::ParsePath(index.field, index.path))
+    {
+      Napi::TypeError::New(env, "Index name and field path must not be empty").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    WT_SESSION *session = state_->session;
+    WT_CURSOR *cursor;
+    int ret = session->open_cursor(session, index.table.c_str(), nullptr, nullptr, &cursor);
+    if (ret != 0)
+    {
+      Napi::Error::New(env, "Failed to register index: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    bool documents = std::strcmp(cursor->key_format, "u") == 0 && std::strcmp(cursor->value_format, "u") == 0;
+    cursor->close(cursor);
+    if (!documents)
+    {
+      Napi::Error::New(env, "Field indexes need a key_format=u,value_format=u table").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    ret = session->create(session, index.uri.c_str(), "key_format=u,value_format=u,prefix_compression=true,exclusive=true");
+    if (ret != 0 && ret != EEXIST)
+    {
+      Napi::Error::New(env, "Failed to create index table: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    bool created = ret == 0;
+    ret = field_index::SaveDefinition(session, index);
+    if (ret != 0)
+    {
+      Napi::Error::New(env, "Failed to record index: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    state_->indexes->Add(index);
+    return Napi::Boolean::New(env, created);
+  }
+
+  Napi::Value DropIndex(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureSessionUsable(env, state_))
+    {
+      return env.Null();
+    }
+
+    if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString())
+    {
+      Napi::TypeError::New(env, "Table and index name strings expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    std::string table = "table:" + info[0].As<Napi::String>().Utf8Value();
+    std::string name = info[1].As<Napi::String>().Utf8Value();
+    std::string uri = table + "_idx_" + name;
+    int ret = field_index::RemoveDefinition(state_->session, uri);
+    if (ret != 0)
+    {
+      Napi::Error::New(env, "Failed to drop index: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    state_->indexes->Remove(table, name);
+
+    WiredTigerCursor::FlushCache(*state_);
+    ret = state_->session->drop(state_->session, uri.c_str(), nullptr);
+    if (ret != 0 && ret != WT_NOTFOUND && ret != ENOENT)
+    {
+      Napi::Error::New(env, "Failed to drop index: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    return Napi::Boolean::New(env, true);
+  }
+
+  // buildIndexAsync(table, name, { threads }): repopulates a registered index
+  // from the table. Resolves with the number of entries written.
+  Napi::Value BuildIndexAsync(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!state_ || !state_->session)
+    {
+      Napi::Error::New(env, "Session is closed").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    field_index::Definition index;
+    if (!FindIndex(env, info, index))
+    {
+      return env.Null();
+    }
+    if (!state_->pool)
+    {
+      Napi::Error::New(env, "Index builds need a pooled session").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    unsigned threads = 4;
+    if (info.Length() > 2 && info[2].IsObject())
+    {
+      Napi::Value threadsOpt = info[2].As<Napi::Object>().Get("threads");
+      if (threadsOpt.IsNumber() && threadsOpt.As<Napi::Number>().Int32Value() > 0)
+      {
+        threads = (unsigned)threadsOpt.As<Napi::Number>().Int32Value();
+      }
+    }
+
+    auto *worker = new IndexBuildWorker(env, state_, info.This().As<Napi::Object>(), std::move(index), threads);
+    return worker->Schedule();
+  }
+
+  // findByIndex(table, name, value, { limit }): primary keys of the
+  // documents whose indexed field equals `value` (string, number, boolean or
+  // null), or falls in { gt, gte, lt, lte } of such values, in index order
+  Napi::Value FindByIndex(const Napi::CallbackInfo &info)
+  {
+    return LookupIndex(info, false);
+  }
+
+  // countByIndex(table, name, value): number of documents whose indexed
+  // field equals `value` or falls in its range, counted from the index alone
+  Napi::Value CountByIndex(const Napi::CallbackInfo &info)
+  {
+    return LookupIndex(info, true);
+  }
+
+  // aggregateAsync(table, { gt, gte, lt, lte, filter, field, groupBy,
+  // threads }): resolves with { count, sum, min, max } over the matching
+  // documents of the range, plus { key, count, sum, min, max } per distinct
+  // `groupBy` value. sum/min/max cover the documents where `field` is a
+  // number.
+  Napi::Value AggregateAsync(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!state_ || !state_->session)
+    {
+      Napi::Error::New(env, "Session is closed").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    if (info.Length() < 1 || !info[0].IsString())
+    {
+      Napi::TypeError::New(env, "Table name string expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    if (!state_->pool)
+    {
+      Napi::Error::New(env, "Aggregation needs a pooled session").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    Napi::Value input = info.Length() > 1 ? info[1] : env.Undefined();
+    aggregate::Spec spec;
+    spec.uri = "table:" + info[0].As<Napi::String>().Utf8Value();
+    RangeScan range;
+    if (!ParseTableRange(env, *state_->pool, spec.uri, input, range))
+    {
+      return env.Null();
+    }
+
+    spec.lower = range.lower;
+    spec.upper = range.upper;
+    spec.hasLower = range.hasLower;
+    spec.hasUpper = range.hasUpper;
+    spec.lowerInclusive = range.lowerInclusive;
+    spec.upperInclusive = range.upperInclusive;
+    spec.filter = range.filter;
+
+    unsigned threads = 4;
+    if (input.IsObject())
+    {
+      Napi::Object options = input.As<Napi::Object>();
+      const char *pathOptions[] = {"field", "groupBy"};
+      std::vector<std::string> *paths[] = {&spec.field, &spec.groupBy};
+      for (int i = 0; i < 2; i++)
+      {
+        Napi::Value pathOpt = options.Get(pathOptions[i]);
+        if (pathOpt.IsUndefined())
+        {
+          continue;
+        }
+        if (!pathOpt.IsString() || !field_index::ParsePath(pathOpt.As<Napi::String>().Utf8Value(), *paths[i]))
+        {
+          Napi::TypeError::New(env, std::string("Field path expected for ") + pathOptions[i])
+              .ThrowAsJavaScriptException();
+          return env.Null();
+        }
+      }
+
+      Napi::Value threadsOpt = options.Get("threads");
+      if (threadsOpt.IsNumber() && threadsOpt.As<Napi::Number>().Int32Value() > 0)
+      {
+        threads = (unsigned)threadsOpt.As<Napi::Number>().Int32Value();
+      }
+    }
+
+    bool grouped = !spec.groupBy.empty();
+    auto *worker = new AggregateWorker(env, state_, info.This().As<Napi::Object>(), std::move(spec), threads);
+    worker->SetGrouped(grouped);
+    return worker->Schedule();
+  }
+
+  // parallelScan(table, options): a WiredTigerParallelScan over the range,
+  // started by its first next()
+  Napi::Value ParallelScan(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!state_ || !state_->session)
+    {
+      Napi::Error::New(env, "Session is closed").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    if (info.Length() < 1 || !info[0].IsString())
+    {
+      Napi::TypeError::New(env, "Table name string expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    if (!state_->pool)
+    {
+      Napi::Error::New(env, "Parallel scans need a pooled session").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    Napi::Value input = info.Length() > 1 ? info[1] : env.Undefined();
+    parallel_scan::Spec spec;
+    spec.uri = "table:" + info[0].As<Napi::String>().Utf8Value();
+    RangeScan range;
+    if (!ParseTableRange(env, *state_->pool, spec.uri, input, range))
+    {
+      return env.Null();
+    }
+
+    spec.lower = range.lower;
+    spec.upper = range.upper;
+    spec.hasLower = range.hasLower;
+    spec.hasUpper = range.hasUpper;
+    spec.lowerInclusive = range.lowerInclusive;
+    spec.upperInclusive = range.upperInclusive;
+    spec.filter = range.filter;
+
+    // Options beyond the range: { threads, ordered, snapshot, readTimestamp,
+    // batchSize, queueDepth }
+    unsigned threads = 4;
+    if (input.IsObject())
+    {
+      Napi::Object options = input.As<Napi::Object>();
+      Napi::Value threadsOpt = options.Get("threads");
+      if (threadsOpt.IsNumber() && threadsOpt.As<Napi::Number>().Int32Value() > 0)
+      {
+        threads = (unsigned)threadsOpt.As<Napi::Number>().Int32Value();
+      }
+      Napi::Value ordered = options.Get("ordered");
+      if (ordered.IsBoolean())
+      {
+        spec.ordered = ordered.As<Napi::Boolean>().Value();
+      }
+      Napi::Value snapshot = options.Get("snapshot");
+      if (snapshot.IsString())
+      {
+        std::string mode = snapshot.As<Napi::String>().Utf8Value();
+        if (mode != "checkpoint" && mode != "none")
+        {
+          Napi::TypeError::New(env, "snapshot must be 'checkpoint' or 'none'").ThrowAsJavaScriptException();
+          return env.Null();
+        }
+        spec.snapshot = mode == "none" ? parallel_scan::NONE : parallel_scan::CHECKPOINT;
+      }
+      Napi::Value timestamp = options.Get("readTimestamp");
+      if (timestamp.IsString())
+      {
+        spec.snapshot = parallel_scan::TIMESTAMP;
+        spec.readTimestamp = timestamp.As<Napi::String>().Utf8Value();
+      }
+      Napi::Value batchSize = options.Get("batchSize");
+      if (batchSize.IsNumber() && batchSize.As<Napi::Number>().Int64Value() > 0)
+      {
+        spec.batchBytes = (size_t)batchSize.As<Napi::Number>().Int64Value();
+      }
+      Napi::Value depth = options.Get("queueDepth");
+      if (depth.IsNumber() && depth.As<Napi::Number>().Int64Value() > 0)
+      {
+        spec.queueDepth = (size_t)depth.As<Napi::Number>().Int64Value();
+      }
+    }
+
+    auto scanner = std::make_shared<parallel_scan::Scanner>(state_->pool, std::move(spec), threads, state_->connection);
+    state_->scans.erase(std::remove_if(state_->scans.begin(), state_->scans.end(),
+                                       [](const std::weak_ptr<parallel_scan::Scanner> &scan)
+                                       { return scan.expired(); }),
+                        state_->scans.end());
+    state_->scans.push_back(scanner);
+    return WiredTigerParallelScan::NewInstance(env, std::move(scanner), state_);
+  }
+
+  // Encoded value bounds of an index lookup. An empty lower bound starts at
+  // the first entry; an empty upper bound runs to the last.
+  struct IndexRange
+  {
+    std::string lower, upper;
+    bool lowerExclusive = false, upperInclusive = false;
+  };
+
+  static bool ReadIndexRange(Napi::Env env, Napi::Value input, IndexRange &range)
+  {
+    if (EncodeFieldValue(input, range.lower))
+    {
+      range.upper = range.lower;
+      range.upperInclusive = true;
+      return true;
+    }
+    if (!input.IsObject() || input.IsArray())
+    {
+      Napi::TypeError::New(env, "String, number, boolean, null or { gt, gte, lt, lte } expected for index value")
+          .ThrowAsJavaScriptException();
+      return false;
+    }
+    Napi::Object options = input.As<Napi::Object>();
+    const char *names[] = {"gt", "gte", "lt", "lte"};
+    for (const char *name : names)
+    {
+      Napi::Value value = options.Get(name);
+      if (value.IsUndefined())
+      {
+        continue;
+      }
+      bool lower = name[0] == 'g';
+      std::string &bound = lower ? range.lower : range.upper;
+      bound.clear();
+      if (!EncodeFieldValue(value, bound))
+      {
+        Napi::TypeError::New(env, std::string("String, number, boolean or null expected for ") + name)
+            .ThrowAsJavaScriptException();
+        return false;
+      }
+      bool strict = name[2] == '\0';
+      if (lower)
+      {
+        range.lowerExclusive = strict;
+      }
+      else
+      {
+        range.upperInclusive = !strict;
+      }
+    }
+    // A one-sided range stays among values of its bound's type, whose
+    // encodings all start with the same tag byte
+    if (range.upper.empty() && !range.lower.empty())
+    {
+      range.upper = range.lower.substr(0, 1);
+      range.upperInclusive = true;
+    }
+    else if (range.lower.empty() && !range.upper.empty())
+    {
+      range.lower = range.upper.substr(0, 1);
+    }
+    return true;
+  }
+
+  // Where an index entry falls relative to an encoded value: below it, an
+  // entry of that value (it starts with it; encodings are prefix-free) or
+  // above it
+  static int CompareIndexKey(const WT_ITEM &key, const std::string &value)
+  {
+    int cmp = std::memcmp(key.data, value.data(), std::min(key.size, value.size()));
+    if (cmp != 0)
+    {
+      return cmp < 0 ? -1 : 1;
+    }
+    return key.size < value.size() ? -1 : 0;
+  }
+
+  // Range scan of an index for findByIndex/countByIndex. Unique entries are
+  // keyed by the value alone; the others by the value followed by the
+  // primary key.
+  Napi::Value LookupIndex(const Napi::CallbackInfo &info, bool countOnly)
+  {
+    Napi::Env env = info.Env();
+
+    if (!EnsureSessionUsable(env, state_))
+    {
+      return env.Null();
+    }
+
+    field_index::Definition index;
+    if (!FindIndex(env, info, index))
+    {
+      return env.Null();
+    }
+
+    IndexRange range;
+    if (!ReadIndexRange(env, info.Length() > 2 ? info[2] : env.Undefined(), range))
+    {
+      return env.Null();
+    }
+
+    uint32_t limit = UINT32_MAX;
+    if (info.Length() > 3 && info[3].IsObject())
+    {
+      Napi::Value limitOpt = info[3].As<Napi::Object>().Get("limit");
+      if (limitOpt.IsNumber() && limitOpt.As<Napi::Number>().Int64Value() >= 0)
+      {
+        limit = (uint32_t)std::min<int64_t>(limitOpt.As<Napi::Number>().Int64Value(), UINT32_MAX);
+      }
+    }
+
+    WT_SESSION *session = state_->session;
+    WT_CURSOR *cursor;
+    int ret = session->open_cursor(session, index.uri.c_str(), nullptr, nullptr, &cursor);
+    if (ret != 0)
+    {
+      Napi::Error::New(env, "Failed to open index: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    Napi::Array result = Napi::Array::New(env);
+    WT_ITEM key_item, value_item;
+    if (range.lower.empty())
+    {
+      ret = cursor->next(cursor);
+    }
+    else
+    {
+      key_item.data = range.lower.data();
+      key_item.size = range.lower.size();
+      cursor->set_key(cursor, &key_item);
+      int exact = 0;
+      ret = cursor->search_near(cursor, &exact);
+      if (ret == 0 && exact < 0)
+      {
+        ret = cursor->next(cursor);
+      }
+    }
+    uint32_t count = 0;
+    while (ret == 0 && count < limit)
+    {
+      if ((ret = cursor->get_key(cursor, &key_item)) != 0)
+      {
+        break;
+      }
+      if (range.lowerExclusive && CompareIndexKey(key_item, range.lower) == 0)
+      {
+        ret = cursor->next(cursor);
+        continue;
+      }
+      if (!range.upper.empty())
+      {
+        int cmp = CompareIndexKey(key_item, range.upper);
+        if (cmp > 0 || (cmp == 0 && !range.upperInclusive))
+        {
+          break;
+        }
+      }
+      if (!countOnly)
+      {
+        if ((ret = cursor->get_value(cursor, &value_item)) != 0)
+        {
+          break;
+        }
+        result.Set(count, Napi::String::New(env, (const char *)value_item.data, value_item.size));
+      }
+      count++;
+      ret = cursor->next(cursor);
+    }
+    cursor->close(cursor);
+
+    if (ret != 0 && ret != WT_NOTFOUND)
+    {
+      Napi::Error::New(env, "Index lookup failed: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    if (countOnly)
+    {
+      return Napi::Number::New(env, (double)count);
+    }
+    return result;
+  }
+
+  // Looks up the index named by info[0] (table) and info[1] (name). Throws
+  // and returns false if it isn't registered.
+  bool FindIndex(Napi::Env env, const Napi::CallbackInfo &info, field_index::Definition &index)
+  {
+    if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString())
+    {
+      Napi::TypeError::New(env, "Table and index name strings expected").ThrowAsJavaScriptException();
+      return false;
+    }
+    std::string table = "table:" + info[0].As<Napi::String>().Utf8Value();
+    std::string name = info[1].As<Napi::String>().Utf8Value();
+    if (!state_->indexes || !state_->indexes->Find(table, name, index))
+    {
+      Napi::Error::New(env, "No index '" + name + "' registered on " + table).ThrowAsJavaScriptException();
+      return false;
+    }
+    return true;
+  }
+
+  Napi::Value GetCursorCacheStats(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    Napi::Object stats = Napi::Object::New(env);
+    stats.Set("size", Napi::Number::New(env, (double)state_->cursorCacheMax));
+    stats.Set("cached", Napi::Number::New(env, (double)state_->cursorCache.size()));
+    stats.Set("hits", Napi::Number::New(env, (double)state_->cursorCacheHits));
+    stats.Set("misses", Napi::Number::New(env, (double)state_->cursorCacheMisses));
+    stats.Set("evictions", Napi::Number::New(env, (double)state_->cursorCacheEvictions));
+    return stats;
+  }
+
+  Napi::Value Close(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (state_ && state_->session)
+    {
+      if (state_->busy)
+      {
+        Napi::Error::New(env, "Session is busy with an async operation").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      int ret = ReturnSession(*state_);
+      if (ret != 0)
+      {
+        Napi::Error::New(env, "Failed to close session: " + std::string(wiredtiger_strerror(ret)))
+            .ThrowAsJavaScriptException();
+        return env.Null();
+      }
     }
-  }
 
-private:
-  WT_CURSOR *cursor_;
-  WT_SESSION *session_;
-  // Keep strings alive until insert/update is called
-  std::string pending_key_;
-  std::string pending_value_;
+    return Napi::Boolean::New(env, true);
+  }
 
-  Napi::Value Set(const Napi::CallbackInfo &info)
+  Napi::Value BeginTransaction(const Napi::CallbackInfo &info)
   {
     Napi::Env env = info.Env();
 
-    if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString())
+    if (!EnsureSessionUsable(env, state_))
     {
-      Napi::TypeError::New(env, "Key and value strings expected").ThrowAsJavaScriptException();
       return env.Null();
     }
 
-    // Store strings as member variables to keep them alive!
-    // This is crucial: WiredTiger stores pointers, not copies, so the strings
-    // must remain valid until insert()/update() is called
-    pending_key_ = info[0].As<Napi::String>().Utf8Value();
-    pending_value_ = info[1].As<Napi::String>().Utf8Value();
-
-    // For format 'u' (raw bytes), use WT_ITEM for better performance
-    WT_ITEM key_item;
-    key_item.data = pending_key_.data();
-    key_item.size = pending_key_.size();
-
-    WT_ITEM value_item;
-    value_item.data = pending_value_.data();
-    value_item.size = pending_value_.size();
+    std::string config = info.Length() > 0 && info[0].IsString()
+                             ? info[0].As<Napi::String>().Utf8Value()
+                             : "";
 
-    cursor_->set_key(cursor_, &key_item);
-    cursor_->set_value(cursor_, &value_item);
+    int ret = state_->session->begin_transaction(state_->session, config.c_str());
+    if (ret != 0)
+    {
+      Napi::Error::New(env, "Failed to begin transaction: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    state_->inTransaction = true;
 
     return Napi::Boolean::New(env, true);
   }
 
-  Napi::Value Get(const Napi::CallbackInfo &info)
+  Napi::Value CommitTransaction(const Napi::CallbackInfo &info)
   {
     Napi::Env env = info.Env();
+    binding_metrics::Call call(binding_metrics::COMMIT);
 
-    WT_ITEM key_item, value_item;
-
-    int ret = cursor_->get_key(cursor_, &key_item);
-    if (ret != 0)
+    if (!EnsureSessionUsable(env, state_))
     {
       return env.Null();
     }
 
-    ret = cursor_->get_value(cursor_, &value_item);
+    std::string config = info.Length() > 0 && info[0].IsString()
+                             ? info[0].As<Napi::String>().Utf8Value()
+                             : "";
+
+    // Ending the transaction resets every cursor on the session
+    ReleaseViews(*state_, nullptr);
+    int ret;
+    {
+      binding_metrics::Engine engine;
+      ret = state_->session->commit_transaction(state_->session, config.c_str());
+    }
+    state_->inTransaction = false;
+    FinishCacheWrites(*state_, ret == 0);
     if (ret != 0)
     {
+      Napi::Error::New(env, "Failed to commit transaction: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
       return env.Null();
     }
 
-    // Extract strings from WT_ITEM
-    std::string key_str((const char *)key_item.data, key_item.size);
-    std::string value_str((const char *)value_item.data, value_item.size);
-
-    Napi::Object result = Napi::Object::New(env);
-    result.Set("key", Napi::String::New(env, key_str));
-    result.Set("value", Napi::String::New(env, value_str));
-
-    return result;
+    return Napi::Boolean::New(env, true);
   }
 
-  Napi::Value Search(const Napi::CallbackInfo &info)
+  Napi::Value RollbackTransaction(const Napi::CallbackInfo &info)
   {
     Napi::Env env = info.Env();
 
-    if (info.Length() < 1 || !info[0].IsString())
+    if (!EnsureSessionUsable(env, state_))
     {
-      Napi::TypeError::New(env, "Key string expected").ThrowAsJavaScriptException();
       return env.Null();
     }
 
-    std::string key = info[0].As<Napi::String>().Utf8Value();
+    std::string config = info.Length() > 0 && info[0].IsString()
+                             ? info[0].As<Napi::String>().Utf8Value()
+                             : "";
 
-    // For format 'u' (raw bytes), use WT_ITEM
-    WT_ITEM key_item;
-    key_item.data = key.data();
-    key_item.size = key.size();
+    // Ending the transaction resets every cursor on the session
+    ReleaseViews(*state_, nullptr);
+    int ret = state_->session->rollback_transaction(state_->session, config.c_str());
+    state_->inTransaction = false;
+    FinishCacheWrites(*state_, false);
+    if (ret != 0)
+    {
+      Napi::Error::New(env, "Failed to rollback transaction: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
 
-    cursor_->set_key(cursor_, &key_item);
+    return Napi::Boolean::New(env, true);
+  }
 
-    int ret = cursor_->search(cursor_);
+  // timestampTransaction(config): sets commit/durable/prepare/read
+  // timestamps of the running transaction, e.g. "commit_timestamp=2a"
+  Napi::Value TimestampTransaction(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
 
-    if (ret == 0)
+    if (!EnsureSessionUsable(env, state_))
     {
-      WT_ITEM value_item;
-      cursor_->get_value(cursor_, &value_item);
-      // Copy the data immediately - the pointer is only valid until cursor moves!
-      std::string value_copy((const char *)value_item.data, value_item.size);
-      return Napi::String::New(env, value_copy);
+      return env.Null();
     }
-    else if (ret == WT_NOTFOUND)
+    if (info.Length() < 1 || !info[0].IsString())
     {
+      Napi::TypeError::New(env, "Timestamp config string expected").ThrowAsJavaScriptException();
       return env.Null();
     }
-    else
+
+    std::string config = info[0].As<Napi::String>().Utf8Value();
+    int ret = state_->session->timestamp_transaction(state_->session, config.c_str());
+    if (ret != 0)
     {
-      Napi::Error::New(env, "Search failed: " + std::string(wiredtiger_strerror(ret)))
+      Napi::Error::New(env, "Failed to set transaction timestamp: " + std::string(wiredtiger_strerror(ret)))
           .ThrowAsJavaScriptException();
       return env.Null();
     }
+    return Napi::Boolean::New(env, true);
   }
 
-  Napi::Value SearchNear(const Napi::CallbackInfo &info)
+  // queryTimestamp(which): "commit", "first_commit", "prepare" or "read" of
+  // the running transaction, as a hex string
+  Napi::Value QueryTimestamp(const Napi::CallbackInfo &info)
   {
     Napi::Env env = info.Env();
 
-    if (info.Length() < 1 || !info[0].IsArrayBuffer())
+    if (!EnsureSessionUsable(env, state_))
     {
-      Napi::TypeError::New(env, "ArrayBuffer expected for searchNear key").ThrowAsJavaScriptException();
       return env.Null();
     }
-
-    Napi::ArrayBuffer keyBuffer = info[0].As<Napi::ArrayBuffer>();
-    WT_ITEM key_item;
-    key_item.data = keyBuffer.Data();
-    key_item.size = keyBuffer.ByteLength();
-    cursor_->set_key(cursor_, &key_item);
-
-    int exact;
-    int ret = cursor_->search_near(cursor_, &exact);
-
-    if (ret == 0)
-    {
-      Napi::Object result = Napi::Object::New(env);
-      result.Set("exact", Napi::Number::New(env, exact));
-      return result;
-    }
-    else if (ret == WT_NOTFOUND)
+    if (info.Length() < 1 || !info[0].IsString())
     {
+      Napi::TypeError::New(env, "Timestamp name expected").ThrowAsJavaScriptException();
       return env.Null();
     }
-    else
+
+    std::string config = "get=" + info[0].As<Napi::String>().Utf8Value();
+    char hex[64];
+    int ret = state_->session->query_timestamp(state_->session, hex, config.c_str());
+    if (ret != 0)
     {
-      Napi::Error::New(env, "search_near failed: " + std::string(wiredtiger_strerror(ret)))
+      Napi::Error::New(env, "Failed to query timestamp: " + std::string(wiredtiger_strerror(ret)))
           .ThrowAsJavaScriptException();
       return env.Null();
     }
+    return Napi::String::New(env, hex);
   }
 
-  Napi::Value Next(const Napi::CallbackInfo &info)
+  Napi::Value CommitTransactionAsync(const Napi::CallbackInfo &info)
   {
     Napi::Env env = info.Env();
 
-    int ret = cursor_->next(cursor_);
-
-    if (ret == 0)
+    if (!state_ || !state_->session)
     {
-      // For format 'u' (raw bytes), use WT_ITEM
-      WT_ITEM key_item, value_item;
-
-      cursor_->get_key(cursor_, &key_item);
-      cursor_->get_value(cursor_, &value_item);
+      Napi::Error::New(env, "Session is closed").ThrowAsJavaScriptException();
+      return env.Null();
+    }
 
-      // Copy data immediately - the pointers are only valid until cursor moves!
-      std::string key_copy((const char *)key_item.data, key_item.size);
-      std::string value_copy((const char *)value_item.data, value_item.size);
+    std::string config = info.Length() > 0 && info[0].IsString()
+                             ? info[0].As<Napi::String>().Utf8Value()
+                             : "";
 
-      Napi::Object result = Napi::Object::New(env);
-      result.Set("key", Napi::String::New(env, key_copy));
-      result.Set("value", Napi::String::New(env, value_copy));
-      return result;
+    ReleaseViews(*state_, nullptr);
+    // A config choosing its own sync setting opts out of group commit
+    if (state_->groupCommit && !HasConfigKey(config, "sync"))
+    {
+      auto *worker = new GroupCommitWorker(env, state_, info.This().As<Napi::Object>(), std::move(config));
+      return worker->Schedule();
     }
-    else if (ret == WT_NOTFOUND)
+    auto *worker = new SessionCallWorker(env, "WiredTigerSession.commitTransactionAsync", state_, info.This().As<Napi::Object>(),
+                                         SessionCallWorker::COMMIT, "", std::move(config));
+    return worker->Schedule();
+  }
+
+  Napi::Value CompactAsync(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsString())
     {
+      Napi::TypeError::New(env, "URI string expected for compact").ThrowAsJavaScriptException();
       return env.Null();
     }
-    else
+    if (!state_ || !state_->session)
     {
-      Napi::Error::New(env, "Next failed: " + std::string(wiredtiger_strerror(ret)))
-          .ThrowAsJavaScriptException();
+      Napi::Error::New(env, "Session is closed").ThrowAsJavaScriptException();
       return env.Null();
     }
+
+    std::string uri = info[0].As<Napi::String>().Utf8Value();
+    std::string config = info.Length() > 1 && info[1].IsString() ? info[1].As<Napi::String>().Utf8Value() : "";
+
+    auto *worker = new SessionCallWorker(env, "WiredTigerSession.compactAsync", state_, info.This().As<Napi::Object>(),
+                                         SessionCallWorker::COMPACT, std::move(uri), std::move(config));
+    return worker->Schedule();
   }
+};
 
-  Napi::Value GetRawKey(const Napi::CallbackInfo &info)
+// connection.checkpointAsync(config) - runs on its own short-lived session
+class CheckpointWorker : public SessionWorker
+{
+public:
+  CheckpointWorker(Napi::Env env, std::shared_ptr<SessionState> state, Napi::Object owner, std::shared_ptr<SessionPool> pool, std::string config)
+      : SessionWorker(env, "WiredTigerConnection.checkpointAsync", std::move(state), owner), pool_(std::move(pool)), config_(std::move(config))
   {
-    Napi::Env env = info.Env();
+  }
 
-    WT_ITEM key_item;
-    int ret = cursor_->get_key(cursor_, &key_item);
+protected:
+  void Execute() override
+  {
+    WT_SESSION *session;
+    int ret = pool_->Acquire(&session, true);
     if (ret != 0)
     {
-      return env.Null();
+      SetError("Failed to open session for checkpoint: " + std::string(wiredtiger_strerror(ret)));
+      return;
     }
 
-    Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(env, key_item.size);
-    std::memcpy(buffer.Data(), key_item.data, key_item.size);
-    return buffer;
+    ret = session->checkpoint(session, config_.empty() ? nullptr : config_.c_str());
+    pool_->Release(session);
+
+    if (ret != 0)
+    {
+      SetError("Checkpoint failed: " + std::string(wiredtiger_strerror(ret)));
+    }
   }
 
-  Napi::Value GetRawValue(const Napi::CallbackInfo &info)
+  Napi::Value Result(Napi::Env env) override
   {
-    Napi::Env env = info.Env();
+    return Napi::Boolean::New(env, true);
+  }
 
-    WT_ITEM value_item;
-    int ret = cursor_->get_value(cursor_, &value_item);
-    if (ret != 0)
+private:
+  std::shared_ptr<SessionPool> pool_;
+  std::string config_;
+};
+
+static Napi::Object ImportProgressObject(Napi::Env env, const bulk_import::Progress &progress)
+{
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("phase", Napi::String::New(env, bulk_import::PhaseName(progress.phase)));
+  result.Set("bytesRead", Napi::Number::New(env, (double)progress.bytesRead));
+  result.Set("totalBytes", Napi::Number::New(env, (double)progress.totalBytes));
+  result.Set("records", Napi::Number::New(env, (double)progress.records));
+  result.Set("skipped", Napi::Number::New(env, (double)progress.skipped));
+  result.Set("duplicates", Napi::Number::New(env, (double)progress.duplicates));
+  result.Set("loaded", Napi::Number::New(env, (double)progress.loaded));
+  result.Set("runs", Napi::Number::New(env, (double)progress.runs));
+  result.Set("bulk", Napi::Boolean::New(env, progress.bulk));
+  return result;
+}
+
+// connection.importFile(uri, path, options, onProgress): runs a
+// bulk_import::Importer on a thread of its own. Progress events and the
+// result go back through one thread-safe function, so every event reaches
+// JS before the promise settles. close() is refused until then (see `admin`);
+// the job also holds the shared connection, so no other wrapper's close
+// pulls WiredTiger out from under it.
+class ImportJob
+{
+public:
+  static Napi::Value Start(Napi::Env env, std::shared_ptr<SharedConnection> shared, std::shared_ptr<SessionPool> pool,
+                           std::shared_ptr<SessionState> admin, bulk_import::Spec spec, Napi::Value onProgress)
+  {
+    auto *job = new ImportJob(env, std::move(shared), std::move(admin));
+    bool reporting = onProgress.IsFunction();
+    Napi::Function emit = reporting ? onProgress.As<Napi::Function>()
+                                    : Napi::Function::New(env, [](const Napi::CallbackInfo &) {});
+    job->events_ = Napi::ThreadSafeFunction::New(env, emit, "WiredTigerConnection.importFile", 0, 1);
+
+    std::function<void(const bulk_import::Progress &)> report;
+    if (reporting)
     {
-      return env.Null();
+      Napi::ThreadSafeFunction events = job->events_;
+      report = [events](const bulk_import::Progress &progress)
+      { events.NonBlockingCall(new bulk_import::Progress(progress), EmitProgress); };
     }
+    auto indexes = job->shared_->indexes->For(spec.uri.c_str());
+    job->importer_ = std::make_unique<bulk_import::Importer>(std::move(pool), std::move(spec), std::move(indexes),
+                                                             job->shared_->readCache, std::move(report));
+
+    Napi::Promise promise = job->deferred_.Promise();
+    std::thread([job]
+                { job->Run(); })
+        .detach();
+    return promise;
+  }
 
-    Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(env, value_item.size);
-    std::memcpy(buffer.Data(), value_item.data, value_item.size);
-    return buffer;
+private:
+  std::shared_ptr<SharedConnection> shared_;
+  // The connection's admin state, counting the job in `jobs`
+  std::shared_ptr<SessionState> admin_;
+  Napi::Promise::Deferred deferred_;
+  Napi::ThreadSafeFunction events_;
+  std::unique_ptr<bulk_import::Importer> importer_;
+  int ret_ = 0;
+  uint64_t durationNanos_ = 0;
+
+  ImportJob(Napi::Env env, std::shared_ptr<SharedConnection> shared, std::shared_ptr<SessionState> admin)
+      : shared_(std::move(shared)), admin_(std::move(admin)), deferred_(Napi::Promise::Deferred::New(env))
+  {
+    admin_->jobs++;
   }
 
-  Napi::Value SetRawKey(const Napi::CallbackInfo &info)
+  void Run()
   {
-    Napi::Env env = info.Env();
+    auto start = std::chrono::steady_clock::now();
+    ret_ = importer_->Run();
+    durationNanos_ = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    // Queued behind the progress events; the job is gone once it runs
+    Napi::ThreadSafeFunction events = events_;
+    events.BlockingCall(this, Finish);
+    events.Release();
+  }
 
-    if (info.Length() < 1 || !info[0].IsArrayBuffer())
+  static void Finish(Napi::Env env, Napi::Function, ImportJob *job)
+  {
+    job->admin_->jobs--;
+    if (job->ret_ != 0)
     {
-      Napi::TypeError::New(env, "ArrayBuffer expected for key").ThrowAsJavaScriptException();
-      return env.Null();
+      job->deferred_.Reject(Napi::Error::New(env, "Import failed: " + job->importer_->Error()).Value());
+    }
+    else
+    {
+      Napi::Object result = ImportProgressObject(env, job->importer_->GetProgress());
+      result.Set("durationMs", Napi::Number::New(env, job->durationNanos_ / 1e6));
+      job->deferred_.Resolve(result);
     }
+    delete job;
+  }
 
-    Napi::ArrayBuffer buffer = info[0].As<Napi::ArrayBuffer>();
-    WT_ITEM key_item;
-    key_item.data = buffer.Data();
-    key_item.size = buffer.ByteLength();
-    cursor_->set_key(cursor_, &key_item);
-    return Napi::Boolean::New(env, true);
+  static void EmitProgress(Napi::Env env, Napi::Function emit, bulk_import::Progress *progress)
+  {
+    Napi::Object event = ImportProgressObject(env, *progress);
+    delete progress;
+    emit.Call({event});
+  }
+};
+
+// connection.adviseCompression(uri, options): see compression_advisor::Advisor.
+// Holds the shared connection, so it stays open until the advisor is done.
+class CompressionAdviceWorker : public Napi::AsyncWorker
+{
+public:
+  CompressionAdviceWorker(Napi::Env env, std::shared_ptr<SharedConnection> shared, std::shared_ptr<SessionState> admin,
+                          compression_advisor::Spec spec)
+      : Napi::AsyncWorker(env, "WiredTigerConnection.adviseCompression"), shared_(std::move(shared)),
+        admin_(std::move(admin)), advisor_(shared_->conn, shared_->home, std::move(spec)),
+        deferred_(Napi::Promise::Deferred::New(env))
+  {
+    admin_->jobs++;
   }
 
-  Napi::Value SetRawValue(const Napi::CallbackInfo &info)
+  Napi::Promise Promise()
   {
-    Napi::Env env = info.Env();
+    return deferred_.Promise();
+  }
 
-    if (info.Length() < 1 || !info[0].IsArrayBuffer())
+protected:
+  void Execute() override
+  {
+    if (advisor_.Run() != 0)
     {
-      Napi::TypeError::New(env, "ArrayBuffer expected for value").ThrowAsJavaScriptException();
-      return env.Null();
+      SetError("Compression advice failed: " + advisor_.Error());
     }
+  }
 
-    Napi::ArrayBuffer buffer = info[0].As<Napi::ArrayBuffer>();
-    WT_ITEM value_item;
-    value_item.data = buffer.Data();
-    value_item.size = buffer.ByteLength();
-    cursor_->set_value(cursor_, &value_item);
-    return Napi::Boolean::New(env, true);
+  void OnOK() override
+  {
+    Napi::Env env = Env();
+    admin_->jobs--;
+    const compression_advisor::Result &advice = advisor_.GetResult();
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("sampledRows", Napi::Number::New(env, (double)advice.sampledRows));
+    result.Set("sampledBytes", Napi::Number::New(env, (double)advice.sampledBytes));
+    result.Set("keyPrefixRatio", Napi::Number::New(env, advice.keyPrefixRatio));
+    Napi::Array candidates = Napi::Array::New(env, advice.candidates.size());
+    for (size_t i = 0; i < advice.candidates.size(); i++)
+    {
+      candidates.Set((uint32_t)i, CandidateObject(env, advice.candidates[i]));
+    }
+    result.Set("candidates", candidates);
+    Napi::Array unavailable = Napi::Array::New(env, advice.unavailable.size());
+    for (size_t i = 0; i < advice.unavailable.size(); i++)
+    {
+      unavailable.Set((uint32_t)i, Napi::String::New(env, advice.unavailable[i]));
+    }
+    result.Set("unavailable", unavailable);
+
+    Napi::Object recommended = CandidateObject(env, advice.recommended);
+    recommended.Set("memoryPageMax", Napi::Number::New(env, (double)advice.memoryPageMax));
+    recommended.Set("prefixCompression", Napi::Boolean::New(env, advice.prefixCompression));
+    recommended.Set("config", Napi::String::New(env, advice.config));
+    result.Set("recommended", recommended);
+    if (!advisor_.GetSpec().rebuildUri.empty())
+    {
+      Napi::Object rebuilt = Napi::Object::New(env);
+      rebuilt.Set("uri", Napi::String::New(env, advisor_.GetSpec().rebuildUri));
+      rebuilt.Set("rows", Napi::Number::New(env, (double)advice.rebuiltRows));
+      result.Set("rebuilt", rebuilt);
+    }
+    deferred_.Resolve(result);
   }
 
-  Napi::Value Prev(const Napi::CallbackInfo &info)
+  void OnError(const Napi::Error &error) override
+  {
+    admin_->jobs--;
+    deferred_.Reject(error.Value());
+  }
+
+private:
+  std::shared_ptr<SharedConnection> shared_;
+  std::shared_ptr<SessionState> admin_;
+  compression_advisor::Advisor advisor_;
+  Napi::Promise::Deferred deferred_;
+
+  static Napi::Object CandidateObject(Napi::Env env, const compression_advisor::Candidate &candidate)
+  {
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("compressor", Napi::String::New(env, candidate.compressor));
+    result.Set("leafPageMax", Napi::Number::New(env, (double)candidate.leafPageMax));
+    result.Set("bytes", Napi::Number::New(env, (double)candidate.bytes));
+    result.Set("ratio", Napi::Number::New(env, candidate.ratio));
+    result.Set("writeMBps", Napi::Number::New(env, candidate.writeMBps));
+    result.Set("readMBps", Napi::Number::New(env, candidate.readMBps));
+    result.Set("score", Napi::Number::New(env, candidate.score));
+    return result;
+  }
+};
+
+// WiredTigerConnection class (defined last since it uses WiredTigerSession)
+class WiredTigerConnection : public Napi::ObjectWrap<WiredTigerConnection>
+{
+public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports)
+  {
+    Napi::Function func = DefineClass(env, "WiredTigerConnection", {InstanceMethod("open", &WiredTigerConnection::Open), InstanceMethod("close", &WiredTigerConnection::Close), InstanceMethod("openSession", &WiredTigerConnection::OpenSession), InstanceMethod("checkpoint", &WiredTigerConnection::Checkpoint), InstanceMethod("releaseSession", &WiredTigerConnection::ReleaseSession), InstanceMethod("loadExtension", &WiredTigerConnection::LoadExtension), InstanceMethod("checkpointAsync", &WiredTigerConnection::CheckpointAsync), InstanceMethod("getSessionPoolStats", &WiredTigerConnection::GetSessionPoolStats), InstanceMethod("getStats", &WiredTigerConnection::GetStats), InstanceMethod("getGroupCommitStats", &WiredTigerConnection::GetGroupCommitStats), InstanceMethod("startMaintenance", &WiredTigerConnection::StartMaintenance), InstanceMethod("stopMaintenance", &WiredTigerConnection::StopMaintenance), InstanceMethod("pauseMaintenance", &WiredTigerConnection::PauseMaintenance), InstanceMethod("triggerMaintenance", &WiredTigerConnection::TriggerMaintenance), InstanceMethod("getMaintenanceStats", &WiredTigerConnection::GetMaintenanceStats), InstanceMethod("setTimestamp", &WiredTigerConnection::SetTimestamp), InstanceMethod("queryTimestamp", &WiredTigerConnection::QueryTimestamp), InstanceMethod("getReadCacheStats", &WiredTigerConnection::GetReadCacheStats), InstanceMethod("importFile", &WiredTigerConnection::ImportFile), InstanceMethod("adviseCompression", &WiredTigerConnection::AdviseCompression)});
+
+    env.GetInstanceData<AddonData>()->connectionConstructor = Napi::Persistent(func);
+
+    exports.Set("WiredTigerConnection", func);
+    return exports;
+  }
+
+  WiredTigerConnection(const Napi::CallbackInfo &info)
+      : Napi::ObjectWrap<WiredTigerConnection>(info), conn_(nullptr), admin_(std::make_shared<SessionState>())
+  {
+  }
+
+  ~WiredTigerConnection()
+  {
+    CloseInternal();
+  }
+
+private:
+  WT_CONNECTION *conn_;
+  // Shared with every other wrapper (on any thread) opened on the same home
+  std::shared_ptr<SharedConnection> shared_;
+  std::map<std::string, std::shared_ptr<SessionState>> sessions_;
+  // Every session handed out, including released ones, so they can be
+  // invalidated (and checked for in-flight async work) on close
+  std::vector<std::weak_ptr<SessionState>> states_;
+  // Serializes connection-level async work such as checkpointAsync()
+  std::shared_ptr<SessionState> admin_;
+  std::shared_ptr<SessionPool> pool_;
+  size_t cursorCacheSize_ = 32;
+  // False when sessionConfig picks an isolation other than snapshot
+  bool snapshotSessions_ = true;
+  // Field indexes live as long as the shared connection; their tables persist
+  std::shared_ptr<field_index::Registry> indexes_;
+  std::shared_ptr<GroupCommitQueue> groupCommit_;
+  // Background checkpoints and compaction, reporting to JS through `maintenanceEvents_`
+  std::unique_ptr<maintenance::Scheduler> maintenance_;
+  Napi::ThreadSafeFunction maintenanceEvents_;
+
+  Napi::Value Open(const Napi::CallbackInfo &info)
   {
     Napi::Env env = info.Env();
 
-    int ret = cursor_->prev(cursor_);
-
-    if (ret == 0)
+    if (info.Length() < 1 || !info[0].IsString())
     {
-      WT_ITEM key_item, value_item;
-      cursor_->get_key(cursor_, &key_item);
-      cursor_->get_value(cursor_, &value_item);
-
-      // Extract strings from WT_ITEM
-      std::string key_str((const char *)key_item.data, key_item.size);
-      std::string value_str((const char *)value_item.data, value_item.size);
-
-      Napi::Object result = Napi::Object::New(env);
-      result.Set("key", Napi::String::New(env, key_str));
-      result.Set("value", Napi::String::New(env, value_str));
-      return result;
+      Napi::TypeError::New(env, "String expected for path").ThrowAsJavaScriptException();
+      return env.Null();
     }
-    else if (ret == WT_NOTFOUND)
+
+    std::string path = info[0].As<Napi::String>().Utf8Value();
+    std::string config = info.Length() > 1 && info[1].IsString()
+                             ? info[1].As<Napi::String>().Utf8Value()
+                             : "create,cache_size=500M,statistics=(fast)";
+
+    // Options: { sessionPoolSize, sessionConfig, cursorCacheSize, statistics, groupCommit, readCache }
+    size_t poolSize = 16;
+    size_t readCacheBytes = 0;
+    std::string sessionConfig = "cache_cursors=true";
+    bool groupCommit = false;
+    GroupCommit::Options groupCommitOptions;
+    if (info.Length() > 2 && info[2].IsObject())
     {
-      return env.Null();
+      Napi::Object options = info[2].As<Napi::Object>();
+      Napi::Value size = options.Get("sessionPoolSize");
+      if (size.IsNumber() && size.As<Napi::Number>().Int64Value() > 0)
+      {
+        poolSize = (size_t)size.As<Napi::Number>().Int64Value();
+      }
+      Napi::Value sessionConfigOpt = options.Get("sessionConfig");
+      if (sessionConfigOpt.IsString())
+      {
+        sessionConfig = sessionConfigOpt.As<Napi::String>().Utf8Value();
+      }
+      Napi::Value cacheSize = options.Get("cursorCacheSize");
+      if (cacheSize.IsNumber() && cacheSize.As<Napi::Number>().Int64Value() >= 0)
+      {
+        cursorCacheSize_ = (size_t)cacheSize.As<Napi::Number>().Int64Value();
+      }
+      // Appended, so it overrides any statistics= in the config string
+      Napi::Value statistics = options.Get("statistics");
+      if (statistics.IsString())
+      {
+        config += ",statistics=(" + statistics.As<Napi::String>().Utf8Value() + ")";
+      }
+      // true or { maxDelayMs, maxBatch }
+      Napi::Value groupCommitOpt = options.Get("groupCommit");
+      if (groupCommitOpt.IsObject())
+      {
+        Napi::Object groupOptions = groupCommitOpt.As<Napi::Object>();
+        Napi::Value maxDelay = groupOptions.Get("maxDelayMs");
+        if (maxDelay.IsNumber() && maxDelay.As<Napi::Number>().DoubleValue() >= 0)
+        {
+          groupCommitOptions.maxDelay =
+              std::chrono::microseconds((int64_t)(maxDelay.As<Napi::Number>().DoubleValue() * 1000));
+        }
+        Napi::Value maxBatch = groupOptions.Get("maxBatch");
+        if (maxBatch.IsNumber() && maxBatch.As<Napi::Number>().Int64Value() > 0)
+        {
+          groupCommitOptions.maxBatch = (size_t)maxBatch.As<Napi::Number>().Int64Value();
+        }
+        groupCommit = true;
+      }
+      else
+      {
+        groupCommit = groupCommitOpt.IsBoolean() && groupCommitOpt.As<Napi::Boolean>().Value();
+      }
+      // Bytes, or { maxBytes }
+      Napi::Value readCacheOpt = options.Get("readCache");
+      if (readCacheOpt.IsObject())
+      {
+        readCacheOpt = readCacheOpt.As<Napi::Object>().Get("maxBytes");
+      }
+      if (readCacheOpt.IsNumber() && readCacheOpt.As<Napi::Number>().Int64Value() > 0)
+      {
+        readCacheBytes = (size_t)readCacheOpt.As<Napi::Number>().Int64Value();
+      }
     }
-    else
+
+    if (conn_)
     {
-      Napi::Error::New(env, "Prev failed: " + std::string(wiredtiger_strerror(ret)))
-          .ThrowAsJavaScriptException();
+      Napi::Error::New(env, "Connection is already open").ThrowAsJavaScriptException();
       return env.Null();
     }
-  }
 
-  Napi::Value Reset(const Napi::CallbackInfo &info)
-  {
-    Napi::Env env = info.Env();
-
-    int ret = cursor_->reset(cursor_);
+    // Another wrapper (possibly on another worker_thread) may have the home
+    // open already; then this one shares its connection and config
+    bool opened;
+    int ret = ConnectionRegistry::Get().Open(path, config, shared_, opened, readCacheBytes);
     if (ret != 0)
     {
-      Napi::Error::New(env, "Reset failed: " + std::string(wiredtiger_strerror(ret)))
+      Napi::Error::New(env, "Failed to open WiredTiger connection: " + std::string(wiredtiger_strerror(ret)))
           .ThrowAsJavaScriptException();
       return env.Null();
     }
+    conn_ = shared_->conn;
+    indexes_ = shared_->indexes;
+
+    pool_ = std::make_shared<SessionPool>(conn_, poolSize, sessionConfig);
+    WT_CONFIG_ITEM isolation;
+    snapshotSessions_ = !GetConfigItem(sessionConfig, "isolation", isolation) ||
+                        std::string(isolation.str, isolation.len) == "snapshot";
 
+    if (groupCommit)
+    {
+      ret = StartGroupCommit(env, groupCommitOptions);
+      if (ret != 0)
+      {
+        CloseInternal();
+        Napi::Error::New(env, "Failed to start group commit (requires log=(enabled)): " +
+                                  std::string(wiredtiger_strerror(ret)))
+            .ThrowAsJavaScriptException();
+        return env.Null();
+      }
+    }
     return Napi::Boolean::New(env, true);
   }
 
-  Napi::Value Insert(const Napi::CallbackInfo &info)
+  int StartGroupCommit(Napi::Env env, GroupCommit::Options options)
   {
-    Napi::Env env = info.Env();
-
-    int ret = cursor_->insert(cursor_);
-
+    struct Flush
+    {
+      uint64_t upTo;
+      int ret;
+    };
+
+    auto queue = std::make_shared<GroupCommitQueue>();
+    queue->flushed = Napi::ThreadSafeFunction::New(
+        env, Napi::Function::New(env, [](const Napi::CallbackInfo &) {}), "WiredTigerConnection.groupCommit", 0, 1);
+    // Only referenced while commits are waiting
+    queue->flushed.Unref(env);
+
+    // Each queued result holds the queue until it has been delivered, as
+    // flushes from close() arrive after the connection let go of it
+    std::weak_ptr<GroupCommitQueue> weak = queue;
+    queue->committer = std::make_unique<GroupCommit>(conn_, options, [weak](uint64_t upTo, int ret)
+                                                     {
+                                                       std::shared_ptr<GroupCommitQueue> target = weak.lock();
+                                                       if (!target)
+                                                       {
+                                                         return;
+                                                       }
+                                                       target->flushed.NonBlockingCall(
+                                                           new Flush{upTo, ret},
+                                                           [target](Napi::Env env, Napi::Function, Flush *flush)
+                                                           {
+                                                             target->OnFlushed(env, flush->upTo, flush->ret);
+                                                             delete flush;
+                                                           }); });
+    int ret = queue->committer->Start();
     if (ret != 0)
     {
-      Napi::Error::New(env, "Insert failed: " + std::string(wiredtiger_strerror(ret)))
-          .ThrowAsJavaScriptException();
-      return env.Null();
+      queue->committer.reset();
+      queue->flushed.Release();
+      return ret;
     }
-
-    return Napi::Boolean::New(env, true);
+    groupCommit_ = queue;
+    return 0;
   }
 
-  Napi::Value Update(const Napi::CallbackInfo &info)
+  Napi::Value Close(const Napi::CallbackInfo &info)
   {
     Napi::Env env = info.Env();
 
-    int ret = cursor_->update(cursor_);
-
-    if (ret != 0)
+    if (HasPendingWork())
     {
-      Napi::Error::New(env, "Update failed: " + std::string(wiredtiger_strerror(ret)))
+      Napi::Error::New(env, "Cannot close connection while async operations are pending")
           .ThrowAsJavaScriptException();
       return env.Null();
     }
 
+    for (auto &weak : states_)
+    {
+      auto state = weak.lock();
+      if (state)
+      {
+        ReleaseViews(*state, nullptr);
+      }
+    }
+
+    CloseInternal();
+
     return Napi::Boolean::New(env, true);
   }
 
-  Napi::Value Remove(const Napi::CallbackInfo &info)
+  Napi::Value OpenSession(const Napi::CallbackInfo &info)
   {
     Napi::Env env = info.Env();
 
-    // Key must be set before calling remove
-    // The key should already be set by a previous search() or set() call
-    int ret = cursor_->remove(cursor_);
+    if (!conn_)
+    {
+      Napi::Error::New(env, "Connection not open").ThrowAsJavaScriptException();
+      return env.Null();
+    }
 
-    if (ret != 0 && ret != WT_NOTFOUND)
+    // Never blocks: if every pooled session is in use this opens an extra one
+    WT_SESSION *session;
+    int ret = pool_->Acquire(&session, false);
+    if (ret != 0)
     {
-      Napi::Error::New(env, "Remove failed: " + std::string(wiredtiger_strerror(ret)))
+      Napi::Error::New(env, "Failed to open session: " + std::string(wiredtiger_strerror(ret)))
           .ThrowAsJavaScriptException();
       return env.Null();
     }
 
-    return Napi::Boolean::New(env, true);
+    auto state = std::make_shared<SessionState>();
+    state->session = session;
+    state->pool = pool_;
+    state->cursorCacheMax = cursorCacheSize_;
+    state->indexes = indexes_;
+    state->groupCommit = groupCommit_;
+    state->readCache = shared_->readCache;
+    state->readsFromCache = snapshotSessions_;
+    state->connection = shared_;
+    states_.erase(std::remove_if(states_.begin(), states_.end(),
+                                 [](const std::weak_ptr<SessionState> &s)
+                                 { return s.expired(); }),
+                  states_.end());
+    states_.push_back(state);
+
+    // Create a WiredTigerSession wrapper
+    Napi::Object sessionObj = WiredTigerSession::NewInstance(env, state);
+    std::string sessionId = sessionObj.Get("__nativeSessionPtr").As<Napi::String>().Utf8Value();
+    sessions_[sessionId] = state;
+    return sessionObj;
   }
 
-  Napi::Value Close(const Napi::CallbackInfo &info)
+  bool HasPendingWork()
   {
-    Napi::Env env = info.Env();
-
-    if (cursor_)
+    if (admin_->busy || admin_->jobs > 0)
     {
-      cursor_->close(cursor_);
-      cursor_ = nullptr;
+      return true;
     }
-
-    return Napi::Boolean::New(env, true);
+    for (auto &weak : states_)
+    {
+      auto state = weak.lock();
+      if (state && (state->busy || state->scanCalls > 0))
+      {
+        return true;
+      }
+    }
+    return false;
   }
-};
 
-// WiredTigerSession class (defined second since it's used by WiredTigerConnection)
-class WiredTigerSession : public Napi::ObjectWrap<WiredTigerSession>
-{
-public:
-  static Napi::Object Init(Napi::Env env, Napi::Object exports)
+  void CloseInternal()
   {
-    Napi::Function func = DefineClass(env, "WiredTigerSession", {InstanceMethod("createTable", &WiredTigerSession::CreateTable), InstanceMethod("openCursor", &WiredTigerSession::OpenCursor), InstanceMethod("close", &WiredTigerSession::Close), InstanceMethod("beginTransaction", &WiredTigerSession::BeginTransaction), InstanceMethod("commitTransaction", &WiredTigerSession::CommitTransaction), InstanceMethod("rollbackTransaction", &WiredTigerSession::RollbackTransaction), InstanceMethod("openCursorWithConfig", &WiredTigerSession::OpenCursorWithConfig), InstanceMethod("createIndex", &WiredTigerSession::CreateIndex), InstanceMethod("drop", &WiredTigerSession::Drop), InstanceMethod("compact", &WiredTigerSession::Compact)});
+    StopMaintenanceInternal();
 
-    sessionConstructor = new Napi::FunctionReference();
-    *sessionConstructor = Napi::Persistent(func);
-    exports.Set("WiredTigerSession", func);
-    return exports;
-  }
+    if (groupCommit_)
+    {
+      // Flushes the commits still waiting; their promises settle once the
+      // queued results reach the JS thread
+      groupCommit_->committer->Stop();
+      groupCommit_->flushed.Release();
+      groupCommit_.reset();
+    }
 
-  static Napi::Object NewInstance(Napi::Env env, WT_SESSION *session)
-  {
-    Napi::EscapableHandleScope scope(env);
-    Napi::Object obj = sessionConstructor->New({});
-    WiredTigerSession *wrapper = Napi::ObjectWrap<WiredTigerSession>::Unwrap(obj);
-    wrapper->session_ = session;
-    if (session)
+    // The connection may outlive this wrapper, so close every session still
+    // open (with its cursors) rather than leave it to WT_CONNECTION::close.
+    // close() refuses while work runs, but a collected wrapper can't: sessions
+    // still busy keep the connection open and are returned by their last
+    // worker.
+    for (auto &weak : states_)
     {
-      const char *idProperty = "__nativeSessionPtr";
-      uintptr_t rawPtr = reinterpret_cast<uintptr_t>(session);
-      obj.Set(idProperty, Napi::String::New(env, std::to_string(rawPtr)));
+      auto state = weak.lock();
+      if (state)
+      {
+        CancelScans(*state);
+      }
+      if (state && state->busy)
+      {
+        state->orphaned = true;
+      }
+      else if (state && state->session)
+      {
+        state->session->close(state->session, nullptr);
+        state->session = nullptr;
+      }
     }
-    return scope.Escape(napi_value(obj)).ToObject();
-  }
+    sessions_.clear();
 
-  WiredTigerSession(const Napi::CallbackInfo &info)
-      : Napi::ObjectWrap<WiredTigerSession>(info), session_(nullptr)
-  {
-  }
+    if (pool_)
+    {
+      pool_->Close();
+      pool_.reset();
+    }
 
-  ~WiredTigerSession()
-  {
-    // Session is managed by connection, don't close here
-  }
+    // Closes the connection if no other wrapper uses it
+    conn_ = nullptr;
+    shared_.reset();
+    indexes_.reset();
 
-private:
-  WT_SESSION *session_;
+    // The sessions (and their cursors) are gone; make sure the wrappers
+    // don't touch them again
+    for (auto &weak : states_)
+    {
+      auto state = weak.lock();
+      if (state && !state->orphaned)
+      {
+        state->session = nullptr;
+        state->connection.reset();
+        // Cached wrappers hold the state alive; let them go
+        state->cursorCache.clear();
+      }
+    }
+    states_.clear();
+  }
 
-  Napi::Value CreateTable(const Napi::CallbackInfo &info)
+  Napi::Value Checkpoint(const Napi::CallbackInfo &info)
   {
     Napi::Env env = info.Env();
 
-    if (info.Length() < 1 || !info[0].IsString())
+    if (!conn_)
     {
-      Napi::TypeError::New(env, "String expected for table name").ThrowAsJavaScriptException();
+      Napi::Error::New(env, "Connection not open").ThrowAsJavaScriptException();
       return env.Null();
     }
 
-    std::string tableName = info[0].As<Napi::String>().Utf8Value();
-    std::string config = info.Length() > 1 && info[1].IsString()
-                             ? info[1].As<Napi::String>().Utf8Value()
-                             : "key_format=S,value_format=S";
+    WT_SESSION *session;
+    int ret = pool_->Acquire(&session, false);
+    if (ret != 0)
+    {
+      Napi::Error::New(env, "Failed to open session for checkpoint: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
 
-    std::string uri = "table:" + tableName;
-    int ret = session_->create(session_, uri.c_str(), config.c_str());
+    // Run checkpoint
+    ret = session->checkpoint(session, nullptr);
+    pool_->Release(session);
 
-    if (ret != 0 && ret != EEXIST)
+    if (ret != 0)
     {
-      Napi::Error::New(env, "Failed to create table: " + std::string(wiredtiger_strerror(ret)))
+      Napi::Error::New(env, "Checkpoint failed: " + std::string(wiredtiger_strerror(ret)))
           .ThrowAsJavaScriptException();
       return env.Null();
     }
@@ -494,288 +5729,448 @@ private:
     return Napi::Boolean::New(env, true);
   }
 
-  Napi::Value OpenCursor(const Napi::CallbackInfo &info)
+  Napi::Value CheckpointAsync(const Napi::CallbackInfo &info)
   {
     Napi::Env env = info.Env();
 
-    if (info.Length() < 1 || !info[0].IsString())
+    if (!conn_)
     {
-      Napi::TypeError::New(env, "String expected for table name").ThrowAsJavaScriptException();
+      Napi::Error::New(env, "Connection not open").ThrowAsJavaScriptException();
       return env.Null();
     }
 
-    std::string tableName = info[0].As<Napi::String>().Utf8Value();
-    std::string uri = "table:" + tableName;
+    std::string config = info.Length() > 0 && info[0].IsString() ? info[0].As<Napi::String>().Utf8Value() : "";
+    auto *worker = new CheckpointWorker(env, admin_, info.This().As<Napi::Object>(), pool_, std::move(config));
+    return worker->Schedule();
+  }
 
-    WT_CURSOR *cursor;
-    // Open cursor without raw mode - let WiredTiger handle packing/unpacking for format S
-    int ret = session_->open_cursor(session_, uri.c_str(), nullptr, nullptr, &cursor);
+  Napi::Value GetSessionPoolStats(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
 
-    if (ret != 0)
+    if (!conn_)
     {
-      Napi::Error::New(env, "Failed to open cursor: " + std::string(wiredtiger_strerror(ret)))
-          .ThrowAsJavaScriptException();
+      Napi::Error::New(env, "Connection not open").ThrowAsJavaScriptException();
       return env.Null();
     }
 
-    Napi::Object cursorObj = WiredTigerCursor::NewInstance(env, cursor, session_);
-    return cursorObj;
+    SessionPool::Stats stats;
+    size_t open, idle;
+    pool_->Snapshot(stats, open, idle);
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("size", Napi::Number::New(env, (double)pool_->Max()));
+    result.Set("open", Napi::Number::New(env, (double)open));
+    result.Set("idle", Napi::Number::New(env, (double)idle));
+    result.Set("hits", Napi::Number::New(env, (double)stats.hits));
+    result.Set("affinityHits", Napi::Number::New(env, (double)stats.affinityHits));
+    result.Set("misses", Napi::Number::New(env, (double)stats.misses));
+    result.Set("overflows", Napi::Number::New(env, (double)stats.overflows));
+    result.Set("waits", Napi::Number::New(env, (double)stats.waits));
+    result.Set("waitTimeMs", Napi::Number::New(env, stats.waitNanos / 1e6));
+    return result;
   }
 
-  Napi::Value OpenCursorWithConfig(const Napi::CallbackInfo &info)
+  // setTimestamp(config): moves the global timestamps, e.g.
+  // "oldest_timestamp=10,stable_timestamp=2a"
+  Napi::Value SetTimestamp(const Napi::CallbackInfo &info)
   {
     Napi::Env env = info.Env();
 
+    if (!conn_)
+    {
+      Napi::Error::New(env, "Connection not open").ThrowAsJavaScriptException();
+      return env.Null();
+    }
     if (info.Length() < 1 || !info[0].IsString())
     {
-      Napi::TypeError::New(env, "URI string expected for cursor").ThrowAsJavaScriptException();
+      Napi::TypeError::New(env, "Timestamp config string expected").ThrowAsJavaScriptException();
       return env.Null();
     }
 
-    std::string uri = info[0].As<Napi::String>().Utf8Value();
-    std::string config = info.Length() > 1 && info[1].IsString() ? info[1].As<Napi::String>().Utf8Value() : "";
-
-    WT_CURSOR *cursor;
-    int ret = session_->open_cursor(session_, uri.c_str(), nullptr, config.empty() ? nullptr : config.c_str(), &cursor);
-
+    std::string config = info[0].As<Napi::String>().Utf8Value();
+    int ret = conn_->set_timestamp(conn_, config.c_str());
     if (ret != 0)
     {
-      Napi::Error::New(env, "Failed to open cursor: " + std::string(wiredtiger_strerror(ret)))
+      Napi::Error::New(env, "Failed to set timestamp: " + std::string(wiredtiger_strerror(ret)))
           .ThrowAsJavaScriptException();
       return env.Null();
     }
-
-    Napi::Object cursorObj = WiredTigerCursor::NewInstance(env, cursor, session_);
-    return cursorObj;
+    return Napi::Boolean::New(env, true);
   }
 
-  Napi::Value CreateIndex(const Napi::CallbackInfo &info)
+  // queryTimestamp(which): "all_durable", "last_checkpoint",
+  // "oldest_timestamp", "oldest_reader", "pinned", "recovery" or
+  // "stable_timestamp", as a hex string
+  Napi::Value QueryTimestamp(const Napi::CallbackInfo &info)
   {
     Napi::Env env = info.Env();
 
-    if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString())
+    if (!conn_)
     {
-      Napi::TypeError::New(env, "URI and config strings expected for createIndex").ThrowAsJavaScriptException();
+      Napi::Error::New(env, "Connection not open").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    if (info.Length() < 1 || !info[0].IsString())
+    {
+      Napi::TypeError::New(env, "Timestamp name expected").ThrowAsJavaScriptException();
       return env.Null();
     }
 
-    std::string uri = info[0].As<Napi::String>().Utf8Value();
-    std::string config = info[1].As<Napi::String>().Utf8Value();
-
-    int ret = session_->create(session_, uri.c_str(), config.c_str());
-
-    if (ret != 0 && ret != EEXIST)
+    std::string config = "get=" + info[0].As<Napi::String>().Utf8Value();
+    char hex[64];
+    int ret = conn_->query_timestamp(conn_, hex, config.c_str());
+    if (ret != 0)
     {
-      Napi::Error::New(env, "Failed to create index: " + std::string(wiredtiger_strerror(ret)))
+      Napi::Error::New(env, "Failed to query timestamp: " + std::string(wiredtiger_strerror(ret)))
           .ThrowAsJavaScriptException();
       return env.Null();
     }
-
-    return Napi::Boolean::New(env, true);
+    return Napi::String::New(env, hex);
   }
 
-  Napi::Value Drop(const Napi::CallbackInfo &info)
+  // startMaintenance(options, emit): emit(event) is called on the JS thread
+  // for every start, progress, complete and error event
+  Napi::Value StartMaintenance(const Napi::CallbackInfo &info)
   {
     Napi::Env env = info.Env();
 
-    if (info.Length() < 1 || !info[0].IsString())
+    if (!conn_)
     {
-      Napi::TypeError::New(env, "URI string expected for drop").ThrowAsJavaScriptException();
+      Napi::Error::New(env, "Connection not open").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    if (info.Length() < 2 || !info[0].IsObject() || !info[1].IsFunction())
+    {
+      Napi::TypeError::New(env, "Options object and event callback expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    if (maintenance_)
+    {
+      Napi::Error::New(env, "Maintenance is already running").ThrowAsJavaScriptException();
       return env.Null();
     }
 
-    std::string uri = info[0].As<Napi::String>().Utf8Value();
-    std::string config = info.Length() > 1 && info[1].IsString() ? info[1].As<Napi::String>().Utf8Value() : "";
-
-    int ret = session_->drop(session_, uri.c_str(), config.empty() ? nullptr : config.c_str());
-
-    if (ret != 0 && ret != WT_NOTFOUND)
+    // Options: { checkpointIntervalMs, checkpointLogSize, compactTables,
+    // compactFreeSpaceRatio, compactCheckIntervalMs, compactTimeoutSec, tickMs }
+    Napi::Object options = info[0].As<Napi::Object>();
+    maintenance::Policy policy;
+    auto millis = [&options](const char *name, std::chrono::milliseconds &out)
+    {
+      Napi::Value value = options.Get(name);
+      if (value.IsNumber() && value.As<Napi::Number>().Int64Value() >= 0)
+      {
+        out = std::chrono::milliseconds(value.As<Napi::Number>().Int64Value());
+      }
+    };
+    millis("checkpointIntervalMs", policy.checkpointInterval);
+    millis("compactCheckIntervalMs", policy.compactCheckInterval);
+    millis("tickMs", policy.tick);
+    if (policy.tick.count() == 0)
+    {
+      policy.tick = std::chrono::milliseconds(1);
+    }
+    Napi::Value logSize = options.Get("checkpointLogSize");
+    if (logSize.IsNumber() && logSize.As<Napi::Number>().Int64Value() > 0)
+    {
+      policy.checkpointLogBytes = (uint64_t)logSize.As<Napi::Number>().Int64Value();
+    }
+    Napi::Value tables = options.Get("compactTables");
+    if (tables.IsArray())
+    {
+      Napi::Array list = tables.As<Napi::Array>();
+      for (uint32_t i = 0; i < list.Length(); i++)
+      {
+        Napi::Value table = list.Get(i);
+        if (!table.IsString())
+        {
+          Napi::TypeError::New(env, "compactTables must be table names").ThrowAsJavaScriptException();
+          return env.Null();
+        }
+        std::string uri = table.As<Napi::String>().Utf8Value();
+        policy.compactTables.push_back(uri.find(':') == std::string::npos ? "table:" + uri : uri);
+      }
+    }
+    Napi::Value ratio = options.Get("compactFreeSpaceRatio");
+    if (ratio.IsNumber())
+    {
+      policy.compactFreeRatio = ratio.As<Napi::Number>().DoubleValue();
+    }
+    Napi::Value timeout = options.Get("compactTimeoutSec");
+    if (timeout.IsNumber() && timeout.As<Napi::Number>().Int64Value() > 0)
     {
-      Napi::Error::New(env, "Failed to drop object: " + std::string(wiredtiger_strerror(ret)))
-          .ThrowAsJavaScriptException();
-      return env.Null();
+      policy.compactTimeout = (unsigned)timeout.As<Napi::Number>().Int64Value();
     }
 
+    maintenanceEvents_ = Napi::ThreadSafeFunction::New(env, info[1].As<Napi::Function>(), "WiredTigerConnection.maintenance", 0, 1);
+    // Maintenance alone doesn't keep the process alive
+    maintenanceEvents_.Unref(env);
+    Napi::ThreadSafeFunction events = maintenanceEvents_;
+    maintenance_ = std::make_unique<maintenance::Scheduler>(pool_, std::move(policy), [events](const maintenance::Event &event)
+                                                            { events.NonBlockingCall(new maintenance::Event(event), EmitMaintenanceEvent); });
+    maintenance_->Start();
     return Napi::Boolean::New(env, true);
   }
 
-  Napi::Value Compact(const Napi::CallbackInfo &info)
+  static void EmitMaintenanceEvent(Napi::Env env, Napi::Function emit, maintenance::Event *event)
   {
-    Napi::Env env = info.Env();
-
-    if (info.Length() < 1 || !info[0].IsString())
+    static const char *types[] = {"start", "progress", "complete", "error"};
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("type", Napi::String::New(env, types[event->type]));
+    result.Set("task", Napi::String::New(env, maintenance::TaskName(event->task)));
+    result.Set("reason", Napi::String::New(env, maintenance::ReasonName(event->reason)));
+    if (!event->uri.empty())
     {
-      Napi::TypeError::New(env, "URI string expected for compact").ThrowAsJavaScriptException();
-      return env.Null();
+      result.Set("uri", Napi::String::New(env, event->uri));
     }
-
-    std::string uri = info[0].As<Napi::String>().Utf8Value();
-    std::string config = info.Length() > 1 && info[1].IsString() ? info[1].As<Napi::String>().Utf8Value() : "";
-
-    int ret = session_->compact(session_, uri.c_str(), config.empty() ? nullptr : config.c_str());
-
-    if (ret != 0)
+    if (event->task == maintenance::COMPACT)
     {
-      Napi::Error::New(env, "Failed to compact object: " + std::string(wiredtiger_strerror(ret)))
-          .ThrowAsJavaScriptException();
-      return env.Null();
+      result.Set("index", Napi::Number::New(env, (double)event->index));
+      result.Set("total", Napi::Number::New(env, (double)event->total));
+      if (event->freeRatio >= 0)
+      {
+        result.Set("freeSpaceRatio", Napi::Number::New(env, event->freeRatio));
+      }
+      if (event->type == maintenance::Event::COMPLETE)
+      {
+        result.Set("compacted", Napi::Number::New(env, (double)event->compacted));
+      }
     }
-
-    return Napi::Boolean::New(env, true);
+    if (event->type == maintenance::Event::COMPLETE || event->type == maintenance::Event::ERROR)
+    {
+      result.Set("durationMs", Napi::Number::New(env, event->durationNanos / 1e6));
+    }
+    if (!event->error.empty())
+    {
+      result.Set("error", Napi::String::New(env, event->error));
+    }
+    delete event;
+    emit.Call({result});
   }
 
-  Napi::Value Close(const Napi::CallbackInfo &info)
+  // Stops the scheduler without holding up the JS thread: a checkpoint or
+  // compaction in progress is waited for on a thread of its own, which keeps
+  // the shared connection open until then. `stopped` runs once the scheduler
+  // thread has exited, on whichever thread saw it go.
+  void StopMaintenanceInternal(std::function<void()> stopped = nullptr)
   {
-    Napi::Env env = info.Env();
-
-    if (session_)
+    if (!maintenance_)
     {
-      int ret = session_->close(session_, nullptr);
-      if (ret != 0)
+      if (stopped)
       {
-        Napi::Error::New(env, "Failed to close session: " + std::string(wiredtiger_strerror(ret)))
-            .ThrowAsJavaScriptException();
-        return env.Null();
+        stopped();
       }
-      session_ = nullptr;
+      return;
     }
-
-    return Napi::Boolean::New(env, true);
+    // Events already queued are still delivered
+    Napi::ThreadSafeFunction events = maintenanceEvents_;
+    auto finish = [events, stopped]() mutable
+    {
+      events.Release();
+      if (stopped)
+      {
+        stopped();
+      }
+    };
+    if (!maintenance_->RequestStop())
+    {
+      maintenance_->Stop();
+      maintenance_.reset();
+      finish();
+      return;
+    }
+    std::thread([scheduler = std::move(maintenance_), shared = shared_, finish]() mutable
+                {
+                  scheduler->Stop();
+                  scheduler.reset();
+                  finish();
+                })
+        .detach();
   }
 
-  Napi::Value BeginTransaction(const Napi::CallbackInfo &info)
+  // Resolves once a checkpoint or compaction in progress has finished
+  Napi::Value StopMaintenance(const Napi::CallbackInfo &info)
   {
     Napi::Env env = info.Env();
+    auto *deferred = new Napi::Promise::Deferred(env);
+    Napi::Promise promise = deferred->Promise();
+    Napi::ThreadSafeFunction done = Napi::ThreadSafeFunction::New(
+        env, Napi::Function::New(env, [](const Napi::CallbackInfo &) {}), "WiredTigerConnection.stopMaintenance", 0, 1);
+    StopMaintenanceInternal([done, deferred]() mutable
+                            {
+                              done.BlockingCall([deferred](Napi::Env env, Napi::Function)
+                                                {
+                                                  deferred->Resolve(env.Undefined());
+                                                  delete deferred;
+                                                });
+                              done.Release();
+                            });
+    return promise;
+  }
 
-    std::string config = info.Length() > 0 && info[0].IsString()
-                             ? info[0].As<Napi::String>().Utf8Value()
-                             : "";
-
-    int ret = session_->begin_transaction(session_, config.c_str());
-    if (ret != 0)
+  Napi::Value PauseMaintenance(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsBoolean())
     {
-      Napi::Error::New(env, "Failed to begin transaction: " + std::string(wiredtiger_strerror(ret)))
-          .ThrowAsJavaScriptException();
+      Napi::TypeError::New(env, "Boolean expected").ThrowAsJavaScriptException();
       return env.Null();
     }
-
+    if (!maintenance_)
+    {
+      Napi::Error::New(env, "Maintenance is not running").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    maintenance_->Pause(info[0].As<Napi::Boolean>().Value());
     return Napi::Boolean::New(env, true);
   }
 
-  Napi::Value CommitTransaction(const Napi::CallbackInfo &info)
+  Napi::Value TriggerMaintenance(const Napi::CallbackInfo &info)
   {
     Napi::Env env = info.Env();
-
-    std::string config = info.Length() > 0 && info[0].IsString()
-                             ? info[0].As<Napi::String>().Utf8Value()
-                             : "";
-
-    int ret = session_->commit_transaction(session_, config.c_str());
-    if (ret != 0)
+    std::string task = info.Length() > 0 && info[0].IsString() ? info[0].As<Napi::String>().Utf8Value() : "";
+    if (task != "checkpoint" && task != "compact")
     {
-      Napi::Error::New(env, "Failed to commit transaction: " + std::string(wiredtiger_strerror(ret)))
-          .ThrowAsJavaScriptException();
+      Napi::TypeError::New(env, "Task must be 'checkpoint' or 'compact'").ThrowAsJavaScriptException();
       return env.Null();
     }
-
+    if (!maintenance_)
+    {
+      Napi::Error::New(env, "Maintenance is not running").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    maintenance_->Trigger(task == "checkpoint" ? maintenance::CHECKPOINT : maintenance::COMPACT);
     return Napi::Boolean::New(env, true);
   }
 
-  Napi::Value RollbackTransaction(const Napi::CallbackInfo &info)
+  Napi::Value GetMaintenanceStats(const Napi::CallbackInfo &info)
   {
     Napi::Env env = info.Env();
 
-    std::string config = info.Length() > 0 && info[0].IsString()
-                             ? info[0].As<Napi::String>().Utf8Value()
-                             : "";
-
-    int ret = session_->rollback_transaction(session_, config.c_str());
-    if (ret != 0)
+    if (!maintenance_)
     {
-      Napi::Error::New(env, "Failed to rollback transaction: " + std::string(wiredtiger_strerror(ret)))
-          .ThrowAsJavaScriptException();
       return env.Null();
     }
 
-    return Napi::Boolean::New(env, true);
+    maintenance::Stats stats = maintenance_->GetStats();
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("checkpoints", Napi::Number::New(env, (double)stats.checkpoints));
+    result.Set("compactions", Napi::Number::New(env, (double)stats.compactions));
+    result.Set("errors", Napi::Number::New(env, (double)stats.errors));
+    result.Set("checkpointTimeMs", Napi::Number::New(env, stats.checkpointNanos / 1e6));
+    result.Set("compactTimeMs", Napi::Number::New(env, stats.compactNanos / 1e6));
+    result.Set("paused", Napi::Boolean::New(env, stats.paused));
+    result.Set("running", Napi::Boolean::New(env, stats.running));
+    return result;
   }
-};
 
-// WiredTigerConnection class (defined last since it uses WiredTigerSession)
-class WiredTigerConnection : public Napi::ObjectWrap<WiredTigerConnection>
-{
-public:
-  static Napi::Object Init(Napi::Env env, Napi::Object exports)
+  Napi::Value GetGroupCommitStats(const Napi::CallbackInfo &info)
   {
-    Napi::Function func = DefineClass(env, "WiredTigerConnection", {InstanceMethod("open", &WiredTigerConnection::Open), InstanceMethod("close", &WiredTigerConnection::Close), InstanceMethod("openSession", &WiredTigerConnection::OpenSession), InstanceMethod("checkpoint", &WiredTigerConnection::Checkpoint), InstanceMethod("releaseSession", &WiredTigerConnection::ReleaseSession), InstanceMethod("loadExtension", &WiredTigerConnection::LoadExtension)});
-
-    connectionConstructor = new Napi::FunctionReference();
-    *connectionConstructor = Napi::Persistent(func);
-
-    exports.Set("WiredTigerConnection", func);
-    return exports;
-  }
+    Napi::Env env = info.Env();
 
-  WiredTigerConnection(const Napi::CallbackInfo &info)
-      : Napi::ObjectWrap<WiredTigerConnection>(info), conn_(nullptr)
-  {
-  }
+    if (!groupCommit_)
+    {
+      return env.Null();
+    }
 
-  ~WiredTigerConnection()
-  {
-    CloseInternal();
+    GroupCommit::Stats stats = groupCommit_->committer->GetStats();
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("commits", Napi::Number::New(env, (double)stats.commits));
+    result.Set("flushes", Napi::Number::New(env, (double)stats.flushes));
+    result.Set("pending", Napi::Number::New(env, (double)stats.pending));
+    result.Set("largestBatch", Napi::Number::New(env, (double)stats.largestBatch));
+    result.Set("flushTimeMs", Napi::Number::New(env, stats.flushNanos / 1e6));
+    return result;
   }
 
-private:
-  WT_CONNECTION *conn_;
-  std::map<std::string, WT_SESSION *> sessions_;
-
-  Napi::Value Open(const Napi::CallbackInfo &info)
+  // importFile(uri, path, options, onProgress): see bulk_import::Importer
+  Napi::Value ImportFile(const Napi::CallbackInfo &info)
   {
     Napi::Env env = info.Env();
 
-    if (info.Length() < 1 || !info[0].IsString())
+    if (!conn_)
     {
-      Napi::TypeError::New(env, "String expected for path").ThrowAsJavaScriptException();
+      Napi::Error::New(env, "Connection not open").ThrowAsJavaScriptException();
       return env.Null();
     }
-
-    std::string path = info[0].As<Napi::String>().Utf8Value();
-    std::string config = info.Length() > 1 && info[1].IsString()
-                             ? info[1].As<Napi::String>().Utf8Value()
-                             : "create,cache_size=500M";
-
-    int ret = wiredtiger_open(path.c_str(), nullptr, config.c_str(), &conn_);
-    if (ret != 0)
+    if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString())
     {
-      Napi::Error::New(env, "Failed to open WiredTiger connection: " + std::string(wiredtiger_strerror(ret)))
-          .ThrowAsJavaScriptException();
+      Napi::TypeError::New(env, "Table URI and file path strings expected").ThrowAsJavaScriptException();
       return env.Null();
     }
 
-    return Napi::Boolean::New(env, true);
-  }
-
-  Napi::Value Close(const Napi::CallbackInfo &info)
-  {
-    Napi::Env env = info.Env();
+    bulk_import::Spec spec;
+    spec.uri = info[0].As<Napi::String>().Utf8Value();
+    if (spec.uri.find(':') == std::string::npos)
+    {
+      spec.uri = "table:" + spec.uri;
+    }
+    spec.path = info[1].As<Napi::String>().Utf8Value();
 
-    // Close all sessions first
-    for (auto &pair : sessions_)
+    // Options: { format, keyField, keyEncoding, threads, memoryBytes,
+    // blockBytes, tempDir, bulk, batchSize }
+    if (info.Length() > 2 && info[2].IsObject())
     {
-      if (pair.second)
+      Napi::Object options = info[2].As<Napi::Object>();
+      Napi::Value format = options.Get("format");
+      if (format.IsString())
+      {
+        std::string name = format.As<Napi::String>().Utf8Value();
+        if (name != "ndjson" && name != "packed")
+        {
+          Napi::TypeError::New(env, "format must be 'ndjson' or 'packed'").ThrowAsJavaScriptException();
+          return env.Null();
+        }
+        spec.format = name == "packed" ? bulk_import::PACKED : bulk_import::NDJSON;
+      }
+      Napi::Value keyField = options.Get("keyField");
+      if (keyField.IsString() && !field_index::ParsePath(keyField.As<Napi::String>().Utf8Value(), spec.keyPath))
+      {
+        Napi::TypeError::New(env, "Invalid keyField").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      Napi::Value keyEncoding = options.Get("keyEncoding");
+      if (keyEncoding.IsString())
+      {
+        std::string name = keyEncoding.As<Napi::String>().Utf8Value();
+        if (name != "string" && name != "compound")
+        {
+          Napi::TypeError::New(env, "keyEncoding must be 'string' or 'compound'").ThrowAsJavaScriptException();
+          return env.Null();
+        }
+        spec.keyEncoding = name == "compound" ? bulk_import::KEY_COMPOUND : bulk_import::KEY_STRING;
+      }
+      auto size = [&options](const char *name, size_t &out)
+      {
+        Napi::Value value = options.Get(name);
+        if (value.IsNumber() && value.As<Napi::Number>().Int64Value() > 0)
+        {
+          out = (size_t)value.As<Napi::Number>().Int64Value();
+        }
+      };
+      size_t threads = spec.threads;
+      size("threads", threads);
+      spec.threads = (unsigned)threads;
+      size("memoryBytes", spec.memoryBytes);
+      size("blockBytes", spec.blockBytes);
+      size("batchSize", spec.batchRecords);
+      Napi::Value tempDir = options.Get("tempDir");
+      if (tempDir.IsString())
+      {
+        spec.tempDir = tempDir.As<Napi::String>().Utf8Value();
+      }
+      Napi::Value bulk = options.Get("bulk");
+      if (bulk.IsBoolean())
       {
-        pair.second->close(pair.second, nullptr);
+        spec.bulk = bulk.As<Napi::Boolean>().Value();
       }
     }
-    sessions_.clear();
-
-    CloseInternal();
 
-    return Napi::Boolean::New(env, true);
+    return ImportJob::Start(env, shared_, pool_, admin_, std::move(spec), info.Length() > 3 ? info[3] : env.Undefined());
   }
 
-  Napi::Value OpenSession(const Napi::CallbackInfo &info)
+  // adviseCompression(uri, options): see compression_advisor::Advisor
+  Napi::Value AdviseCompression(const Napi::CallbackInfo &info)
   {
     Napi::Env env = info.Env();
 
@@ -784,42 +6179,128 @@ private:
       Napi::Error::New(env, "Connection not open").ThrowAsJavaScriptException();
       return env.Null();
     }
-
-    WT_SESSION *session;
-    int ret = conn_->open_session(conn_, nullptr, nullptr, &session);
-    if (ret != 0)
+    if (info.Length() < 1 || !info[0].IsString())
     {
-      Napi::Error::New(env, "Failed to open session: " + std::string(wiredtiger_strerror(ret)))
-          .ThrowAsJavaScriptException();
+      Napi::TypeError::New(env, "Table URI string expected").ThrowAsJavaScriptException();
       return env.Null();
     }
 
-    // Create a WiredTigerSession wrapper
-    Napi::Object sessionObj = WiredTigerSession::NewInstance(env, session);
-    std::string sessionId = sessionObj.Get("__nativeSessionPtr").As<Napi::String>().Utf8Value();
-    sessions_[sessionId] = session;
-    return sessionObj;
-  }
-
-  void CloseInternal()
-  {
-    for (auto &pair : sessions_)
+    auto tableUri = [](std::string uri)
     {
-      if (pair.second)
+      return uri.find(':') == std::string::npos ? "table:" + uri : uri;
+    };
+    compression_advisor::Spec spec;
+    spec.uri = tableUri(info[0].As<Napi::String>().Utf8Value());
+
+    // Options: { sampleSize, compressors, leafPageSizes, optimizeFor,
+    // rebuildInto }
+    if (info.Length() > 1 && info[1].IsObject())
+    {
+      Napi::Object options = info[1].As<Napi::Object>();
+      Napi::Value sampleSize = options.Get("sampleSize");
+      if (sampleSize.IsNumber() && sampleSize.As<Napi::Number>().Int64Value() > 0)
+      {
+        spec.sampleRows = (size_t)sampleSize.As<Napi::Number>().Int64Value();
+      }
+      Napi::Value compressors = options.Get("compressors");
+      if (compressors.IsArray())
+      {
+        Napi::Array names = compressors.As<Napi::Array>();
+        spec.compressors.clear();
+        for (uint32_t i = 0; i < names.Length(); i++)
+        {
+          Napi::Value name = names.Get(i);
+          if (!name.IsString())
+          {
+            Napi::TypeError::New(env, "compressors must be an array of strings").ThrowAsJavaScriptException();
+            return env.Null();
+          }
+          spec.compressors.push_back(name.As<Napi::String>().Utf8Value());
+        }
+      }
+      Napi::Value leafPageSizes = options.Get("leafPageSizes");
+      if (leafPageSizes.IsArray())
+      {
+        Napi::Array sizes = leafPageSizes.As<Napi::Array>();
+        spec.leafPageSizes.clear();
+        for (uint32_t i = 0; i < sizes.Length(); i++)
+        {
+          Napi::Value size = sizes.Get(i);
+          if (!size.IsNumber() || size.As<Napi::Number>().Int64Value() <= 0)
+          {
+            Napi::TypeError::New(env, "leafPageSizes must be an array of positive numbers").ThrowAsJavaScriptException();
+            return env.Null();
+          }
+          if (!compression_advisor::ValidPageSize((size_t)size.As<Napi::Number>().Int64Value()))
+          {
+            Napi::RangeError::New(env, "leafPageSizes must be multiples of 4KB up to 512MB").ThrowAsJavaScriptException();
+            return env.Null();
+          }
+          spec.leafPageSizes.push_back((size_t)size.As<Napi::Number>().Int64Value());
+        }
+      }
+      Napi::Value optimizeFor = options.Get("optimizeFor");
+      if (optimizeFor.IsString())
+      {
+        std::string goal = optimizeFor.As<Napi::String>().Utf8Value();
+        if (goal != "size" && goal != "balanced" && goal != "speed")
+        {
+          Napi::TypeError::New(env, "optimizeFor must be 'size', 'balanced' or 'speed'").ThrowAsJavaScriptException();
+          return env.Null();
+        }
+        spec.goal = goal == "size" ? compression_advisor::SIZE
+                    : goal == "speed" ? compression_advisor::SPEED
+                                      : compression_advisor::BALANCED;
+      }
+      Napi::Value rebuildInto = options.Get("rebuildInto");
+      if (rebuildInto.IsString())
       {
-        pair.second->close(pair.second, nullptr);
+        spec.rebuildUri = tableUri(rebuildInto.As<Napi::String>().Utf8Value());
       }
     }
-    sessions_.clear();
+    if (spec.compressors.empty() || spec.leafPageSizes.empty())
+    {
+      Napi::TypeError::New(env, "compressors and leafPageSizes must not be empty").ThrowAsJavaScriptException();
+      return env.Null();
+    }
 
-    if (conn_)
+    auto *worker = new CompressionAdviceWorker(env, shared_, admin_, std::move(spec));
+    Napi::Promise promise = worker->Promise();
+    worker->Queue();
+    return promise;
+  }
+
+  // getReadCacheStats(): null unless the connection has a read cache
+  Napi::Value GetReadCacheStats(const Napi::CallbackInfo &info)
+  {
+    Napi::Env env = info.Env();
+
+    if (!shared_ || !shared_->readCache)
     {
-      conn_->close(conn_, nullptr);
-      conn_ = nullptr;
+      return env.Null();
     }
+
+    ReadCache::Stats stats = shared_->readCache->GetStats();
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("hits", Napi::Number::New(env, (double)stats.hits));
+    result.Set("misses", Napi::Number::New(env, (double)stats.misses));
+    uint64_t lookups = stats.hits + stats.misses;
+    result.Set("hitRatio", Napi::Number::New(env, lookups > 0 ? (double)stats.hits / lookups : 0));
+    result.Set("fills", Napi::Number::New(env, (double)stats.fills));
+    result.Set("invalidations", Napi::Number::New(env, (double)stats.invalidations));
+    result.Set("evictions", Napi::Number::New(env, (double)stats.evictions));
+    result.Set("entries", Napi::Number::New(env, (double)stats.entries));
+    result.Set("bytes", Napi::Number::New(env, (double)stats.bytes));
+    result.Set("maxBytes", Napi::Number::New(env, (double)stats.maxBytes));
+    return result;
   }
 
-  Napi::Value Checkpoint(const Napi::CallbackInfo &info)
+  // getStats({ scope, fast }): reads a statistics cursor, for the connection
+  // (scope 'connection', the default) or a data source URI such as
+  // 'table:users', into { category: { description: value } }, e.g.
+  // stats.cache['bytes currently in the cache']. `fast` limits data source
+  // statistics to the ones that don't walk the tree.
+  Napi::Value GetStats(const Napi::CallbackInfo &info)
   {
     Napi::Env env = info.Env();
 
@@ -829,28 +6310,74 @@ private:
       return env.Null();
     }
 
-    // Open a temporary session for checkpoint
+    std::string uri = "statistics:";
+    const char *cursorConfig = nullptr;
+    if (info.Length() > 0 && info[0].IsObject())
+    {
+      Napi::Object options = info[0].As<Napi::Object>();
+      Napi::Value scope = options.Get("scope");
+      if (scope.IsString() && scope.As<Napi::String>().Utf8Value() != "connection")
+      {
+        uri += scope.As<Napi::String>().Utf8Value();
+      }
+      Napi::Value fast = options.Get("fast");
+      if (fast.IsBoolean() && fast.As<Napi::Boolean>().Value())
+      {
+        cursorConfig = "statistics=(fast)";
+      }
+    }
+
     WT_SESSION *session;
-    int ret = conn_->open_session(conn_, nullptr, nullptr, &session);
+    int ret = pool_->Acquire(&session, false);
     if (ret != 0)
     {
-      Napi::Error::New(env, "Failed to open session for checkpoint: " + std::string(wiredtiger_strerror(ret)))
+      Napi::Error::New(env, "Failed to open session for statistics: " + std::string(wiredtiger_strerror(ret)))
           .ThrowAsJavaScriptException();
       return env.Null();
     }
 
-    // Run checkpoint
-    ret = session->checkpoint(session, nullptr);
-    session->close(session, nullptr);
-
+    WT_CURSOR *cursor;
+    ret = session->open_cursor(session, uri.c_str(), nullptr, cursorConfig, &cursor);
     if (ret != 0)
     {
-      Napi::Error::New(env, "Checkpoint failed: " + std::string(wiredtiger_strerror(ret)))
+      pool_->Release(session);
+      Napi::Error::New(env, "Failed to open statistics cursor: " + std::string(wiredtiger_strerror(ret)))
           .ThrowAsJavaScriptException();
       return env.Null();
     }
 
-    return Napi::Boolean::New(env, true);
+    // Descriptions read "category: name"
+    Napi::Object result = Napi::Object::New(env);
+    const char *desc, *printable;
+    int64_t value;
+    while ((ret = cursor->next(cursor)) == 0)
+    {
+      if ((ret = cursor->get_value(cursor, &desc, &printable, &value)) != 0)
+      {
+        break;
+      }
+      const char *colon = std::strstr(desc, ": ");
+      std::string category = colon ? std::string(desc, colon - desc) : "other";
+      const char *name = colon ? colon + 2 : desc;
+
+      Napi::Value group = result.Get(category);
+      if (!group.IsObject())
+      {
+        group = Napi::Object::New(env);
+        result.Set(category, group);
+      }
+      group.As<Napi::Object>().Set(name, Napi::Number::New(env, (double)value));
+    }
+    cursor->close(cursor);
+    pool_->Release(session);
+
+    if (ret != WT_NOTFOUND)
+    {
+      Napi::Error::New(env, "Failed to read statistics: " + std::string(wiredtiger_strerror(ret)))
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    return result;
   }
 
   Napi::Value LoadExtension(const Napi::CallbackInfo &info)
@@ -904,11 +6431,175 @@ private:
   }
 };
 
+// Latency summary of a histogram, in microseconds
+static Napi::Object LatencySummary(Napi::Env env, const std::vector<uint64_t> &histogram, uint64_t calls,
+                                   uint64_t totalNs)
+{
+  Napi::Object summary = Napi::Object::New(env);
+  summary.Set("mean", Napi::Number::New(env, calls > 0 ? (double)totalNs / (double)calls / 1e3 : 0));
+  summary.Set("p50", Napi::Number::New(env, binding_metrics::OpSnapshot::Percentile(histogram, 0.5) / 1e3));
+  summary.Set("p90", Napi::Number::New(env, binding_metrics::OpSnapshot::Percentile(histogram, 0.9) / 1e3));
+  summary.Set("p99", Napi::Number::New(env, binding_metrics::OpSnapshot::Percentile(histogram, 0.99) / 1e3));
+  return summary;
+}
+
+// getBindingMetrics(): per-method call counts, bytes and latencies recorded
+// while metrics are enabled (see binding_metrics.h)
+static Napi::Value GetBindingMetrics(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+
+  std::vector<binding_metrics::OpSnapshot> snapshot;
+  binding_metrics::Registry::Get().Snapshot(snapshot);
+
+  Napi::Object ops = Napi::Object::New(env);
+  for (int op = 0; op < binding_metrics::OP_COUNT; op++)
+  {
+    const binding_metrics::OpSnapshot &stats = snapshot[op];
+    Napi::Object entry = Napi::Object::New(env);
+    entry.Set("calls", Napi::Number::New(env, (double)stats.calls));
+    entry.Set("bytesIn", Napi::Number::New(env, (double)stats.bytesIn));
+    entry.Set("bytesOut", Napi::Number::New(env, (double)stats.bytesOut));
+    entry.Set("totalMs", Napi::Number::New(env, stats.totalNs / 1e6));
+    entry.Set("engineMs", Napi::Number::New(env, stats.engineNs / 1e6));
+    entry.Set("marshalMs", Napi::Number::New(env, (stats.totalNs - std::min(stats.engineNs, stats.totalNs)) / 1e6));
+    Napi::Object latency = LatencySummary(env, stats.total, stats.calls, stats.totalNs);
+    latency.Set("max", Napi::Number::New(env, stats.maxNs / 1e3));
+    entry.Set("latencyUs", latency);
+    entry.Set("engineLatencyUs", LatencySummary(env, stats.engine, stats.calls, stats.engineNs));
+    ops.Set(binding_metrics::OpName(op), entry);
+  }
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("enabled", Napi::Boolean::New(env, binding_metrics::Enabled()));
+  result.Set("ops", ops);
+  return result;
+}
+
+static Napi::Value SetBindingMetricsEnabled(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsBoolean())
+  {
+    Napi::TypeError::New(env, "Boolean expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  binding_metrics::SetEnabled(info[0].As<Napi::Boolean>().Value());
+  return Napi::Boolean::New(env, true);
+}
+
+static Napi::Value ResetBindingMetrics(const Napi::CallbackInfo &info)
+{
+  binding_metrics::Registry::Get().Reset();
+  return Napi::Boolean::New(info.Env(), true);
+}
+
+// encodeKey(parts): the memcmp-ordered encoding of a compound key (see
+// key_codec.h)
+static Napi::Value EncodeKey(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray())
+  {
+    Napi::TypeError::New(env, "Array of key elements expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  std::string encoded;
+  if (!EncodeKeyParts(env, info[0].As<Napi::Array>(), encoded))
+  {
+    return env.Null();
+  }
+  return Napi::Buffer<char>::Copy(env, encoded.data(), encoded.size());
+}
+
+// decodeKey(bytes): the elements of an encoded key. ObjectIds come back as
+// { $oid: hex }.
+static Napi::Value DecodeKey(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  const uint8_t *data;
+  size_t length;
+  if (info.Length() < 1 || !GetBytes(info[0], data, length))
+  {
+    Napi::TypeError::New(env, "ArrayBuffer or Uint8Array expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  std::vector<key_codec::Part> parts;
+  if (!key_codec::Decode(data, length, parts))
+  {
+    Napi::Error::New(env, "Malformed key").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Array result = Napi::Array::New(env, parts.size());
+  for (size_t i = 0; i < parts.size(); i++)
+  {
+    const key_codec::Part &part = parts[i];
+    Napi::Value value;
+    switch (part.tag)
+    {
+    case key_codec::TAG_FALSE:
+    case key_codec::TAG_TRUE:
+      value = Napi::Boolean::New(env, part.tag == key_codec::TAG_TRUE);
+      break;
+    case key_codec::TAG_NUMBER:
+      value = Napi::Number::New(env, part.number);
+      break;
+    case key_codec::TAG_STRING:
+      value = Napi::String::New(env, part.bytes);
+      break;
+    case key_codec::TAG_DATE:
+      value = Napi::Date::New(env, part.number);
+      break;
+    case key_codec::TAG_BINARY:
+      value = Napi::Buffer<char>::Copy(env, part.bytes.data(), part.bytes.size());
+      break;
+    case key_codec::TAG_OBJECT_ID:
+    {
+      Napi::Object id = Napi::Object::New(env);
+      id.Set("$oid", Napi::String::New(env, key_codec::ObjectIdHex(part.bytes)));
+      value = id;
+      break;
+    }
+    default:
+      value = env.Null();
+    }
+    result.Set((uint32_t)i, value);
+  }
+  return result;
+}
+
+// getOpenConnections(): every home open in the process, with the number of
+// connection objects (across all threads) sharing it
+static Napi::Value GetOpenConnections(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  std::vector<ConnectionRegistry::Entry> entries = ConnectionRegistry::Get().List();
+  Napi::Array result = Napi::Array::New(env, entries.size());
+  for (size_t i = 0; i < entries.size(); i++)
+  {
+    Napi::Object entry = Napi::Object::New(env);
+    entry.Set("home", Napi::String::New(env, entries[i].home));
+    entry.Set("references", Napi::Number::New(env, (double)entries[i].references));
+    result.Set((uint32_t)i, entry);
+  }
+  return result;
+}
+
 Napi::Object InitAll(Napi::Env env, Napi::Object exports)
 {
+  // Freed when the environment (main thread or worker) is torn down
+  env.SetInstanceData(new AddonData());
   WiredTigerCursor::Init(env, exports);
   WiredTigerSession::Init(env, exports);
+  WiredTigerParallelScan::Init(env, exports);
   WiredTigerConnection::Init(env, exports);
+  exports.Set("getBindingMetrics", Napi::Function::New(env, GetBindingMetrics));
+  exports.Set("setBindingMetricsEnabled", Napi::Function::New(env, SetBindingMetricsEnabled));
+  exports.Set("resetBindingMetrics", Napi::Function::New(env, ResetBindingMetrics));
+  exports.Set("getOpenConnections", Napi::Function::New(env, GetOpenConnections));
+  exports.Set("encodeKey", Napi::Function::New(env, EncodeKey));
+  exports.Set("decodeKey", Napi::Function::New(env, DecodeKey));
   return exports;
 }
 
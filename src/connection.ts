@@ -1,11 +1,188 @@
 import { nativeBindings } from './bindings'
 import { WiredTigerSession } from './session'
+import { MaintenanceOptions, MaintenanceScheduler } from './maintenance'
+import {
+  ConnectionTimestampKind,
+  GlobalTimestamps,
+  globalTimestampConfig,
+  timestampFromHex
+} from './timestamps'
+import { StatsOptions, StatsSampler, StatsSamplerOptions, WTStatistics } from './stats'
 import * as pathModule from 'path'
 import * as fs from 'fs'
 
+export interface ConnectionOptions {
+  // Sessions kept for reuse after close() (default 16)
+  sessionPoolSize?: number
+  // Config for pooled sessions (default 'cache_cursors=true')
+  sessionConfig?: string
+  // Closed cursors each session keeps open for reuse (default 32, 0 disables)
+  cursorCacheSize?: number
+  // Statistics level, overriding the config string. The default config
+  // enables 'fast'; WiredTiger's own default is 'none'.
+  statistics?: 'none' | 'fast' | 'all'
+  // Coalesce commitTransactionAsync() calls into one log flush per batch.
+  // Requires log=(enabled) in the config string.
+  groupCommit?: boolean | GroupCommitOptions
+  // Cache hot records of key_format=u,value_format=u tables in front of
+  // WiredTiger, shared by every session and worker_thread on the home.
+  // Bytes, or { maxBytes }. Only the first open of a home sets it up.
+  readCache?: number | ReadCacheOptions
+}
+
+export interface ReadCacheOptions {
+  maxBytes: number
+}
+
+export interface ReadCacheStats {
+  hits: number
+  misses: number
+  hitRatio: number
+  fills: number
+  invalidations: number
+  evictions: number
+  entries: number
+  bytes: number
+  maxBytes: number
+}
+
+export interface GroupCommitOptions {
+  // Longest a commit waits for others to join its flush (default 1)
+  maxDelayMs?: number
+  // Flush as soon as this many commits are waiting (default 128)
+  maxBatch?: number
+}
+
+export interface GroupCommitStats {
+  commits: number
+  flushes: number
+  // Committed but not yet covered by a flush
+  pending: number
+  largestBatch: number
+  flushTimeMs: number
+}
+
+export interface ImportOptions {
+  // 'ndjson' (default): one JSON document per line, stored as the value.
+  // 'packed': [uint32 LE length][key][uint32 LE length][value] records, as
+  // built by packEntries().
+  format?: 'ndjson' | 'packed'
+  // Dotted path of the NDJSON key field (default '_id')
+  keyField?: string
+  // 'string' (default) keys by a string field's text, an { $oid } field's
+  // hex and other values' JSON text; 'compound' encodes the field as
+  // encodeKey([value]) does
+  keyEncoding?: 'string' | 'compound'
+  // Parser and loader threads (default 4, at most the session pool size)
+  threads?: number
+  // Memory for unsorted records before sorted runs spill to disk
+  // (default 256 MiB)
+  memoryBytes?: number
+  // Size of each sequential read (default 4 MiB)
+  blockBytes?: number
+  // Where runs spill (default: the system's temporary directory)
+  tempDir?: string
+  // Load an empty table nobody else has open through a bulk cursor
+  // (default true); otherwise records go in batched transactions
+  bulk?: boolean
+  // Records per transaction when not bulk loading (default 1000)
+  batchSize?: number
+  onProgress?: (progress: ImportProgress) => void
+}
+
+export interface ImportProgress {
+  phase: 'read' | 'merge' | 'load' | 'done'
+  bytesRead: number
+  totalBytes: number
+  // Records parsed, and NDJSON lines skipped for lack of a usable key
+  records: number
+  skipped: number
+  // Records replaced by a later one with the same key
+  duplicates: number
+  loaded: number
+  // Sorted runs spilled to disk
+  runs: number
+  // Loaded through a bulk cursor
+  bulk: boolean
+}
+
+export interface ImportResult extends ImportProgress {
+  durationMs: number
+}
+
+export interface CompressionAdviceOptions {
+  // Rows read through a random cursor (default 10000)
+  sampleSize?: number
+  // Block compressors to try; ones whose extension isn't loaded are
+  // reported as unavailable (default none, snappy, lz4, zstd, zlib)
+  compressors?: string[]
+  // leaf_page_max values to try, in bytes (default 16, 32, 64 and 128 KiB)
+  leafPageSizes?: number[]
+  // Weighs on-disk size against read and write throughput (default
+  // 'balanced')
+  optimizeFor?: 'size' | 'balanced' | 'speed'
+  // Copies the table into this new one with the recommended config
+  rebuildInto?: string
+}
+
+export interface CompressionCandidate {
+  compressor: string
+  leafPageMax: number
+  // On-disk size of the sample, and its raw size over that
+  bytes: number
+  ratio: number
+  // Sample bytes loaded (and checkpointed) and scanned back per second
+  writeMBps: number
+  readMBps: number
+  score: number
+}
+
+export interface CompressionAdvice {
+  sampledRows: number
+  sampledBytes: number
+  // Share of key bytes repeated from the previous key in sorted order
+  keyPrefixRatio: number
+  // Best first
+  candidates: CompressionCandidate[]
+  unavailable: string[]
+  recommended: CompressionCandidate & {
+    memoryPageMax: number
+    prefixCompression: boolean
+    // Ready for createTable()
+    config: string
+  }
+  rebuilt?: { uri: string; rows: number }
+}
+
+  size: number
+  open: number
+  idle: number
+  hits: number
+  affinityHits: number
+  misses: number
+  overflows: number
+  waits: number
+  waitTimeMs: number
+}
+
+export interface OpenConnection {
+  home: string
+  // Connection objects sharing it, across all worker threads
+  references: number
+}
+
+// Homes open in this process. Opening a home that is already open, from
+// this thread or any worker_thread, shares its WT_CONNECTION (and the config
+// it was first opened with); the last close() closes it.
+export function getOpenConnections(): OpenConnection[] {
+  return nativeBindings.getOpenConnections()
+}
+
 export class WiredTigerConnection {
   private connection: any
   private readonly activeSessions: Set<string>
+  private readonly samplers = new Set<StatsSampler>()
+  private maintenance: MaintenanceScheduler | null = null
 
   constructor() {
     if (!nativeBindings) {
@@ -20,8 +197,8 @@ export class WiredTigerConnection {
     this.activeSessions = new Set<string>()
   }
 
-  open(path: string, config?: string): void {
-    this.connection.open(path, config)
+  open(path: string, config?: string, options?: ConnectionOptions): void {
+    this.connection.open(path, config, options)
     this.loadCompressionExtensions()
   }
 
@@ -73,11 +250,79 @@ export class WiredTigerConnection {
     this.connection.checkpoint()
   }
 
+  async checkpointAsync(config?: string): Promise<void> {
+    await this.connection.checkpointAsync(config)
+  }
+
+  // Loads a file into a table on native threads: records are parsed in
+  // parallel, sorted in memory-bounded runs, merged and loaded in key order.
+  // A key appearing more than once keeps its last record. The import isn't
+  // atomic: records committed before a failure stay.
+  importFile(uri: string, path: string, options: ImportOptions = {}): Promise<ImportResult> {
+    const { onProgress, ...rest } = options
+    return this.connection.importFile(uri, path, rest, onProgress)
+  }
+
+  // Benchmarks block compressors and leaf page sizes on a sample of the
+  // table's rows, each loaded into a scratch table, and recommends a config.
+  // rebuildInto copies the table as of the start of the copy; writes after
+  // that and field indexes aren't carried over.
+  adviseCompression(uri: string, options: CompressionAdviceOptions = {}): Promise<CompressionAdvice> {
+    return this.connection.adviseCompression(uri, options)
+  }
+
+  // Moves the oldest/stable/durable timestamps. Advance oldest as readers
+  // finish so WiredTiger can discard the history they no longer need.
+  setTimestamps(timestamps: GlobalTimestamps): void {
+    this.connection.setTimestamp(globalTimestampConfig(timestamps))
+  }
+
+  queryTimestamp(kind: ConnectionTimestampKind): bigint {
+    const name = kind === 'oldest' || kind === 'stable' ? `${kind}_timestamp` : kind
+    return timestampFromHex(this.connection.queryTimestamp(name))
+  }
+
+  getSessionPoolStats(): SessionPoolStats {
+    return this.connection.getSessionPoolStats()
+  }
+
+  // Null unless the connection was opened with groupCommit
+  getGroupCommitStats(): GroupCommitStats | null {
+    return this.connection.getGroupCommitStats()
+  }
+
+  // Null unless the connection was opened with readCache
+  getReadCacheStats(): ReadCacheStats | null {
+    return this.connection.getReadCacheStats()
+  }
+
+  getStats(options: StatsOptions = {}): WTStatistics {
+    return this.connection.getStats(options)
+  }
+
+  // Periodic statistics deltas; call start() on the result
+  createStatsSampler(options: StatsSamplerOptions = {}): StatsSampler {
+    const sampler = new StatsSampler(statsOptions => this.getStats(statsOptions), options)
+    this.samplers.add(sampler)
+    return sampler
+  }
+
+  // Background checkpoints and compaction; one scheduler per connection
+  startMaintenance(options: MaintenanceOptions = {}): MaintenanceScheduler {
+    if (this.maintenance) this.maintenance.stop()
+    this.maintenance = new MaintenanceScheduler(this.connection, options)
+    return this.maintenance
+  }
+
   loadExtension(path: string, config?: string): void {
     this.connection.loadExtension(path, config)
   }
 
   close(): void {
+    for (const sampler of this.samplers) sampler.stop()
+    this.samplers.clear()
+    this.maintenance?.stop()
+    this.maintenance = null
     for (const sessionId of Array.from(this.activeSessions)) {
       this.activeSessions.delete(sessionId)
       this.connection.releaseSession(sessionId)
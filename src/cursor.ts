@@ -1,37 +1,225 @@
-export interface WTCursorResult {
-  key: string
-  value: string
+import { Readable } from 'stream'
+import { decodeScanChunk } from './packed'
+import { KeyPart } from './keys'
+
+// Keys and values of raw ('u') tables are strings. Tables with a typed
+// key_format/value_format are packed natively: integer columns take numbers
+// (or bigints; 64-bit values beyond 2^53 come back as bigints), 'S'/'s'
+// columns strings and 'u' columns bytes. Compound formats such as 'qS' take
+// and return an array with one element per column.
+export type WTField = string | number | bigint | Uint8Array
+export type WTRecordValue = WTField | WTField[]
+
+export interface WTCursorResult<K = string, V = string> {
+  key: K
+  value: V
+}
+
+export interface PutManyOptions {
+  // Load through a bulk cursor if the table is empty and no other handles
+  // are open on it; falls back to a transaction otherwise. Not atomic.
+  bulk?: boolean
+}
+
+export type FilterValue = string | number | boolean | null
+
+export interface FieldCondition {
+  $eq?: FilterValue
+  $ne?: FilterValue
+  $gt?: FilterValue
+  $gte?: FilterValue
+  $lt?: FilterValue
+  $lte?: FilterValue
+  $in?: FilterValue[]
+  $nin?: FilterValue[]
+  $exists?: boolean
+}
+
+// Predicate over the JSON values of a raw table, keyed by dotted field path
+// ('address.city', 'tags.0'). Evaluated natively, so only matching records
+// are copied out of WiredTiger. Ordering operators only match fields of the
+// operand's type.
+export interface DocumentFilter {
+  $and?: DocumentFilter[]
+  $or?: DocumentFilter[]
+  $nor?: DocumentFilter[]
+  [field: string]: FilterValue | FieldCondition | DocumentFilter[] | undefined
+}
+
+// Raw tables: key bytes, or key elements encoded with encodeKey(). Typed
+// tables: a key as set() takes it (packed natively), or its packed bytes.
+export type KeyBound = WTRecordValue | KeyPart[]
+
+export interface KeyBounds {
+  gt?: KeyBound
+  gte?: KeyBound
+  lt?: KeyBound
+  lte?: KeyBound
+}
+
+export interface ScanRange extends KeyBounds {
+  reverse?: boolean
+  // Counts matching records only
+  limit?: number
+  filter?: DocumentFilter
+}
+
+export interface ScanOptions extends ScanRange {
+  // Bytes per chunk buffer (default 64 KiB); grown when a record doesn't fit
+  chunkSize?: number
+}
+
+export interface ScanRecord {
+  key: Buffer
+  value: Buffer
+}
+
+export interface ScanFillResult {
+  count: number
+  bytes: number
+  done: boolean
+  // Set when the next record alone is larger than the buffer
+  needed: number
 }
 
+const DEFAULT_SCAN_CHUNK = 64 * 1024
+
 export class WiredTigerCursor {
   private cursor: any
+  // Output slots for get()/next()/prev(); the native side fills them instead
+  // of building a result object per row
+  private readonly slots: [any, any] = [undefined, undefined]
 
   constructor(cursor: any) {
     this.cursor = cursor
   }
 
-  set(key: string, value: string): void {
+  private record<K, V>(found: boolean): WTCursorResult<K, V> | null {
+    if (!found) return null
+    const result = { key: this.slots[0], value: this.slots[1] }
+    this.slots[0] = this.slots[1] = undefined
+    return result
+  }
+
+  set(key: WTRecordValue, value: WTRecordValue): void {
     this.cursor.set(key, value)
   }
 
-  get(): WTCursorResult | null {
-    return this.cursor.get()
+  get<K = string, V = string>(): WTCursorResult<K, V> | null {
+    return this.record(this.cursor.get(this.slots))
+  }
+
+  // Allocation-free variants of get()/next()/prev(): store the key and value
+  // into out[0] and out[1] and return whether there was a record
+  getInto<K = string, V = string>(out: [K, V]): boolean {
+    return this.cursor.get(out)
   }
 
-  search(key: string): string | null {
+  nextInto<K = string, V = string>(out: [K, V]): boolean {
+    return this.cursor.next(out)
+  }
+
+  prevInto<K = string, V = string>(out: [K, V]): boolean {
+    return this.cursor.prev(out)
+  }
+
+  search<V = string>(key: WTRecordValue): V | null {
     return this.cursor.search(key)
   }
 
-  searchNear(key: ArrayBuffer): { exact: number } | null {
+  // Batched point lookups in one native call. With an array of keys the
+  // result has holes for missing keys; with a packed buffer (see packKeys)
+  // the result is a packed buffer of values (see unpackValues). Packed
+  // buffers on typed tables need single string or byte columns.
+  getMany<V = string>(keys: WTRecordValue[]): (V | undefined)[]
+  getMany(keys: Uint8Array): Buffer
+  getMany<V = string>(keys: WTRecordValue[] | Uint8Array): (V | undefined)[] | Buffer {
+    return this.cursor.getMany(keys)
+  }
+
+  // Applies a packed batch of key/value records (see packEntries) in one
+  // transaction, or inside the caller's if one is running. Returns per-item
+  // statuses (see BatchStatus).
+  putMany(batch: Uint8Array, options?: PutManyOptions): Int32Array {
+    return this.cursor.putMany(batch, options)
+  }
+
+  removeMany(keys: WTRecordValue[] | Uint8Array): Int32Array {
+    return this.cursor.removeMany(keys)
+  }
+
+  // Low-level chunked scan: scanStart() sets the range, each scanFill() copies
+  // the next records into `buffer` (see decodeScanChunk).
+  scanStart(range: ScanRange = {}): void {
+    this.cursor.scanStart(range)
+  }
+
+  scanFill(buffer: Uint8Array): ScanFillResult {
+    return this.cursor.scanFill(buffer)
+  }
+
+  scanFillAsync(buffer: Uint8Array): Promise<ScanFillResult> {
+    return this.cursor.scanFillAsync(buffer)
+  }
+
+  // Range scan as an async iterator. Chunks are filled on the threadpool and
+  // never reused, so yielded keys/values stay valid.
+  async *scan(options: ScanOptions = {}): AsyncGenerator<ScanRecord> {
+    const { chunkSize = DEFAULT_SCAN_CHUNK, ...range } = options
+    this.cursor.scanStart(range)
+
+    let size = chunkSize
+    let done = false
+    try {
+      while (!done) {
+        const chunk = Buffer.allocUnsafe(size)
+        const result: ScanFillResult = await this.cursor.scanFillAsync(chunk)
+        if (result.needed > 0) {
+          size = Math.max(size * 2, result.needed)
+          continue
+        }
+        done = result.done
+        yield* decodeScanChunk(chunk, result.count)
+      }
+    } finally {
+      // Release the cursor position if the consumer stopped early
+      if (!done) this.cursor.reset()
+    }
+  }
+
+  scanStream(options: ScanOptions = {}): Readable {
+    return Readable.from(this.scan(options))
+  }
+
+  // Limits the cursor to a key range, enforced by WiredTiger: next()/prev()
+  // start at the range's ends and return null past them. Lasts until
+  // bound(null) or reset(). Resets the cursor.
+  bound(bounds: KeyBounds | null): void {
+    this.cursor.bound(bounds)
+  }
+
+  // Records in the range (matching `filter`), counted without leaving native
+  // code. Resets the cursor.
+  count(range: ScanRange = {}): number {
+    return this.cursor.count(range)
+  }
+
+  countAsync(range: ScanRange = {}): Promise<number> {
+    return this.cursor.countAsync(range)
+  }
+
+  // Raw keys may be given as an array of key elements, encoded natively
+  // with encodeKey()
+  searchNear(key: ArrayBuffer | Uint8Array | KeyPart[]): { exact: number } | null {
     return this.cursor.searchNear(key)
   }
 
-  next(): WTCursorResult | null {
-    return this.cursor.next()
+  next<K = string, V = string>(): WTCursorResult<K, V> | null {
+    return this.record(this.cursor.next(this.slots))
   }
 
-  prev(): WTCursorResult | null {
-    return this.cursor.prev()
+  prev<K = string, V = string>(): WTCursorResult<K, V> | null {
+    return this.record(this.cursor.prev(this.slots))
   }
 
   reset(): void {
@@ -62,11 +250,69 @@ export class WiredTigerCursor {
     return this.cursor.getValue()
   }
 
-  setRawKey(buffer: ArrayBuffer): void {
+  // Zero-copy variants of getRawKey/getRawValue/search. The ArrayBuffer points
+  // into WiredTiger's memory and is detached (byteLength becomes 0) once the
+  // cursor moves, resets or closes, or the session's transaction ends. Copy
+  // anything that must outlive the current position.
+  getKeyView(): ArrayBuffer | null {
+    return this.cursor.getKeyView()
+  }
+
+  getValueView(): ArrayBuffer | null {
+    return this.cursor.getValueView()
+  }
+
+  searchView(key: WTRecordValue): ArrayBuffer | null {
+    return this.cursor.searchView(key)
+  }
+
+  setRawKey(buffer: ArrayBuffer | Uint8Array | KeyPart[]): void {
     this.cursor.setRawKey(buffer)
   }
 
   setRawValue(buffer: ArrayBuffer): void {
     this.cursor.setRawValue(buffer)
   }
+
+  // Async variants run on the libuv threadpool. Operations on cursors of the
+  // same session are queued and run in order; sync calls on that session
+  // throw while any of them is in flight.
+
+  searchAsync<V = string>(key: WTRecordValue): Promise<V | null> {
+    return this.cursor.searchAsync(key)
+  }
+
+  nextAsync<K = string, V = string>(): Promise<WTCursorResult<K, V> | null> {
+    return this.cursor.nextAsync()
+  }
+
+  prevAsync<K = string, V = string>(): Promise<WTCursorResult<K, V> | null> {
+    return this.cursor.prevAsync()
+  }
+
+  getManyAsync<V = string>(keys: WTRecordValue[]): Promise<(V | undefined)[]>
+  getManyAsync(keys: Uint8Array): Promise<Buffer>
+  getManyAsync<V = string>(keys: WTRecordValue[] | Uint8Array): Promise<(V | undefined)[] | Buffer> {
+    return this.cursor.getManyAsync(keys)
+  }
+
+  putManyAsync(batch: Uint8Array, options?: PutManyOptions): Promise<Int32Array> {
+    return this.cursor.putManyAsync(batch, options)
+  }
+
+  removeManyAsync(keys: WTRecordValue[] | Uint8Array): Promise<Int32Array> {
+    return this.cursor.removeManyAsync(keys)
+  }
+
+  async insertAsync(key: WTRecordValue, value: WTRecordValue): Promise<void> {
+    await this.cursor.insertAsync(key, value)
+  }
+
+  async updateAsync(key: WTRecordValue, value: WTRecordValue): Promise<void> {
+    await this.cursor.updateAsync(key, value)
+  }
+
+  async removeAsync(key: WTRecordValue): Promise<void> {
+    await this.cursor.removeAsync(key)
+  }
 }
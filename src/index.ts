@@ -1,4 +1,79 @@
 // WiredTiger native bindings for memgoose
-export { WiredTigerConnection } from './connection'
-export { WiredTigerSession } from './session'
-export { WiredTigerCursor, WTCursorResult } from './cursor'
+export {
+  WiredTigerConnection,
+  ConnectionOptions,
+  SessionPoolStats,
+  GroupCommitOptions,
+  GroupCommitStats,
+  ReadCacheOptions,
+  ReadCacheStats,
+  ImportOptions,
+  ImportProgress,
+  ImportResult,
+  CompressionAdviceOptions,
+  CompressionCandidate,
+  CompressionAdvice,
+  OpenConnection,
+  getOpenConnections
+} from './connection'
+export {
+  WiredTigerSession,
+  CursorCacheStats,
+  FieldIndexOptions,
+  IndexBuildOptions,
+  IndexLookupOptions,
+  IndexValue,
+  IndexRange,
+  AggregateOptions,
+  AggregateTotals,
+  AggregateGroup,
+  AggregateResult,
+  ParallelScanOptions,
+  ParallelScanRecord
+} from './session'
+export {
+  WiredTigerCursor,
+  WTCursorResult,
+  WTField,
+  WTRecordValue,
+  PutManyOptions,
+  ScanRange,
+  KeyBound,
+  KeyBounds,
+  ScanOptions,
+  DocumentFilter,
+  FieldCondition,
+  FilterValue,
+  ScanRecord,
+  ScanFillResult
+} from './cursor'
+export {
+  MaintenanceScheduler,
+  MaintenanceOptions,
+  MaintenanceTask,
+  MaintenanceEvent,
+  MaintenanceStats
+} from './maintenance'
+export {
+  Timestamp,
+  TransactionOptions,
+  CommitOptions,
+  TransactionTimestamps,
+  GlobalTimestamps,
+  TransactionTimestampKind,
+  ConnectionTimestampKind,
+  timestampToHex,
+  timestampFromHex
+} from './timestamps'
+export { encodeKey, decodeKey, keyPrefixRange, keyRange, KeyPart, KeyObjectId } from './keys'
+export { StatsSampler, StatsOptions, StatsSamplerOptions, StatsSample, WTStatistics, diffStats } from './stats'
+export {
+  getBindingMetrics,
+  setBindingMetricsEnabled,
+  resetBindingMetrics,
+  BindingMetrics,
+  BindingOp,
+  BindingOpMetrics,
+  LatencySummary
+} from './metrics'
+export { packKeys, packEntries, unpackValues, decodeScanChunk, PACKED_MISSING, BatchStatus } from './packed'
@@ -0,0 +1,71 @@
+import { nativeBindings } from './bindings'
+
+// 12-byte ObjectId as returned by decodeKey(). Any object with a
+// toHexString() (e.g. a bson ObjectId) encodes the same way.
+export class KeyObjectId {
+  constructor(private readonly hex: string) {}
+
+  toHexString(): string {
+    return this.hex
+  }
+
+  toString(): string {
+    return this.hex
+  }
+}
+
+export type KeyPart =
+  | null
+  | undefined
+  | boolean
+  | number
+  | string
+  | Date
+  | Uint8Array
+  | { toHexString(): string }
+
+// Encodes a compound key for a key_format=u table. The bytes compare with
+// memcmp in tuple order: element by element (numbers numerically, strings
+// by UTF-8 bytes), shorter tuples first. Elements of different types sort
+// null < false < true < numbers < strings < dates < ObjectIds < binary.
+export function encodeKey(parts: KeyPart[]): Buffer {
+  return nativeBindings.encodeKey(parts)
+}
+
+export function decodeKey(key: ArrayBuffer | Uint8Array): KeyPart[] {
+  const parts: any[] = nativeBindings.decodeKey(key)
+  for (let i = 0; i < parts.length; i++) {
+    const part = parts[i]
+    if (part !== null && typeof part === 'object' && typeof part.$oid === 'string') {
+      parts[i] = new KeyObjectId(part.$oid)
+    }
+  }
+  return parts
+}
+
+// Bounds covering every key that starts with `prefix`, for scan() and
+// friends
+export function keyPrefixRange(prefix: KeyPart[]): { gte: Buffer; lt: Buffer } {
+  const gte = encodeKey(prefix)
+  // No encoded element starts with 0xFF
+  return { gte, lt: Buffer.concat([gte, Buffer.from([0xff])]) }
+}
+
+// Bounds for keys under `prefix` whose next element lies in the given
+// range, e.g. keyRange(['age'], { gte: 18, lt: 65 })
+export function keyRange(
+  prefix: KeyPart[],
+  range: { gt?: KeyPart; gte?: KeyPart; lt?: KeyPart; lte?: KeyPart }
+): { gt?: Buffer; gte?: Buffer; lt?: Buffer; lte?: Buffer } {
+  const bounds: { gt?: Buffer; gte?: Buffer; lt?: Buffer; lte?: Buffer } = {}
+  const whole = keyPrefixRange(prefix)
+  // A key extending prefix+[x] sorts after prefix+[x] itself, so exclusive
+  // lower and inclusive upper bounds extend past every such key
+  if ('gt' in range) bounds.gt = keyPrefixRange([...prefix, range.gt]).lt
+  else if ('gte' in range) bounds.gte = encodeKey([...prefix, range.gte])
+  else bounds.gte = whole.gte
+  if ('lt' in range) bounds.lt = encodeKey([...prefix, range.lt])
+  else if ('lte' in range) bounds.lt = keyPrefixRange([...prefix, range.lte]).lt
+  else bounds.lt = whole.lt
+  return bounds
+}
@@ -0,0 +1,96 @@
+import { EventEmitter } from 'events'
+
+export interface MaintenanceOptions {
+  // Checkpoint this often (0 or unset disables)
+  checkpointIntervalMs?: number
+  // Checkpoint once this many bytes of log were written since the last one.
+  // Needs statistics (on by default) and log=(enabled).
+  checkpointLogSize?: number
+  // Tables to compact, e.g. ['users'] or ['table:users']
+  compactTables?: string[]
+  // Compact a table once this share of its file is free space (default 0.2)
+  compactFreeSpaceRatio?: number
+  // How often the tables' free space is checked (default 60000)
+  compactCheckIntervalMs?: number
+  // Longest a single table's compaction may run
+  compactTimeoutSec?: number
+  // How often the policy is evaluated (default 1000)
+  tickMs?: number
+}
+
+export type MaintenanceTask = 'checkpoint' | 'compact'
+
+export interface MaintenanceEvent {
+  type: 'start' | 'progress' | 'complete' | 'error'
+  task: MaintenanceTask
+  reason: 'interval' | 'logSize' | 'freeSpace' | 'manual'
+  // Compaction: the table concerned, its position in the pass, and the share
+  // of its file that was free space
+  uri?: string
+  index?: number
+  total?: number
+  freeSpaceRatio?: number
+  // Compaction 'complete': tables compacted in the pass
+  compacted?: number
+  durationMs?: number
+  error?: string
+}
+
+export interface MaintenanceStats {
+  checkpoints: number
+  compactions: number
+  errors: number
+  checkpointTimeMs: number
+  compactTimeMs: number
+  paused: boolean
+  running: boolean
+}
+
+// Checkpoints and compaction on a native thread of their own. Emits
+// 'start', 'progress' and 'complete' with a MaintenanceEvent, and 'error'
+// with an Error carrying the event as `event` (only when listened for; the
+// scheduler keeps running). Doesn't keep the process alive; closing the
+// connection stops it, letting a task in progress finish in the background.
+export class MaintenanceScheduler extends EventEmitter {
+  private stopped = false
+
+  constructor(private readonly connection: any, options: MaintenanceOptions) {
+    super()
+    connection.startMaintenance(options, (event: MaintenanceEvent) => this.dispatch(event))
+  }
+
+  // Holds off new work, e.g. during peak traffic. A checkpoint or table
+  // compaction already running finishes first.
+  pause(): void {
+    this.connection.pauseMaintenance(true)
+  }
+
+  resume(): void {
+    this.connection.pauseMaintenance(false)
+  }
+
+  // Runs the task as soon as the scheduler is free and not paused
+  trigger(task: MaintenanceTask): void {
+    this.connection.triggerMaintenance(task)
+  }
+
+  stats(): MaintenanceStats | null {
+    return this.stopped ? null : this.connection.getMaintenanceStats()
+  }
+
+  // Resolves once a running task has finished; nothing new starts
+  // meanwhile. Doesn't block the event loop.
+  stop(): Promise<void> {
+    if (this.stopped) return Promise.resolve()
+    this.stopped = true
+    return this.connection.stopMaintenance()
+  }
+
+  private dispatch(event: MaintenanceEvent): void {
+    if (event.type !== 'error') {
+      this.emit(event.type, event)
+    } else if (this.listenerCount('error') > 0) {
+      this.emit('error', Object.assign(new Error(event.error), { event }))
+    }
+  }
+}
@@ -0,0 +1,44 @@
+import { nativeBindings } from './bindings'
+
+export interface LatencySummary {
+  // Microseconds; percentiles are bucket upper bounds (within 25%)
+  mean: number
+  p50: number
+  p90: number
+  p99: number
+}
+
+export interface BindingOpMetrics {
+  calls: number
+  // Bytes marshalled from JS into WiredTiger and back
+  bytesIn: number
+  bytesOut: number
+  totalMs: number
+  // Time inside WiredTiger; marshalMs is the rest of the call
+  engineMs: number
+  marshalMs: number
+  latencyUs: LatencySummary & { max: number }
+  engineLatencyUs: LatencySummary
+}
+
+export type BindingOp = 'set' | 'search' | 'next' | 'prev' | 'insert' | 'update' | 'remove' | 'commit' | 'scanFill'
+
+export interface BindingMetrics {
+  enabled: boolean
+  ops: Record<BindingOp, BindingOpMetrics>
+}
+
+// Timing of the binding's synchronous hot paths, split between WiredTiger and
+// JS<->native marshalling. Off by default; while off a call pays for a single
+// flag check. Counters are kept per thread and summed on read.
+export function setBindingMetricsEnabled(enabled: boolean): void {
+  nativeBindings.setBindingMetricsEnabled(enabled)
+}
+
+export function getBindingMetrics(): BindingMetrics {
+  return nativeBindings.getBindingMetrics()
+}
+
+export function resetBindingMetrics(): void {
+  nativeBindings.resetBindingMetrics()
+}
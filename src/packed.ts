@@ -0,0 +1,63 @@
+// Helpers for the packed batch format used by the bulk cursor APIs: a
+// sequence of [uint32 little-endian length][bytes] records. A length of
+// 0xFFFFFFFF marks a missing value in results.
+
+export const PACKED_MISSING = 0xffffffff
+
+// Per-item statuses returned by putMany/removeMany (WiredTiger error codes)
+export const BatchStatus = {
+  OK: 0,
+  DUPLICATE_KEY: -31801,
+  NOT_FOUND: -31803
+} as const
+
+export function packKeys(keys: (string | Uint8Array)[]): Buffer {
+  const parts = keys.map(key => (typeof key === 'string' ? Buffer.from(key) : key))
+  let total = 0
+  for (const part of parts) total += 4 + part.length
+
+  const out = Buffer.allocUnsafe(total)
+  let offset = 0
+  for (const part of parts) {
+    out.writeUInt32LE(part.length, offset)
+    out.set(part, offset + 4)
+    offset += 4 + part.length
+  }
+  return out
+}
+
+export function packEntries(entries: [string | Uint8Array, string | Uint8Array][]): Buffer {
+  return packKeys(entries.flat())
+}
+
+export function unpackValues(buffer: Uint8Array): (Buffer | undefined)[] {
+  const buf = Buffer.from(buffer.buffer, buffer.byteOffset, buffer.byteLength)
+  const values: (Buffer | undefined)[] = []
+  let offset = 0
+  while (offset < buf.length) {
+    const length = buf.readUInt32LE(offset)
+    offset += 4
+    if (length === PACKED_MISSING) {
+      values.push(undefined)
+      continue
+    }
+    values.push(buf.subarray(offset, offset + length))
+    offset += length
+  }
+  return values
+}
+
+// Decodes the first `count` records of a scan chunk. Keys and values are
+// views into `chunk`, not copies.
+export function* decodeScanChunk(chunk: Buffer, count: number): Generator<{ key: Buffer; value: Buffer }> {
+  let offset = 0
+  for (let i = 0; i < count; i++) {
+    const keyLength = chunk.readUInt32LE(offset)
+    const key = chunk.subarray(offset + 4, offset + 4 + keyLength)
+    offset += 4 + keyLength
+    const valueLength = chunk.readUInt32LE(offset)
+    const value = chunk.subarray(offset + 4, offset + 4 + valueLength)
+    offset += 4 + valueLength
+    yield { key, value }
+  }
+}
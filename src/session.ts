@@ -1,9 +1,106 @@
-import { WiredTigerCursor } from './cursor'
+import { WiredTigerCursor, DocumentFilter, KeyBounds, ScanRecord } from './cursor'
+import { decodeScanChunk } from './packed'
+import {
+  CommitOptions,
+  Timestamp,
+  TransactionOptions,
+  TransactionTimestampKind,
+  TransactionTimestamps,
+  commitConfig,
+  timestampFromHex,
+  timestampToHex,
+  transactionConfig,
+  transactionTimestampConfig
+} from './timestamps'
+
+export interface CursorCacheStats {
+  size: number
+  cached: number
+  hits: number
+  misses: number
+  evictions: number
+}
+
+export interface FieldIndexOptions {
+  unique?: boolean
+}
+
+export interface IndexBuildOptions {
+  // Threads scanning the table (default 4, capped at the session pool size)
+  threads?: number
+}
+
+export interface IndexLookupOptions {
+  limit?: number
+}
+
+export type IndexValue = string | number | boolean | null
+
+// Bounds on an indexed value. With one side only, the range stays among
+// values of the bound's type.
+export interface IndexRange {
+  gt?: IndexValue
+  gte?: IndexValue
+  lt?: IndexValue
+  lte?: IndexValue
+}
+
+export interface AggregateOptions extends KeyBounds {
+  filter?: DocumentFilter
+  // Dotted path of the numeric field to sum/min/max; omit to only count
+  field?: string
+  // Dotted path of the field to group by; documents without it group as null
+  groupBy?: string
+  // Threads scanning the range (default 4, capped at the session pool size)
+  threads?: number
+}
+
+export interface AggregateTotals {
+  count: number
+  // Over the documents where `field` is a number; min/max are null if none
+  sum: number
+  min: number | null
+  max: number | null
+}
+
+export interface AggregateGroup extends AggregateTotals {
+  key: unknown
+}
+
+export interface AggregateResult extends AggregateTotals {
+  // Present with groupBy, in index order (null < booleans < numbers < strings)
+  groups?: AggregateGroup[]
+}
+
+export interface ParallelScanOptions extends KeyBounds {
+  filter?: DocumentFilter
+  // Threads scanning the range (default 4, capped at the session pool size)
+  threads?: number
+  // Yield records in key order (default) or as each thread produces them
+  ordered?: boolean
+  // What the threads read: a checkpoint of the table taken when the scan
+  // starts ('checkpoint', default), or each its own snapshot ('none')
+  snapshot?: 'checkpoint' | 'none'
+  // Read every part at this timestamp instead of a checkpoint
+  readTimestamp?: Timestamp
+  // Bytes per batch handed to JS (default 256 KiB)
+  batchSize?: number
+  // Batches each thread may get ahead of the consumer (default 4)
+  queueDepth?: number
+}
+
+export interface ParallelScanRecord extends ScanRecord {
+  // Which key range (thread) the record came from
+  part: number
+}
 
 export class WiredTigerSession {
   private session: any
   private readonly sessionId: string
   private readonly invalidate: (id: string) => void
+  // Closed cursors are cached natively and handed back by openCursor(), so
+  // their wrappers are reused along with them
+  private readonly cursors = new WeakMap<object, WiredTigerCursor>()
 
   constructor(session: any, invalidate: (id: string) => void) {
     if (!session?.__nativeSessionPtr) {
@@ -19,21 +116,65 @@ export class WiredTigerSession {
   }
 
   openCursor(tableName: string): WiredTigerCursor {
-    const cursor = this.session.openCursor(tableName)
-    return new WiredTigerCursor(cursor)
+    return this.wrapCursor(this.session.openCursor(tableName))
   }
 
   openCursorWithConfig(uri: string, config?: string): WiredTigerCursor {
-    const cursor = this.session.openCursorWithConfig(uri, config)
-    return new WiredTigerCursor(cursor)
+    return this.wrapCursor(this.session.openCursorWithConfig(uri, config))
+  }
+
+  getCursorCacheStats(): CursorCacheStats {
+    return this.session.getCursorCacheStats()
+  }
+
+  private wrapCursor(cursor: any): WiredTigerCursor {
+    let wrapper = this.cursors.get(cursor)
+    if (!wrapper) {
+      wrapper = new WiredTigerCursor(cursor)
+      this.cursors.set(cursor, wrapper)
+    }
+    return wrapper
+  }
+
+  beginTransaction(config?: string | TransactionOptions): void {
+    this.session.beginTransaction(typeof config === 'object' ? transactionConfig(config) : config)
+  }
+
+  commitTransaction(config?: string | CommitOptions): void {
+    this.session.commitTransaction(typeof config === 'object' ? commitConfig(config) : config)
+  }
+
+  // With groupCommit enabled on the connection, resolves once the log flush
+  // covering this commit is done; a config with its own sync setting
+  // commits on its own
+  async commitTransactionAsync(config?: string | CommitOptions): Promise<void> {
+    await this.session.commitTransactionAsync(typeof config === 'object' ? commitConfig(config) : config)
   }
 
-  beginTransaction(config?: string): void {
-    this.session.beginTransaction(config)
+  // Sets timestamps of the running transaction, e.g. a commit timestamp
+  // decided after the transaction began
+  timestampTransaction(timestamps: TransactionTimestamps): void {
+    this.session.timestampTransaction(transactionTimestampConfig(timestamps))
   }
 
-  commitTransaction(config?: string): void {
-    this.session.commitTransaction(config)
+  queryTimestamp(kind: TransactionTimestampKind): bigint {
+    return timestampFromHex(this.session.queryTimestamp(kind))
+  }
+
+  // Runs `fn` in a transaction reading the data as of `timestamp`, then
+  // rolls it back. The timestamp must not be older than the connection's
+  // oldest timestamp (see roundUpRead).
+  async readAt<T>(
+    timestamp: Timestamp,
+    fn: (session: WiredTigerSession) => T | Promise<T>,
+    options: Omit<TransactionOptions, 'readTimestamp'> = {}
+  ): Promise<T> {
+    this.beginTransaction({ ...options, readTimestamp: timestamp })
+    try {
+      return await fn(this)
+    } finally {
+      this.session.rollbackTransaction()
+    }
   }
 
   rollbackTransaction(config?: string): void {
@@ -52,6 +193,74 @@ export class WiredTigerSession {
     this.session.compact(uri, config)
   }
 
+  async compactAsync(uri: string, config?: string): Promise<void> {
+    await this.session.compactAsync(uri, config)
+  }
+
+  // Field indexes over the JSON documents of a key_format=u,value_format=u
+  // table. Once registered, every write through a cursor on the table
+  // updates the index in the same transaction; unique violations fail with
+  // WT_DUPLICATE_KEY. Registrations are saved with the database and
+  // reloaded when it is opened again. Returns true if the index table was
+  // just created and needs buildIndexAsync() for existing documents.
+  registerIndex(table: string, name: string, field: string, options?: FieldIndexOptions): boolean {
+    return this.session.registerIndex(table, name, field, options)
+  }
+
+  dropIndex(table: string, name: string): void {
+    this.session.dropIndex(table, name)
+  }
+
+  // Repopulates an index from its table in parallel; resolves with the
+  // number of entries written
+  buildIndexAsync(table: string, name: string, options?: IndexBuildOptions): Promise<number> {
+    return this.session.buildIndexAsync(table, name, options)
+  }
+
+  // Primary keys of the documents whose indexed field equals `value` or
+  // falls in its range
+  findByIndex(table: string, name: string, value: IndexValue | IndexRange, options?: IndexLookupOptions): string[] {
+    return this.session.findByIndex(table, name, value, options)
+  }
+
+  // Counts the documents whose indexed field equals `value` or falls in its
+  // range without reading the table
+  countByIndex(table: string, name: string, value: IndexValue | IndexRange): number {
+    return this.session.countByIndex(table, name, value)
+  }
+
+  // Count/sum/min/max over the JSON documents of a key range, computed
+  // natively and split across pooled sessions by key range
+  aggregateAsync(table: string, options: AggregateOptions = {}): Promise<AggregateResult> {
+    return this.session.aggregateAsync(table, options)
+  }
+
+  // Scans a key range on several threads reading one consistent view of
+  // the table. Breaking out of the loop stops the threads.
+  async *parallelScan(table: string, options: ParallelScanOptions = {}): AsyncGenerator<ParallelScanRecord> {
+    const scan = this.session.parallelScan(
+      table,
+      options.readTimestamp === undefined
+        ? options
+        : { ...options, readTimestamp: timestampToHex(options.readTimestamp) }
+    )
+    try {
+      for (;;) {
+        const batch: { chunk: Buffer; count: number; part: number } | null = await scan.next()
+        if (!batch) return
+        for (const record of decodeScanChunk(batch.chunk, batch.count)) {
+          yield { ...record, part: batch.part }
+        }
+      }
+    } finally {
+      try {
+        await scan.close()
+      } catch {
+        // Already closed along with the session
+      }
+    }
+  }
+
   close(): void {
     if (!this.session) return
     this.session.close()
@@ -0,0 +1,89 @@
+import { EventEmitter } from 'events'
+
+// WiredTiger statistics grouped by category, e.g.
+// stats.cache['bytes currently in the cache']
+export type WTStatistics = Record<string, Record<string, number>>
+
+export interface StatsOptions {
+  // 'connection' (default) or a data source URI such as 'table:users'
+  scope?: string
+  // Skip data source statistics that walk the tree
+  fast?: boolean
+}
+
+export interface StatsSamplerOptions extends StatsOptions {
+  // Milliseconds between samples (default 10000)
+  intervalMs?: number
+}
+
+export interface StatsSample {
+  stats: WTStatistics
+  // Change since the previous sample. Counters give the activity over the
+  // interval; gauges (e.g. bytes currently in the cache) how far they moved.
+  deltas: WTStatistics
+  intervalMs: number
+}
+
+export function diffStats(current: WTStatistics, previous: WTStatistics): WTStatistics {
+  const deltas: WTStatistics = {}
+  for (const [category, values] of Object.entries(current)) {
+    const before = previous[category] ?? {}
+    const changed: Record<string, number> = {}
+    for (const [name, value] of Object.entries(values)) {
+      changed[name] = value - (before[name] ?? 0)
+    }
+    deltas[category] = changed
+  }
+  return deltas
+}
+
+// Reads statistics every `intervalMs` and emits 'sample' with the values and
+// their deltas, or 'error' if a read fails (the sampler keeps running). The
+// timer doesn't keep the process alive, and closing the connection stops it.
+export class StatsSampler extends EventEmitter {
+  private timer: NodeJS.Timeout | null = null
+  private previous: WTStatistics | null = null
+  private previousTime = 0
+
+  constructor(
+    private readonly read: (options: StatsOptions) => WTStatistics,
+    private readonly options: StatsSamplerOptions = {}
+  ) {
+    super()
+  }
+
+  start(): this {
+    if (this.timer) return this
+    this.previous = this.read(this.options)
+    this.previousTime = Date.now()
+    this.timer = setInterval(() => this.sample(), this.options.intervalMs ?? 10000)
+    this.timer.unref()
+    return this
+  }
+
+  stop(): void {
+    if (this.timer) clearInterval(this.timer)
+    this.timer = null
+    this.previous = null
+  }
+
+  private sample(): void {
+    let stats: WTStatistics
+    try {
+      stats = this.read(this.options)
+    } catch (err) {
+      // Unhandled 'error' events throw, which would escape the timer
+      if (this.listenerCount('error') > 0) this.emit('error', err)
+      return
+    }
+    const now = Date.now()
+    const sample: StatsSample = {
+      stats,
+      deltas: diffStats(stats, this.previous ?? {}),
+      intervalMs: now - this.previousTime
+    }
+    this.previous = stats
+    this.previousTime = now
+    this.emit('sample', sample)
+  }
+}
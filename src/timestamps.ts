@@ -0,0 +1,113 @@
+// WiredTiger timestamps are unsigned 64-bit values passed around as hex
+// strings. The API takes them as bigints, safe-integer numbers or hex
+// strings and hands them back as bigints.
+export type Timestamp = bigint | number | string
+
+export interface TransactionOptions {
+  // Read the data as of this timestamp
+  readTimestamp?: Timestamp
+  // Round a read timestamp older than the oldest timestamp up to it instead
+  // of failing
+  roundUpRead?: boolean
+  isolation?: 'snapshot' | 'read-committed' | 'read-uncommitted'
+  // Raw begin_transaction settings appended to the above
+  config?: string
+}
+
+export interface CommitOptions {
+  commitTimestamp?: Timestamp
+  // Defaults to the commit timestamp
+  durableTimestamp?: Timestamp
+  config?: string
+}
+
+export interface TransactionTimestamps {
+  commit?: Timestamp
+  durable?: Timestamp
+  prepare?: Timestamp
+  read?: Timestamp
+}
+
+export interface GlobalTimestamps {
+  // History older than this may be discarded
+  oldest?: Timestamp
+  // Checkpoints include commits up to this
+  stable?: Timestamp
+  durable?: Timestamp
+}
+
+export type TransactionTimestampKind = 'commit' | 'first_commit' | 'prepare' | 'read'
+
+export type ConnectionTimestampKind =
+  | 'all_durable'
+  | 'last_checkpoint'
+  | 'oldest'
+  | 'oldest_reader'
+  | 'pinned'
+  | 'recovery'
+  | 'stable'
+
+export function timestampToHex(timestamp: Timestamp): string {
+  if (typeof timestamp === 'string') {
+    if (!/^[0-9a-fA-F]{1,16}$/.test(timestamp)) {
+      throw new TypeError(`Invalid hex timestamp: ${timestamp}`)
+    }
+    return timestamp.toLowerCase()
+  }
+  if (typeof timestamp === 'number' && !Number.isSafeInteger(timestamp)) {
+    throw new TypeError(`Timestamp must be a safe integer: ${timestamp}`)
+  }
+  const value = BigInt(timestamp)
+  if (value < 0n || value > 0xffffffffffffffffn) {
+    throw new RangeError(`Timestamp out of range: ${value}`)
+  }
+  return value.toString(16)
+}
+
+export function timestampFromHex(hex: string): bigint {
+  return BigInt('0x' + (hex || '0'))
+}
+
+function joinConfig(parts: string[], extra?: string): string | undefined {
+  if (extra) parts.push(extra)
+  return parts.length > 0 ? parts.join(',') : undefined
+}
+
+export function transactionConfig(options: TransactionOptions): string | undefined {
+  const parts: string[] = []
+  if (options.readTimestamp !== undefined) {
+    parts.push(`read_timestamp=${timestampToHex(options.readTimestamp)}`)
+  }
+  if (options.roundUpRead) parts.push('roundup_timestamps=(read=true)')
+  if (options.isolation) parts.push(`isolation=${options.isolation}`)
+  return joinConfig(parts, options.config)
+}
+
+export function commitConfig(options: CommitOptions): string | undefined {
+  const parts: string[] = []
+  if (options.commitTimestamp !== undefined) {
+    parts.push(`commit_timestamp=${timestampToHex(options.commitTimestamp)}`)
+  }
+  if (options.durableTimestamp !== undefined) {
+    parts.push(`durable_timestamp=${timestampToHex(options.durableTimestamp)}`)
+  }
+  return joinConfig(parts, options.config)
+}
+
+export function transactionTimestampConfig(timestamps: TransactionTimestamps): string {
+  const parts: string[] = []
+  for (const name of ['commit', 'durable', 'prepare', 'read'] as const) {
+    const value = timestamps[name]
+    if (value !== undefined) parts.push(`${name}_timestamp=${timestampToHex(value)}`)
+  }
+  return parts.join(',')
+}
+
+export function globalTimestampConfig(timestamps: GlobalTimestamps): string {
+  const parts: string[] = []
+  for (const name of ['oldest', 'stable', 'durable'] as const) {
+    const value = timestamps[name]
+    if (value !== undefined) parts.push(`${name}_timestamp=${timestampToHex(value)}`)
+  }
+  return parts.join(',')
+}
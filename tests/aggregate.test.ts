@@ -0,0 +1,131 @@
+import { describe, it, beforeEach, afterEach } from 'node:test'
+import * as assert from 'node:assert'
+import { WiredTigerConnection } from '../src/connection'
+import { WiredTigerSession } from '../src/session'
+import { WiredTigerCursor } from '../src/cursor'
+import * as fs from 'fs'
+import * as path from 'path'
+
+describe('Aggregation', () => {
+  const testDbPath = path.join(__dirname, 'test-db-aggregate')
+  const statuses = ['open', 'paid', 'shipped']
+  let conn: WiredTigerConnection
+  let session: WiredTigerSession
+  let cursor: WiredTigerCursor
+
+  beforeEach(() => {
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+    fs.mkdirSync(testDbPath, { recursive: true })
+
+    conn = new WiredTigerConnection()
+    conn.open(testDbPath, 'create')
+    session = conn.openSession()
+    session.createTable('orders', 'key_format=u,value_format=u')
+    cursor = session.openCursor('orders')
+
+    // order:0000 .. order:2999, total = i, status cycles through `statuses`
+    session.beginTransaction()
+    for (let i = 0; i < 3000; i++) {
+      const doc: Record<string, unknown> = { total: i, status: statuses[i % 3] }
+      if (i % 100 === 0) delete doc.status
+      cursor.set(`order:${String(i).padStart(4, '0')}`, JSON.stringify(doc))
+      cursor.insert()
+    }
+    cursor.set('note', 'not json')
+    cursor.insert()
+    session.commitTransaction()
+  })
+
+  afterEach(() => {
+    try {
+      cursor?.close()
+      session?.close()
+      conn?.close()
+    } catch {
+      // Ignore errors if already closed
+    }
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+  })
+
+  it('should count a key range', async () => {
+    const all = await session.aggregateAsync('orders')
+    assert.strictEqual(all.count, 3001)
+    assert.strictEqual(all.min, null)
+
+    const range = await session.aggregateAsync('orders', { gte: 'order:1000', lt: 'order:2000', threads: 3 })
+    assert.strictEqual(range.count, 1000)
+  })
+
+  it('should sum, min and max a field across threads', async () => {
+    for (const threads of [1, 4]) {
+      const result = await session.aggregateAsync('orders', { field: 'total', threads })
+      assert.deepStrictEqual(result, { count: 3001, sum: (2999 * 3000) / 2, min: 0, max: 2999 })
+    }
+
+    const range = await session.aggregateAsync('orders', { gt: 'order:0010', lte: 'order:0020', field: 'total' })
+    assert.deepStrictEqual(range, { count: 10, sum: 155, min: 11, max: 20 })
+  })
+
+  it('should group by a field', async () => {
+    const result = await session.aggregateAsync('orders', {
+      field: 'total',
+      groupBy: 'status',
+      filter: { total: { $lt: 300 } }
+    })
+    assert.strictEqual(result.count, 300)
+    assert.deepStrictEqual(
+      result.groups?.map((group) => [group.key, group.count]),
+      [
+        [null, 3],
+        ['open', 99],
+        ['paid', 99],
+        ['shipped', 99]
+      ]
+    )
+    const paid = result.groups?.find((group) => group.key === 'paid')
+    assert.strictEqual(paid?.min, 1)
+    assert.strictEqual(paid?.max, 298)
+  })
+
+  it('should pack bounds on typed keys', async () => {
+    session.createTable('events', 'key_format=q,value_format=u')
+    const events = session.openCursor('events')
+    for (let i = -500; i < 500; i++) {
+      events.set(i, Buffer.from(JSON.stringify({ n: i })))
+      events.insert()
+    }
+    events.close()
+
+    const result = await session.aggregateAsync('events', { gte: -10, lt: 10, field: 'n', threads: 4 })
+    assert.deepStrictEqual(result, { count: 20, sum: -10, min: -10, max: 9 })
+  })
+
+  it('should count through an index without reading the table', async () => {
+    session.registerIndex('orders', 'status', 'status')
+    await session.buildIndexAsync('orders', 'status')
+    assert.strictEqual(session.countByIndex('orders', 'status', 'paid'), 990)
+    assert.strictEqual(session.countByIndex('orders', 'status', 'lost'), 0)
+  })
+
+  it('should count index ranges', async () => {
+    session.registerIndex('orders', 'total', 'total')
+    session.registerIndex('orders', 'status', 'status')
+    await session.buildIndexAsync('orders', 'total')
+    await session.buildIndexAsync('orders', 'status')
+    assert.strictEqual(session.countByIndex('orders', 'total', { gte: 100, lt: 200 }), 100)
+    assert.strictEqual(session.countByIndex('orders', 'total', { gt: 2990 }), 9)
+    assert.strictEqual(session.countByIndex('orders', 'total', { lte: 9 }), 10)
+    assert.strictEqual(session.countByIndex('orders', 'status', { gte: 'open', lt: 'shipped' }), 1980)
+    assert.strictEqual(session.countByIndex('orders', 'status', { gt: 'paid', lte: 'shipped' }), 990)
+    assert.deepStrictEqual(session.findByIndex('orders', 'total', { gt: 1, lte: 3 }).length, 2)
+    assert.throws(() => session.countByIndex('orders', 'total', { gt: {} as never }), /expected for gt/)
+  })
+
+  it('should reject invalid field paths', () => {
+    assert.throws(() => session.aggregateAsync('orders', { field: 'a..b' }), /Field path expected for field/)
+  })
+})
@@ -0,0 +1,203 @@
+import { describe, it, beforeEach, afterEach } from 'node:test'
+import * as assert from 'node:assert'
+import { WiredTigerConnection } from '../src/connection'
+import { WiredTigerSession } from '../src/session'
+import { WiredTigerCursor } from '../src/cursor'
+import * as fs from 'fs'
+import * as path from 'path'
+
+describe('Async operations', () => {
+  const testDbPath = path.join(__dirname, 'test-db-async')
+  let conn: WiredTigerConnection
+  let session: WiredTigerSession
+  let cursor: WiredTigerCursor
+
+  beforeEach(() => {
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+    fs.mkdirSync(testDbPath, { recursive: true })
+
+    conn = new WiredTigerConnection()
+    conn.open(testDbPath, 'create')
+    session = conn.openSession()
+    session.createTable('test', 'key_format=u,value_format=u')
+    cursor = session.openCursor('test')
+  })
+
+  afterEach(() => {
+    try {
+      cursor?.close()
+      session?.close()
+      conn?.close()
+    } catch {
+      // Ignore errors if already closed
+    }
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+  })
+
+  it('should insert and search asynchronously', async () => {
+    await cursor.insertAsync('key1', 'value1')
+
+    const value = await cursor.searchAsync('key1')
+    assert.strictEqual(value, 'value1')
+
+    const missing = await cursor.searchAsync('nope')
+    assert.strictEqual(missing, null)
+  })
+
+  it('should update and remove asynchronously', async () => {
+    await cursor.insertAsync('key1', 'value1')
+    await cursor.updateAsync('key1', 'updated')
+    assert.strictEqual(await cursor.searchAsync('key1'), 'updated')
+
+    await cursor.removeAsync('key1')
+    assert.strictEqual(await cursor.searchAsync('key1'), null)
+  })
+
+  it('should iterate with nextAsync() and prevAsync()', async () => {
+    await cursor.insertAsync('a', '1')
+    await cursor.insertAsync('b', '2')
+    cursor.reset()
+
+    const first = await cursor.nextAsync()
+    assert.deepStrictEqual(first, { key: 'a', value: '1' })
+    const second = await cursor.nextAsync()
+    assert.deepStrictEqual(second, { key: 'b', value: '2' })
+    assert.strictEqual(await cursor.nextAsync(), null)
+
+    cursor.reset()
+    const last = await cursor.prevAsync()
+    assert.deepStrictEqual(last, { key: 'b', value: '2' })
+  })
+
+  it('should run queued operations on one session in order', async () => {
+    const writes: Promise<void>[] = []
+    for (let i = 0; i < 50; i++) {
+      writes.push(cursor.insertAsync(`key${String(i).padStart(2, '0')}`, `value${i}`))
+    }
+    await Promise.all(writes)
+
+    const reads = await Promise.all([cursor.searchAsync('key00'), cursor.searchAsync('key49')])
+    assert.deepStrictEqual(reads, ['value0', 'value49'])
+  })
+
+  it('should reject sync calls while the session is busy', async () => {
+    const pending = cursor.insertAsync('key1', 'value1')
+
+    assert.throws(() => cursor.search('key1'), /busy/)
+    assert.throws(() => session.beginTransaction(), /busy/)
+
+    await pending
+    assert.strictEqual(cursor.search('key1'), 'value1')
+  })
+
+  it('should commit transactions asynchronously', async () => {
+    session.beginTransaction()
+    cursor.set('txn-key', 'txn-value')
+    cursor.insert()
+    await session.commitTransactionAsync()
+
+    assert.strictEqual(cursor.search('txn-key'), 'txn-value')
+  })
+
+  it('should reject when the async commit fails', async () => {
+    await assert.rejects(session.commitTransactionAsync(), /Failed to commit transaction/)
+  })
+
+  it('should compact and checkpoint asynchronously', async () => {
+    await cursor.insertAsync('key1', 'value1')
+    cursor.close()
+
+    await session.compactAsync('table:test')
+    await conn.checkpointAsync()
+  })
+
+  it('should refuse to close the connection with work in flight', async () => {
+    const pending = conn.checkpointAsync()
+    assert.throws(() => conn.close(), /async operations are pending/)
+    await pending
+  })
+})
+
+describe('Group commit', () => {
+  const testDbPath = path.join(__dirname, 'test-db-group-commit')
+  let conn: WiredTigerConnection
+
+  beforeEach(() => {
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+    fs.mkdirSync(testDbPath, { recursive: true })
+
+    conn = new WiredTigerConnection()
+    conn.open(testDbPath, 'create,log=(enabled)', { groupCommit: { maxDelayMs: 5, maxBatch: 64 } })
+  })
+
+  afterEach(() => {
+    try {
+      conn?.close()
+    } catch {
+      // Ignore errors if already closed
+    }
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+  })
+
+  it('should coalesce commits from many sessions into fewer flushes', async () => {
+    const setup = conn.openSession()
+    setup.createTable('test', 'key_format=u,value_format=u')
+    setup.close()
+
+    const sessions = Array.from({ length: 16 }, () => conn.openSession())
+    const commits = sessions.map((session, i) => {
+      const cursor = session.openCursor('test')
+      session.beginTransaction()
+      cursor.set(`key${i}`, `value${i}`)
+      cursor.insert()
+      cursor.close()
+      return session.commitTransactionAsync()
+    })
+    await Promise.all(commits)
+
+    const stats = conn.getGroupCommitStats()!
+    assert.strictEqual(stats.commits, 16)
+    assert.strictEqual(stats.pending, 0)
+    assert.ok(stats.flushes >= 1 && stats.flushes < 16, `${stats.flushes} flushes`)
+
+    const cursor = sessions[0].openCursor('test')
+    assert.strictEqual(cursor.search('key15'), 'value15')
+    cursor.close()
+    for (const session of sessions) session.close()
+  })
+
+  it('should commit on its own when given a config', async () => {
+    const session = conn.openSession()
+    session.createTable('test', 'key_format=u,value_format=u')
+    const cursor = session.openCursor('test')
+    session.beginTransaction()
+    cursor.set('key', 'value')
+    cursor.insert()
+    await session.commitTransactionAsync('sync=on')
+    cursor.close()
+    session.close()
+
+    assert.strictEqual(conn.getGroupCommitStats()!.commits, 0)
+  })
+
+  it('should report no stats without group commit', () => {
+    const plain = new WiredTigerConnection()
+    const plainPath = `${testDbPath}-plain`
+    fs.mkdirSync(plainPath, { recursive: true })
+    try {
+      plain.open(plainPath, 'create')
+      assert.strictEqual(plain.getGroupCommitStats(), null)
+      plain.close()
+    } finally {
+      fs.rmSync(plainPath, { recursive: true, force: true })
+    }
+  })
+})
@@ -0,0 +1,168 @@
+import { describe, it, beforeEach, afterEach } from 'node:test'
+import * as assert from 'node:assert'
+import { WiredTigerConnection } from '../src/connection'
+import { WiredTigerSession } from '../src/session'
+import { WiredTigerCursor } from '../src/cursor'
+import { packKeys, packEntries, unpackValues, BatchStatus } from '../src/packed'
+import * as fs from 'fs'
+import * as path from 'path'
+
+describe('Batch operations', () => {
+  const testDbPath = path.join(__dirname, 'test-db-batch')
+  let conn: WiredTigerConnection
+  let session: WiredTigerSession
+  let cursor: WiredTigerCursor
+
+  beforeEach(() => {
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+    fs.mkdirSync(testDbPath, { recursive: true })
+
+    conn = new WiredTigerConnection()
+    conn.open(testDbPath, 'create')
+    session = conn.openSession()
+    session.createTable('test', 'key_format=u,value_format=u')
+    cursor = session.openCursor('test')
+
+    for (let i = 0; i < 10; i++) {
+      cursor.set(`key${i}`, `value${i}`)
+      cursor.insert()
+    }
+  })
+
+  afterEach(() => {
+    try {
+      cursor?.close()
+      session?.close()
+      conn?.close()
+    } catch {
+      // Ignore errors if already closed
+    }
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+  })
+
+  describe('getMany', () => {
+    it('should return values in request order with holes for missing keys', () => {
+      const values = cursor.getMany(['key7', 'missing', 'key2', 'key0'])
+
+      assert.strictEqual(values.length, 4)
+      assert.strictEqual(values[0], 'value7')
+      assert.ok(!(1 in values))
+      assert.strictEqual(values[2], 'value2')
+      assert.strictEqual(values[3], 'value0')
+    })
+
+    it('should handle an empty batch', () => {
+      assert.deepStrictEqual(cursor.getMany([]), [])
+    })
+
+    it('should accept and return packed buffers', () => {
+      const result = cursor.getMany(packKeys(['key3', 'nope', 'key9']))
+      const values = unpackValues(result)
+
+      assert.strictEqual(values.length, 3)
+      assert.strictEqual(values[0]?.toString(), 'value3')
+      assert.strictEqual(values[1], undefined)
+      assert.strictEqual(values[2]?.toString(), 'value9')
+    })
+
+    it('should reject malformed packed buffers', () => {
+      const bad = Buffer.alloc(6)
+      bad.writeUInt32LE(100, 0)
+      assert.throws(() => cursor.getMany(bad), /Malformed packed key buffer/)
+    })
+
+    it('should run asynchronously', async () => {
+      const values = await cursor.getManyAsync(['key1', 'key5'])
+      assert.deepStrictEqual(values, ['value1', 'value5'])
+    })
+  })
+  describe('putMany / removeMany', () => {
+    it('should write a packed batch and return statuses', () => {
+      const statuses = cursor.putMany(
+        packEntries([
+          ['a', '1'],
+          ['b', '2'],
+          ['key0', 'overwritten']
+        ])
+      )
+
+      assert.deepStrictEqual(Array.from(statuses), [0, 0, 0])
+      assert.strictEqual(cursor.search('a'), '1')
+      assert.strictEqual(cursor.search('key0'), 'overwritten')
+    })
+
+    it('should report duplicate keys without overwrite', () => {
+      const strict = session.openCursorWithConfig('table:test', 'overwrite=false')
+      const statuses = strict.putMany(
+        packEntries([
+          ['key1', 'x'],
+          ['fresh', 'y']
+        ])
+      )
+      strict.close()
+
+      assert.deepStrictEqual(Array.from(statuses), [BatchStatus.DUPLICATE_KEY, BatchStatus.OK])
+      assert.strictEqual(cursor.search('key1'), 'value1')
+      assert.strictEqual(cursor.search('fresh'), 'y')
+    })
+
+    it('should join the caller transaction', () => {
+      session.beginTransaction()
+      cursor.putMany(packEntries([['txn', 'value']]))
+      session.rollbackTransaction()
+
+      assert.strictEqual(cursor.search('txn'), null)
+    })
+
+    it('should remove keys', () => {
+      const statuses = cursor.removeMany(['key1', 'key2'])
+      assert.strictEqual(statuses.length, 2)
+      assert.strictEqual(cursor.search('key1'), null)
+      assert.strictEqual(cursor.search('key2'), null)
+      assert.strictEqual(cursor.search('key3'), 'value3')
+
+      cursor.removeMany(packKeys(['key3']))
+      assert.strictEqual(cursor.search('key3'), null)
+    })
+
+    it('should bulk load an empty table', () => {
+      session.createTable('empty', 'key_format=u,value_format=u')
+      const bulk = session.openCursor('empty')
+      bulk.putMany(
+        packEntries([
+          ['c', '3'],
+          ['a', '1'],
+          ['b', '2'],
+          ['a', 'last']
+        ]),
+        { bulk: true }
+      )
+
+      bulk.reset()
+      const rows = []
+      let row = bulk.next()
+      while (row) {
+        rows.push(row)
+        row = bulk.next()
+      }
+      bulk.close()
+
+      assert.deepStrictEqual(rows, [
+        { key: 'a', value: 'last' },
+        { key: 'b', value: '2' },
+        { key: 'c', value: '3' }
+      ])
+    })
+
+    it('should run asynchronously', async () => {
+      const statuses = await cursor.putManyAsync(packEntries([['async', 'yes']]))
+      assert.deepStrictEqual(Array.from(statuses), [0])
+      await cursor.removeManyAsync(['async'])
+      assert.strictEqual(cursor.search('async'), null)
+    })
+  })
+})
@@ -0,0 +1,100 @@
+import { describe, it, beforeEach, afterEach } from 'node:test'
+import * as assert from 'node:assert'
+import { WiredTigerConnection } from '../src/connection'
+import { WiredTigerSession } from '../src/session'
+import * as fs from 'fs'
+import * as path from 'path'
+
+describe('Compression advice', () => {
+  const testDbPath = path.join(__dirname, 'test-db-compression')
+  let conn: WiredTigerConnection
+  let session: WiredTigerSession
+
+  beforeEach(() => {
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+    fs.mkdirSync(testDbPath, { recursive: true })
+
+    conn = new WiredTigerConnection()
+    conn.open(testDbPath, 'create')
+    session = conn.openSession()
+  })
+
+  afterEach(() => {
+    try {
+      session?.close()
+      conn?.close()
+    } catch {
+      // Ignore errors if already closed
+    }
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+  })
+
+  it('should measure candidates, recommend a config and rebuild the table', async () => {
+    session.createTable('events', 'key_format=S,value_format=S')
+    const cursor = session.openCursor('events')
+    for (let i = 0; i < 3000; i++) {
+      cursor.set(`event:2024-01-01:${String(i).padStart(6, '0')}`, JSON.stringify({ type: 'click', page: `/p/${i % 20}` }))
+      cursor.insert()
+    }
+    cursor.close()
+
+    const advice = await conn.adviseCompression('events', {
+      sampleSize: 2000,
+      compressors: ['none', 'snappy', 'no-such-compressor'],
+      leafPageSizes: [16 * 1024, 64 * 1024],
+      rebuildInto: 'events_v2'
+    })
+
+    assert.ok(advice.sampledRows > 0 && advice.sampledRows <= 2000)
+    assert.ok(advice.keyPrefixRatio > 0.5)
+    assert.ok(advice.unavailable.includes('no-such-compressor'))
+    const none = advice.candidates.filter(candidate => candidate.compressor === 'none')
+    assert.deepStrictEqual(none.map(candidate => candidate.leafPageMax).sort((a, b) => a - b), [16384, 65536])
+    for (const candidate of advice.candidates) {
+      assert.ok(candidate.bytes > 0 && candidate.ratio > 0 && candidate.readMBps > 0 && candidate.writeMBps > 0)
+    }
+    assert.strictEqual(advice.recommended.compressor, advice.candidates[0].compressor)
+    assert.strictEqual(advice.recommended.prefixCompression, true)
+    assert.match(advice.recommended.config, /^key_format=S,value_format=S,block_compressor=/)
+    assert.deepStrictEqual(advice.rebuilt, { uri: 'table:events_v2', rows: 3000 })
+
+    // Scratch tables are gone
+    assert.deepStrictEqual(
+      fs.readdirSync(testDbPath).filter(file => file.startsWith('__compression_advisor')),
+      []
+    )
+
+    const copy = session.openCursor('events_v2')
+    assert.strictEqual(JSON.parse(copy.search('event:2024-01-01:000042')!).page, '/p/2')
+    copy.close()
+
+    await assert.rejects(conn.adviseCompression('events', { rebuildInto: 'events_v2' }), /cannot create table:events_v2/)
+    await assert.rejects(conn.adviseCompression('missing'), /cannot find table:missing/)
+  })
+
+  it('should keep the source schema and reject invalid page sizes', async () => {
+    session.createTable('notes', 'key_format=S,value_format=S,columns=(id,body),app_metadata=(owner=web)')
+    const cursor = session.openCursor('notes')
+    for (let i = 0; i < 200; i++) {
+      cursor.set(`note:${i}`, `body ${i}`)
+      cursor.insert()
+    }
+    cursor.close()
+
+    assert.throws(() => conn.adviseCompression('notes', { leafPageSizes: [1000] }), /multiples of 4KB/)
+
+    const advice = await conn.adviseCompression('notes', {
+      compressors: ['none'],
+      leafPageSizes: [16 * 1024],
+      rebuildInto: 'notes_v2'
+    })
+    assert.deepStrictEqual(advice.unavailable, [])
+    assert.match(advice.recommended.config, /,columns=\(id,body\)/)
+    assert.match(advice.recommended.config, /,app_metadata=\(owner=web\)/)
+    assert.deepStrictEqual(advice.rebuilt, { uri: 'table:notes_v2', rows: 200 })
+  })
+})
@@ -1,8 +1,10 @@
 import { describe, it, beforeEach, afterEach, mock } from 'node:test'
 import * as assert from 'node:assert'
 import { WiredTigerConnection } from '../src/connection'
+import { packEntries } from '../src/packed'
 import * as fs from 'fs'
 import * as path from 'path'
+import { Worker } from 'worker_threads'
 
 let connectionModule: typeof import('../src/connection')
 
@@ -161,4 +163,290 @@ describe('WiredTigerConnection', () => {
     assert.ok((session as any).session.__nativeSessionPtr, 'Session should have native pointer')
     session.close()
   })
+
+  it('should reuse pooled sessions', () => {
+    conn = new connectionModule.WiredTigerConnection()
+    conn.open(testDbPath, 'create', { sessionPoolSize: 2 })
+
+    const first = conn.openSession()
+    first.close()
+    const second = conn.openSession()
+
+    const stats = conn.getSessionPoolStats()
+    assert.strictEqual(stats.size, 2)
+    assert.strictEqual(stats.misses, 1)
+    assert.strictEqual(stats.hits, 1)
+    second.close()
+  })
+
+  it('should open overflow sessions past the pool size', () => {
+    conn = new connectionModule.WiredTigerConnection()
+    conn.open(testDbPath, 'create', { sessionPoolSize: 1 })
+
+    const a = conn.openSession()
+    const b = conn.openSession()
+    assert.strictEqual(conn.getSessionPoolStats().overflows, 1)
+
+    a.close()
+    b.close()
+    const stats = conn.getSessionPoolStats()
+    assert.strictEqual(stats.open, 1)
+    assert.strictEqual(stats.idle, 1)
+  })
+
+  it('should close cursors and roll back when a session returns to the pool', () => {
+    conn = new connectionModule.WiredTigerConnection()
+    conn.open(testDbPath, 'create')
+
+    const session = conn.openSession()
+    session.createTable('pooled', 'key_format=u,value_format=u')
+    const cursor = session.openCursor('pooled')
+    session.beginTransaction()
+    cursor.set('k', 'v')
+    cursor.insert()
+    session.close()
+
+    assert.throws(() => cursor.search('k'), /closed/)
+
+    const next = conn.openSession()
+    const check = next.openCursor('pooled')
+    assert.strictEqual(check.search('k'), null)
+    check.close()
+    next.close()
+  })
+
+  it('should read connection and table statistics', () => {
+    conn = new connectionModule.WiredTigerConnection()
+    conn.open(testDbPath, 'create', { statistics: 'fast' })
+
+    const session = conn.openSession()
+    session.createTable('stats', 'key_format=u,value_format=u')
+    const cursor = session.openCursor('stats')
+    cursor.set('k', 'v')
+    cursor.insert()
+
+    const stats = conn.getStats()
+    assert.strictEqual(typeof stats.cache['bytes currently in the cache'], 'number')
+    assert.ok(stats.cursor['cursor insert calls'] >= 1)
+
+    const table = conn.getStats({ scope: 'table:stats', fast: true })
+    assert.ok(Object.keys(table).length > 0)
+    session.close()
+  })
+
+  it('should emit statistics deltas from a sampler', async () => {
+    conn = new connectionModule.WiredTigerConnection()
+    conn.open(testDbPath, 'create', { statistics: 'fast' })
+    const session = conn.openSession()
+    session.createTable('stats', 'key_format=u,value_format=u')
+    const cursor = session.openCursor('stats')
+
+    const sampler = conn.createStatsSampler({ intervalMs: 20 }).start()
+    for (let i = 0; i < 10; i++) {
+      cursor.set(`k${i}`, 'v')
+      cursor.insert()
+    }
+    // The sampler's timer is unref'd; hold the event loop open meanwhile
+    const keepAlive = setTimeout(() => {}, 5000)
+    const sample: any = await new Promise(resolve => sampler.once('sample', resolve))
+    clearTimeout(keepAlive)
+    sampler.stop()
+    assert.ok(sample.deltas.cursor['cursor insert calls'] >= 10)
+    assert.ok(sample.intervalMs > 0)
+    session.close()
+  })
+
+  it('should run checkpoints and compaction in the background', async () => {
+    conn = new connectionModule.WiredTigerConnection()
+    conn.open(testDbPath, 'create')
+    const session = conn.openSession()
+    session.createTable('maint', 'key_format=u,value_format=u')
+    const cursor = session.openCursor('maint')
+    cursor.set('k', 'v')
+    cursor.insert()
+    cursor.close()
+    session.close()
+
+    const scheduler = conn.startMaintenance({ compactTables: ['maint'], tickMs: 10 })
+    const events: any[] = []
+    scheduler.on('start', event => events.push(event))
+    scheduler.on('complete', event => events.push(event))
+    // Events don't keep the process alive
+    const keepAlive = setTimeout(() => {}, 5000)
+    const completed = (task: string) =>
+      new Promise<any>(resolve =>
+        scheduler.on('complete', event => {
+          if (event.task === task) resolve(event)
+        })
+      )
+
+    const checkpoint = completed('checkpoint')
+    scheduler.trigger('checkpoint')
+    assert.strictEqual((await checkpoint).reason, 'manual')
+
+    // Paused work waits for resume()
+    scheduler.pause()
+    const compaction = completed('compact')
+    scheduler.trigger('compact')
+    await new Promise(resolve => setTimeout(resolve, 50))
+    assert.ok(!events.some(event => event.task === 'compact'))
+    scheduler.resume()
+    const done = await compaction
+    clearTimeout(keepAlive)
+    assert.strictEqual(done.total, 1)
+    assert.strictEqual(done.compacted, 1)
+
+    const stats = scheduler.stats()!
+    assert.strictEqual(stats.checkpoints, 1)
+    assert.strictEqual(stats.compactions, 1)
+    await scheduler.stop()
+    assert.strictEqual(scheduler.stats(), null)
+    await scheduler.stop()
+  })
+
+  it('should share one connection between objects opening the same home', () => {
+    conn = new connectionModule.WiredTigerConnection()
+    conn.open(testDbPath, 'create')
+    const other = new connectionModule.WiredTigerConnection()
+    other.open(testDbPath, 'create')
+
+    const home = connectionModule.getOpenConnections().find(entry => entry.home === fs.realpathSync(testDbPath))
+    assert.strictEqual(home?.references, 2)
+
+    const session = other.openSession()
+    session.createTable('shared', 'key_format=u,value_format=u')
+    const cursor = session.openCursor('shared')
+    cursor.set('k', 'v')
+    cursor.insert()
+    other.close()
+
+    // Still open for the remaining object
+    const reader = conn.openSession()
+    const check = reader.openCursor('shared')
+    assert.strictEqual(check.search('k'), 'v')
+    check.close()
+    reader.close()
+    conn.close()
+    assert.ok(!connectionModule.getOpenConnections().some(entry => entry.home === fs.realpathSync(testDbPath)))
+  })
+
+  it('should let worker threads write through the shared connection', async () => {
+    conn = new connectionModule.WiredTigerConnection()
+    conn.open(testDbPath, 'create')
+    const session = conn.openSession()
+    session.createTable('workers', 'key_format=u,value_format=u')
+
+    const binding = path.join(__dirname, '..', 'build', 'Release', 'wiredtiger_native.node')
+    const source = `
+      const { workerData, parentPort } = require('worker_threads')
+      const native = require(workerData.binding)
+      const conn = new native.WiredTigerConnection()
+      conn.open(workerData.home, 'create')
+      const session = conn.openSession()
+      const cursor = session.openCursor('workers')
+      for (let i = 0; i < 100; i++) {
+        cursor.set('w' + workerData.id + ':' + i, 'v')
+        cursor.insert()
+      }
+      cursor.close()
+      session.close()
+      conn.close()
+      parentPort.postMessage('done')
+    `
+    await Promise.all(
+      [0, 1, 2].map(
+        id =>
+          new Promise((resolve, reject) => {
+            const worker = new Worker(source, { eval: true, workerData: { binding, home: testDbPath, id } })
+            worker.once('message', resolve)
+            worker.once('error', reject)
+          })
+      )
+    )
+
+    const cursor = session.openCursor('workers')
+    let rows = 0
+    while (cursor.next()) rows++
+    assert.strictEqual(rows, 300)
+    cursor.close()
+    session.close()
+  })
+
+  it('should serve hot keys from the read cache and invalidate them on writes', async () => {
+    conn = new connectionModule.WiredTigerConnection()
+    conn.open(testDbPath, 'create', { readCache: { maxBytes: 1 << 20 } })
+    const session = conn.openSession()
+    const other = conn.openSession()
+    session.createTable('hot', 'key_format=u,value_format=u')
+    const cursor = session.openCursor('hot')
+    const reader = other.openCursor('hot')
+    cursor.set('k', 'v1')
+    cursor.insert()
+
+    for (let i = 0; i < 10; i++) assert.strictEqual(reader.search('k'), 'v1')
+    let stats = conn.getReadCacheStats()!
+    assert.strictEqual(stats.misses, 1)
+    assert.strictEqual(stats.hits, 9)
+    assert.strictEqual(stats.hitRatio, 0.9)
+    // A hit still leaves the cursor usable from the key
+    assert.strictEqual(reader.search('k'), 'v1')
+    assert.ok(reader.get())
+
+    cursor.set('k', 'v2')
+    cursor.update()
+    assert.strictEqual(reader.search('k'), 'v2')
+
+    // Uncommitted writes stay invisible to other sessions' cached reads,
+    // and the writer's own reads bypass the cache
+    session.beginTransaction()
+    cursor.set('k', 'v3')
+    cursor.update()
+    assert.strictEqual(cursor.search('k'), 'v3')
+    assert.strictEqual(reader.search('k'), 'v2')
+    session.rollbackTransaction()
+    assert.strictEqual(reader.search('k'), 'v2')
+
+    session.beginTransaction()
+    cursor.set('k', 'v4')
+    cursor.update()
+    assert.strictEqual(reader.search('k'), 'v2')
+    session.commitTransaction()
+    assert.strictEqual(reader.search('k'), 'v4')
+
+    await cursor.removeAsync('k')
+    assert.strictEqual(reader.search('k'), null)
+    cursor.putMany(packEntries([['k', 'v5']]))
+    assert.strictEqual(reader.search('k'), 'v5')
+    stats = conn.getReadCacheStats()!
+    assert.ok(stats.invalidations >= 3)
+    assert.ok(stats.bytes <= stats.maxBytes)
+
+    reader.close()
+    cursor.close()
+    other.close()
+    session.close()
+  })
+
+  it('should not serve checkpoint cursors from the read cache', () => {
+    conn = new connectionModule.WiredTigerConnection()
+    conn.open(testDbPath, 'create', { readCache: { maxBytes: 1 << 20 } })
+    const session = conn.openSession()
+    session.createTable('hot', 'key_format=u,value_format=u')
+    const cursor = session.openCursor('hot')
+    cursor.set('k', 'v1')
+    cursor.insert()
+    conn.checkpoint()
+    cursor.set('k', 'v2')
+    cursor.update()
+
+    assert.strictEqual(cursor.search('k'), 'v2')
+    assert.strictEqual(cursor.search('k'), 'v2')
+    const checkpoint = session.openCursorWithConfig('table:hot', 'checkpoint=WiredTigerCheckpoint')
+    assert.strictEqual(checkpoint.search('k'), 'v1')
+    assert.strictEqual(conn.getReadCacheStats()!.hits, 1)
+
+    checkpoint.close()
+    cursor.close()
+    session.close()
+  })
 })
@@ -5,6 +5,8 @@ import { WiredTigerSession } from '../src/session'
 import { WiredTigerCursor } from '../src/cursor'
 import * as fs from 'fs'
 import * as path from 'path'
+import * as v8 from 'v8'
+import * as vm from 'vm'
 
 describe('WiredTigerCursor', () => {
   const testDbPath = path.join(__dirname, 'test-db-cursor')
@@ -218,4 +220,95 @@ describe('WiredTigerCursor', () => {
     const result = cursor.next() // Try to move past end
     assert.strictEqual(result, null)
   })
+  it('should return zero-copy value views', () => {
+    cursor.set('k1', 'v1')
+    cursor.insert()
+
+    const view = cursor.searchView('k1')
+    assert.ok(view)
+    assert.strictEqual(Buffer.from(view).toString(), 'v1')
+    assert.strictEqual(cursor.searchView('missing'), null)
+  })
+
+  it('should detach views when the cursor moves', () => {
+    cursor.set('k1', 'v1')
+    cursor.insert()
+    cursor.set('k2', 'v2')
+    cursor.insert()
+
+    cursor.reset()
+    cursor.next()
+    const key = cursor.getKeyView()
+    const value = cursor.getValueView()
+    assert.strictEqual(Buffer.from(key!).toString(), 'k1')
+    assert.strictEqual(value!.byteLength, 2)
+
+    cursor.next()
+    assert.strictEqual(key!.byteLength, 0)
+    assert.strictEqual(value!.byteLength, 0)
+  })
+
+  it('should detach views when the transaction ends', () => {
+    cursor.set('k1', 'v1')
+    cursor.insert()
+
+    session.beginTransaction()
+    const view = cursor.searchView('k1')
+    session.commitTransaction()
+    assert.strictEqual(view!.byteLength, 0)
+  })
+
+  it('should detach views when their cursor is garbage collected', async () => {
+    cursor.set('k1', 'v1')
+    cursor.insert()
+
+    v8.setFlagsFromString('--expose-gc')
+    const gc = vm.runInNewContext('gc') as () => void
+    const viewFromDroppedCursor = () => {
+      const dropped = session.openCursor('test')
+      return dropped.searchView('k1')!
+    }
+    const view = viewFromDroppedCursor()
+    assert.strictEqual(view.byteLength, 2)
+
+    // Finalizers may run a turn after the collection
+    for (let i = 0; i < 20 && view.byteLength > 0; i++) {
+      gc()
+      await new Promise(resolve => setImmediate(resolve))
+    }
+    assert.strictEqual(view.byteLength, 0)
+  })
+
+  it('should round-trip strings of every length through reused buffers', () => {
+    // Lengths around the reused buffer's capacity, with multi-byte
+    // characters straddling its end
+    const values: string[] = []
+    for (let length = 0; length < 80; length++) {
+      values.push('x'.repeat(length) + 'é€😀'.repeat(length % 4))
+    }
+    values.forEach((value, i) => {
+      cursor.set(`k${String(i).padStart(3, '0')}`, value)
+      cursor.insert()
+    })
+    values.forEach((value, i) => {
+      assert.strictEqual(cursor.search(`k${String(i).padStart(3, '0')}`), value)
+    })
+  })
+
+  it('should iterate into caller-provided slots', () => {
+    for (let i = 0; i < 3; i++) {
+      cursor.set(`k${i}`, `v${i}`)
+      cursor.insert()
+    }
+
+    const out: [string, string] = ['', '']
+    const seen: string[] = []
+    while (cursor.nextInto(out)) seen.push(`${out[0]}=${out[1]}`)
+    assert.deepStrictEqual(seen, ['k0=v0', 'k1=v1', 'k2=v2'])
+
+    assert.strictEqual(cursor.prevInto(out), true)
+    assert.deepStrictEqual(out, ['k2', 'v2'])
+    assert.strictEqual(cursor.getInto(out), true)
+    assert.deepStrictEqual(cursor.get(), { key: 'k2', value: 'v2' })
+  })
 })
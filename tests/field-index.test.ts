@@ -0,0 +1,141 @@
+import { describe, it, beforeEach, afterEach } from 'node:test'
+import * as assert from 'node:assert'
+import { WiredTigerConnection } from '../src/connection'
+import { WiredTigerSession } from '../src/session'
+import { WiredTigerCursor } from '../src/cursor'
+import { packEntries } from '../src/packed'
+import * as fs from 'fs'
+import * as path from 'path'
+
+describe('Field indexes', () => {
+  const testDbPath = path.join(__dirname, 'test-db-field-index')
+  let conn: WiredTigerConnection
+  let session: WiredTigerSession
+  let cursor: WiredTigerCursor
+
+  const put = (key: string, doc: object) => {
+    cursor.set(key, JSON.stringify(doc))
+    cursor.insert()
+  }
+
+  beforeEach(() => {
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+    fs.mkdirSync(testDbPath, { recursive: true })
+
+    conn = new WiredTigerConnection()
+    conn.open(testDbPath, 'create')
+    session = conn.openSession()
+    session.createTable('users', 'key_format=u,value_format=u')
+    cursor = session.openCursor('users')
+  })
+
+  afterEach(() => {
+    try {
+      cursor?.close()
+      session?.close()
+      conn?.close()
+    } catch {
+      // Ignore errors if already closed
+    }
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+  })
+
+  it('should maintain an index through inserts, updates and removes', () => {
+    assert.strictEqual(session.registerIndex('users', 'age', 'age'), true)
+
+    put('u1', { name: 'a', age: 30 })
+    put('u2', { name: 'b', age: 30 })
+    put('u3', { name: 'c', age: 4 })
+    assert.deepStrictEqual(session.findByIndex('users', 'age', 30), ['u1', 'u2'])
+
+    put('u1', { name: 'a', age: 31 })
+    assert.deepStrictEqual(session.findByIndex('users', 'age', 30), ['u2'])
+    assert.deepStrictEqual(session.findByIndex('users', 'age', 31), ['u1'])
+
+    cursor.set('u2', '')
+    cursor.remove()
+    assert.deepStrictEqual(session.findByIndex('users', 'age', 30), [])
+    assert.deepStrictEqual(session.findByIndex('users', 'age', 4, { limit: 5 }), ['u3'])
+  })
+
+  it('should index nested fields and skip documents without them', () => {
+    session.registerIndex('users', 'city', 'address.city')
+
+    put('u1', { address: { city: 'Oslo' } })
+    put('u2', { address: {} })
+    put('u3', { address: { city: 'Oslo\u0000x' } })
+    assert.deepStrictEqual(session.findByIndex('users', 'city', 'Oslo'), ['u1'])
+  })
+
+  it('should enforce unique indexes', async () => {
+    session.registerIndex('users', 'email', 'email', { unique: true })
+
+    put('u1', { email: 'a@example.com' })
+    assert.throws(() => put('u2', { email: 'a@example.com' }), /Insert failed/)
+    assert.strictEqual(cursor.search('u2'), null)
+
+    // Re-writing the owner is fine
+    put('u1', { email: 'a@example.com', name: 'a' })
+
+    const statuses = cursor.putMany(
+      packEntries([
+        ['u3', JSON.stringify({ email: 'b@example.com' })],
+        ['u4', JSON.stringify({ email: 'b@example.com' })]
+      ])
+    )
+    assert.deepStrictEqual([...statuses], [0, -31801])
+    assert.deepStrictEqual(session.findByIndex('users', 'email', 'b@example.com'), ['u3'])
+
+    await assert.rejects(cursor.insertAsync('u5', JSON.stringify({ email: 'a@example.com' })), /Insert failed/)
+  })
+
+  it('should build an index over existing documents in parallel', async () => {
+    for (let i = 0; i < 500; i++) {
+      put(`u${String(i).padStart(4, '0')}`, { group: i % 5 })
+    }
+    cursor.close()
+
+    assert.strictEqual(session.registerIndex('users', 'group', 'group'), true)
+    const count = await session.buildIndexAsync('users', 'group', { threads: 4 })
+    assert.strictEqual(count, 500)
+    assert.strictEqual(session.findByIndex('users', 'group', 3).length, 100)
+
+    cursor = session.openCursor('users')
+  })
+
+  it('should fail to build a unique index over duplicate values', async () => {
+    put('u1', { email: 'same' })
+    put('u2', { email: 'same' })
+
+    session.registerIndex('users', 'email', 'email', { unique: true })
+    await assert.rejects(session.buildIndexAsync('users', 'email'), /duplicate values/)
+  })
+
+  it('should drop indexes', () => {
+    session.registerIndex('users', 'age', 'age')
+    session.dropIndex('users', 'age')
+    assert.throws(() => session.findByIndex('users', 'age', 1), /No index 'age'/)
+  })
+
+  it('should reload registrations when the connection reopens', () => {
+    session.registerIndex('users', 'age', 'age')
+    session.registerIndex('users', 'name', 'name')
+    session.dropIndex('users', 'name')
+    put('u1', { age: 30 })
+    cursor.close()
+    session.close()
+    conn.close()
+
+    conn = new WiredTigerConnection()
+    conn.open(testDbPath, 'create')
+    session = conn.openSession()
+    cursor = session.openCursor('users')
+    put('u2', { age: 30 })
+    assert.deepStrictEqual(session.findByIndex('users', 'age', 30), ['u1', 'u2'])
+    assert.throws(() => session.findByIndex('users', 'name', 'x'), /No index 'name'/)
+  })
+})
@@ -0,0 +1,119 @@
+import { describe, it, beforeEach, afterEach } from 'node:test'
+import * as assert from 'node:assert'
+import { WiredTigerConnection } from '../src/connection'
+import { WiredTigerSession } from '../src/session'
+import { WiredTigerCursor, ScanOptions } from '../src/cursor'
+import * as fs from 'fs'
+import * as path from 'path'
+
+describe('Scan filters', () => {
+  const testDbPath = path.join(__dirname, 'test-db-filter')
+  let conn: WiredTigerConnection
+  let session: WiredTigerSession
+  let cursor: WiredTigerCursor
+
+  const collect = async (options: ScanOptions) => {
+    const keys: string[] = []
+    for await (const record of cursor.scan(options)) {
+      keys.push(record.key.toString())
+    }
+    return keys
+  }
+
+  beforeEach(() => {
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+    fs.mkdirSync(testDbPath, { recursive: true })
+
+    conn = new WiredTigerConnection()
+    conn.open(testDbPath, 'create')
+    session = conn.openSession()
+    session.createTable('users', 'key_format=u,value_format=u')
+    cursor = session.openCursor('users')
+
+    const docs: Record<string, object> = {
+      'user:1': { name: 'Ada', age: 36, address: { city: 'London' }, tags: ['admin'] },
+      'user:2': { name: 'Bo "B"', age: 17, address: { city: 'Oslo' } },
+      'user:3': { name: 'Cy', age: 52, vip: true, address: { city: 'Oslo' } },
+      'user:4': { name: 'Di', age: '40', nickname: null },
+      'user:5': { name: 'Ed', age: 24, address: { city: 'Paris' }, tags: ['ops', 'admin'] }
+    }
+    for (const [key, doc] of Object.entries(docs)) {
+      cursor.set(key, JSON.stringify(doc))
+      cursor.insert()
+    }
+    cursor.set('raw', 'not json')
+    cursor.insert()
+  })
+
+  afterEach(() => {
+    try {
+      cursor?.close()
+      session?.close()
+      conn?.close()
+    } catch {
+      // Ignore errors if already closed
+    }
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+  })
+
+  it('should match equality on nested fields', async () => {
+    assert.deepStrictEqual(await collect({ filter: { 'address.city': 'Oslo' } }), ['user:2', 'user:3'])
+    assert.deepStrictEqual(await collect({ filter: { name: 'Bo "B"' } }), ['user:2'])
+    assert.deepStrictEqual(await collect({ filter: { 'tags.1': 'admin' } }), ['user:5'])
+  })
+
+  it('should compare numbers without crossing types', async () => {
+    assert.deepStrictEqual(await collect({ filter: { age: { $gte: 24, $lt: 50 } } }), ['user:1', 'user:5'])
+    assert.deepStrictEqual(await collect({ filter: { age: { $gt: '3' } } }), ['user:4'])
+  })
+
+  it('should support $in, $nin, $ne and $exists', async () => {
+    assert.deepStrictEqual(await collect({ filter: { age: { $in: [17, 52] } } }), ['user:2', 'user:3'])
+    assert.deepStrictEqual(await collect({ filter: { 'address.city': { $nin: ['Oslo', 'London'] } } }), [
+      'raw',
+      'user:4',
+      'user:5'
+    ])
+    assert.deepStrictEqual(await collect({ filter: { vip: { $exists: true } } }), ['user:3'])
+    assert.deepStrictEqual(await collect({ filter: { vip: { $ne: true }, tags: { $exists: true } } }), [
+      'user:1',
+      'user:5'
+    ])
+  })
+
+  it('should match null against null and missing fields', async () => {
+    assert.deepStrictEqual(await collect({ gte: 'user:', lt: 'user;', filter: { nickname: null } }), [
+      'user:1',
+      'user:2',
+      'user:3',
+      'user:4',
+      'user:5'
+    ])
+  })
+
+  it('should combine $and, $or and $nor', async () => {
+    const filter = { $or: [{ vip: true }, { age: { $lt: 20 } }], $nor: [{ name: 'Cy' }] }
+    assert.deepStrictEqual(await collect({ filter }), ['user:2'])
+    assert.deepStrictEqual(await collect({ filter: { $and: [{ age: { $gt: 20 } }, { age: { $lt: 40 } }] } }), [
+      'user:1',
+      'user:5'
+    ])
+  })
+
+  it('should apply the limit to matching records only', async () => {
+    assert.deepStrictEqual(await collect({ filter: { 'address.city': 'Oslo' }, limit: 1, reverse: true }), ['user:3'])
+    assert.deepStrictEqual(await collect({ filter: { age: { $gt: 20 } }, chunkSize: 16 }), ['user:1', 'user:3', 'user:5'])
+  })
+
+  it('should reject malformed filters', () => {
+    assert.throws(() => cursor.scanStart({ filter: { age: { $regex: 'x' } } as any }), /Unknown filter operator/)
+    assert.throws(() => cursor.scanStart({ filter: { age: { $in: 3 } } as any }), /Array expected/)
+    assert.throws(() => cursor.scanStart({ filter: { $or: [] } }), /Non-empty array/)
+    assert.throws(() => cursor.scanStart({ filter: { age: [1, 2] } as any }), /\$in/)
+    assert.throws(() => cursor.scanStart({ filter: { 'a..b': 1 } }), /Invalid filter field/)
+  })
+})
@@ -0,0 +1,206 @@
+import { describe, it, beforeEach, afterEach } from 'node:test'
+import * as assert from 'node:assert'
+import { WiredTigerConnection } from '../src/connection'
+import { WiredTigerSession } from '../src/session'
+import { packEntries, packKeys, unpackValues } from '../src/packed'
+import * as fs from 'fs'
+import * as path from 'path'
+
+describe('Typed key/value formats', () => {
+  const testDbPath = path.join(__dirname, 'test-db-formats')
+  let conn: WiredTigerConnection
+  let session: WiredTigerSession
+
+  beforeEach(() => {
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+    fs.mkdirSync(testDbPath, { recursive: true })
+
+    conn = new WiredTigerConnection()
+    conn.open(testDbPath, 'create')
+    session = conn.openSession()
+  })
+
+  afterEach(() => {
+    try {
+      session?.close()
+      conn?.close()
+    } catch {
+      // Ignore errors if already closed
+    }
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+  })
+
+  it('should store string tables through native packing', () => {
+    session.createTable('strings', 'key_format=S,value_format=S')
+    const cursor = session.openCursor('strings')
+
+    cursor.set('key1', 'value1')
+    cursor.insert()
+    assert.strictEqual(cursor.search('key1'), 'value1')
+
+    cursor.reset()
+    assert.deepStrictEqual(cursor.next(), { key: 'key1', value: 'value1' })
+    cursor.close()
+  })
+
+  it('should order integer keys numerically', () => {
+    session.createTable('numbers', 'key_format=q,value_format=S')
+    const cursor = session.openCursor('numbers')
+
+    for (const key of [100, -5, 7, 2 ** 40]) {
+      cursor.set(key, `v${key}`)
+      cursor.insert()
+    }
+
+    cursor.reset()
+    const keys: number[] = []
+    let row = cursor.next<number>()
+    while (row) {
+      keys.push(row.key)
+      row = cursor.next<number>()
+    }
+    assert.deepStrictEqual(keys, [-5, 7, 100, 2 ** 40])
+    assert.strictEqual(cursor.search(7), 'v7')
+    cursor.close()
+  })
+
+  it('should round-trip 64-bit values as bigint', () => {
+    session.createTable('big', 'key_format=Q,value_format=q')
+    const cursor = session.openCursor('big')
+
+    cursor.set(2n ** 63n, -(2n ** 60n))
+    cursor.insert()
+    cursor.set(1, 2)
+    cursor.insert()
+
+    assert.strictEqual(cursor.search<bigint>(2n ** 63n), -(2n ** 60n))
+    assert.strictEqual(cursor.search<number>(1n), 2)
+    cursor.close()
+  })
+
+  it('should pack compound keys and values', () => {
+    session.createTable('compound', 'key_format=qS,value_format=Su')
+    const cursor = session.openCursor('compound')
+
+    cursor.set([2, 'b'], ['two', Buffer.from([1, 2, 3])])
+    cursor.insert()
+    cursor.set([1, 'z'], ['one', Buffer.alloc(0)])
+    cursor.insert()
+
+    cursor.reset()
+    const first = cursor.next<[number, string], [string, Buffer]>()
+    assert.deepStrictEqual(first?.key, [1, 'z'])
+
+    const value = cursor.search<[string, Buffer]>([2, 'b'])
+    assert.strictEqual(value?.[0], 'two')
+    assert.deepStrictEqual([...value![1]], [1, 2, 3])
+    cursor.close()
+  })
+
+  it('should pack on the threadpool for async calls', async () => {
+    session.createTable('async', 'key_format=r,value_format=S')
+    const cursor = session.openCursor('async')
+
+    await cursor.insertAsync(1, 'first')
+    await cursor.insertAsync(2, 'second')
+    assert.strictEqual(await cursor.searchAsync(2), 'second')
+
+    cursor.reset()
+    assert.deepStrictEqual(await cursor.nextAsync(), { key: 1, value: 'first' })
+
+    await cursor.removeAsync(1)
+    assert.strictEqual(await cursor.searchAsync(1), null)
+    cursor.close()
+  })
+
+  it('should pack range bounds and batch keys on typed tables', async () => {
+    session.createTable('strings', 'key_format=S,value_format=S')
+    const strings = session.openCursor('strings')
+    strings.putMany(packEntries([['k1', 'v1'], ['k2', 'v2'], ['k3', 'v3']]))
+    assert.strictEqual(strings.search('k2'), 'v2')
+    assert.strictEqual(strings.count({ lte: 'k2' }), 2)
+    assert.strictEqual(await strings.countAsync({ gt: 'k1', lt: 'k3' }), 1)
+    assert.deepStrictEqual(strings.getMany(['k3', 'missing', 'k1']), ['v3', undefined, 'v1'])
+    assert.deepStrictEqual(
+      unpackValues(strings.getMany(packKeys(['k2']))).map(value => value?.toString()),
+      ['v2']
+    )
+    assert.deepStrictEqual([...strings.removeMany(['k1'])], [0])
+    assert.strictEqual(strings.count(), 2)
+    strings.close()
+
+    session.createTable('numbers', 'key_format=q,value_format=S')
+    const numbers = session.openCursor('numbers')
+    for (const n of [-5, 2, 10, 300]) {
+      numbers.set(n, `n${n}`)
+      numbers.insert()
+    }
+    assert.strictEqual(numbers.count({ gte: 2, lte: 10 }), 2)
+    assert.deepStrictEqual(await numbers.getManyAsync([300, -5]), ['n300', 'n-5'])
+    numbers.bound({ gt: 2 })
+    assert.deepStrictEqual(numbers.next(), { key: 10, value: 'n10' })
+    numbers.bound(null)
+    assert.throws(() => numbers.putMany(packEntries([['1', 'x']])), /need string or byte keys/)
+    numbers.close()
+  })
+
+  it('should pack the key of a value view search', () => {
+    session.createTable('views', 'key_format=qS,value_format=S')
+    const cursor = session.openCursor('views')
+    cursor.set([7, 'a'], 'seven')
+    cursor.insert()
+
+    // Views expose the packed value, trailing NUL included
+    const view = cursor.searchView([7, 'a'])
+    assert.ok(view)
+    assert.strictEqual(Buffer.from(view).toString(), 'seven\0')
+    assert.strictEqual(cursor.searchView([7, 'b']), null)
+    assert.throws(() => cursor.searchView('7a'), /does not match format 'qS'/)
+    cursor.close()
+  })
+
+  it('should split parallel scans of typed tables', async () => {
+    session.createTable('strings', 'key_format=S,value_format=S')
+    const strings = session.openCursor('strings')
+    const keyOf = (i: number) => `k${String(i).padStart(5, '0')}`
+    strings.putMany(packEntries(Array.from({ length: 2000 }, (_, i) => [keyOf(i), `v${i}`] as [string, string])))
+    strings.close()
+
+    // Typed records come back packed: 'S' columns keep their trailing NUL
+    const keys: string[] = []
+    for await (const { key } of session.parallelScan('strings', { threads: 4, gte: keyOf(500) })) {
+      keys.push(key.toString('utf8', 0, key.length - 1))
+    }
+    assert.strictEqual(keys.length, 1500)
+    assert.deepStrictEqual(keys, Array.from({ length: 1500 }, (_, i) => keyOf(i + 500)))
+
+    session.createTable('numbers', 'key_format=q,value_format=S')
+    const numbers = session.openCursor('numbers')
+    for (let n = -1000; n < 1000; n++) {
+      numbers.set(n, `n${n}`)
+      numbers.insert()
+    }
+    numbers.close()
+
+    const values = new Set<string>()
+    for await (const { value } of session.parallelScan('numbers', { threads: 4, gte: -100, lt: 100, ordered: false })) {
+      values.add(value.toString('utf8', 0, value.length - 1))
+    }
+    assert.strictEqual(values.size, 200)
+    assert.ok(values.has('n-100') && values.has('n99') && !values.has('n100'))
+  })
+
+  it('should reject values that do not match the format', () => {
+    session.createTable('strict', 'key_format=qS,value_format=I')
+    const cursor = session.openCursor('strict')
+
+    assert.throws(() => cursor.set('nope', 1), /does not match format 'qS'/)
+    assert.throws(() => cursor.set([1, 'a'], -1), /does not match format 'I'/)
+    assert.throws(() => cursor.set([1.5, 'a'], 1), /does not match/)
+    cursor.close()
+  })
+})
@@ -0,0 +1,139 @@
+import { describe, it, beforeEach, afterEach } from 'node:test'
+import * as assert from 'node:assert'
+import { ImportProgress, WiredTigerConnection } from '../src/connection'
+import { WiredTigerSession } from '../src/session'
+import { decodeKey } from '../src/keys'
+import { packEntries } from '../src/packed'
+import * as fs from 'fs'
+import * as path from 'path'
+
+describe('Bulk import', () => {
+  const testDbPath = path.join(__dirname, 'test-db-import')
+  const inputDir = path.join(__dirname, 'test-import-input')
+  let conn: WiredTigerConnection
+  let session: WiredTigerSession
+
+  beforeEach(() => {
+    for (const dir of [testDbPath, inputDir]) {
+      if (fs.existsSync(dir)) {
+        fs.rmSync(dir, { recursive: true, force: true })
+      }
+      fs.mkdirSync(dir, { recursive: true })
+    }
+
+    conn = new WiredTigerConnection()
+    conn.open(testDbPath, 'create')
+    session = conn.openSession()
+  })
+
+  afterEach(() => {
+    try {
+      session?.close()
+      conn?.close()
+    } catch {
+      // Ignore errors if already closed
+    }
+    for (const dir of [testDbPath, inputDir]) {
+      if (fs.existsSync(dir)) {
+        fs.rmSync(dir, { recursive: true, force: true })
+      }
+    }
+  })
+
+  const readAll = (table: string) => {
+    const cursor = session.openCursor(table)
+    const rows: [string, string][] = []
+    for (let record = cursor.next(); record; record = cursor.next()) rows.push([record.key, record.value])
+    cursor.close()
+    return rows
+  }
+
+  it('should sort NDJSON through spilled runs and bulk load it', async () => {
+    const ids = Array.from({ length: 2000 }, (_, i) => `doc${String((i * 7919) % 2000).padStart(5, '0')}`)
+    const lines = ids.map(id => JSON.stringify({ _id: id, n: id.length }))
+    lines.splice(10, 0, '', JSON.stringify({ name: 'no id' }))
+    lines.push(JSON.stringify({ _id: 'doc00003', n: 'last' }))
+    const file = path.join(inputDir, 'docs.ndjson')
+    fs.writeFileSync(file, lines.join('\r\n') + '\n')
+
+    session.createTable('docs', 'key_format=S,value_format=S')
+    const phases = new Set<string>()
+    const result = await conn.importFile('docs', file, {
+      memoryBytes: 16 * 1024,
+      blockBytes: 8 * 1024,
+      tempDir: inputDir,
+      onProgress: (progress: ImportProgress) => phases.add(progress.phase)
+    })
+
+    assert.strictEqual(result.bulk, true)
+    assert.strictEqual(result.records, 2001)
+    assert.strictEqual(result.skipped, 1)
+    assert.strictEqual(result.duplicates, 1)
+    assert.strictEqual(result.loaded, 2000)
+    assert.ok(result.runs > 0)
+    assert.strictEqual(result.bytesRead, fs.statSync(file).size)
+    assert.deepStrictEqual([...phases].sort(), ['done', 'load', 'merge', 'read'])
+    // Spilled runs are cleaned up
+    assert.deepStrictEqual(fs.readdirSync(inputDir), ['docs.ndjson'])
+
+    const rows = readAll('docs')
+    assert.strictEqual(rows.length, 2000)
+    assert.deepStrictEqual(
+      rows.map(([key]) => key),
+      [...ids].sort()
+    )
+    assert.deepStrictEqual(rows[3], ['doc00003', JSON.stringify({ _id: 'doc00003', n: 'last' })])
+  })
+
+  it('should load packed records into a populated table in transactions', async () => {
+    session.createTable('packed', 'key_format=u,value_format=u')
+    const cursor = session.openCursor('packed')
+    cursor.set('k0001', 'old')
+    cursor.insert()
+    cursor.close()
+
+    const entries: [string, string][] = []
+    for (let i = 500; i > 0; i--) entries.push([`k${String(i).padStart(4, '0')}`, `v${i}`])
+    const file = path.join(inputDir, 'records.bin')
+    fs.writeFileSync(file, packEntries(entries))
+
+    const result = await conn.importFile('table:packed', file, { format: 'packed', threads: 3, batchSize: 64 })
+    assert.strictEqual(result.bulk, false)
+    assert.strictEqual(result.loaded, 500)
+
+    const rows = readAll('packed')
+    assert.strictEqual(rows.length, 500)
+    assert.deepStrictEqual(rows[0], ['k0001', 'v1'])
+    assert.deepStrictEqual(rows[499], ['k0500', 'v500'])
+
+    fs.writeFileSync(file, packEntries(entries).subarray(0, 10))
+    await assert.rejects(conn.importFile('packed', file, { format: 'packed' }), /truncated record/)
+  })
+
+  it('should refuse to close the connection while an import runs', async () => {
+    const file = path.join(inputDir, 'pending.bin')
+    fs.writeFileSync(file, packEntries([['a', '1'], ['b', '2']]))
+    session.createTable('pending', 'key_format=u,value_format=u')
+    const running = conn.importFile('pending', file, { format: 'packed' })
+    assert.throws(() => conn.close(), /async operations are pending/)
+    assert.strictEqual((await running).loaded, 2)
+  })
+
+  it('should encode compound keys from ObjectIds and numbers', async () => {
+    const file = path.join(inputDir, 'ids.ndjson')
+    fs.writeFileSync(
+      file,
+      [{ _id: { $oid: '65a1b2c3d4e5f60718293a4b' } }, { _id: 10 }, { _id: 2 }].map(doc => JSON.stringify(doc)).join('\n')
+    )
+    session.createTable('ids', 'key_format=u,value_format=u')
+    await conn.importFile('ids', file, { keyEncoding: 'compound' })
+
+    const cursor = session.openCursor('ids')
+    const keys: unknown[] = []
+    while (cursor.next()) keys.push(decodeKey(cursor.getRawKey()!)[0])
+    cursor.close()
+    assert.strictEqual(keys.length, 3)
+    assert.deepStrictEqual(keys.slice(0, 2), [2, 10])
+    assert.strictEqual(String(keys[2]), '65a1b2c3d4e5f60718293a4b')
+  })
+})
@@ -0,0 +1,93 @@
+import { describe, it, beforeEach, afterEach } from 'node:test'
+import * as assert from 'node:assert'
+import { WiredTigerConnection } from '../src/connection'
+import { WiredTigerSession } from '../src/session'
+import { KeyObjectId, KeyPart, decodeKey, encodeKey, keyPrefixRange, keyRange } from '../src/keys'
+import * as fs from 'fs'
+import * as path from 'path'
+
+describe('Compound key encoding', () => {
+  const testDbPath = path.join(__dirname, 'test-db-keys')
+  let conn: WiredTigerConnection
+  let session: WiredTigerSession
+
+  beforeEach(() => {
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+    fs.mkdirSync(testDbPath, { recursive: true })
+
+    conn = new WiredTigerConnection()
+    conn.open(testDbPath, 'create')
+    session = conn.openSession()
+  })
+
+  afterEach(() => {
+    try {
+      session?.close()
+      conn?.close()
+    } catch {
+      // Ignore errors if already closed
+    }
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+  })
+
+  it('should round-trip every element type', () => {
+    const when = new Date('2024-01-02T03:04:05Z')
+    const id = new KeyObjectId('65a1b2c3d4e5f60718293a4b')
+    const key = encodeKey([null, true, false, -1.5, 'a\u0000b', when, id, Buffer.from([0, 1])])
+    const [nil, yes, no, number, text, date, objectId, bytes] = decodeKey(key) as any[]
+    assert.strictEqual(nil, null)
+    assert.strictEqual(yes, true)
+    assert.strictEqual(no, false)
+    assert.strictEqual(number, -1.5)
+    assert.strictEqual(text, 'a\u0000b')
+    assert.strictEqual(date.getTime(), when.getTime())
+    assert.strictEqual(objectId.toHexString(), id.toHexString())
+    assert.deepStrictEqual([...bytes], [0, 1])
+  })
+
+  it('should sort encoded keys in tuple order', () => {
+    const tuples: KeyPart[][] = [
+      ['age', -10, 'b'],
+      ['age', 2],
+      ['age', 2, 'a'],
+      ['age', 10],
+      ['age', 35, 'x'],
+      ['age', 'thirty'],
+      ['agf'],
+      ['b\u0000'],
+      ['b\u0000a']
+    ]
+    const encoded = tuples.map(encodeKey)
+    const sorted = [...encoded].sort(Buffer.compare)
+    assert.deepStrictEqual(sorted, encoded)
+    assert.throws(() => encodeKey([NaN]), /NaN/)
+    assert.throws(() => encodeKey([new Date(NaN)]), /invalid Date/)
+    assert.throws(() => encodeKey([{} as any]), /Unsupported key element/)
+  })
+
+  it('should set raw keys from key elements and scan ranges', async () => {
+    session.createTable('people', 'key_format=u,value_format=u')
+    const cursor = session.openCursor('people')
+    for (const [age, id] of [[35, 'c'], [9, 'a'], [100, 'd'], [35, 'b'], [18, 'e']] as const) {
+      cursor.setRawKey(['age', age, id])
+      cursor.setRawValue(new TextEncoder().encode(id).buffer as ArrayBuffer)
+      cursor.insert()
+    }
+
+    const ids = async (range: object) => {
+      const found: string[] = []
+      for await (const record of cursor.scan(range)) found.push(record.value.toString())
+      return found
+    }
+    assert.deepStrictEqual(await ids(keyPrefixRange(['age'])), ['a', 'e', 'b', 'c', 'd'])
+    assert.deepStrictEqual(await ids(keyRange(['age'], { gte: 18, lt: 100 })), ['e', 'b', 'c'])
+    assert.deepStrictEqual(await ids(keyRange(['age'], { gt: 18, lte: 35 })), ['b', 'c'])
+
+    assert.deepStrictEqual(cursor.searchNear(['age', 35, 'b']), { exact: 0 })
+    assert.deepStrictEqual(decodeKey(cursor.getRawKey()!), ['age', 35, 'b'])
+  })
+})
@@ -0,0 +1,85 @@
+import { describe, it, beforeEach, afterEach } from 'node:test'
+import * as assert from 'node:assert'
+import { WiredTigerConnection } from '../src/connection'
+import { getBindingMetrics, resetBindingMetrics, setBindingMetricsEnabled } from '../src/metrics'
+import * as fs from 'fs'
+import * as path from 'path'
+
+describe('Binding metrics', () => {
+  const testDbPath = path.join(__dirname, 'test-db-metrics')
+  let conn: WiredTigerConnection
+
+  beforeEach(() => {
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+    fs.mkdirSync(testDbPath, { recursive: true })
+    conn = new WiredTigerConnection()
+    conn.open(testDbPath, 'create')
+    resetBindingMetrics()
+  })
+
+  afterEach(() => {
+    setBindingMetricsEnabled(false)
+    try {
+      conn?.close()
+    } catch {
+      // Ignore errors if already closed
+    }
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+  })
+
+  it('should record nothing while disabled', () => {
+    const session = conn.openSession()
+    session.createTable('test', 'key_format=u,value_format=u')
+    const cursor = session.openCursor('test')
+    cursor.set('k', 'v')
+    cursor.insert()
+    cursor.search('k')
+
+    const metrics = getBindingMetrics()
+    assert.strictEqual(metrics.enabled, false)
+    assert.strictEqual(metrics.ops.search.calls, 0)
+    assert.strictEqual(metrics.ops.insert.calls, 0)
+    session.close()
+  })
+
+  it('should time calls and count bytes while enabled', () => {
+    const session = conn.openSession()
+    session.createTable('test', 'key_format=u,value_format=u')
+    const cursor = session.openCursor('test')
+
+    setBindingMetricsEnabled(true)
+    session.beginTransaction()
+    for (let i = 0; i < 50; i++) {
+      cursor.set(`key${i}`, 'value')
+      cursor.insert()
+    }
+    session.commitTransaction()
+    for (let i = 0; i < 50; i++) {
+      cursor.search(`key${i}`)
+    }
+    cursor.reset()
+    while (cursor.next()) {
+      // walk the table
+    }
+
+    const { enabled, ops } = getBindingMetrics()
+    assert.strictEqual(enabled, true)
+    assert.strictEqual(ops.insert.calls, 50)
+    assert.strictEqual(ops.commit.calls, 1)
+    assert.strictEqual(ops.search.calls, 50)
+    assert.strictEqual(ops.next.calls, 51)
+    assert.ok(ops.set.bytesIn >= 50 * 'value'.length)
+    assert.strictEqual(ops.search.bytesOut, 50 * 'value'.length)
+    assert.ok(ops.search.totalMs >= ops.search.engineMs)
+    assert.ok(ops.search.latencyUs.p99 >= ops.search.latencyUs.p50)
+    assert.ok(ops.search.latencyUs.max > 0)
+
+    resetBindingMetrics()
+    assert.strictEqual(getBindingMetrics().ops.search.calls, 0)
+    session.close()
+  })
+})
@@ -0,0 +1,245 @@
+import { describe, it, beforeEach, afterEach } from 'node:test'
+import * as assert from 'node:assert'
+import { WiredTigerConnection } from '../src/connection'
+import { WiredTigerSession } from '../src/session'
+import { WiredTigerCursor, ScanOptions } from '../src/cursor'
+import { decodeScanChunk } from '../src/packed'
+import * as fs from 'fs'
+import * as path from 'path'
+
+describe('Range scans', () => {
+  const testDbPath = path.join(__dirname, 'test-db-scan')
+  let conn: WiredTigerConnection
+  let session: WiredTigerSession
+  let cursor: WiredTigerCursor
+
+  const collect = async (options: ScanOptions) => {
+    const keys: string[] = []
+    for await (const record of cursor.scan(options)) {
+      keys.push(record.key.toString())
+    }
+    return keys
+  }
+
+  beforeEach(() => {
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+    fs.mkdirSync(testDbPath, { recursive: true })
+
+    conn = new WiredTigerConnection()
+    conn.open(testDbPath, 'create')
+    session = conn.openSession()
+    session.createTable('test', 'key_format=u,value_format=u')
+    cursor = session.openCursor('test')
+
+    for (let i = 0; i < 20; i++) {
+      cursor.set(`key${String(i).padStart(2, '0')}`, `value${i}`)
+      cursor.insert()
+    }
+  })
+
+  afterEach(() => {
+    try {
+      cursor?.close()
+      session?.close()
+      conn?.close()
+    } catch {
+      // Ignore errors if already closed
+    }
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+  })
+
+  it('should scan the whole table', async () => {
+    const keys = await collect({})
+    assert.strictEqual(keys.length, 20)
+    assert.strictEqual(keys[0], 'key00')
+    assert.strictEqual(keys[19], 'key19')
+  })
+
+  it('should honour inclusive and exclusive bounds', async () => {
+    assert.deepStrictEqual(await collect({ gte: 'key05', lte: 'key07' }), ['key05', 'key06', 'key07'])
+    assert.deepStrictEqual(await collect({ gt: 'key05', lt: 'key07' }), ['key06'])
+    assert.deepStrictEqual(await collect({ gte: 'key045', lt: 'key06' }), ['key05'])
+  })
+
+  it('should scan in reverse with a limit', async () => {
+    assert.deepStrictEqual(await collect({ lte: 'key10', reverse: true, limit: 3 }), ['key10', 'key09', 'key08'])
+  })
+
+  it('should span several small chunks', async () => {
+    const keys = await collect({ chunkSize: 32 })
+    assert.strictEqual(keys.length, 20)
+  })
+
+  it('should return values with the records', async () => {
+    for await (const record of cursor.scan({ gte: 'key03', limit: 1 })) {
+      assert.strictEqual(record.value.toString(), 'value3')
+    }
+  })
+
+  it('should fill caller-supplied buffers synchronously', () => {
+    cursor.scanStart({ gte: 'key18' })
+    const chunk = Buffer.alloc(1024)
+    const result = cursor.scanFill(chunk)
+
+    assert.strictEqual(result.count, 2)
+    assert.strictEqual(result.done, true)
+    const records = Array.from(decodeScanChunk(chunk, result.count))
+    assert.deepStrictEqual(
+      records.map(r => r.key.toString()),
+      ['key18', 'key19']
+    )
+  })
+
+  it('should report the size needed for an oversized record', () => {
+    cursor.scanStart({})
+    const result = cursor.scanFill(Buffer.alloc(4))
+    assert.strictEqual(result.count, 0)
+    assert.ok(result.needed > 4)
+    assert.strictEqual(result.done, false)
+  })
+
+  it('should expose a Readable stream', async () => {
+    let count = 0
+    for await (const record of cursor.scanStream({ lt: 'key05' })) {
+      assert.ok(record.key)
+      count++
+    }
+    assert.strictEqual(count, 5)
+  })
+
+  it('should stop next() and prev() at cursor bounds', () => {
+    cursor.bound({ gt: 'key03', lte: 'key05' })
+    const forward: string[] = []
+    for (let row = cursor.next(); row; row = cursor.next()) forward.push(row.key)
+    assert.deepStrictEqual(forward, ['key04', 'key05'])
+
+    cursor.bound({ gte: 'key17' })
+    assert.strictEqual(cursor.prev()?.key, 'key19')
+    assert.strictEqual(cursor.search('key02'), null)
+
+    cursor.bound(null)
+    assert.strictEqual(cursor.search('key02'), 'value2')
+  })
+
+  it('should count a range natively', async () => {
+    assert.strictEqual(cursor.count(), 20)
+    assert.strictEqual(cursor.count({ gte: 'key05', lt: 'key10' }), 5)
+    assert.strictEqual(cursor.count({ gt: 'key05', limit: 3 }), 3)
+    assert.strictEqual(await cursor.countAsync({ lte: 'key02' }), 3)
+    // The cursor isn't left bounded
+    assert.strictEqual(cursor.next()?.key, 'key00')
+  })
+})
+
+describe('Parallel scans', () => {
+  const testDbPath = path.join(__dirname, 'test-db-parallel-scan')
+  let conn: WiredTigerConnection
+  let session: WiredTigerSession
+
+  const keyOf = (i: number) => `key${String(i).padStart(5, '0')}`
+
+  beforeEach(() => {
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+    fs.mkdirSync(testDbPath, { recursive: true })
+
+    conn = new WiredTigerConnection()
+    conn.open(testDbPath, 'create')
+    session = conn.openSession()
+    session.createTable('test', 'key_format=u,value_format=u')
+    const cursor = session.openCursor('test')
+    session.beginTransaction()
+    for (let i = 0; i < 5000; i++) {
+      cursor.set(keyOf(i), JSON.stringify({ n: i }))
+      cursor.insert()
+    }
+    session.commitTransaction()
+    cursor.close()
+  })
+
+  afterEach(() => {
+    try {
+      session?.close()
+      conn?.close()
+    } catch {
+      // Ignore errors if already closed
+    }
+    if (fs.existsSync(testDbPath)) {
+      fs.rmSync(testDbPath, { recursive: true, force: true })
+    }
+  })
+
+  it('should return every record in key order', async () => {
+    const keys: string[] = []
+    for await (const record of session.parallelScan('test', { threads: 4, batchSize: 4096 })) {
+      keys.push(record.key.toString())
+    }
+    assert.strictEqual(keys.length, 5000)
+    assert.deepStrictEqual(keys, [...keys].sort())
+  })
+
+  it('should read the table as of the start of the scan', async () => {
+    const scan = session.parallelScan('test', { threads: 4, batchSize: 1024 })
+    const first = await scan.next()
+    assert.strictEqual(first.value?.key.toString(), keyOf(0))
+
+    const writer = conn.openSession()
+    const cursor = writer.openCursor('test')
+    cursor.set('key99999', '{}')
+    cursor.insert()
+    cursor.set(keyOf(4999), JSON.stringify({ n: -1 }))
+    cursor.update()
+    cursor.close()
+    writer.close()
+
+    let count = 1
+    let last = ''
+    for await (const record of scan) {
+      count++
+      last = record.value.toString()
+    }
+    assert.strictEqual(count, 5000)
+    assert.strictEqual(JSON.parse(last).n, 4999)
+  })
+
+  it('should scan a filtered range unordered', async () => {
+    const keys = new Set<string>()
+    const parts = new Set<number>()
+    for await (const record of session.parallelScan('test', {
+      gte: keyOf(1000),
+      lt: keyOf(3000),
+      filter: { n: { $lt: 2000 } },
+      ordered: false,
+      snapshot: 'none'
+    })) {
+      keys.add(record.key.toString())
+      parts.add(record.part)
+    }
+    assert.strictEqual(keys.size, 1000)
+    assert.ok(keys.has(keyOf(1000)) && keys.has(keyOf(1999)) && !keys.has(keyOf(2000)))
+    assert.ok(parts.size >= 1)
+  })
+
+  it('should stop the threads when the consumer stops early', async () => {
+    let seen = 0
+    for await (const _record of session.parallelScan('test', { batchSize: 512, queueDepth: 1 })) {
+      if (++seen === 10) break
+    }
+    assert.strictEqual(seen, 10)
+    session.close()
+  })
+
+  it('should reject next() as cancelled once the session closes', async () => {
+    const scan = session.parallelScan('test', { batchSize: 1, queueDepth: 1 })
+    const first = await scan.next()
+    assert.strictEqual(first.value?.key.toString(), keyOf(0))
+    session.close()
+    await assert.rejects(scan.next(), /scan cancelled/)
+    conn.close()
+  })
+})
@@ -206,4 +206,106 @@ describe('WiredTigerSession', () => {
       'Should throw error for undefined session'
     )
   })
+  it('should reuse closed cursors from the cursor cache', () => {
+    const session = conn.openSession()
+    session.createTable('test', 'key_format=u,value_format=u')
+
+    const first = session.openCursor('test')
+    first.set('key1', 'value1')
+    first.insert()
+    first.close()
+    assert.throws(() => first.search('key1'), /Cursor is closed/)
+
+    const second = session.openCursorWithConfig('table:test')
+    assert.strictEqual(second, first)
+    assert.strictEqual(second.search('key1'), 'value1')
+
+    const other = session.openCursorWithConfig('table:test', 'overwrite=false')
+    assert.notStrictEqual(other, first)
+
+    const stats = session.getCursorCacheStats()
+    assert.strictEqual(stats.hits, 1)
+    assert.strictEqual(stats.misses, 2)
+    assert.strictEqual(stats.cached, 0)
+
+    other.close()
+    second.close()
+    assert.strictEqual(session.getCursorCacheStats().cached, 2)
+    session.close()
+  })
+
+  it('should evict the least recently closed cursor', () => {
+    conn.close()
+    conn = new WiredTigerConnection()
+    conn.open(testDbPath, 'create', { cursorCacheSize: 1 })
+
+    const session = conn.openSession()
+    session.createTable('a', 'key_format=u,value_format=u')
+    session.createTable('b', 'key_format=u,value_format=u')
+
+    session.openCursor('a').close()
+    session.openCursor('b').close()
+    const stats = session.getCursorCacheStats()
+    assert.strictEqual(stats.cached, 1)
+    assert.strictEqual(stats.evictions, 1)
+
+    session.openCursor('b')
+    assert.strictEqual(session.getCursorCacheStats().hits, 1)
+    session.close()
+  })
+
+  it('should drop a table with cached cursors', () => {
+    const session = conn.openSession()
+    session.createTable('test', 'key_format=u,value_format=u')
+    session.openCursor('test').close()
+
+    assert.doesNotThrow(() => session.drop('table:test'))
+    assert.strictEqual(session.getCursorCacheStats().cached, 0)
+    session.close()
+  })
+
+  it('should read versions as of a timestamp', async () => {
+    const session = conn.openSession()
+    session.createTable('versions', 'key_format=u,value_format=u')
+    const cursor = session.openCursor('versions')
+    for (const [value, ts] of [['v1', 10n], ['v2', 20]] as const) {
+      session.beginTransaction()
+      cursor.set('k', value)
+      cursor.insert()
+      session.commitTransaction({ commitTimestamp: ts })
+    }
+    assert.strictEqual(conn.queryTimestamp('all_durable'), 20n)
+
+    const read = () => session.openCursor('versions').search('k')
+    assert.strictEqual(await session.readAt(5, read), null)
+    assert.strictEqual(await session.readAt('f', read), 'v1')
+    assert.strictEqual(await session.readAt(25n, read), 'v2')
+
+    session.beginTransaction({ readTimestamp: 12 })
+    assert.strictEqual(session.queryTimestamp('read'), 12n)
+    session.rollbackTransaction()
+
+    conn.setTimestamps({ oldest: 10, stable: 20 })
+    assert.strictEqual(conn.queryTimestamp('stable'), 20n)
+    assert.strictEqual(conn.queryTimestamp('oldest'), 10n)
+    // Older than the oldest timestamp
+    await assert.rejects(session.readAt(5, read))
+    assert.strictEqual(await session.readAt(5, read, { roundUpRead: true }), 'v1')
+    session.close()
+  })
+
+  it('should set a commit timestamp inside the transaction', () => {
+    const session = conn.openSession()
+    session.createTable('late', 'key_format=u,value_format=u')
+    const cursor = session.openCursor('late')
+    session.beginTransaction()
+    cursor.set('k', 'v')
+    cursor.insert()
+    session.timestampTransaction({ commit: 30 })
+    assert.strictEqual(session.queryTimestamp('commit'), 30n)
+    session.commitTransaction()
+    assert.strictEqual(conn.queryTimestamp('all_durable'), 30n)
+    assert.throws(() => session.timestampTransaction({ commit: -1 }), RangeError)
+    session.close()
+  })
 })